@@ -0,0 +1,811 @@
+/* Implementation of the scan resistant page replacement algorithms			*/
+/* for comments on the global functions see the associated .h-file			*/
+/* Resident pages and ghosts are kept in one pool of entries. An entry can	*/
+/* be linked into two lists at a time (slot 0 and slot 1), which LIRS needs	*/
+/* for stack S and queue Q and CLOCK-Pro for its clock and the age order of	*/
+/* the ghosts. Lists are doubly linked via entry indices, head is the		*/
+/* oldest (LRU) end, tail the newest (MRU) end. The clocks of CAR and		*/
+/* CLOCK-Pro are lists as well, the hand of CAR is always the head.			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <stdio.h>
+#include "bs_types.h"
+#include "global.h"
+#include "adaptive.h"
+
+// resident pages plus at most MEMORYSIZE ghosts plus the entry of a fault
+#define ADAPTIVE_ENTRIES (2 * MEMORYSIZE + 1)
+#define ADAPTIVE_BUCKETS (2 * MEMORYSIZE)
+
+#define ENTRY_REFERENCED 1		// CAR, CLOCK-Pro: reference bit
+#define ENTRY_HOT 2				// LIRS: LIR page, CLOCK-Pro: hot page
+#define ENTRY_TEST 4			// CLOCK-Pro: cold page in its test period
+
+/* the lists, each with a fixed slot of the entries */
+typedef enum
+{
+	noList, listT1, listT2, listB1, listB2,		// ARC, CAR
+	listA1in, listAm, listA1out,				// 2Q
+	listStack, listQueue,						// LIRS
+	listClock,									// CLOCK-Pro
+	listGhosts,									// LIRS, CLOCK-Pro: ghosts by age
+	ADAPTIVE_LISTS
+} adaptiveListId_t;
+
+/* one resident page or ghost */
+typedef struct adaptiveEntry_struct
+{
+	unsigned pid;
+	unsigned page;
+	int frame;					// NONE for a ghost
+	int hashNext;				// next ghost in the hash bucket, next free entry
+	int prev[2];				// neighbours in the list of each slot
+	int next[2];
+	unsigned char list[2];		// list of each slot, noList if not linked
+	unsigned char flags;		// ENTRY_...
+} adaptiveEntry_t;
+
+typedef struct adaptiveList_struct
+{
+	int head;					// oldest entry, NONE if empty
+	int tail;					// newest entry
+	unsigned count;
+} adaptiveList_t;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+adaptiveEntry_t adaptiveEntry[ADAPTIVE_ENTRIES];
+int adaptiveBucket[ADAPTIVE_BUCKETS];		// hash index of the ghosts
+int adaptiveFrameEntry[MEMORYSIZE];			// entry of the page in each frame
+adaptiveList_t adaptiveLists[ADAPTIVE_LISTS];
+const unsigned char adaptiveListSlot[ADAPTIVE_LISTS] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1 };
+int adaptiveFreeEntry = NONE;				// unused entries, linked via hashNext
+int adaptivePending = NONE;					// entry of the page of the last fault
+adaptiveListId_t adaptivePendingList = noList;	// ghost list it was found in, noList for a miss
+unsigned adaptiveTarget = 0;				// ARC/CAR p, CLOCK-Pro mc
+unsigned adaptiveKin = 1;					// 2Q: size of A1in
+unsigned adaptiveKout = 1;					// 2Q: size of A1out
+unsigned adaptiveLirMax = 1;				// LIRS: size of the LIR set
+unsigned adaptiveLirCount = 0;				// LIRS: LIR pages
+unsigned adaptiveHotCount = 0;				// CLOCK-Pro: hot pages
+unsigned adaptiveColdCount = 0;				// CLOCK-Pro: resident cold pages
+int adaptiveHandHot = NONE;					// CLOCK-Pro: hand demoting hot pages
+int adaptiveHandCold = NONE;				// CLOCK-Pro: hand evicting cold pages
+adaptiveStatistics_t adaptiveStats;
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+unsigned ghostHash(unsigned pid, unsigned page);
+/* returns the hash bucket of the page										*/
+
+int ghostLookup(unsigned pid, unsigned page);
+/* returns the ghost entry of the page, NONE if the page has no ghost		*/
+
+void makeGhost(int e, adaptiveListId_t list);
+/* turns the entry of an evicted page into a ghost appended to the list		*/
+
+void unhashGhost(int e);
+/* removes the ghost from the hash index, it is no ghost any more			*/
+
+void dropGhost(int e);
+/* discards the ghost completely											*/
+
+int newEntry(unsigned pid, unsigned page);
+/* returns an unused entry for the page, NONE if the pool is exhausted		*/
+
+void freeEntry(int e);
+/* unlinks the entry from all lists and returns it to the pool				*/
+
+void listAppend(adaptiveListId_t id, int e);
+/* links the entry as the newest entry of the list							*/
+
+void listRemove(int e, int slot);
+/* unlinks the entry from its list in the given slot, if any				*/
+
+void listMoveToTail(int e, int slot);
+/* makes the entry the newest entry of its list in the given slot			*/
+
+int clockNext(int e);
+/* CLOCK-Pro: the entry following e in the clock							*/
+
+void trimArcGhosts(void);
+/* ARC, CAR: keeps |T1|+|B1| <= c and |B1|+|B2| <= c						*/
+
+void trimGhosts(adaptiveListId_t list, unsigned limit);
+/* drops the oldest ghosts of the list until at most limit remain			*/
+
+void lirsPrune(void);
+/* LIRS: removes HIR entries from the bottom of stack S						*/
+
+int clockProHandCold(void);
+/* CLOCK-Pro: runs the cold hand until a victim is found, returns its frame	*/
+
+void clockProHandHot(void);
+/* CLOCK-Pro: runs the hot hand until one hot page is turned cold			*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+void adaptiveInit(void)
+{
+	for (int i = 0; i < ADAPTIVE_ENTRIES; i++)
+	{
+		adaptiveEntry[i].list[0] = noList;
+		adaptiveEntry[i].list[1] = noList;
+		adaptiveEntry[i].hashNext = (i + 1 < ADAPTIVE_ENTRIES) ? i + 1 : NONE;
+	}
+	adaptiveFreeEntry = 0;
+	for (int i = 0; i < ADAPTIVE_BUCKETS; i++)
+		adaptiveBucket[i] = NONE;
+	for (int i = 0; i < MEMORYSIZE; i++)
+		adaptiveFrameEntry[i] = NONE;
+	for (int i = 0; i < ADAPTIVE_LISTS; i++)
+	{
+		adaptiveLists[i].head = NONE;
+		adaptiveLists[i].tail = NONE;
+		adaptiveLists[i].count = 0;
+	}
+	adaptivePending = NONE;
+	adaptivePendingList = noList;
+	adaptiveKin = (MEMORYSIZE * TWOQ_KIN_PERCENT / 100 > 0) ? MEMORYSIZE * TWOQ_KIN_PERCENT / 100 : 1;
+	adaptiveKout = (MEMORYSIZE * TWOQ_KOUT_PERCENT / 100 > 0) ? MEMORYSIZE * TWOQ_KOUT_PERCENT / 100 : 1;
+	adaptiveLirMax = MEMORYSIZE - ((MEMORYSIZE * LIRS_HIR_PERCENT / 100 > 0) ? MEMORYSIZE * LIRS_HIR_PERCENT / 100 : 1);
+	if (adaptiveLirMax == 0) adaptiveLirMax = 1;
+	adaptiveLirCount = 0;
+	adaptiveHotCount = 0;
+	adaptiveColdCount = 0;
+	adaptiveHandHot = NONE;
+	adaptiveHandCold = NONE;
+	adaptiveTarget = (replacementPolicy == clockProReplacement) ? 1 : 0;
+	memset(&adaptiveStats, 0, sizeof(adaptiveStats));
+	// all of it belongs to the algorithm in use, see checkpoint.h
+	checkpointRegister("adaptive.entries", adaptiveEntry, sizeof(adaptiveEntry), TRUE);
+	checkpointRegister("adaptive.buckets", adaptiveBucket, sizeof(adaptiveBucket), TRUE);
+	checkpointRegister("adaptive.frameEntry", adaptiveFrameEntry, sizeof(adaptiveFrameEntry), TRUE);
+	checkpointRegister("adaptive.lists", adaptiveLists, sizeof(adaptiveLists), TRUE);
+	checkpointRegister("adaptive.freeEntry", &adaptiveFreeEntry, sizeof(adaptiveFreeEntry), TRUE);
+	checkpointRegister("adaptive.pending", &adaptivePending, sizeof(adaptivePending), TRUE);
+	checkpointRegister("adaptive.pendingList", &adaptivePendingList, sizeof(adaptivePendingList), TRUE);
+	checkpointRegister("adaptive.target", &adaptiveTarget, sizeof(adaptiveTarget), TRUE);
+	checkpointRegister("adaptive.kin", &adaptiveKin, sizeof(adaptiveKin), TRUE);
+	checkpointRegister("adaptive.kout", &adaptiveKout, sizeof(adaptiveKout), TRUE);
+	checkpointRegister("adaptive.lirMax", &adaptiveLirMax, sizeof(adaptiveLirMax), TRUE);
+	checkpointRegister("adaptive.lirCount", &adaptiveLirCount, sizeof(adaptiveLirCount), TRUE);
+	checkpointRegister("adaptive.hotCount", &adaptiveHotCount, sizeof(adaptiveHotCount), TRUE);
+	checkpointRegister("adaptive.coldCount", &adaptiveColdCount, sizeof(adaptiveColdCount), TRUE);
+	checkpointRegister("adaptive.handHot", &adaptiveHandHot, sizeof(adaptiveHandHot), TRUE);
+	checkpointRegister("adaptive.handCold", &adaptiveHandCold, sizeof(adaptiveHandCold), TRUE);
+	checkpointRegister("adaptive.statistics", &adaptiveStats, sizeof(adaptiveStats), TRUE);
+}
+
+void adaptiveFault(unsigned pid, unsigned page)
+{
+	int e = ghostLookup(pid, page);
+	unsigned b1, b2, delta;
+	adaptivePending = e;
+	adaptivePendingList = noList;
+	if (e == NONE) return;			// no ghost: a cold miss
+	// the ghost becomes the entry of the page again
+	adaptivePendingList = (adaptiveEntry[e].list[1] != noList) ? adaptiveEntry[e].list[1] : adaptiveEntry[e].list[0];
+	adaptiveStats.ghostHits[(adaptivePendingList == listB2) ? 1 : 0]++;
+	unhashGhost(e);
+	b1 = adaptiveLists[listB1].count;
+	b2 = adaptiveLists[listB2].count;
+	switch (replacementPolicy)
+	{
+	case arcReplacement:
+	case carReplacement:
+		// a hit in B1 asks for a larger T1, a hit in B2 for a larger T2
+		if (adaptivePendingList == listB1)
+		{
+			delta = (b2 > b1) ? b2 / b1 : 1;
+			adaptiveTarget = (adaptiveTarget + delta < MEMORYSIZE) ? adaptiveTarget + delta : MEMORYSIZE;
+		}
+		else
+		{
+			delta = (b1 > b2) ? b1 / b2 : 1;
+			adaptiveTarget = (adaptiveTarget > delta) ? adaptiveTarget - delta : 0;
+		}
+		listRemove(e, 0);
+		break;
+	case clockProReplacement:
+		// re-accessed during the test period: more cold pages are needed
+		if (adaptiveTarget + 1 < MEMORYSIZE) adaptiveTarget++;
+		listRemove(e, 0);
+		listRemove(e, 1);
+		break;
+	default:		// 2Q: A1out, LIRS: non-resident HIR page in stack S
+		listRemove(e, 0);
+		listRemove(e, 1);
+		break;
+	}
+	if (logEnabled)
+		printf("%6u : PID %3u : MEM: Ghost hit for page %u, %u ghosts, target %u\n",
+			systemTime, processTable[pid].pid, page, adaptiveStats.ghosts, adaptiveTarget);
+}
+
+int adaptiveSelectVictim(void)
+{
+	adaptiveList_t* t1 = &adaptiveLists[listT1];
+	adaptiveList_t* t2 = &adaptiveLists[listT2];
+	int e = NONE;
+	switch (replacementPolicy)
+	{
+	case arcReplacement:
+		// REPLACE(x, p) of ARC: T1 shrinks if it exceeds its target
+		if ((t1->count > 0) && ((t1->count > adaptiveTarget) || (t2->count == 0)
+			|| ((adaptivePendingList == listB2) && (t1->count == adaptiveTarget))))
+			e = t1->head;
+		else
+			e = t2->head;
+		break;
+	case carReplacement:
+		// sweep the clock of T1 or T2, referenced pages of T1 move to T2
+		while ((t1->count > 0) || (t2->count > 0))
+		{
+			if ((t1->count > 0) && ((t1->count >= adaptiveTarget) || (t2->count == 0)))
+			{
+				e = t1->head;
+				if (!(adaptiveEntry[e].flags & ENTRY_REFERENCED)) break;
+				adaptiveEntry[e].flags &= ~ENTRY_REFERENCED;
+				listRemove(e, 0);
+				listAppend(listT2, e);
+			}
+			else
+			{
+				e = t2->head;
+				if (!(adaptiveEntry[e].flags & ENTRY_REFERENCED)) break;
+				adaptiveEntry[e].flags &= ~ENTRY_REFERENCED;
+				listMoveToTail(e, 0);
+			}
+			e = NONE;
+		}
+		break;
+	case twoQueueReplacement:
+		// pages seen only once leave first, as long as A1in exceeds Kin
+		if ((adaptiveLists[listA1in].count > adaptiveKin) || (adaptiveLists[listAm].count == 0))
+			e = adaptiveLists[listA1in].head;
+		else
+			e = adaptiveLists[listAm].head;
+		break;
+	case lirsReplacement:
+		// the oldest resident HIR page, LIR pages only if none exists
+		e = adaptiveLists[listQueue].head;
+		if (e == NONE) e = adaptiveLists[listStack].head;
+		break;
+	case clockProReplacement:
+		return clockProHandCold();
+	default:
+		break;
+	}
+	return (e == NONE) ? NONE : adaptiveEntry[e].frame;
+}
+
+void adaptiveFrameEvicted(int frame)
+{
+	int e = adaptiveFrameEntry[frame];
+	adaptiveEntry_t* entry;
+	if (e == NONE) return;
+	entry = &adaptiveEntry[e];
+	adaptiveFrameEntry[frame] = NONE;
+	switch (replacementPolicy)
+	{
+	case arcReplacement:
+	case carReplacement:
+		// T1 -> B1, T2 -> B2, trimmed when the faulting page is loaded
+		makeGhost(e, (entry->list[0] == listT1) ? listB1 : listB2);
+		break;
+	case twoQueueReplacement:
+		// only pages from A1in are remembered
+		if (entry->list[0] == listA1in)
+		{
+			makeGhost(e, listA1out);
+			trimGhosts(listA1out, adaptiveKout);
+		}
+		else
+			freeEntry(e);
+		break;
+	case lirsReplacement:
+		if (entry->flags & ENTRY_HOT)
+		{	// no resident HIR page was left
+			adaptiveLirCount--;
+			freeEntry(e);
+			lirsPrune();
+		}
+		else
+		{	// a HIR page stays in S as non-resident HIR page
+			listRemove(e, 1);
+			if (entry->list[0] == listStack)
+			{
+				makeGhost(e, listGhosts);
+				trimGhosts(listGhosts, MEMORYSIZE);
+			}
+			else
+				freeEntry(e);
+		}
+		break;
+	case clockProReplacement:
+		if (entry->flags & ENTRY_HOT)
+		{
+			adaptiveHotCount--;
+			freeEntry(e);
+		}
+		else
+		{	// a cold page in its test period stays in the clock as ghost
+			adaptiveColdCount--;
+			if (entry->flags & ENTRY_TEST)
+			{
+				makeGhost(e, listGhosts);
+				trimGhosts(listGhosts, MEMORYSIZE);
+			}
+			else
+				freeEntry(e);
+		}
+		break;
+	default:
+		freeEntry(e);
+		break;
+	}
+}
+
+void adaptiveFrameLoaded(int frame, unsigned pid, unsigned page)
+{
+	int e = adaptivePending;
+	adaptiveEntry_t* entry;
+	Boolean ghostHit = (adaptivePendingList != noList);
+	if ((e == NONE) || (adaptiveEntry[e].pid != pid) || (adaptiveEntry[e].page != page))
+	{
+		e = newEntry(pid, page);
+		ghostHit = FALSE;
+	}
+	adaptivePending = NONE;
+	adaptivePendingList = noList;
+	if (e == NONE) return;			// cannot happen, the pool covers all entries
+	entry = &adaptiveEntry[e];
+	entry->frame = frame;
+	entry->flags = 0;
+	adaptiveFrameEntry[frame] = e;
+	switch (replacementPolicy)
+	{
+	case arcReplacement:
+	case carReplacement:
+		listAppend(ghostHit ? listT2 : listT1, e);
+		trimArcGhosts();
+		break;
+	case twoQueueReplacement:
+		listAppend(ghostHit ? listAm : listA1in, e);
+		break;
+	case lirsReplacement:
+		if ((adaptiveLirCount < adaptiveLirMax) || ghostHit)
+		{	// a LIR page, recently used with a short reuse distance
+			entry->flags = ENTRY_HOT;
+			adaptiveLirCount++;
+			listAppend(listStack, e);
+			if (adaptiveLirCount > adaptiveLirMax)
+			{	// the LIR page at the bottom of S becomes a resident HIR page
+				int bottom = adaptiveLists[listStack].head;
+				adaptiveEntry[bottom].flags &= ~ENTRY_HOT;
+				adaptiveLirCount--;
+				listRemove(bottom, 0);
+				listAppend(listQueue, bottom);
+				lirsPrune();
+			}
+		}
+		else
+		{	// a resident HIR page
+			listAppend(listStack, e);
+			listAppend(listQueue, e);
+		}
+		break;
+	case clockProReplacement:
+		if (ghostHit)
+		{	// accessed in the test period: the page is hot
+			entry->flags = ENTRY_HOT;
+			adaptiveHotCount++;
+			listAppend(listClock, e);
+			while ((adaptiveHotCount > 0) && (adaptiveHotCount > MEMORYSIZE - adaptiveTarget))
+				clockProHandHot();
+		}
+		else
+		{	// a new cold page starts its test period
+			entry->flags = ENTRY_TEST;
+			adaptiveColdCount++;
+			listAppend(listClock, e);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void adaptiveFrameAccessed(int frame)
+{
+	int e = adaptiveFrameEntry[frame];
+	adaptiveEntry_t* entry;
+	if (e == NONE) return;
+	entry = &adaptiveEntry[e];
+	switch (replacementPolicy)
+	{
+	case arcReplacement:
+		// a second access moves the page to T2
+		if (entry->list[0] == listT1)
+		{
+			listRemove(e, 0);
+			listAppend(listT2, e);
+		}
+		else
+			listMoveToTail(e, 0);
+		break;
+	case carReplacement:
+	case clockProReplacement:
+		entry->flags |= ENTRY_REFERENCED;
+		break;
+	case twoQueueReplacement:
+		if (entry->list[0] == listAm) listMoveToTail(e, 0);
+		break;
+	case lirsReplacement:
+		if (entry->flags & ENTRY_HOT)
+		{	// LIR page: move to the top of S
+			Boolean wasBottom = (adaptiveLists[listStack].head == e);
+			listMoveToTail(e, 0);
+			if (wasBottom) lirsPrune();
+		}
+		else if (entry->list[0] == listStack)
+		{	// HIR page with a reuse distance shorter than the oldest LIR page
+			entry->flags |= ENTRY_HOT;
+			adaptiveLirCount++;
+			listRemove(e, 1);
+			listMoveToTail(e, 0);
+			if (adaptiveLirCount > adaptiveLirMax)
+			{	// the LIR page at the bottom of S becomes a resident HIR page
+				int bottom = adaptiveLists[listStack].head;
+				adaptiveEntry[bottom].flags &= ~ENTRY_HOT;
+				adaptiveLirCount--;
+				listRemove(bottom, 0);
+				listAppend(listQueue, bottom);
+			}
+			lirsPrune();
+		}
+		else
+		{	// HIR page not in S: stays HIR
+			listAppend(listStack, e);
+			listMoveToTail(e, 1);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void adaptiveFrameFreed(int frame)
+{
+	int e = adaptiveFrameEntry[frame];
+	if (e == NONE) return;
+	adaptiveFrameEntry[frame] = NONE;
+	if (adaptiveEntry[e].flags & ENTRY_HOT)
+	{
+		if (replacementPolicy == lirsReplacement) adaptiveLirCount--;
+		else adaptiveHotCount--;
+	}
+	else if (replacementPolicy == clockProReplacement)
+		adaptiveColdCount--;
+	freeEntry(e);
+	if (replacementPolicy == lirsReplacement) lirsPrune();
+}
+
+void adaptiveFramesExchanged(int a, int b)
+{
+	int e = adaptiveFrameEntry[a];
+	adaptiveFrameEntry[a] = adaptiveFrameEntry[b];
+	adaptiveFrameEntry[b] = e;
+	if (adaptiveFrameEntry[a] != NONE) adaptiveEntry[adaptiveFrameEntry[a]].frame = a;
+	if (adaptiveFrameEntry[b] != NONE) adaptiveEntry[adaptiveFrameEntry[b]].frame = b;
+}
+
+void adaptiveFrameRemapped(int frame, unsigned pid, unsigned page)
+{
+	int e = adaptiveFrameEntry[frame];
+	if (e == NONE) return;
+	adaptiveEntry[e].pid = pid;
+	adaptiveEntry[e].page = page;
+}
+
+void adaptiveForgetPage(unsigned pid, unsigned page)
+{
+	int e = ghostLookup(pid, page);
+	if (e == NONE) return;
+	unhashGhost(e);
+	freeEntry(e);
+}
+
+void adaptiveGetStatistics(adaptiveStatistics_t* stats)
+{
+	*stats = adaptiveStats;
+	switch (replacementPolicy)
+	{
+	case twoQueueReplacement: stats->target = adaptiveKin; break;
+	case lirsReplacement: stats->target = adaptiveLirMax; break;
+	default: stats->target = adaptiveTarget; break;
+	}
+}
+
+void adaptiveLogStatistics(void)
+{
+	adaptiveStatistics_t stats;
+	if (!logEnabled) return;
+	adaptiveGetStatistics(&stats);
+	printf("%6u : MEM: %s ghost hits %llu/%llu, %u ghosts, target %u\n", systemTime,
+		getReplacementPolicyName(replacementPolicy), stats.ghostHits[0], stats.ghostHits[1],
+		stats.ghosts, stats.target);
+}
+
+void adaptivePrintStatistics(unsigned long long faults)
+{
+	adaptiveStatistics_t stats;
+	const char* ghostName[ADAPTIVE_GHOST_LISTS] = { "ghost hits", NULL };
+	const char* targetName = "target";
+	adaptiveGetStatistics(&stats);
+	switch (replacementPolicy)
+	{
+	case arcReplacement:
+	case carReplacement:
+		ghostName[0] = "ghost hits in B1";
+		ghostName[1] = "ghost hits in B2";
+		targetName = "target size of T1 (p)";
+		break;
+	case twoQueueReplacement:
+		ghostName[0] = "ghost hits in A1out";
+		targetName = "size of A1in (Kin)";
+		break;
+	case lirsReplacement:
+		ghostName[0] = "non-resident HIR hits";
+		targetName = "size of the LIR set";
+		break;
+	case clockProReplacement:
+		ghostName[0] = "test period hits";
+		targetName = "target of cold pages (mc)";
+		break;
+	default:
+		break;
+	}
+	for (int i = 0; i < ADAPTIVE_GHOST_LISTS; i++)
+		if (ghostName[i] != NULL)
+			printf("%-28s %15llu (%.1f%% of the faults)\n", ghostName[i], stats.ghostHits[i],
+				(faults > 0) ? 100.0 * stats.ghostHits[i] / faults : 0.0);
+	printf("%-28s %15llu\n", "ghosts dropped", stats.ghostsDropped);
+	printf("%-28s %15u\n", "ghosts at the end", stats.ghosts);
+	printf("%-28s %15u\n", targetName, stats.target);
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+unsigned ghostHash(unsigned pid, unsigned page)
+{
+	unsigned long long key = ((unsigned long long)pid << 32) | page;
+	key *= 0x9E3779B97F4A7C15ull;		// Fibonacci hashing, the upper bits are well mixed
+	return (unsigned)(((key >> 32) * ADAPTIVE_BUCKETS) >> 32);
+}
+
+int ghostLookup(unsigned pid, unsigned page)
+{
+	int e = adaptiveBucket[ghostHash(pid, page)];
+	while ((e != NONE) && ((adaptiveEntry[e].pid != pid) || (adaptiveEntry[e].page != page)))
+		e = adaptiveEntry[e].hashNext;
+	return e;
+}
+
+void makeGhost(int e, adaptiveListId_t list)
+{
+	adaptiveEntry_t* entry = &adaptiveEntry[e];
+	unsigned bucket = ghostHash(entry->pid, entry->page);
+	entry->frame = NONE;
+	entry->hashNext = adaptiveBucket[bucket];
+	adaptiveBucket[bucket] = e;
+	adaptiveStats.ghosts++;
+	if (entry->list[adaptiveListSlot[list]] != noList) listRemove(e, adaptiveListSlot[list]);
+	listAppend(list, e);
+}
+
+void unhashGhost(int e)
+{
+	int* link = &adaptiveBucket[ghostHash(adaptiveEntry[e].pid, adaptiveEntry[e].page)];
+	while ((*link != NONE) && (*link != e))
+		link = &adaptiveEntry[*link].hashNext;
+	if (*link == e) *link = adaptiveEntry[e].hashNext;
+	adaptiveEntry[e].hashNext = NONE;
+	adaptiveStats.ghosts--;
+}
+
+void dropGhost(int e)
+{
+	Boolean bottom = (adaptiveLists[listStack].head == e);
+	unhashGhost(e);
+	freeEntry(e);
+	adaptiveStats.ghostsDropped++;
+	if (replacementPolicy == clockProReplacement)
+	{	// the test period ended without an access: fewer cold pages are needed
+		if (adaptiveTarget > 1) adaptiveTarget--;
+	}
+	if (bottom) lirsPrune();
+}
+
+int newEntry(unsigned pid, unsigned page)
+{
+	int e = adaptiveFreeEntry;
+	if (e == NONE) return NONE;
+	adaptiveFreeEntry = adaptiveEntry[e].hashNext;
+	adaptiveEntry[e].pid = pid;
+	adaptiveEntry[e].page = page;
+	adaptiveEntry[e].frame = NONE;
+	adaptiveEntry[e].hashNext = NONE;
+	adaptiveEntry[e].flags = 0;
+	return e;
+}
+
+void freeEntry(int e)
+{
+	listRemove(e, 0);
+	listRemove(e, 1);
+	adaptiveEntry[e].hashNext = adaptiveFreeEntry;
+	adaptiveFreeEntry = e;
+}
+
+void listAppend(adaptiveListId_t id, int e)
+{
+	int slot = adaptiveListSlot[id];
+	adaptiveList_t* list = &adaptiveLists[id];
+	adaptiveEntry_t* entry = &adaptiveEntry[e];
+	entry->list[slot] = (unsigned char)id;
+	entry->prev[slot] = list->tail;
+	entry->next[slot] = NONE;
+	if (list->tail == NONE) list->head = e;
+	else adaptiveEntry[list->tail].next[slot] = e;
+	list->tail = e;
+	list->count++;
+	if ((id == listClock) && (adaptiveHandHot == NONE))
+	{	// first page in the clock
+		adaptiveHandHot = e;
+		adaptiveHandCold = e;
+	}
+}
+
+void listRemove(int e, int slot)
+{
+	adaptiveEntry_t* entry = &adaptiveEntry[e];
+	adaptiveList_t* list;
+	if (entry->list[slot] == noList) return;
+	list = &adaptiveLists[entry->list[slot]];
+	if (entry->list[slot] == listClock)
+	{	// hands pointing to the entry move on
+		if (adaptiveHandHot == e) adaptiveHandHot = clockNext(e);
+		if (adaptiveHandCold == e) adaptiveHandCold = clockNext(e);
+	}
+	if (entry->prev[slot] == NONE) list->head = entry->next[slot];
+	else adaptiveEntry[entry->prev[slot]].next[slot] = entry->next[slot];
+	if (entry->next[slot] == NONE) list->tail = entry->prev[slot];
+	else adaptiveEntry[entry->next[slot]].prev[slot] = entry->prev[slot];
+	list->count--;
+	if ((entry->list[slot] == listClock) && (list->count == 0))
+	{
+		adaptiveHandHot = NONE;
+		adaptiveHandCold = NONE;
+	}
+	entry->list[slot] = noList;
+}
+
+void listMoveToTail(int e, int slot)
+{
+	adaptiveListId_t id = (adaptiveListId_t)adaptiveEntry[e].list[slot];
+	if ((id == noList) || (adaptiveLists[id].tail == e)) return;
+	listRemove(e, slot);
+	listAppend(id, e);
+}
+
+int clockNext(int e)
+{
+	int next = adaptiveEntry[e].next[0];
+	return (next != NONE) ? next : adaptiveLists[listClock].head;
+}
+
+void trimArcGhosts(void)
+{
+	while ((adaptiveLists[listB1].count > 0)
+		&& (adaptiveLists[listT1].count + adaptiveLists[listB1].count > MEMORYSIZE))
+		dropGhost(adaptiveLists[listB1].head);
+	while (adaptiveLists[listB1].count + adaptiveLists[listB2].count > MEMORYSIZE)
+		dropGhost((adaptiveLists[listB2].count > 0) ? adaptiveLists[listB2].head : adaptiveLists[listB1].head);
+}
+
+void trimGhosts(adaptiveListId_t list, unsigned limit)
+{
+	while (adaptiveLists[list].count > limit)
+		dropGhost(adaptiveLists[list].head);
+}
+
+void lirsPrune(void)
+{
+	int e = adaptiveLists[listStack].head;
+	while ((e != NONE) && !(adaptiveEntry[e].flags & ENTRY_HOT))
+	{
+		listRemove(e, 0);
+		if (adaptiveEntry[e].frame == NONE)
+		{	// a non-resident HIR page leaving S is forgotten
+			unhashGhost(e);
+			freeEntry(e);
+			adaptiveStats.ghostsDropped++;
+		}
+		e = adaptiveLists[listStack].head;
+	}
+}
+
+int clockProHandCold(void)
+{
+	int e;
+	adaptiveEntry_t* entry;
+	for (;;)
+	{
+		if (adaptiveColdCount == 0)
+		{	// only hot pages are resident
+			if (adaptiveHotCount == 0) return NONE;
+			clockProHandHot();
+			continue;
+		}
+		e = adaptiveHandCold;
+		entry = &adaptiveEntry[e];
+		adaptiveHandCold = clockNext(e);
+		if ((entry->frame == NONE) || (entry->flags & ENTRY_HOT)) continue;
+		if (!(entry->flags & ENTRY_REFERENCED)) return entry->frame;	// the victim
+		entry->flags &= ~ENTRY_REFERENCED;
+		if (entry->flags & ENTRY_TEST)
+		{	// re-accessed in its test period: the page becomes hot
+			entry->flags = ENTRY_HOT;
+			adaptiveColdCount--;
+			adaptiveHotCount++;
+			listMoveToTail(e, 0);
+			while ((adaptiveHotCount > 0) && (adaptiveHotCount > MEMORYSIZE - adaptiveTarget))
+				clockProHandHot();
+		}
+		else
+		{	// a new test period starts
+			entry->flags |= ENTRY_TEST;
+			listMoveToTail(e, 0);
+		}
+	}
+}
+
+void clockProHandHot(void)
+{
+	int e;
+	adaptiveEntry_t* entry;
+	while (adaptiveHotCount > 0)
+	{
+		e = adaptiveHandHot;
+		entry = &adaptiveEntry[e];
+		adaptiveHandHot = clockNext(e);
+		if (entry->flags & ENTRY_HOT)
+		{
+			if (entry->flags & ENTRY_REFERENCED)
+				entry->flags &= ~ENTRY_REFERENCED;
+			else
+			{	// not used since the last pass: the page turns cold
+				entry->flags &= ~ENTRY_HOT;
+				adaptiveHotCount--;
+				adaptiveColdCount++;
+				return;
+			}
+		}
+		else if (entry->flags & ENTRY_TEST)
+		{	// the hot hand ends the test period of cold pages
+			if (entry->frame == NONE)
+				dropGhost(e);
+			else
+			{
+				entry->flags &= ~ENTRY_TEST;
+				if (adaptiveTarget > 1) adaptiveTarget--;
+			}
+		}
+	}
+}
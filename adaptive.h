@@ -0,0 +1,96 @@
+/* Include-file defining the interface of the scan resistant page			*/
+/* replacement algorithms ARC, CAR, 2Q, LIRS and CLOCK-Pro					*/
+/* All of them remember recently evicted pages in ghost lists: entries		*/
+/* holding only pid and page of a page no longer in memory. A fault on a	*/
+/* ghost shows that the page was evicted too early; the algorithms use		*/
+/* this to keep pages used repeatedly in memory while a long sequential		*/
+/* scan passes through the rest of the frames.								*/
+/* The ghosts are found via a hash table over (pid, page) and their number	*/
+/* is bounded by the number of frames, so the bookkeeping per access and	*/
+/* per fault is O(1), apart from the sweeps of the clock hands of CAR and	*/
+/* CLOCK-Pro.																*/
+/*																			*/
+/* ARC       : Megiddo/Modha, resident LRU lists T1, T2, ghost lists B1, B2	*/
+/* CAR       : Bansal/Modha, as ARC with clocks instead of T1 and T2		*/
+/* 2Q        : Johnson/Shasha, FIFO A1in, LRU Am, ghost list A1out			*/
+/* LIRS      : Jiang/Zhang, LIR stack S, queue Q of resident HIR pages		*/
+/* CLOCK-Pro : Jiang/Chen/Zhang, one clock of hot, cold and non-resident	*/
+/*             cold pages in their test period								*/
+#ifndef __ADAPTIVE__
+#define __ADAPTIVE__
+
+#include "bs_types.h"
+
+// 2Q: sizes of A1in and A1out in percent of the frames, at least one frame
+#ifndef TWOQ_KIN_PERCENT
+#define TWOQ_KIN_PERCENT 25
+#endif
+#ifndef TWOQ_KOUT_PERCENT
+#define TWOQ_KOUT_PERCENT 50
+#endif
+// LIRS: frames reserved for resident HIR pages in percent, at least one frame
+#ifndef LIRS_HIR_PERCENT
+#define LIRS_HIR_PERCENT 1
+#endif
+
+/* predicate: the replacement algorithm is implemented by this module		*/
+#define IS_ADAPTIVE_POLICY(policy) ((policy) >= arcReplacement)
+
+/* number of ghost lists distinguished in the statistics (B1 and B2 of ARC)	*/
+#define ADAPTIVE_GHOST_LISTS 2
+
+/* statistics of the ghost lists, for reports and the timer log				*/
+typedef struct adaptiveStatistics_struct
+{
+	unsigned long long ghostHits[ADAPTIVE_GHOST_LISTS];	// faults on a ghost, per ghost list
+	unsigned long long ghostsDropped;	// ghosts discarded to keep the lists bounded
+	unsigned ghosts;					// current number of ghosts
+	unsigned target;					// ARC/CAR: target size of T1 (p), CLOCK-Pro: target
+										// number of cold pages (mc), 2Q: Kin, LIRS: LIR set size
+} adaptiveStatistics_t;
+
+void adaptiveInit(void);
+/* clears all lists, the ghosts and the statistics, must be called before	*/
+/* the first frame is used and after replacementPolicy has been selected	*/
+
+void adaptiveFault(unsigned pid, unsigned page);
+/* called first on a page fault: looks the page up in the ghost lists and	*/
+/* adapts the parameters of the algorithm on a ghost hit					*/
+
+int adaptiveSelectVictim(void);
+/* returns the frame to be cleared for the page of the last fault			*/
+/* Returns NONE if no frame is in use										*/
+
+void adaptiveFrameEvicted(int frame);
+/* the page in the frame is moved out by the replacement, it is kept as		*/
+/* a ghost if the algorithm asks for it										*/
+
+void adaptiveFrameLoaded(int frame, unsigned pid, unsigned page);
+/* the page of the last fault was moved into the frame						*/
+
+void adaptiveFrameAccessed(int frame);
+/* the page in the frame was accessed without a page fault					*/
+
+void adaptiveFrameFreed(int frame);
+/* the frame became empty without replacement, e.g. the process ended		*/
+
+void adaptiveFramesExchanged(int a, int b);
+/* the pages in the frames a and b changed places, also if one is empty		*/
+
+void adaptiveFrameRemapped(int frame, unsigned pid, unsigned page);
+/* the page in the frame is known by another process sharing it now, the	*/
+/* ghost of the page is kept under this process								*/
+
+void adaptiveForgetPage(unsigned pid, unsigned page);
+/* removes the ghost of the page, if any, e.g. when the process ends		*/
+
+void adaptiveGetStatistics(adaptiveStatistics_t* stats);
+/* returns the current statistics											*/
+
+void adaptiveLogStatistics(void);
+/* writes one log line with the ghost hits and the adaptive target			*/
+
+void adaptivePrintStatistics(unsigned long long faults);
+/* prints the statistics, ghost hits relative to the given number of faults	*/
+
+#endif  /* __ADAPTIVE__ */
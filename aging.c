@@ -0,0 +1,159 @@
+/* Implementation of the aging page replacement								*/
+/* for comments on the global functions see the associated .h-file			*/
+/* The loops over all frames are kept free of branches and function calls,	*/
+/* so that they are vectorised by the compiler (SSE2/AVX2 resp. NEON with	*/
+/* gcc/clang -O2 and MSVC /O2), MEMORYSIZE is known at compile time.		*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include "bs_types.h"
+#include "global.h"
+#include "aging.h"
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+agingCounter_t agingCounter[MEMORYSIZE];	// the aging counter of each frame
+agingCounter_t agingEmptyMask[MEMORYSIZE];	// AGING_EMPTY for empty frames, 0 otherwise
+int agingHand = 0;							// start of the search for ties
+
+/* ---------------------------------------------------------------- */
+/*                Externally available functions					*/
+/* ---------------------------------------------------------------- */
+
+void agingInit(void)
+{
+	for (int i = 0; i < MEMORYSIZE; i++)
+	{
+		agingCounter[i] = AGING_EMPTY;
+		agingEmptyMask[i] = AGING_EMPTY;
+	}
+	agingHand = 0;
+	checkpointRegister("aging.counter", agingCounter, sizeof(agingCounter), TRUE);
+	checkpointRegister("aging.emptyMask", agingEmptyMask, sizeof(agingEmptyMask), TRUE);
+	checkpointRegister("aging.hand", &agingHand, sizeof(agingHand), TRUE);
+}
+
+void agingFrameLoaded(int frame)
+{
+	agingCounter[frame] = 0;
+	agingEmptyMask[frame] = 0;
+}
+
+void agingFrameFreed(int frame)
+{
+	agingCounter[frame] = AGING_EMPTY;
+	agingEmptyMask[frame] = AGING_EMPTY;
+}
+
+void agingFramesExchanged(int a, int b)
+{
+	agingCounter_t counter = agingCounter[a];
+	agingCounter_t empty = agingEmptyMask[a];
+	agingCounter[a] = agingCounter[b];
+	agingEmptyMask[a] = agingEmptyMask[b];
+	agingCounter[b] = counter;
+	agingEmptyMask[b] = empty;
+}
+
+/* the timer update of agingTick() and agingTickLocal(), inlined so that	*/
+/* the number of frames is constant for the whole memory					*/
+static inline void tickCounters(agingCounter_t* restrict counter, const agingCounter_t* restrict empty,
+	const unsigned char* restrict referenced, int count, unsigned ticks)
+{
+	unsigned shift = ticks - 1;		// idle periods after the first tick
+	if (ticks == 0) return;
+	// first tick: shift right, R-bit becomes the top bit, empty frames stay at AGING_EMPTY
+	for (int i = 0; i < count; i++)
+		counter[i] = (agingCounter_t)((counter[i] >> 1)
+			| ((agingCounter_t)referenced[i] << (AGING_COUNTER_BITS - 1)) | empty[i]);
+	// remaining idle ticks: no R-bit can be set, so shift by all of them at once
+	if (shift >= AGING_COUNTER_BITS)
+		for (int i = 0; i < count; i++)
+			counter[i] = empty[i];
+	else if (shift > 0)
+		for (int i = 0; i < count; i++)
+			counter[i] = (agingCounter_t)((counter[i] >> shift) | empty[i]);
+}
+
+void agingTick(const unsigned char* restrict referenced, unsigned ticks)
+{
+	tickCounters(agingCounter, agingEmptyMask, referenced, MEMORYSIZE, ticks);
+}
+
+void agingTickLocal(agingCounter_t* restrict counter, const agingCounter_t* restrict empty,
+	const unsigned char* restrict referenced, int count, unsigned ticks)
+{
+	tickCounters(counter, empty, referenced, count, ticks);
+}
+
+/* the value the counter of frame i would have after the next tick */
+#define AGING_KEY(i) ((agingCounter_t)((counter[i] >> 1) \
+	| ((agingCounter_t)referenced[i] << (AGING_COUNTER_BITS - 1)) | empty[i]))
+
+/* the victim search of agingSelectVictim() and agingSelectVictimRange(),	*/
+/* inlined so that the bounds are constant for the whole memory, since the	*/
+/* compiler needs them to vectorise the reduction over 8 bit counters		*/
+static inline int selectVictimRange(const agingCounter_t* restrict counter, const agingCounter_t* restrict empty,
+	const unsigned char* restrict referenced, int first, int last, int* hand)
+{
+	agingCounter_t minimum = AGING_EMPTY, key;
+	int frame;
+	if ((*hand < first) || (*hand >= last)) *hand = first;
+	// min-reduction over all keys, empty frames never lower the minimum
+	for (int i = first; i < last; i++)
+	{
+		key = AGING_KEY(i);
+		minimum = (key < minimum) ? key : minimum;
+	}
+	// find the next occupied frame with this value, starting at the hand
+	for (int i = first; i < last; i++)
+	{
+		frame = *hand + i - first;
+		if (frame >= last) frame -= last - first;
+		if ((AGING_KEY(frame) == minimum) && (empty[frame] == 0))
+		{
+			*hand = (frame + 1 < last) ? frame + 1 : first;
+			return frame;
+		}
+	}
+	return NONE;		// all frames are empty
+}
+
+int agingSelectVictim(const unsigned char* restrict referenced)
+{
+	return selectVictimRange(agingCounter, agingEmptyMask, referenced, 0, MEMORYSIZE, &agingHand);
+}
+
+int agingSelectVictimRange(const unsigned char* restrict referenced, int first, int last, int* hand)
+{
+	return selectVictimRange(agingCounter, agingEmptyMask, referenced, first, last, hand);
+}
+
+int agingSelectVictimLocal(const agingCounter_t* restrict counter, const agingCounter_t* restrict empty,
+	const unsigned char* restrict referenced, const unsigned page[], int count)
+{
+	agingCounter_t minimum = AGING_EMPTY, key;
+	int victim = NONE;
+	for (int i = 0; i < count; i++)
+	{
+		key = AGING_KEY(i);
+		minimum = (key < minimum) ? key : minimum;
+	}
+	// the lowest page with this value, which does not depend on the frames
+	for (int i = 0; i < count; i++)
+		if ((AGING_KEY(i) == minimum) && (empty[i] == 0) && ((victim == NONE) || (page[i] < page[victim])))
+			victim = i;
+	return victim;
+}
+
+agingCounter_t agingGetKey(const unsigned char* restrict referenced, int frame)
+{
+	const agingCounter_t* const counter = agingCounter;
+	const agingCounter_t* const empty = agingEmptyMask;
+	return AGING_KEY(frame);
+}
+
+agingCounter_t agingGetCounter(int frame)
+{
+	return agingCounter[frame];
+}
@@ -0,0 +1,80 @@
+/* Include-file defining the interface of the aging page replacement		*/
+/* Each frame of the physical memory has an aging counter. The counters		*/
+/* (and the R-bits of the frames kept by the memory manager) are stored		*/
+/* contiguously, so the timer update and the search for the victim are		*/
+/* simple loops over arrays, written to be vectorised by the compiler.		*/
+#ifndef __AGING__
+#define __AGING__
+
+#include <stdint.h>
+#include "bs_types.h"
+
+// Width of the aging counters in bits: 8, 16 or 32, may be set at compile time
+#ifndef AGING_COUNTER_BITS
+#define AGING_COUNTER_BITS 8
+#endif
+
+#if AGING_COUNTER_BITS == 8
+typedef uint8_t agingCounter_t;
+#elif AGING_COUNTER_BITS == 16
+typedef uint16_t agingCounter_t;
+#elif AGING_COUNTER_BITS == 32
+typedef uint32_t agingCounter_t;
+#else
+#error "AGING_COUNTER_BITS must be 8, 16 or 32"
+#endif
+
+#define AGING_TOP_BIT ((agingCounter_t)1 << (AGING_COUNTER_BITS - 1))
+#define AGING_EMPTY ((agingCounter_t)~(agingCounter_t)0)	// counter of an empty frame
+
+void agingInit(void);
+/* resets the counters of all frames to "empty"								*/
+
+void agingFrameLoaded(int frame);
+/* a page was moved into the frame: its counter starts at zero				*/
+
+void agingFrameFreed(int frame);
+/* the frame became empty: it must never be chosen as victim				*/
+
+void agingTick(const unsigned char referenced[], unsigned ticks);
+/* timer update for <ticks> consecutive timer events without memory		*/
+/* accesses in between: all counters are shifted right by one, the R-bit	*/
+/* of the frame (referenced[frame] != 0) is or-ed in as the top bit, then	*/
+/* the counters are shifted by the remaining ticks-1 idle periods at once	*/
+
+void agingFramesExchanged(int a, int b);
+/* the pages in the frames a and b changed places, also if one is empty		*/
+
+int agingSelectVictim(const unsigned char referenced[]);
+/* returns the occupied frame least used recently. The frames are compared	*/
+/* by the value their counter would have after the next timer event, i.e.	*/
+/* the R-bits of the current period (referenced[frame] != 0) count most.	*/
+/* This keeps pages just moved in from being evicted first.					*/
+/* Ties are resolved round robin. Returns NONE if all frames are empty		*/
+
+int agingSelectVictimRange(const unsigned char referenced[], int first, int last, int* hand);
+/* as agingSelectVictim(), but only the frames first..last-1 are searched	*/
+/* and ties are resolved from the given hand, which is updated. Used by		*/
+/* the shards of the memory manager with several CPUs						*/
+
+void agingTickLocal(agingCounter_t counter[], const agingCounter_t empty[],
+	const unsigned char referenced[], int count, unsigned ticks);
+/* agingTick() for count frames whose counters, masks of the empty frames	*/
+/* (AGING_EMPTY or 0) and R-bits are kept by the caller, e.g. the frames	*/
+/* of a process under a local quota (see localsim.h)						*/
+
+int agingSelectVictimLocal(const agingCounter_t counter[], const agingCounter_t empty[],
+	const unsigned char referenced[], const unsigned page[], int count);
+/* agingSelectVictim() for the frames kept by the caller as for				*/
+/* agingTickLocal(), page[] holds the page in each frame. Ties are			*/
+/* resolved by the lowest page, not round robin, so that the same page is	*/
+/* chosen whichever frames the process holds (see localSelectVictim())		*/
+
+agingCounter_t agingGetKey(const unsigned char referenced[], int frame);
+/* returns the value the counter of the frame would have after the next		*/
+/* timer event, which agingSelectVictim() compares, AGING_EMPTY if empty	*/
+
+agingCounter_t agingGetCounter(int frame);
+/* returns the current counter of the frame (for statistics and checks)	*/
+
+#endif  /* __AGING__ */
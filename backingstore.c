@@ -0,0 +1,315 @@
+/* Implementation of the backing store with real page contents				*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <stdio.h>
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "backingstore.h"
+#include "swapfile.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in backingstore.h*/
+char backingStoreFileName[FILENAME_LENGTH] = BACKINGSTORE_FILENAME;
+Boolean backingStoreDirect = FALSE;
+Boolean backingStoreEnabled = FALSE;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+
+#define PAGE_WORDS (BACKINGSTORE_PAGE_SIZE / sizeof(unsigned long long))
+#define HEADER_WORDS 3			// pid, page and number of writes at the start of a page
+
+unsigned char* backingStoreArena = NULL;		// contents of all frames
+int swapFile = -1;								// file descriptor, -1: not open
+unsigned long long* slotChecksum = NULL;		// checksum of the copy in each slot
+unsigned slotCount = 0;							// slots in use or free, size of the file
+unsigned slotCapacity = 0;						// size of slotChecksum and freeSlots
+unsigned* freeSlots = NULL;						// stack of released slots
+unsigned freeSlotCount = 0;
+unsigned char* batchBuffer = NULL;				// copies of the pages moved out
+int batchSlot[BACKINGSTORE_BATCH];				// slot of each page in the batch
+unsigned batchCount = 0;
+backingStoreStatistics_t backingStoreStats;
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+unsigned long long pageChecksum(const unsigned long long* words);
+/* returns the FNV-1a hash of the 64 bit words of the page					*/
+
+int allocateSlot(void);
+/* returns a free slot of the swap file, NONE if out of memory				*/
+
+Boolean flushBatch(void);
+/* writes all pages of the batch, one pwritev() per run of consecutive		*/
+/* slots. Returns FALSE on an I/O error										*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+Boolean backingStoreOpen(const char* filename, unsigned frames)
+{
+	int direct = backingStoreDirect;
+	memset(&backingStoreStats, 0, sizeof(backingStoreStats));
+	backingStoreEnabled = FALSE;
+	if ((filename == NULL) || (filename[0] == '\0')) return TRUE;
+	backingStoreArena = swapFileAllocate((size_t)frames * BACKINGSTORE_PAGE_SIZE, BACKINGSTORE_PAGE_SIZE);
+	batchBuffer = swapFileAllocate(BACKINGSTORE_BATCH * BACKINGSTORE_PAGE_SIZE, BACKINGSTORE_PAGE_SIZE);
+	if ((backingStoreArena == NULL) || (batchBuffer == NULL))
+	{
+		backingStoreClose();
+		return FALSE;
+	}
+	swapFile = swapFileOpen(filename, &direct);
+	if (backingStoreDirect && !direct)
+	{
+		logGeneric("Direct I/O not supported for the swap file, using the page cache");
+		backingStoreDirect = FALSE;
+	}
+	if (swapFile < 0)
+	{
+		backingStoreClose();
+		return FALSE;
+	}
+	slotCount = freeSlotCount = batchCount = 0;
+	backingStoreEnabled = TRUE;
+	return TRUE;
+}
+
+Boolean backingStoreClose(void)
+{
+	Boolean ok = (backingStoreStats.checksumErrors == 0) && (backingStoreStats.ioErrors == 0);
+	if (swapFile >= 0)
+	{
+		ok = flushBatch() && ok;
+		swapFileClose(swapFile, backingStoreFileName);	// the swap file holds no data worth keeping
+		swapFile = -1;
+	}
+	swapFileFree(backingStoreArena);
+	swapFileFree(batchBuffer);
+	free(slotChecksum);
+	free(freeSlots);
+	backingStoreArena = batchBuffer = NULL;
+	slotChecksum = NULL;
+	freeSlots = NULL;
+	slotCount = slotCapacity = freeSlotCount = batchCount = 0;
+	backingStoreEnabled = FALSE;
+	return ok;
+}
+
+Boolean backingStorePageIn(unsigned pid, unsigned page, int frame, int swapLocation)
+{
+	unsigned long long* words = backingStoreFrame(frame);
+	Boolean ok = TRUE;
+	double t0, seconds;
+	unsigned i;
+	if (swapLocation == NONE)
+	{	// first use of the page
+		backingStoreFillPage(words, pid, page);
+		backingStoreStats.pagesFilled++;
+		return TRUE;
+	}
+	t0 = smpWallClock();
+	// the latest copy may still wait in the batch
+	for (i = 0; (i < batchCount) && (batchSlot[i] != swapLocation); i++);
+	if (i < batchCount)
+	{
+		memcpy(words, batchBuffer + (size_t)i * BACKINGSTORE_PAGE_SIZE, BACKINGSTORE_PAGE_SIZE);
+		backingStoreStats.batchHits++;
+	}
+	else if (swapFileRead(swapFile, words, BACKINGSTORE_PAGE_SIZE, (unsigned long long)swapLocation * BACKINGSTORE_PAGE_SIZE))
+		backingStoreStats.pagesRead++;
+	else
+	{
+		backingStoreStats.ioErrors++;
+		ok = FALSE;
+	}
+	if (ok && ((pageChecksum(words) != slotChecksum[swapLocation]) || (words[0] != pid) || (words[1] != page)))
+	{
+		backingStoreStats.checksumErrors++;
+		ok = FALSE;
+	}
+	seconds = smpWallClock() - t0;
+	backingStoreStats.readSeconds += seconds;
+	if (seconds > backingStoreStats.maxReadSeconds) backingStoreStats.maxReadSeconds = seconds;
+	return ok;
+}
+
+Boolean backingStorePageOut(int frame, Boolean modified, int* swapLocation)
+{
+	if (!modified)
+	{	// the copy in the swap file is still valid, or there is none and the
+		// page is filled again when it is moved in
+		backingStoreStats.cleanEvictions++;
+		return TRUE;
+	}
+	return backingStoreWritePage(backingStoreFrame(frame), swapLocation);
+}
+
+Boolean backingStoreWritePage(const unsigned long long* words, int* swapLocation)
+{
+	unsigned i;
+	if ((*swapLocation == NONE) && ((*swapLocation = allocateSlot()) == NONE))
+		return FALSE;
+	// a page moved out again before the batch was written replaces its copy
+	for (i = 0; (i < batchCount) && (batchSlot[i] != *swapLocation); i++);
+	if (i == batchCount) batchSlot[batchCount++] = *swapLocation;
+	memcpy(batchBuffer + (size_t)i * BACKINGSTORE_PAGE_SIZE, words, BACKINGSTORE_PAGE_SIZE);
+	slotChecksum[*swapLocation] = pageChecksum(words);
+	if (batchCount == BACKINGSTORE_BATCH) return flushBatch();
+	return TRUE;
+}
+
+void backingStoreWrite(int frame)
+{
+	unsigned long long* words = backingStoreFrame(frame);
+	words[2]++;
+	words[HEADER_WORDS + words[2] % (PAGE_WORDS - HEADER_WORDS)] ^= words[2];
+}
+
+void backingStoreFreeSlot(int swapLocation)
+{
+	unsigned i;
+	if ((swapLocation == NONE) || !backingStoreEnabled) return;
+	// a pending copy of the slot is not needed any more
+	for (i = 0; (i < batchCount) && (batchSlot[i] != swapLocation); i++);
+	if (i < batchCount)
+	{
+		batchCount--;
+		if (i < batchCount)
+		{
+			batchSlot[i] = batchSlot[batchCount];
+			memcpy(batchBuffer + (size_t)i * BACKINGSTORE_PAGE_SIZE,
+				batchBuffer + (size_t)batchCount * BACKINGSTORE_PAGE_SIZE, BACKINGSTORE_PAGE_SIZE);
+		}
+	}
+	freeSlots[freeSlotCount++] = (unsigned)swapLocation;
+}
+
+void backingStoreGetStatistics(backingStoreStatistics_t* stats)
+{
+	*stats = backingStoreStats;
+	stats->slots = slotCount;
+}
+
+void backingStorePrintStatistics(void)
+{
+	backingStoreStatistics_t s;
+	double mb = (double)BACKINGSTORE_PAGE_SIZE / (1024.0 * 1024.0);
+	unsigned long long reads;
+	backingStoreGetStatistics(&s);
+	reads = s.pagesRead + s.batchHits;
+	printf("Backing store (%s, %s)\n", backingStoreFileName, backingStoreDirect ? "direct I/O" : "page cache");
+	printf("%-28s %15llu\n", "pages read", s.pagesRead);
+	printf("%-28s %15llu\n", "pages read from the batch", s.batchHits);
+	printf("%-28s %15llu\n", "pages written", s.pagesWritten);
+	printf("%-28s %15llu\n", "pages filled on first use", s.pagesFilled);
+	printf("%-28s %15llu\n", "clean pages not written", s.cleanEvictions);
+	printf("%-28s %15.1f\n", "pages per pwritev", (s.writeCalls > 0) ? (double)s.pagesWritten / s.writeCalls : 0.0);
+	printf("%-28s %15.2f\n", "avg. page-in latency [us]", (reads > 0) ? 1e6 * s.readSeconds / reads : 0.0);
+	printf("%-28s %15.2f\n", "max. page-in latency [us]", 1e6 * s.maxReadSeconds);
+	printf("%-28s %15.2f\n", "avg. page-out time [us]", (s.pagesWritten > 0) ? 1e6 * s.writeSeconds / s.pagesWritten : 0.0);
+	printf("%-28s %15.1f\n", "read throughput [MB/s]", (s.readSeconds > 0) ? reads * mb / s.readSeconds : 0.0);
+	printf("%-28s %15.1f\n", "write throughput [MB/s]", (s.writeSeconds > 0) ? s.pagesWritten * mb / s.writeSeconds : 0.0);
+	printf("%-28s %15u\n", "swap file size [pages]", s.slots);
+	printf("%-28s %15llu\n", "checksum errors", s.checksumErrors);
+	printf("%-28s %15llu\n", "I/O errors", s.ioErrors);
+}
+
+unsigned long long* backingStoreFrame(int frame)
+{
+	return (unsigned long long*)(backingStoreArena + (size_t)frame * BACKINGSTORE_PAGE_SIZE);
+}
+
+void backingStoreFillPage(unsigned long long* words, unsigned pid, unsigned page)
+{
+	unsigned long long x = ((unsigned long long)pid << 32) ^ page ^ 0x9E3779B97F4A7C15ull;
+	unsigned i, used;
+	words[0] = pid;
+	words[1] = page;
+	words[2] = 0;
+	// like real memory a page is only partly used: 1/8 to 8/8 of it holds
+	// data, the rest is zero, so that pages differ in how well they compress
+	used = HEADER_WORDS + (unsigned)(((x * 0xBF58476D1CE4E5B9ull) >> 61) + 1) * (PAGE_WORDS - HEADER_WORDS) / 8;
+	for (i = HEADER_WORDS; i < used; i++)
+	{	// xorshift64
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		words[i] = x;
+	}
+	for (; i < PAGE_WORDS; i++)
+		words[i] = 0;
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+unsigned long long pageChecksum(const unsigned long long* words)
+{
+	unsigned long long hash = 14695981039346656037ull;
+	for (unsigned i = 0; i < PAGE_WORDS; i++)
+	{
+		hash ^= words[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+int allocateSlot(void)
+{
+	void* grown;
+	unsigned capacity;
+	if (freeSlotCount > 0) return (int)freeSlots[--freeSlotCount];
+	if (slotCount == slotCapacity)
+	{
+		capacity = (slotCapacity > 0) ? 2 * slotCapacity : 1024;
+		grown = realloc(slotChecksum, capacity * sizeof(unsigned long long));
+		if (grown == NULL) return NONE;
+		slotChecksum = grown;
+		grown = realloc(freeSlots, capacity * sizeof(unsigned));
+		if (grown == NULL) return NONE;
+		freeSlots = grown;
+		slotCapacity = capacity;
+	}
+	return (int)slotCount++;
+}
+
+Boolean flushBatch(void)
+{
+	unsigned order[BACKINGSTORE_BATCH];
+	void* pages[BACKINGSTORE_BATCH];
+	unsigned first, last, k;
+	Boolean ok = TRUE;
+	double t0;
+	if (batchCount == 0) return TRUE;
+	t0 = smpWallClock();
+	// sort the pages by slot, so that consecutive slots are written together
+	for (unsigned i = 0; i < batchCount; i++)
+	{
+		for (k = i; (k > 0) && (batchSlot[order[k - 1]] > batchSlot[i]); k--)
+			order[k] = order[k - 1];
+		order[k] = i;
+	}
+	for (first = 0; first < batchCount; first = last)
+	{
+		for (last = first + 1; (last < batchCount) && (batchSlot[order[last]] == batchSlot[order[last - 1]] + 1); last++);
+		for (k = first; k < last; k++)
+			pages[k - first] = batchBuffer + (size_t)order[k] * BACKINGSTORE_PAGE_SIZE;
+		if (swapFileWrite(swapFile, pages, last - first, BACKINGSTORE_PAGE_SIZE,
+				(unsigned long long)batchSlot[order[first]] * BACKINGSTORE_PAGE_SIZE))
+			backingStoreStats.pagesWritten += last - first;
+		else
+		{
+			backingStoreStats.ioErrors++;
+			ok = FALSE;
+		}
+		backingStoreStats.writeCalls++;
+	}
+	batchCount = 0;
+	backingStoreStats.writeSeconds += smpWallClock() - t0;
+	return ok;
+}
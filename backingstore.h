@@ -0,0 +1,83 @@
+/* Include-file defining the backing store with real page contents			*/
+/* If a swap file is given, every frame is a page of a memory arena and		*/
+/* every page moved out is written to the swap file, so that the real cost	*/
+/* of the I/O caused by a replacement algorithm can be measured.			*/
+/* A page starts with a header (pid, page, number of writes) followed by a	*/
+/* pattern derived from pid and page filling a part of the page, the rest	*/
+/* is zero. A write access changes the page.								*/
+/* Only modified pages are written when they are moved out, a clean page	*/
+/* keeps its copy in the swap file or, if it was never modified, is filled	*/
+/* again when it is moved in. The pages moved out are collected and			*/
+/* written with one pwritev() per run of consecutive swap slots. A checksum	*/
+/* of each slot is kept in memory and verified when the page is read back.	*/
+#ifndef __BACKINGSTORE__
+#define __BACKINGSTORE__
+
+#include "bs_types.h"
+
+#define BACKINGSTORE_PAGE_SIZE 4096		// bytes of a page, also the alignment for direct I/O
+#define BACKINGSTORE_BATCH 16			// pages moved out that are written together
+
+/* statistics of the backing store, for the report at the end of the run	*/
+typedef struct backingStoreStatistics_struct
+{
+	unsigned long long pagesRead;		// pages read from the swap file
+	unsigned long long pagesWritten;	// pages written to the swap file
+	unsigned long long pagesFilled;		// pages used for the first time, filled instead of read
+	unsigned long long cleanEvictions;	// clean pages moved out without a write
+	unsigned long long batchHits;		// pages read back from the batch before it was written
+	unsigned long long writeCalls;		// calls of pwritev()
+	unsigned long long checksumErrors;	// pages read back with wrong contents
+	unsigned long long ioErrors;		// failed or short reads and writes
+	double readSeconds;					// wall clock time spent reading and verifying pages
+	double writeSeconds;				// wall clock time spent writing batches
+	double maxReadSeconds;				// longest time of a single page read
+	unsigned slots;						// size of the swap file in pages
+} backingStoreStatistics_t;
+
+extern char backingStoreFileName[];		// swap file, empty: page contents are not simulated
+extern Boolean backingStoreDirect;		// bypass the page cache of the host, if supported
+extern Boolean backingStoreEnabled;		// set by backingStoreOpen()
+
+Boolean backingStoreOpen(const char* filename, unsigned frames);
+/* allocates the arena for the given number of frames and creates the swap	*/
+/* file. An empty filename leaves the backing store disabled and returns	*/
+/* TRUE. Returns FALSE if the arena or the file cannot be created			*/
+
+Boolean backingStoreClose(void);
+/* writes the pending batch, removes the swap file and frees the arena		*/
+/* Returns FALSE if an I/O error or a checksum error occured during the run	*/
+
+Boolean backingStorePageIn(unsigned pid, unsigned page, int frame, int swapLocation);
+/* loads the page into the frame: from the swap file if swapLocation is a	*/
+/* slot, else it is filled with its initial contents						*/
+/* Returns FALSE on an I/O error or if the contents read are wrong			*/
+
+Boolean backingStorePageOut(int frame, Boolean modified, int* swapLocation);
+/* moves the page in the frame out, allocating a slot if *swapLocation is	*/
+/* NONE. A clean page is not written										*/
+/* Returns FALSE if no slot can be allocated or the batch cannot be written	*/
+
+Boolean backingStoreWritePage(const unsigned long long* words, int* swapLocation);
+/* writes the page contents given to the swap file like a modified page		*/
+/* moved out, used for pages kept outside of the frames					*/
+
+void backingStoreWrite(int frame);
+/* a process wrote to the page in the frame: the contents are changed		*/
+
+void backingStoreFreeSlot(int swapLocation);
+/* releases the slot of a page of a terminated process						*/
+
+unsigned long long* backingStoreFrame(int frame);
+/* returns the contents of the frame, BACKINGSTORE_PAGE_SIZE bytes			*/
+
+void backingStoreFillPage(unsigned long long* words, unsigned pid, unsigned page);
+/* writes the initial contents of the page, also used without a swap file	*/
+
+void backingStoreGetStatistics(backingStoreStatistics_t* stats);
+/* returns the current statistics											*/
+
+void backingStorePrintStatistics(void);
+/* prints the I/O statistics, the throughput and the latency per page		*/
+
+#endif  /* __BACKINGSTORE__ */
@@ -0,0 +1,754 @@
+/* Benchmark suite for the hot paths of the memory manager				*/
+/* Micro benchmarks time single functions of the OS (accessPage() on	*/
+/* hit and fault, pageReplacement(), timerEventHandler(), parsing of	*/
+/* the stimulus file, process churn with the slab allocator and with	*/
+/* malloc()), macro benchmarks replay generated standard		*/
+/* traces through coreLoop(). Results are reported in ns/event and		*/
+/* events/s and compared against a stored baseline.						*/
+/* Each benchmark is run BENCH_REPEAT times, interleaved with the others,	*/
+/* and its median run counts. Every run is scaled by the speed of a		*/
+/* reference loop timed around it, so that the results are those of a		*/
+/* machine on which one iteration takes BENCH_REFERENCE_NS. This removes	*/
+/* most of the variation of shared or throttled machines.				*/
+/* The runs BENCH_BOUND from either end of the sorted runs bound the		*/
+/* median with a confidence of 96%, both are kept in the baseline. A		*/
+/* benchmark regressed if the lower bound of this run exceeds the upper		*/
+/* bound of the baseline by more than the threshold, so the threshold only	*/
+/* has to cover the drift of the machine between runs, not their spread.	*/
+/* The throughput of coreLoopMultiCPU() is printed for 1, 2, 4 and 8		*/
+/* CPUs with the speedup over one CPU, but not compared with the baseline,	*/
+/* as it depends on the cores of the machine.								*/
+/* MEMORYSIZE is a compile time constant, so one binary is built per	*/
+/* frame count (see Makefile).											*/
+/*																		*/
+/* usage: bench_<frames> [-b baseline] [-t threshold%] [-u] [-w dir]	*/
+/*   -b file  baseline file (read, or written with -u)					*/
+/*   -t pct   allowed slow-down between the bounds in percent				*/
+/*   -u       update the baseline with the results of this run			*/
+/*   -w dir   working directory for the generated trace files			*/
+/* Returns 0 on success, 1 if any benchmark regressed, 2 on errors		*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include "bs_types.h"
+#include "global.h"
+#include "core.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in global.h	*/
+/* (the benchmark replaces main.c)									*/
+unsigned systemTime = 0; 		// the current system time (up time)
+
+// local helpers of the memory manager that are benchmarked directly
+Boolean pageReplacement(unsigned *pid, unsigned *page, int *frame);
+
+#define BENCH_MAX_RESULTS 32
+#define BENCH_NAME_LENGTH 64
+#define BENCH_REPEAT 9			// each benchmark is run this often, the median counts
+#define BENCH_BOUND 1			// runs below and above the bounds of the median (96% for 9 runs)
+#define BENCH_MIN_NS 50000000.0	// minimum duration of one timed run: 50 ms
+#define BENCH_MAX_TRACES 8
+#define BENCH_REFERENCE_LOOPS 2000000	// iterations of the reference loop
+#define BENCH_REFERENCE_NS 2.0			// ns per iteration the results are scaled to
+#define BENCH_SCALING_CPUS 8			// CPUs of the largest multi-CPU run
+#define BENCH_SCALING_REPEAT 3			// runs of each number of CPUs, the median counts
+#define BENCH_SCALING_EVENTS 400000		// events of the trace cpus
+
+/* a benchmark with the results of its runs, the runs of all of them are	*/
+/* interleaved																*/
+typedef struct benchCase_struct
+{
+	const char* name;						// name of the result, without the frames
+	double (*micro)(unsigned long events);	// micro benchmark, NULL for a replay
+	const char* trace;						// trace replayed through coreLoop()
+	unsigned long events;					// events of one run
+	double ns[BENCH_REPEAT];				// ns/event of each run
+} benchCase_t;
+
+/* a generated trace, it is written once and read by all runs				*/
+typedef struct benchTrace_struct
+{
+	const char* name;
+	unsigned long events;
+	char processFile[FILENAME_LENGTH];
+	char runFile[FILENAME_LENGTH];
+} benchTrace_t;
+
+typedef struct benchResult_struct
+{
+	char name[BENCH_NAME_LENGTH];
+	double nsPerEvent;
+	double low, high;			// confidence bounds of nsPerEvent
+} benchResult_t;
+
+benchResult_t results[BENCH_MAX_RESULTS];
+unsigned resultCount = 0;
+char workDir[FILENAME_LENGTH] = ".";
+benchTrace_t tracesWritten[BENCH_MAX_TRACES];
+unsigned traceCount = 0;
+unsigned referenceSink = 0;		// result of the reference loop, keeps it from being optimised away
+unsigned benchSeed = 12345;		// fixed seed: the generated traces are the same on every run
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+double nowNs(void);
+/* monotonic wall clock in nanoseconds										*/
+
+unsigned benchRandom(void);
+/* deterministic pseudo random numbers, independent of rand()				*/
+
+void setupOS(void);
+/* initialise the OS without a stimulus file for the micro benchmarks		*/
+
+void teardownOS(void);
+/* free all page tables and shut down the OS after a micro benchmark		*/
+
+void addProcess(unsigned pid, unsigned size);
+/* make the given process valid with the given size and create its page table*/
+/* The benchmarks add their processes in the order of their PIDs from 1 on,	*/
+/* so that the entry of each process in the process table is its PID		*/
+
+void report(const char* name, double nsPerEvent, double low, double high);
+/* store and print the result of one benchmark								*/
+
+/* ------------------------------------------------------------------------ */
+/*		               Micro benchmarks										*/
+
+double benchAccessHit(unsigned long events)
+/* accessPage() on a page that is present									*/
+{
+	action_t action = { read, 0 };
+	double t0, t1;
+	setupOS();
+	addProcess(1, 1);
+	accessPage(1, action);			// fault the page in once
+	t0 = nowNs();
+	for (unsigned long i = 0; i < events; i++)
+	{
+		action.op = (i & 3) ? read : write;
+		accessPage(1, action);
+	}
+	t1 = nowNs();
+	teardownOS();
+	return (t1 - t0) / events;
+}
+
+double benchAccessFault(unsigned long events)
+/* accessPage() on pages that are absent while memory is full, i.e. the		*/
+/* fault path including replacement, page-out and page-in.					*/
+/* The process cycles over 64 times more pages than frames exist, so almost	*/
+/* every access faults (4 times for large memories to limit the page table)*/
+{
+	action_t action = { read, 0 };
+	unsigned size = (MEMORYSIZE <= 16384) ? 64 * MEMORYSIZE : 4 * MEMORYSIZE;
+	double t0, t1;
+	setupOS();
+	addProcess(1, size);
+	for (unsigned page = 0; page < MEMORYSIZE; page++)	// fill memory
+	{
+		action.page = page;
+		accessPage(1, action);
+	}
+	t0 = nowNs();
+	for (unsigned long i = 0; i < events; i++)
+	{
+		action.page = (unsigned)((MEMORYSIZE + i) % size);
+		action.op = (i & 3) ? read : write;
+		accessPage(1, action);
+	}
+	t1 = nowNs();
+	teardownOS();
+	return (t1 - t0) / events;
+}
+
+double benchReplacement(unsigned long events)
+/* pageReplacement() alone with a full memory shared by several processes	*/
+{
+	action_t action = { read, 0 };
+	unsigned pid, page;
+	int frame;
+	double t0, t1;
+	setupOS();
+	for (pid = 1; pid <= 8; pid++)
+		addProcess(pid, 2 * MEMORYSIZE);
+	for (unsigned i = 0; i < MEMORYSIZE; i++)		// fill memory round robin
+	{
+		action.page = i / 8;
+		accessPage(1 + (i % 8), action);
+	}
+	t0 = nowNs();
+	for (unsigned long i = 0; i < events; i++)
+	{
+		pid = 1; page = 0; frame = NONE;
+		pageReplacement(&pid, &page, &frame);
+	}
+	t1 = nowNs();
+	teardownOS();
+	return (t1 - t0) / events;
+}
+
+double benchTimer(unsigned long events)
+/* timerEventHandler() with a full memory shared by several processes		*/
+/* One page is referenced before each tick, otherwise the handler has		*/
+/* nothing to do															*/
+{
+	action_t action = { read, 0 };
+	double t0, t1;
+	setupOS();
+	for (unsigned pid = 1; pid <= 8; pid++)
+		addProcess(pid, 2 * MEMORYSIZE);
+	for (unsigned i = 0; i < MEMORYSIZE; i++)
+	{
+		action.page = i / 8;
+		accessPage(1 + (i % 8), action);
+	}
+	t0 = nowNs();
+	action.page = 0;
+	for (unsigned long i = 0; i < events; i++)
+	{
+		accessPage(1, action);
+		systemTime += TIMER_INTERVAL;
+		timerEventHandler();
+	}
+	t1 = nowNs();
+	teardownOS();
+	return (t1 - t0) / events;
+}
+
+double benchChurn(unsigned long events)
+/* process churn: each event ends one of 16 processes and starts it again	*/
+/* with another size, then it faults in a few pages. Page tables and the	*/
+/* entries of the list of empty frames are allocated and freed all the		*/
+/* time, by the slab allocator or by malloc(), see benchChurnMalloc()		*/
+{
+	static const unsigned sizes[4] = { 8, 64, 1024, 32 };
+	action_t action = { write, 0 };
+	unsigned pid;
+	double t0, t1;
+	setupOS();
+	for (pid = 1; pid <= 16; pid++)
+		addProcess(pid, sizes[pid % 4]);
+	t0 = nowNs();
+	for (unsigned long i = 0; i < events; i++)
+	{
+		pid = 1 + (unsigned)(i % 16);
+		deAllocateProcess(pid);
+		processTable[pid].size = sizes[(i / 16 + pid) % 4];
+		createPageTable(pid);
+		for (unsigned k = 0; k < 4; k++)
+		{
+			action.page = (unsigned)(i * 7 + k * 5) % processTable[pid].size;
+			accessPage(pid, action);
+		}
+	}
+	t1 = nowNs();
+	teardownOS();
+	return (t1 - t0) / events;
+}
+
+double benchChurnMalloc(unsigned long events)
+/* benchChurn() with all OS data allocated by malloc()						*/
+{
+	double ns;
+	slabEnabled = FALSE;
+	ns = benchChurn(events);
+	slabEnabled = TRUE;
+	return ns;
+}
+
+Boolean writeTraceFiles(const char* name, unsigned long events,
+	char* processFile, char* runFile);
+/* generates the standard trace <name> with the given number of events	*/
+
+Boolean writeManyPidsTrace(unsigned long events, const char* processFile, const char* runFile);
+/* generates the trace manypids, see writeTraceFiles()						*/
+
+Boolean writeCpusTrace(unsigned long events, const char* processFile, const char* runFile);
+/* generates the trace cpus, see writeTraceFiles()							*/
+
+void writeTraceOrExit(const char* name, unsigned long events);
+/* writeTraceFiles() into the files of the simulation, exits on errors		*/
+/* A trace already written with the same length is only selected, so the	*/
+/* runs do not write back the files of each other while they are timed		*/
+
+double benchParse(unsigned long events)
+/* reading and parsing of the stimulus file by sim_ReadNextEvent()			*/
+{
+	memoryEvent_t event;
+	unsigned long count = 0;
+	double t0, t1;
+	writeTraceOrExit("parse", events);
+	initOS();
+	sim_initSim();
+	t0 = nowNs();
+	while (sim_ReadNextEvent(&event) != NULL)
+		count++;
+	t1 = nowNs();
+	sim_shutdownSim();
+	shutdownMemoryManager();
+	return (t1 - t0) / (count > 0 ? count : 1);
+}
+
+/* ------------------------------------------------------------------------ */
+/*		               Macro benchmarks										*/
+
+double benchReplay(const char* name, unsigned long events)
+/* replays a generated standard trace through coreLoop()					*/
+{
+	double t0, t1;
+	writeTraceOrExit(name, events);
+	initOS();
+	sim_initSim();
+	srand(benchSeed);				// random replacement shall be repeatable
+	t0 = nowNs();
+	coreLoop();
+	t1 = nowNs();
+	sim_shutdownSim();
+	shutdownOS();
+	return (t1 - t0) / events;
+}
+
+double benchScaling(unsigned cpus, unsigned long events)
+/* replays the trace cpus on the given number of CPUs with					*/
+/* coreLoopMultiCPU(), returns the memory accesses per second				*/
+{
+	double accessesPerSecond;
+	writeTraceOrExit("cpus", events);
+	smpCpuCount = cpus;
+	initOS();
+	sim_initSim();
+	coreLoopMultiCPU();
+	accessesPerSecond = (multiCPUSeconds > 0) ? multiCPUAccesses / multiCPUSeconds : 0.0;
+	sim_shutdownSim();
+	shutdownOS();
+	smpCpuCount = 1;
+	return accessesPerSecond;
+}
+
+/* ------------------------------------------------------------------------ */
+/*		               Trace generation										*/
+
+Boolean writeTraceFiles(const char* name, unsigned long events,
+	char* processFile, char* runFile)
+/* Standard traces, all but manypids use the processes 1..7 with fixed sizes:*/
+/*  parse   : uniform random accesses, used for the parser benchmark		*/
+/*  random  : uniform random accesses over all processes					*/
+/*  loop    : every process loops over its whole address space			*/
+/*  hotscan : interactive processes with a small hot set, batch processes	*/
+/*            scanning sequentially through a large address space			*/
+/*  sparse  : uniform random accesses with long idle periods in between		*/
+/*  manypids: short-lived processes with PIDs spread over the whole range,	*/
+/*            eight of them run at a time with a few accesses each			*/
+/*  cpus    : 32 processes with a hot set each, 1600 accesses per timer		*/
+/*            period, so the CPUs of coreLoopMultiCPU() rarely meet			*/
+/* The time advances by 5 units per event, so the timer is triggered		*/
+/* every 10 events. In the sparse trace it advances by 100 timer periods.	*/
+{
+	static const unsigned sizes[8] = { 0, 16, 32, 64, 128, 256, 1024, 4096 };
+	FILE *file;
+	unsigned position[8] = { 0 };
+	unsigned pid, page, time = 10;
+
+	if ((snprintf(processFile, FILENAME_LENGTH, "%s/%s_processes.txt", workDir, name) >= FILENAME_LENGTH)
+		|| (snprintf(runFile, FILENAME_LENGTH, "%s/%s_run.txt", workDir, name) >= FILENAME_LENGTH))
+		return FALSE;				// the working directory has a too long path
+	benchSeed = 12345;
+	if (strcmp(name, "manypids") == 0) return writeManyPidsTrace(events, processFile, runFile);
+	if (strcmp(name, "cpus") == 0) return writeCpusTrace(events, processFile, runFile);
+	file = fopen(processFile, "w");
+	if (file == NULL) return FALSE;
+	fprintf(file, "# <PID> <size>\n");
+	for (pid = 1; pid <= 7; pid++)
+		fprintf(file, "%u %u\n", pid, sizes[pid]);
+	fclose(file);
+
+	file = fopen(runFile, "w");
+	if (file == NULL) return FALSE;
+	fprintf(file, "# <time> <PID> <action>, benchmark trace %s\n", name);
+	for (pid = 1; pid <= 7; pid++)
+		fprintf(file, "%u %u S\n", time, pid);
+	for (unsigned long i = 0; i < events; i++)
+	{
+		time += (strcmp(name, "sparse") == 0) ? 100 * TIMER_INTERVAL : 5;
+		pid = 1 + benchRandom() % 7;
+		if (strcmp(name, "loop") == 0)
+		{
+			page = position[pid];
+			position[pid] = (position[pid] + 1) % sizes[pid];
+		}
+		else if (strcmp(name, "hotscan") == 0)
+		{
+			if (pid <= 4)				// interactive: hot set of 4 pages
+				page = benchRandom() % 4;
+			else						// batch: sequential scan
+			{
+				page = position[pid];
+				position[pid] = (position[pid] + 1) % sizes[pid];
+			}
+		}
+		else
+			page = benchRandom() % sizes[pid];
+		fprintf(file, "%u %u %c%u\n", time, pid, (benchRandom() % 4 == 0) ? 'W' : 'R', page);
+	}
+	for (pid = 1; pid <= 7; pid++)
+	{
+		time += 5;
+		fprintf(file, "%u %u E", time, pid);
+		if (pid < 7) fprintf(file, "\n");	// no linefeed after the last line
+	}
+	fclose(file);
+	return TRUE;
+}
+
+Boolean writeCpusTrace(unsigned long events, const char* processFile, const char* runFile)
+{
+	unsigned pid, page, time = 10;
+	FILE* file = fopen(processFile, "w");
+	if (file == NULL) return FALSE;
+	fprintf(file, "# <PID> <size>\n");
+	for (pid = 1; pid <= 32; pid++)
+		fprintf(file, "%u %u\n", pid, 256u);
+	fclose(file);
+
+	file = fopen(runFile, "w");
+	if (file == NULL) return FALSE;
+	fprintf(file, "# <time> <PID> <action>, benchmark trace cpus\n");
+	for (pid = 1; pid <= 32; pid++)
+		fprintf(file, "%u %u S\n", time, pid);
+	for (unsigned long i = 0; i < events; i++)
+	{
+		if (i % 32 == 0) time++;	// 32 accesses per time unit
+		pid = 1 + benchRandom() % 32;
+		// nine of ten accesses go to the hot set of 32 pages
+		page = (benchRandom() % 10 != 0) ? benchRandom() % 32 : benchRandom() % 256;
+		fprintf(file, "%u %u %c%u\n", time, pid, (benchRandom() % 4 == 0) ? 'W' : 'R', page);
+	}
+	time++;
+	for (pid = 1; pid <= 32; pid++)
+	{
+		fprintf(file, "%u %u E", time, pid);
+		if (pid < 32) fprintf(file, "\n");	// no linefeed after the last line
+	}
+	fclose(file);
+	return TRUE;
+}
+
+void writeTraceOrExit(const char* name, unsigned long events)
+{
+	unsigned i;
+	for (i = 0; (i < traceCount) && (strcmp(tracesWritten[i].name, name) != 0); i++);
+	if ((i < traceCount) && (tracesWritten[i].events == events))
+	{
+		memcpy(sim_processFileName, tracesWritten[i].processFile, FILENAME_LENGTH);
+		memcpy(sim_runFileName, tracesWritten[i].runFile, FILENAME_LENGTH);
+		return;
+	}
+	if (i == traceCount) traceCount++;	// BENCH_MAX_TRACES covers all names of the suite
+	tracesWritten[i].name = name;
+	tracesWritten[i].events = events;
+	if (writeTraceFiles(name, events, tracesWritten[i].processFile, tracesWritten[i].runFile))
+	{
+		memcpy(sim_processFileName, tracesWritten[i].processFile, FILENAME_LENGTH);
+		memcpy(sim_runFileName, tracesWritten[i].runFile, FILENAME_LENGTH);
+		return;
+	}
+	fprintf(stderr, "bench: cannot write the trace %s into %s\n", name, workDir);
+	exit(2);
+}
+
+Boolean writeManyPidsTrace(unsigned long events, const char* processFile, const char* runFile)
+{
+	// 8 starts, 32 accesses and 8 ends per group of processes
+	unsigned long groups = (events + 47) / 48;
+	unsigned pid, time = 10;
+	FILE* file = fopen(processFile, "w");
+	if (file == NULL) return FALSE;
+	fprintf(file, "# <PID> <size>\n");
+	// multiplying by an odd number permutes the PIDs: all of them differ
+	for (unsigned long k = 1; k <= 8 * groups; k++)
+		fprintf(file, "%u %u\n", (unsigned)k * 2654435761u, 16u);
+	fclose(file);
+
+	file = fopen(runFile, "w");
+	if (file == NULL) return FALSE;
+	fprintf(file, "# <time> <PID> <action>, benchmark trace manypids\n");
+	for (unsigned long g = 0; g < groups; g++)
+	{
+		for (unsigned k = 1; k <= 8; k++, time += 5)
+			fprintf(file, "%u %u S\n", time, (unsigned)(8 * g + k) * 2654435761u);
+		for (unsigned i = 0; i < 32; i++, time += 5)
+		{
+			pid = (unsigned)(8 * g + 1 + benchRandom() % 8) * 2654435761u;
+			fprintf(file, "%u %u %c%u\n", time, pid, (benchRandom() % 4 == 0) ? 'W' : 'R', benchRandom() % 16);
+		}
+		for (unsigned k = 1; k <= 8; k++, time += 5)
+		{
+			fprintf(file, "%u %u E", time, (unsigned)(8 * g + k) * 2654435761u);
+			if ((g + 1 < groups) || (k < 8)) fprintf(file, "\n");	// no linefeed after the last line
+		}
+	}
+	fclose(file);
+	return TRUE;
+}
+
+/* ------------------------------------------------------------------------ */
+/*		               Baseline handling									*/
+
+Boolean compareBaseline(const char* filename, double threshold)
+/* compares all results with the baseline, prints the relative change of	*/
+/* the medians. Returns FALSE if the lower bound of any result is above the	*/
+/* upper bound of the baseline by more than threshold (in %)				*/
+{
+	FILE* file = fopen(filename, "r");
+	char line[LINEBUFFER_SIZE + 1], name[BENCH_NAME_LENGTH];
+	double baseline, low, high, change;
+	Boolean ok = TRUE, regressed;
+	if (file == NULL)
+	{
+		fprintf(stderr, "bench: no baseline %s, nothing compared\n", filename);
+		return TRUE;
+	}
+	while (fgets(line, LINEBUFFER_SIZE, file) != NULL)
+	{
+		if (line[0] == '#') continue;
+		switch (sscanf(line, "%63s %lf %lf %lf", name, &baseline, &low, &high))
+		{
+		case 2:						// written without bounds
+			low = high = baseline;
+			break;
+		case 4:
+			break;
+		default:
+			continue;
+		}
+		for (unsigned i = 0; i < resultCount; i++)
+		{
+			if (strcmp(results[i].name, name) != 0) continue;
+			change = 100.0 * (results[i].nsPerEvent - baseline) / baseline;
+			regressed = (results[i].low > high * (1.0 + threshold / 100.0));
+			printf("%-34s baseline %10.1f ns/event  %+7.1f%%  bounds %+7.1f%%%s\n", name, baseline,
+				change, 100.0 * (results[i].low - high) / high, regressed ? "  REGRESSION" : "");
+			if (regressed) ok = FALSE;
+		}
+	}
+	fclose(file);
+	return ok;
+}
+
+Boolean updateBaseline(const char* filename)
+/* replaces the entries of this run in the baseline file, keeps all others	*/
+{
+	char lines[256][LINEBUFFER_SIZE + 1], name[BENCH_NAME_LENGTH];
+	unsigned lineCount = 0;
+	FILE* file = fopen(filename, "r");
+	if (file != NULL)
+	{
+		while ((lineCount < 256) && (fgets(lines[lineCount], LINEBUFFER_SIZE, file) != NULL))
+		{
+			Boolean replaced = FALSE;
+			if ((lines[lineCount][0] != '#') && (sscanf(lines[lineCount], "%63s", name) == 1))
+				for (unsigned i = 0; i < resultCount; i++)
+					if (strcmp(results[i].name, name) == 0) replaced = TRUE;
+			if (!replaced && (lines[lineCount][0] != '#')) lineCount++;
+		}
+		fclose(file);
+	}
+	file = fopen(filename, "w");
+	if (file == NULL) return FALSE;
+	fprintf(file, "# <benchmark> <ns/event> <lower bound> <upper bound>, written by 'make bench-update'\n");
+	for (unsigned i = 0; i < lineCount; i++)
+		fputs(lines[i], file);
+	for (unsigned i = 0; i < resultCount; i++)
+		fprintf(file, "%s %.1f %.1f %.1f\n", results[i].name, results[i].nsPerEvent, results[i].low,
+			results[i].high);
+	fclose(file);
+	return TRUE;
+}
+
+/* ------------------------------------------------------------------------ */
+/*                Main																*/
+
+double median(double ns[], int count)
+/* returns the median of the results of count runs, sorts them				*/
+{
+	double swap;
+	for (int i = 1; i < count; i++)
+		for (int j = i; (j > 0) && (ns[j - 1] > ns[j]); j--)
+		{
+			swap = ns[j];
+			ns[j] = ns[j - 1];
+			ns[j - 1] = swap;
+		}
+	return (count % 2) ? ns[count / 2] : (ns[count / 2 - 1] + ns[count / 2]) / 2;
+}
+
+double referenceNs(void)
+/* times the reference loop, returns ns per iteration						*/
+{
+	static unsigned table[16384];
+	unsigned x = 1, sum = 0;
+	double t0 = nowNs();
+	for (unsigned i = 0; i < BENCH_REFERENCE_LOOPS; i++)
+	{
+		x = x * 1103515245u + 12345u;
+		table[(x >> 8) & 16383] += i;
+		sum += table[(x >> 12) & 16383];
+	}
+	referenceSink += sum;
+	return (nowNs() - t0) / BENCH_REFERENCE_LOOPS;
+}
+
+double runCase(benchCase_t* pCase)
+/* runs a benchmark once and returns its ns/event, scaled by the speed of	*/
+/* the reference loop before and after it									*/
+{
+	double reference = referenceNs(), ns;
+	if (pCase->micro != NULL) ns = pCase->micro(pCase->events);
+	else ns = benchReplay(pCase->trace, pCase->events);
+	reference = (reference + referenceNs()) / 2;
+	return ns * BENCH_REFERENCE_NS / reference;
+}
+
+void reportScaling(void)
+/* prints the throughput of coreLoopMultiCPU() for 1, 2, 4, ... CPUs and	*/
+/* the speedup over one CPU, the median of BENCH_SCALING_REPEAT runs		*/
+{
+	double runs[BENCH_SCALING_REPEAT], single = 0.0, rate;
+	char name[BENCH_NAME_LENGTH];
+	for (unsigned cpus = 1; (cpus <= BENCH_SCALING_CPUS) && (cpus <= SMP_MAX_CPUS); cpus *= 2)
+	{
+		for (int run = 0; run < BENCH_SCALING_REPEAT; run++)
+			runs[run] = benchScaling(cpus, BENCH_SCALING_EVENTS);
+		rate = median(runs, BENCH_SCALING_REPEAT);
+		if (cpus == 1) single = rate;
+		snprintf(name, BENCH_NAME_LENGTH, "frames=%u/scaling_cpus=%u", MEMORYSIZE, cpus);
+		printf("%-34s %14.0f accesses/s  speedup %.2f\n", name, rate, (single > 0) ? rate / single : 0.0);
+	}
+	fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+	static benchCase_t cases[] = {
+		{ "access_hit", benchAccessHit, NULL, 1000 },
+		{ "access_fault", benchAccessFault, NULL, 1000 },
+		{ "page_replacement", benchReplacement, NULL, 100 },
+		{ "timer_event", benchTimer, NULL, 100 },
+		{ "parse", benchParse, NULL, 200000 },
+		{ "process_churn", benchChurn, NULL, 1000 },
+		{ "process_churn_malloc", benchChurnMalloc, NULL, 1000 },
+		{ "replay_random", NULL, "random", 100000 },	// the traces keep their length
+		{ "replay_loop", NULL, "loop", 100000 },
+		{ "replay_hotscan", NULL, "hotscan", 100000 },
+		{ "replay_sparse", NULL, "sparse", 100000 },
+		{ "replay_manypids", NULL, "manypids", 100000 }
+	};
+	const unsigned caseCount = sizeof(cases) / sizeof(cases[0]);
+	char baselineFile[FILENAME_LENGTH] = "";
+	char name[BENCH_NAME_LENGTH];
+	double threshold = 10.0, ns;
+	Boolean update = FALSE, ok = TRUE;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-b") == 0) && (i + 1 < argc))
+			snprintf(baselineFile, FILENAME_LENGTH, "%s", argv[++i]);
+		else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc))
+			threshold = atof(argv[++i]);
+		else if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc))
+			snprintf(workDir, FILENAME_LENGTH, "%s", argv[++i]);
+		else if (strcmp(argv[i], "-u") == 0)
+			update = TRUE;
+		else
+		{
+			fprintf(stderr, "usage: %s [-b baseline] [-t threshold%%] [-u] [-w dir]\n", argv[0]);
+			return 2;
+		}
+	}
+	logEnabled = FALSE;				// measure the OS, not the console output
+
+	printf("Benchmarks for MEMORYSIZE = %u frames\n", MEMORYSIZE);
+	// the events of the micro benchmarks are scaled up until one run takes BENCH_MIN_NS
+	for (unsigned i = 0; i < caseCount; i++)
+		while ((cases[i].micro != NULL) && (runCase(&cases[i]) * cases[i].events < BENCH_MIN_NS))
+			cases[i].events *= 4;
+	// A phase of other load on the machine slows down one run of each benchmark
+	// instead of all runs of one, and the median of the runs ignores it
+	for (int run = 0; run < BENCH_REPEAT; run++)
+		for (unsigned i = 0; i < caseCount; i++)
+			cases[i].ns[run] = runCase(&cases[i]);
+	for (unsigned i = 0; i < caseCount; i++)
+	{
+		snprintf(name, BENCH_NAME_LENGTH, "frames=%u/%s", MEMORYSIZE, cases[i].name);
+		ns = median(cases[i].ns, BENCH_REPEAT);	// sorts the runs for the bounds
+		report(name, ns, cases[i].ns[BENCH_BOUND], cases[i].ns[BENCH_REPEAT - 1 - BENCH_BOUND]);
+	}
+
+	if (strlen(baselineFile) > 0)
+	{
+		if (update)
+			ok = updateBaseline(baselineFile);
+		else
+			ok = compareBaseline(baselineFile, threshold);
+	}
+	reportScaling();
+	fflush(stdout);
+	return ok ? 0 : 1;
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+double nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+unsigned benchRandom(void)
+{
+	benchSeed = benchSeed * 1103515245u + 12345u;
+	return (benchSeed >> 8);
+}
+
+void setupOS(void)
+{
+	initOS();
+	srand(benchSeed);
+}
+
+void teardownOS(void)
+{
+	while (liveProcessCount > 0)
+		deAllocateProcess(liveProcessList[liveProcessCount - 1]);
+	shutdownOS();
+}
+
+void addProcess(unsigned pid, unsigned size)
+{
+	unsigned index = createProcess(pid);
+	processTable[index].valid = TRUE;
+	processTable[index].size = size;
+	createPageTable(index);
+}
+
+void report(const char* name, double nsPerEvent, double low, double high)
+{
+	if (resultCount < BENCH_MAX_RESULTS)
+	{
+		snprintf(results[resultCount].name, BENCH_NAME_LENGTH, "%s", name);
+		results[resultCount].nsPerEvent = nsPerEvent;
+		results[resultCount].low = low;
+		results[resultCount].high = high;
+		resultCount++;
+	}
+	printf("%-34s %10.1f ns/event %14.0f events/s  [%.1f, %.1f]\n", name, nsPerEvent, 1e9 / nsPerEvent,
+		low, high);
+	fflush(stdout);
+}
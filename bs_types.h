@@ -7,7 +7,8 @@ typedef enum { FALSE = 0, TRUE } Boolean;
 
 
 /* data type for storing of process IDs		*/
-typedef unsigned pid_t;
+/* not named pid_t, as POSIX system headers already define a signed pid_t */
+typedef unsigned bsPid_t;
 
 /* data type for the possible types of processes */
 /* the process type determines the IO-characteristic */
@@ -20,7 +21,7 @@ typedef enum
 /* cycle manegament of the processes 								*/
 typedef enum
 {
-	init, running, ready, blocked, ended
+	init, running, ready, blocked, ended, suspended
 
 } status_t;
 
@@ -32,6 +33,13 @@ typedef enum
 
 } schedulingEvent_t;
 
+/* data type for the scheduling policies of the generated workload,		*/
+/* selected by the global variable schedulingPolicy, see scheduler.h		*/
+typedef enum
+{
+	roundRobinScheduling, priorityScheduling
+} schedulingPolicy_t;
+
 /* data type for the simulation environment */
 /* the information contained ion this struct are not available to the os */
 typedef struct simInfo_struct
@@ -49,9 +57,11 @@ typedef struct pageTableEntry_struct
 	int frame;			// physical memory address, if present
 	int swapLocation;	// if page is not present, this indicates it's location in secondary memory
 						// as the content of the pages is not used in this simulation, it is unused
-
-
-
+	int zswapEntry;		// entry in the compressed pool if the page is held there, see zswap.h
+	Boolean huge;		// the page is part of a huge page, see hugepage.h
+	bsPid_t nextSharer;	// next process mapping the same frame after a fork, NOPROCESS at the end
+	int listNext;		// neighbours in the list of the resident or of the moved-out pages
+	int listPrev;		// of the process (see PCB_t), NONE at the ends, listPrev < NONE if in none
 } pageTableEntry_t;
 
 /* data type for the Process Control Block */
@@ -60,8 +70,8 @@ typedef struct pageTableEntry_struct
 typedef struct PCB_struct
 {
 	Boolean valid;
-	pid_t pid;
-	pid_t ppid;
+	bsPid_t pid;
+	bsPid_t ppid;
 	unsigned ownerID;
 	unsigned start;
 	unsigned duration;
@@ -71,6 +81,11 @@ typedef struct PCB_struct
 	simInfo_t simInfo;
 	unsigned size;				// size of logical process memory in pages
 	pageTableEntry_t *pageTable;
+	int residentPages;			// first of the resident pages, linked in the page table, NONE if none
+	unsigned residentCount;		// number of resident pages
+	int movedOutPages;			// first of the pages moved out that the OS keeps data of (swap
+								// slot, entry in the compressed pool, ghost), NONE if none
+	int liveIndex;				// entry in the list of the live processes, NONE if not live
 } PCB_t;
 
 /* data type for the possible actions wtr. memory usage by a process		*/
@@ -78,30 +93,58 @@ typedef struct PCB_struct
 /* management system														*/
 typedef enum
 {
-	start, end, read, write, allocate, deallocate, error
+	start, end, read, write, forkAction, allocate, deallocate, error
 } operation_t;
 
 /* data type for possible memory use by aprocess, kombining the action with	*/
 /* the page that is used for this action, e.g. for reading */
 /* is the action does not require a page number (i.e. a location in virtual	*/
-/* memory), the value of 'page' is not used an may be undefined				*/		
+/* memory), the value of 'page' is not used an may be undefined				*/
+/* for forkAction, 'page' holds the PID of the child						*/
 typedef struct action_struct
 {
 	operation_t op;
 	unsigned page;
 } action_t;
 
+/* maximum number of actions of one process at one point in time, i.e. in	*/
+/* one line of the stimulus file											*/
+#define MAX_EVENT_ACTIONS 64
+
 /* data type for an event, descrtibing a cartain action performad by a		*/
 /* process at agiven point in time.											*/
 /* It is used for modelling the activities of a process during it's			*/
 /* execution wrt. accessing the memory										*/
+/* An event may carry a list of actions of the process, which are executed	*/
+/* in the given order at the same point in time								*/
 typedef struct event_struct
 {
 	unsigned time; 
-	pid_t pid;
-	action_t action;
+	bsPid_t pid;
+	unsigned actionCount;				// number of valid entries in action[]
+	action_t action[MAX_EVENT_ACTIONS];
 } memoryEvent_t;
 
+/* data type for the page replacement algorithms available in the memory	*/
+/* management system, selected by the global variable replacementPolicy		*/
+typedef enum
+{
+	randomReplacement, agingReplacement, weightedReplacement,
+	arcReplacement, carReplacement, twoQueueReplacement, lirsReplacement, clockProReplacement
+} replacementPolicy_t;
+
+/* data type for an entry of the frame table, which maps each frame of the	*/
+/* physical memory back to the page residing in it (reverse mapping)		*/
+/* A frame shared after a fork is mapped at the same page by all sharers:	*/
+/* pid is the first of them, the others follow in the list linked by		*/
+/* nextSharer in their page table entries									*/
+typedef struct frameTableEntry_struct
+{
+	unsigned pid;			// NOPROCESS if the frame is empty
+	unsigned page;			// page residing in the frame, only valid if pid != NOPROCESS
+	unsigned sharers;		// processes mapping the frame, more than one after a fork
+} frameTableEntry_t;
+
 /* list type used by the OS to keep track of the currently available frames	*/ 
 /* in physical memory. Used for allocating additional and freeing used		*/
 /* pyhsical memory for/by processes											*/
@@ -0,0 +1,109 @@
+/* Implementation of the buddy allocator of the empty frames				*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include "bs_types.h"
+#include "global.h"
+#include "buddy.h"
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+
+#define NOT_FREE -1				// buddyBlockOrder of a frame not heading an empty block
+
+int buddyHead[BUDDY_MAX_ORDER + 1];			// first empty block of each order
+unsigned buddyBlocks[BUDDY_MAX_ORDER + 1];	// number of empty blocks of each order
+int buddyNext[MEMORYSIZE];					// list of the blocks of one order, by first frame
+int buddyPrev[MEMORYSIZE];
+signed char buddyBlockOrder[MEMORYSIZE];	// order of the empty block starting at each frame
+unsigned buddyFrames = 0;					// number of frames managed
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+void pushBlock(int frame, unsigned order);
+/* adds the empty block to the list of its order							*/
+
+void removeBlock(int frame);
+/* removes the empty block from the list of its order						*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+void buddyInit(unsigned frames)
+{
+	buddyFrames = frames;
+	for (unsigned order = 0; order <= BUDDY_MAX_ORDER; order++)
+	{
+		buddyHead[order] = NONE;
+		buddyBlocks[order] = 0;
+	}
+	for (unsigned frame = 0; frame < frames; frame++)
+		buddyBlockOrder[frame] = NOT_FREE;
+}
+
+void buddyFree(int frame)
+{
+	unsigned order = 0;
+	int buddy;
+	// merge with the buddy as long as it is an empty block of the same order
+	while (order < BUDDY_MAX_ORDER)
+	{
+		buddy = frame ^ (1 << order);
+		if (((unsigned)buddy + (1u << order) > buddyFrames) || (buddyBlockOrder[buddy] != (signed char)order))
+			break;
+		removeBlock(buddy);
+		if (buddy < frame) frame = buddy;
+		order++;
+	}
+	pushBlock(frame, order);
+}
+
+int buddyAlloc(unsigned order)
+{
+	unsigned o;
+	int frame;
+	for (o = order; (o <= BUDDY_MAX_ORDER) && (buddyHead[o] == NONE); o++);
+	if (o > BUDDY_MAX_ORDER) return NONE;
+	frame = buddyHead[o];
+	removeBlock(frame);
+	// the upper halves of a larger block stay empty
+	while (o > order)
+	{
+		o--;
+		pushBlock(frame + (1 << o), o);
+	}
+	return frame;
+}
+
+unsigned buddyFreeFrames(unsigned order)
+{
+	unsigned frames = 0;
+	for (unsigned o = order; o <= BUDDY_MAX_ORDER; o++)
+		frames += buddyBlocks[o] << o;
+	return frames;
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+void pushBlock(int frame, unsigned order)
+{
+	buddyBlockOrder[frame] = (signed char)order;
+	buddyPrev[frame] = NONE;
+	buddyNext[frame] = buddyHead[order];
+	if (buddyHead[order] != NONE) buddyPrev[buddyHead[order]] = frame;
+	buddyHead[order] = frame;
+	buddyBlocks[order]++;
+}
+
+void removeBlock(int frame)
+{
+	unsigned order = (unsigned)buddyBlockOrder[frame];
+	if (buddyPrev[frame] != NONE) buddyNext[buddyPrev[frame]] = buddyNext[frame];
+	else buddyHead[order] = buddyNext[frame];
+	if (buddyNext[frame] != NONE) buddyPrev[buddyNext[frame]] = buddyPrev[frame];
+	buddyBlockOrder[frame] = NOT_FREE;
+	buddyBlocks[order]--;
+}
@@ -0,0 +1,27 @@
+/* Include-file defining the buddy allocator of the empty frames			*/
+/* The empty frames are kept in aligned blocks of 2^order frames, one list	*/
+/* per order. A block is split in halves (buddies) to serve a smaller		*/
+/* request, a freed block is merged with its buddy if that is empty too.	*/
+/* Single frames are taken from the smallest blocks, so that the large		*/
+/* blocks needed for huge pages are kept as long as possible.				*/
+#ifndef __BUDDY__
+#define __BUDDY__
+
+#include "bs_types.h"
+
+#define BUDDY_MAX_ORDER 10				// largest block: 1024 frames
+
+void buddyInit(unsigned frames);
+/* creates the allocator for the given number of frames, none of them empty	*/
+
+void buddyFree(int frame);
+/* adds the empty frame, merging it with its buddies						*/
+
+int buddyAlloc(unsigned order);
+/* removes an aligned block of 2^order empty frames and returns its first	*/
+/* frame. Returns NONE if no such block exists								*/
+
+unsigned buddyFreeFrames(unsigned order);
+/* returns the number of empty frames in blocks of at least 2^order frames	*/
+
+#endif  /* __BUDDY__ */
@@ -0,0 +1,459 @@
+/* Implementation of the checkpoints of the simulation						*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "checkpoint.h"
+#include "host.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in checkpoint.h	*/
+char checkpointFileName[FILENAME_LENGTH] = CHECKPOINT_FILENAME;
+unsigned checkpointTime = 0;
+Boolean checkpointPending = FALSE;
+char restoreFileName[FILENAME_LENGTH] = RESTORE_FILENAME;
+unsigned checkpointVariantCount = 0;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+
+/* data of a module written to the snapshots								*/
+typedef struct checkpointData_struct
+{
+	char name[CHECKPOINT_NAME_LENGTH];
+	void* data;
+	size_t size;
+	Boolean frameState;
+} checkpointData_t;
+
+checkpointData_t checkpointData[CHECKPOINT_SECTIONS_MAX];
+unsigned checkpointDataCount = 0;
+replacementPolicy_t checkpointVariants[CHECKPOINT_VARIANTS_MAX];
+const unsigned char* snapshot = NULL;		// the mapped snapshot, NULL if none
+size_t snapshotBytes = 0;
+const checkpointHeader_t* snapshotHeader = NULL;
+const unsigned* reloadKeys = NULL;			// value of the page in each frame of the snapshot
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+Boolean checkpointSupported(void);
+/* predicate: the options of the run allow checkpoints, logs the reason		*/
+/* otherwise																*/
+
+void addSection(checkpointSection_t directory[], unsigned* count, const char* name, uint64_t size,
+	Boolean frameState);
+/* appends an entry to the directory, its offset is set by the caller		*/
+
+Boolean writePadding(FILE* file, uint64_t size);
+/* pads a section of the given size to the next multiple of 8 bytes			*/
+
+const void* findSection(const char* name, uint64_t* size);
+/* returns the section of the mapped snapshot with the given name and		*/
+/* stores its size, NULL if there is no such section						*/
+
+Boolean reloadPages(const pageTableEntry_t* tables[]);
+/* moves the pages resident in the snapshot into the frames again, the		*/
+/* least valuable first. tables[] holds the page table of each process in	*/
+/* the snapshot. Returns FALSE if a frame is shared by several processes	*/
+
+int compareReloadKey(const void* a, const void* b);
+/* orders frames by decreasing value of their page, ties by frame number	*/
+
+void releaseSnapshot(void);
+/* unmaps the snapshot														*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+Boolean setCheckpoint(const char* spec)
+{
+	int consumed = 0;
+	if ((sscanf(spec, "%u,%n", &checkpointTime, &consumed) < 1) || (consumed == 0) || (spec[consumed] == '\0'))
+		return FALSE;
+	snprintf(checkpointFileName, FILENAME_LENGTH, "%s", spec + consumed);
+	checkpointPending = TRUE;
+	return TRUE;
+}
+
+Boolean setCheckpointVariants(const char* spec)
+{
+	char name[16];
+	int length;
+	replacementPolicy_t selected = replacementPolicy;	// kept for the run without variants
+	Boolean ok = TRUE;
+	checkpointVariantCount = 0;
+	while (ok && (*spec != '\0'))
+	{
+		ok = (checkpointVariantCount < CHECKPOINT_VARIANTS_MAX) && (sscanf(spec, "%15[^,]%n", name, &length) == 1)
+			&& selectReplacementPolicy(name);
+		if (ok) checkpointVariants[checkpointVariantCount++] = replacementPolicy;
+		spec += ok ? length : 0;
+		if (*spec == ',') spec++;
+	}
+	replacementPolicy = selected;
+	return ok && (checkpointVariantCount > 0);
+}
+
+Boolean checkpointRegister(const char* name, void* data, size_t size, Boolean frameState)
+{
+	unsigned i;
+	for (i = 0; (i < checkpointDataCount) && (strcmp(checkpointData[i].name, name) != 0); i++);
+	if (i == CHECKPOINT_SECTIONS_MAX) return FALSE;
+	if (i == checkpointDataCount) checkpointDataCount++;
+	snprintf(checkpointData[i].name, CHECKPOINT_NAME_LENGTH, "%s", name);
+	checkpointData[i].data = data;
+	checkpointData[i].size = size;
+	checkpointData[i].frameState = frameState;
+	return TRUE;
+}
+
+Boolean checkpointWrite(long stimulusOffset)
+{
+	checkpointHeader_t header;
+	checkpointSection_t directory[CHECKPOINT_SECTIONS_MAX + 4];
+	unsigned count = 0;
+	uint64_t offset, pageEntries = 0;
+	int* emptyFrames = NULL;
+	unsigned emptyCount;
+	Boolean ok;
+	FILE* file;
+	checkpointPending = FALSE;
+	if (!checkpointSupported()) return FALSE;
+	emptyFrames = malloc(MEMORYSIZE * sizeof(int));
+	file = fopen(checkpointFileName, "wb");
+	if ((emptyFrames == NULL) || (file == NULL))
+	{
+		logGeneric("OS-ERROR: Snapshot could not be created");
+		free(emptyFrames);
+		if (file != NULL) fclose(file);
+		return FALSE;
+	}
+	emptyCount = listEmptyFrames(emptyFrames);
+	for (unsigned pid = 1; pid < processCount; pid++)
+		if (processTable[pid].pageTable != NULL) pageEntries += processTable[pid].size;
+	// the OS data kept by pointers, then the data of the modules
+	addSection(directory, &count, "processes", (uint64_t)processCount * sizeof(PCB_t), FALSE);
+	addSection(directory, &count, "live", (uint64_t)liveProcessCount * sizeof(unsigned), FALSE);
+	addSection(directory, &count, "pages", pageEntries * sizeof(pageTableEntry_t), FALSE);
+	addSection(directory, &count, "emptyFrames", (uint64_t)emptyCount * sizeof(int), TRUE);
+	for (unsigned i = 0; i < checkpointDataCount; i++)
+		addSection(directory, &count, checkpointData[i].name, checkpointData[i].size, checkpointData[i].frameState);
+	offset = (sizeof(header) + count * sizeof(checkpointSection_t) + 7) & ~(uint64_t)7;
+	for (unsigned i = 0; i < count; i++)
+	{
+		directory[i].offset = offset;
+		offset += (directory[i].size + 7) & ~(uint64_t)7;
+	}
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+	header.version = CHECKPOINT_VERSION;
+	header.memorySize = MEMORYSIZE;
+	header.policy = (uint32_t)replacementPolicy;
+	header.agingBits = AGING_COUNTER_BITS;
+	header.pcbSize = sizeof(PCB_t);
+	header.entrySize = sizeof(pageTableEntry_t);
+	header.systemTime = systemTime;
+	header.processCount = processCount;
+	header.sectionCount = count;
+	header.stimulusOffset = (uint64_t)stimulusOffset;
+	header.fileSize = offset;
+	ok = (fwrite(&header, sizeof(header), 1, file) == 1)
+		&& (fwrite(directory, sizeof(checkpointSection_t), count, file) == count)
+		&& writePadding(file, sizeof(header) + count * sizeof(checkpointSection_t));
+	ok = ok && (fwrite(processTable, sizeof(PCB_t), processCount, file) == processCount)
+		&& writePadding(file, directory[0].size);
+	ok = ok && (fwrite(liveProcessList, sizeof(unsigned), liveProcessCount, file) == liveProcessCount)
+		&& writePadding(file, directory[1].size);
+	for (unsigned pid = 1; ok && (pid < processCount); pid++)
+		if (processTable[pid].pageTable != NULL)
+			ok = (fwrite(processTable[pid].pageTable, sizeof(pageTableEntry_t), processTable[pid].size, file)
+				== processTable[pid].size);
+	ok = ok && writePadding(file, directory[2].size);
+	ok = ok && (fwrite(emptyFrames, sizeof(int), emptyCount, file) == emptyCount)
+		&& writePadding(file, directory[3].size);
+	for (unsigned i = 0; ok && (i < checkpointDataCount); i++)
+		ok = (fwrite(checkpointData[i].data, 1, checkpointData[i].size, file) == checkpointData[i].size)
+			&& writePadding(file, checkpointData[i].size);
+	if (fclose(file) != 0) ok = FALSE;
+	free(emptyFrames);
+	if (!ok)
+		logGeneric("OS-ERROR: Snapshot could not be written completely");
+	else if (logEnabled)
+		printf("%6u : Checkpoint: %u processes, %u empty frames, %llu bytes written to %s\n", systemTime,
+			liveProcessCount, emptyCount, (unsigned long long)offset, checkpointFileName);
+	return ok;
+}
+
+Boolean checkpointOpen(void)
+{
+	const checkpointSection_t* directory;
+	snapshot = hostMapFile(restoreFileName, &snapshotBytes);
+	if (snapshot == NULL)
+	{
+		printf("Snapshot %s could not be read\n", restoreFileName);
+		return FALSE;
+	}
+	snapshotHeader = (const checkpointHeader_t*)snapshot;
+	directory = (const checkpointSection_t*)(snapshotHeader + 1);
+	if ((snapshotBytes < sizeof(checkpointHeader_t)) || (memcmp(snapshotHeader->magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0)
+		|| (snapshotHeader->version != CHECKPOINT_VERSION) || (snapshotHeader->fileSize != snapshotBytes)
+		|| (snapshotHeader->pcbSize != sizeof(PCB_t)) || (snapshotHeader->entrySize != sizeof(pageTableEntry_t))
+		|| (sizeof(checkpointHeader_t) + (uint64_t)snapshotHeader->sectionCount * sizeof(checkpointSection_t) > snapshotBytes))
+	{	// the layout of the data is the one of the host that wrote it
+		printf("Snapshot %s was not written by this build of the simulation\n", restoreFileName);
+		releaseSnapshot();
+		return FALSE;
+	}
+	for (unsigned i = 0; i < snapshotHeader->sectionCount; i++)
+		if ((directory[i].offset > snapshotBytes) || (directory[i].size > snapshotBytes - directory[i].offset)
+			|| (directory[i].offset % 8 != 0) || (memchr(directory[i].name, '\0', CHECKPOINT_NAME_LENGTH) == NULL))
+		{
+			printf("Snapshot %s is damaged\n", restoreFileName);
+			releaseSnapshot();
+			return FALSE;
+		}
+	return TRUE;
+}
+
+int checkpointForkVariants(void)
+{
+	FILE* output[CHECKPOINT_VARIANTS_MAX];
+	int child[CHECKPOINT_VARIANTS_MAX];
+	int status, c;
+	for (unsigned v = 0; v < checkpointVariantCount; v++)
+	{	// the children share the mapped snapshot with the parent
+		output[v] = tmpfile();
+		child[v] = (output[v] != NULL) ? hostForkOutput(output[v]) : -1;
+		if (child[v] == 0)
+		{
+			replacementPolicy = checkpointVariants[v];
+			return (int)v;
+		}
+	}
+	for (unsigned v = 0; v < checkpointVariantCount; v++)
+	{
+		status = (child[v] > 0) ? hostWaitChild(child[v]) : -1;
+		if (child[v] > 0)
+			printf("Variant %u (%s), exit code %d\n", v + 1, getReplacementPolicyName(checkpointVariants[v]), status);
+		else
+			printf("Variant %u (%s) could not be started\n", v + 1, getReplacementPolicyName(checkpointVariants[v]));
+		if (output[v] == NULL) continue;
+		rewind(output[v]);
+		while ((c = fgetc(output[v])) != EOF)
+			putchar(c);
+		fclose(output[v]);
+	}
+	releaseSnapshot();
+	return -1;
+}
+
+Boolean checkpointRestore(void)
+{
+	const PCB_t* pcbs;
+	const unsigned* live;
+	const pageTableEntry_t* pages;
+	const int* emptyFrames;
+	const pageTableEntry_t** tables = NULL;	// page table of each process in the snapshot
+	const void* data;
+	uint64_t pcbSize, liveSize, pagesSize, emptySize, size;
+	Boolean complete, ok = TRUE;
+	if (snapshot == NULL) return FALSE;
+	pcbs = findSection("processes", &pcbSize);
+	live = findSection("live", &liveSize);
+	pages = findSection("pages", &pagesSize);
+	emptyFrames = findSection("emptyFrames", &emptySize);
+	if (!checkpointSupported() || (pcbs == NULL) || (live == NULL) || (pages == NULL) || (emptyFrames == NULL)
+		|| (snapshotHeader->processCount != processCount) || (pcbSize != (uint64_t)processCount * sizeof(PCB_t)))
+		ok = FALSE;
+	for (unsigned pid = 1; ok && (pid < processCount); pid++)
+		if (pcbs[pid].pid != processTable[pid].pid) ok = FALSE;
+	if (ok) tables = calloc(processCount, sizeof(pageTableEntry_t*));
+	if (!ok || (tables == NULL))
+	{
+		logGeneric("OS-ERROR: Snapshot does not fit the process file or the options");
+		releaseSnapshot();
+		return FALSE;
+	}
+	systemTime = snapshotHeader->systemTime;
+	// the data of the replacement is only taken over by the same configuration
+	complete = (snapshotHeader->memorySize == MEMORYSIZE) && (snapshotHeader->policy == (uint32_t)replacementPolicy)
+		&& (snapshotHeader->agingBits == AGING_COUNTER_BITS);
+	for (unsigned i = 0; i < checkpointDataCount; i++)
+		if (checkpointData[i].frameState
+			&& ((findSection(checkpointData[i].name, &size) == NULL) || (size != checkpointData[i].size)))
+			complete = FALSE;
+	// the page tables follow each other in the order of the process table
+	for (unsigned pid = 1; ok && (pid < processCount); pid++)
+	{
+		pageTableEntry_t* pTable = NULL;
+		if (pcbs[pid].pageTable != NULL)
+		{
+			if (pagesSize < pcbs[pid].size * sizeof(pageTableEntry_t)) ok = FALSE;
+			else pTable = slabAlloc(pid, pcbs[pid].size * sizeof(pageTableEntry_t));
+			if (pTable == NULL)
+			{
+				ok = FALSE;
+				break;
+			}
+			memcpy(pTable, pages, pcbs[pid].size * sizeof(pageTableEntry_t));
+			tables[pid] = pages;
+			pages += pcbs[pid].size;
+			pagesSize -= pcbs[pid].size * sizeof(pageTableEntry_t);
+		}
+		processTable[pid] = pcbs[pid];
+		processTable[pid].pageTable = pTable;
+		processTable[pid].liveIndex = NONE;
+		if (!complete && (pTable != NULL))
+			resetPageTable(pid);		// the pages are moved in again by reloadPages()
+	}
+	for (unsigned i = 0; ok && (i < liveSize / sizeof(unsigned)); i++)
+		if ((live[i] < processCount) && (processTable[live[i]].pageTable != NULL))
+			processStarted(live[i]);
+	for (unsigned i = 0; ok && (i < checkpointDataCount); i++)
+	{
+		data = findSection(checkpointData[i].name, &size);
+		if ((data != NULL) && (size == checkpointData[i].size) && (complete || !checkpointData[i].frameState))
+			memcpy(checkpointData[i].data, data, checkpointData[i].size);
+	}
+	if (ok && complete)
+		ok = restoreEmptyFrames(emptyFrames, (unsigned)(emptySize / sizeof(int)));
+	else if (ok)
+		ok = reloadPages(tables);
+	if (ok && !sim_SeekStimulus((long)snapshotHeader->stimulusOffset))
+	{
+		logGeneric("OS-ERROR: Stimulus file does not reach the position of the snapshot");
+		ok = FALSE;
+	}
+	if (ok && logEnabled)
+		printf("%6u : Checkpoint: restored %s, %s\n", systemTime, restoreFileName,
+			complete ? "complete" : "replacement data rebuilt");
+	else if (!ok)
+		logGeneric("OS-ERROR: Snapshot could not be restored");
+	free(tables);
+	releaseSnapshot();
+	return ok;
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+Boolean checkpointSupported(void)
+{
+	if (sim_randomAccess || (smpCpuCount > 1) || (diskLatency > 0) || backingStoreEnabled || zswapEnabled
+		|| numaEnabled || hugePagesEnabled || ownersEnabled)
+	{
+		logGeneric("OS-ERROR: Checkpoints need a stimulus file and are taken on a single CPU without blocking page faults, the backing store, the compressed pool, NUMA, huge pages and the owners");
+		return FALSE;
+	}
+	return TRUE;
+}
+
+void addSection(checkpointSection_t directory[], unsigned* count, const char* name, uint64_t size,
+	Boolean frameState)
+{
+	memset(&directory[*count], 0, sizeof(checkpointSection_t));
+	snprintf(directory[*count].name, CHECKPOINT_NAME_LENGTH, "%s", name);
+	directory[*count].frameState = frameState;
+	directory[*count].size = size;
+	(*count)++;
+}
+
+Boolean writePadding(FILE* file, uint64_t size)
+{
+	static const char zeros[8] = { 0 };
+	size_t padding = (size_t)((8 - size % 8) % 8);
+	return (fwrite(zeros, 1, padding, file) == padding);
+}
+
+const void* findSection(const char* name, uint64_t* size)
+{
+	const checkpointSection_t* directory = (const checkpointSection_t*)(snapshotHeader + 1);
+	for (unsigned i = 0; i < snapshotHeader->sectionCount; i++)
+		if (strcmp(directory[i].name, name) == 0)
+		{
+			*size = directory[i].size;
+			return snapshot + directory[i].offset;
+		}
+	return NULL;
+}
+
+Boolean reloadPages(const pageTableEntry_t* tables[])
+{
+	const frameTableEntry_t* frames;
+	const agingCounter_t* counters = NULL;
+	const unsigned char* referenced;
+	unsigned* keys;
+	int* order;
+	uint64_t size, referencedSize, countersSize = 0;
+	unsigned frameCount, candidates = 0, loaded;
+	frames = findSection("mm.frameTable", &size);
+	referenced = findSection("mm.frameReferenced", &referencedSize);
+	if ((frames == NULL) || (referenced == NULL)) return FALSE;
+	frameCount = (unsigned)(size / sizeof(frameTableEntry_t));
+	if (referencedSize < frameCount) return FALSE;
+	// the aging counters rank the pages, the other algorithms keep them in lists
+	if (((snapshotHeader->policy == agingReplacement) || (snapshotHeader->policy == weightedReplacement))
+		&& (snapshotHeader->agingBits == AGING_COUNTER_BITS))
+		counters = findSection("aging.counter", &countersSize);
+	if (countersSize < frameCount * sizeof(agingCounter_t)) counters = NULL;
+	keys = calloc(frameCount + 1, sizeof(unsigned));
+	order = malloc((frameCount + 1) * sizeof(int));
+	if ((keys == NULL) || (order == NULL))
+	{
+		free(keys);
+		free(order);
+		return FALSE;
+	}
+	for (unsigned frame = 0; frame < frameCount; frame++)
+	{
+		unsigned pid = frames[frame].pid;
+		if (pid == NOPROCESS) continue;
+		if ((frames[frame].sharers > 1) || (pid >= processCount) || (tables[pid] == NULL)
+			|| (frames[frame].page >= processTable[pid].size))
+		{	// a shared frame would have to be mapped into several page tables
+			logGeneric("OS-ERROR: Pages shared after a fork are only restored with the same algorithm and frames");
+			free(keys);
+			free(order);
+			return FALSE;
+		}
+		if (counters != NULL)
+			keys[frame] = (counters[frame] >> 1) | (referenced[frame] ? AGING_TOP_BIT : 0);
+		order[candidates++] = (int)frame;
+	}
+	reloadKeys = keys;
+	qsort(order, candidates, sizeof(int), compareReloadKey);
+	loaded = (candidates < MEMORYSIZE) ? candidates : MEMORYSIZE;
+	// the most valuable pages are moved in last, so they count as used most recently
+	for (unsigned i = loaded; i-- > 0;)
+	{
+		unsigned pid = frames[order[i]].pid, page = frames[order[i]].page;
+		restorePage(pid, page, tables[pid][page].modified);
+	}
+	if (logEnabled)
+		printf("%6u : Checkpoint: %u of %u resident pages moved in again\n", systemTime, loaded, candidates);
+	free(keys);
+	free(order);
+	reloadKeys = NULL;
+	return TRUE;
+}
+
+int compareReloadKey(const void* a, const void* b)
+{
+	int x = *(const int*)a, y = *(const int*)b;
+	if (reloadKeys[x] != reloadKeys[y]) return (reloadKeys[x] > reloadKeys[y]) ? -1 : 1;
+	return (x < y) ? -1 : (x > y);
+}
+
+void releaseSnapshot(void)
+{
+	if (snapshot != NULL) hostUnmapFile(snapshot, snapshotBytes);
+	snapshot = NULL;
+	snapshotHeader = NULL;
+	snapshotBytes = 0;
+}
@@ -0,0 +1,107 @@
+/* Include-file defining the checkpoints of the simulation: a snapshot of	*/
+/* the OS and the simulation at a point of the stimulus, from which later	*/
+/* runs continue instead of replaying the warm-up phase again.				*/
+/* A snapshot holds the process table, the page tables, the list of the		*/
+/* live processes, the empty frames, systemTime, the position in the		*/
+/* stimulus file and the data the modules registered with					*/
+/* checkpointRegister(): the frame table, the R-bits, the data of the		*/
+/* replacement algorithms and the counters of the statistics.				*/
+/* The format is the memory layout of the host, so that a snapshot is used	*/
+/* in place after mapping it into memory: a header, a directory of the		*/
+/* sections and the sections, each starting at a multiple of 8 bytes.		*/
+/* A snapshot is restored completely if the run uses the same replacement	*/
+/* algorithm and number of frames (MEMORYSIZE), the simulation continues	*/
+/* exactly as the run that wrote it. Else the data of the replacement is	*/
+/* rebuilt: the pages resident in the snapshot are moved into the frames	*/
+/* again, the least valuable first, as far as the frames suffice. With the	*/
+/* aging algorithms the value of a page is its counter, else all pages are	*/
+/* equal. Pages shared after a fork cannot be rebuilt.						*/
+/* A run restoring a snapshot may fork variants: each of them continues		*/
+/* with its own replacement algorithm in a child process, in parallel, and	*/
+/* the output of the variants is printed one after the other at the end.	*/
+/* Checkpoints are taken by the main loop on a single CPU without blocking	*/
+/* page faults, the backing store, the compressed pool, NUMA, huge pages	*/
+/* and owners.																*/
+#ifndef __CHECKPOINT__
+#define __CHECKPOINT__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bs_types.h"
+
+#define CHECKPOINT_MAGIC "PRSNAP1"		// first bytes of a snapshot
+#define CHECKPOINT_VERSION 1
+#define CHECKPOINT_NAME_LENGTH 24		// length of the name of a section, 0 included
+#define CHECKPOINT_SECTIONS_MAX 48		// sections registered by the modules
+#define CHECKPOINT_VARIANTS_MAX 8		// variants forked from one snapshot
+
+/* header at the start of a snapshot										*/
+typedef struct checkpointHeader_struct
+{
+	char magic[8];					// CHECKPOINT_MAGIC
+	uint32_t version;				// CHECKPOINT_VERSION
+	uint32_t memorySize;			// MEMORYSIZE of the run that wrote it
+	uint32_t policy;				// replacementPolicy_t of that run
+	uint32_t agingBits;				// AGING_COUNTER_BITS of that run
+	uint32_t pcbSize;				// sizeof(PCB_t), the layout of the host
+	uint32_t entrySize;				// sizeof(pageTableEntry_t)
+	uint32_t systemTime;
+	uint32_t processCount;			// entries of the process table, index 0 included
+	uint32_t sectionCount;			// entries of the directory following the header
+	uint32_t reserved;
+	uint64_t stimulusOffset;		// position of the next line in the stimulus file
+	uint64_t fileSize;				// length of the snapshot in bytes
+} checkpointHeader_t;
+
+/* entry of the directory of the sections									*/
+typedef struct checkpointSection_struct
+{
+	char name[CHECKPOINT_NAME_LENGTH];
+	uint32_t frameState;			// depends on the frames and the replacement algorithm
+	uint32_t reserved;
+	uint64_t offset;				// from the start of the snapshot
+	uint64_t size;					// in bytes
+} checkpointSection_t;
+
+extern char checkpointFileName[];			// snapshot to write, empty: none
+extern unsigned checkpointTime;				// it is written before the first event at this time
+extern Boolean checkpointPending;			// the snapshot is still to be written
+extern char restoreFileName[];				// snapshot to continue from, empty: start at time 0
+extern unsigned checkpointVariantCount;		// variants forked after restoring, 0: none
+
+Boolean setCheckpoint(const char* spec);
+/* sets the time and the snapshot to write from a string of the form		*/
+/* <time>,<file>. Returns FALSE on syntax errors							*/
+
+Boolean setCheckpointVariants(const char* spec);
+/* sets the replacement algorithms of the variants from a list of their		*/
+/* names separated by commas, e.g. "aging,arc". Returns FALSE on unknown	*/
+/* names or more than CHECKPOINT_VARIANTS_MAX variants						*/
+
+Boolean checkpointRegister(const char* name, void* data, size_t size, Boolean frameState);
+/* adds data of a module to the snapshots, a name registered before is		*/
+/* replaced. frameState is TRUE if the data depends on the frames or on		*/
+/* the replacement algorithm, it is then only restored completely.			*/
+/* Returns FALSE if too many sections are registered						*/
+
+Boolean checkpointWrite(long stimulusOffset);
+/* writes the snapshot to checkpointFileName and clears checkpointPending.	*/
+/* Called by the main loop before it runs the first event due at			*/
+/* checkpointTime, the next line of the stimulus starts at the given		*/
+/* position. Returns FALSE on errors										*/
+
+Boolean checkpointOpen(void);
+/* maps the snapshot restoreFileName into memory and checks its header.		*/
+/* Returns FALSE if it cannot be read or was written by another build		*/
+
+int checkpointForkVariants(void);
+/* starts the variants in child processes and returns the number of the		*/
+/* variant in each child, with replacementPolicy set. The parent waits for	*/
+/* all of them, prints their output and returns -1							*/
+
+Boolean checkpointRestore(void);
+/* restores the opened snapshot after the process file was read and			*/
+/* continues the stimulus where it was written, then releases the mapping.	*/
+/* Returns FALSE if it does not fit the process file or the options			*/
+
+#endif  /* __CHECKPOINT__ */
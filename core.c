@@ -6,6 +6,7 @@
 /* Include required external definitions */
 #include <math.h>
 #include <time.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -18,31 +19,169 @@
 /* Declarations of global variables visible only in this file 		*/
 
 PCB_t process;		// the only user process used for batch and FCFS
-unsigned emptyFrameCounter;		// number of empty Frames 
+extern unsigned emptyFrameCounter;	// number of empty Frames, owned by the memory manager
+
+/* the events executed by one simulated CPU, their actions are stored in	*/
+/* one array per CPU														*/
+typedef struct cpuEvent_struct
+{
+	unsigned time;
+	bsPid_t pid;
+	unsigned firstAction;		// index of the first action in cpuStream_t.actions
+	unsigned actionCount;
+} cpuEvent_t;
+
+typedef struct cpuStream_struct
+{
+	cpuEvent_t* events;
+	unsigned eventCount;
+	unsigned eventCapacity;
+	action_t* actions;
+	unsigned actionCount;
+	unsigned actionCapacity;
+	unsigned long long accesses;	// read and write actions executed
+	Boolean error;					// an access failed, the CPU stopped
+} cpuStream_t;
+
+cpuStream_t cpuStreams[SMP_MAX_CPUS];
+unsigned multiCPUTick = 0;				// number of the last timer tick processed
+smpLock_t timerLock;					// protects the barrier and the timer
+unsigned cpuNextTime[SMP_MAX_CPUS];		// time of the next event of each CPU at the barrier, UINT_MAX: none
+unsigned cpuWaiting = 0;				// CPUs at the barrier
+unsigned cpuFinished = 0;				// CPUs without events left
+unsigned multiCPUPeriod = 0;			// incremented as the CPUs leave the barrier
+unsigned long long multiCPUBarriers = 0;	// periods ended at the barrier
+double multiCPUSeconds = 0.0;
+unsigned long long multiCPUAccesses = 0;
+
+/* an event of a process that cannot run at its time in the stimulus, as	*/
+/* the process is blocked or still executes earlier events. Only the		*/
+/* actions of the event are allocated, not MAX_EVENT_ACTIONS of them		*/
+typedef struct deferredEvent_struct
+{
+	struct deferredEvent_struct* next;
+	memoryEvent_t event;			// must be the last member
+} deferredEvent_t;
+
+// the arrays grow with the process table, see registerProcessArray()
+deferredEvent_t** deferredHead = NULL;	// events waiting for each process, oldest first
+deferredEvent_t** deferredTail = NULL;
+unsigned* deferredPids = NULL;			// processes with waiting events, in no particular order
+unsigned deferredCount = 0;				// number of processes with waiting events
+unsigned deferredEvents = 0;			// number of waiting events, see DEFERRED_EVENTS_MAX
+unsigned long long* processDelay = NULL;	// time each process lags behind the stimulus
+unsigned liveProcesses = 0;				// processes started and not yet terminated
+unsigned blockedProcesses = 0;			// processes waiting for a page read
+unsigned long long ioStallTime = 0;		// time all live processes were blocked
+unsigned stimulusEnd = 0;				// time of the last event in the stimulus
+unsigned long long decompressTime = 0;	// time charged for page faults served from the compressed pool
+unsigned long long accessesCompleted = 0;	// memory accesses executed by the loop with blocking page faults
+// the access each process of the generated workload faulted on, repeated when
+// its page read completed, grows with the process table
+action_t* faultedAccess = NULL;
+Boolean* faultPending = NULL;
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+Boolean appendCpuEvent(cpuStream_t* stream, const memoryEvent_t* event);
+/* appends the event to the stream of a CPU, returns FALSE if out of memory	*/
+
+void cpuMain(unsigned cpu);
+/* executes the stream of events of the CPU, runs on a thread of its own	*/
+
+unsigned waitForPeriod(unsigned cpu, unsigned time);
+/* waits at the barrier at the end of the timer period until the period of	*/
+/* the event at the given time begins, returns the number of that period.	*/
+/* The last CPU to arrive runs the timer events while the others wait		*/
+
+void finishCpu(unsigned cpu);
+/* removes the CPU from the barrier as it has no events left				*/
+
+void endPeriod(void);
+/* runs the timer events up to the period of the earliest next event of		*/
+/* the CPUs at the barrier and releases them, the caller holds timerLock	*/
+
+void advanceSystemTime(unsigned time);
+/* sets systemTime to the given time, running the timer events due before	*/
+
+Boolean deferEvent(const memoryEvent_t* event, unsigned firstAction);
+/* appends the actions of the event from firstAction on to the events		*/
+/* waiting for its process. Returns FALSE if out of memory					*/
+
+Boolean waitsForFork(const memoryEvent_t* event);
+/* predicate: the event belongs to a child not yet forked by its parent,	*/
+/* which may lag behind the stimulus										*/
+
+Boolean mayRun(unsigned pid);
+/* predicate: the process neither waits for a page read nor is suspended	*/
+/* by the load control														*/
+
+Boolean timeOverflows(unsigned long long time);
+/* predicate: the time is beyond the range of systemTime, logs the error	*/
+/* The delays of the blocking page faults are added up in 64 bits and		*/
+/* checked before they become the systemTime								*/
+
+int runEventBlockingIO(memoryEvent_t* event);
+/* executes the actions of the event in their order up to the first access	*/
+/* that causes a page fault not served from the compressed pool.			*/
+/* Returns the index of that action, actionCount							*/
+/* if all actions were executed and NONE on an unrecoverable error			*/
 
 /* ---------------------------------------------------------------- */
 /*                Externally available functions                    */
 /* ---------------------------------------------------------------- */
 
-void initOS(void)
+Boolean initOS(void)
 {
 	systemTime = 0;						// reset the system time to zero
 	initProcessTable();					// create the process table with empty PCBs
 	srand( (unsigned)time( NULL ) );	// init the random number generator
 	/* init the status of the OS */
+	slabInit();							// allocator of the page tables and other OS data
 	initMemoryManager();				// initialise the memory management system 
+	if (!decisionLogOpen(decisionLogFileName, MEMORYSIZE))	// record replacement decisions if requested
+	{	// the log of the run would be missing silently
+		printf("Decision log %s could not be created\n", decisionLogFileName);
+		return FALSE;
+	}
+	if (!backingStoreOpen(backingStoreFileName, MEMORYSIZE))	// real page contents and swap file if requested
+	{	// the run would not simulate the page contents that were requested
+		printf("Backing store %s could not be created\n", backingStoreFileName);
+		return FALSE;
+	}
+	zswapOpen(zswapPoolSize);			// compressed swap tier if requested
+	if (!latencyOpen())					// latency histograms and timeline if requested
+	{
+		if (latencyTraceFileName[0] != '\0')
+			printf("Timeline %s could not be created\n", latencyTraceFileName);
+		else
+			printf("Latency histograms could not be created\n");
+		return FALSE;
+	}
+	profileOpen();						// hardware counters of the main loop if requested
+	return TRUE;
 }
 
 void shutdownOS(void)
 {
 	shutdownMemoryManager();			// make sure allocated memory of the OS is freed
-	// check the process table for not cleared PCBs
-	for (int i = 0; i <= MAX_PROCESSES; i++) {
-		if (processTable[i].pageTable != NULL) {
+	if (!decisionLogClose())
+		logGeneric("OS-ERROR: Decision log could not be written completely");
+	if (!backingStoreClose())
+		logGeneric("OS-ERROR: Backing store reported I/O or checksum errors");
+	zswapClose();
+	if (!latencyClose())
+		logGeneric("OS-ERROR: Timeline could not be written completely");
+	profileClose();
+	// check the live processes for not cleared PCBs
+	for (unsigned i = 0; i < liveProcessCount; i++) {
+		if (processTable[liveProcessList[i]].pageTable != NULL) {
 			// Threre resides a pagetable that was not clearly de-allocated. Report Error
-			logPid(i, "OS-ERROR: Pagetable not cleared up properly for this process");
+			logPid(liveProcessList[i], "OS-ERROR: Pagetable not cleared up properly for this process");
 		}
 	}
+	slabShutdown();
 }
 
 Boolean coreLoop(void)
@@ -54,52 +193,744 @@ Boolean coreLoop(void)
 	memoryEvent_t memoryEvent;			// action relevant to memory management
 	memoryEvent_t *pMemoryEvent = NULL;	// pointer to that memory management event
 	int frame = INT_MAX;				// physical address, neg. value indicate unrecoverable error
+	int frames[MAX_EVENT_ACTIONS];		// physical addresses of a list of memory accesses
+	action_t* pAction = NULL;			// the action of the event currently processed
+	unsigned accessCount, resolved;		// length of a list of memory accesses, resolved part of it
+	long offset = -1;					// position of the event in the stimulus file, for a checkpoint
 
+	if (profileEnabled) profileEnter(profileOther);
 	do {	// loop until batch is complete
+		if (checkpointPending) offset = sim_StimulusOffset();
+		if (profileEnabled) profileEnter(profileParse);
 		pMemoryEvent = sim_ReadNextEvent(&memoryEvent);
-		if (pMemoryEvent == NULL) break;			// on error exit the simulation loop 
+		if (profileEnabled) profileLeave();
+		if (pMemoryEvent == NULL)
+		{	// end of the stimulus
+			batchCompleted = TRUE;
+			break;
+		}
+		// the snapshot holds the state before the first event due at the checkpoint
+		if (checkpointPending && (pMemoryEvent->time >= checkpointTime)) checkpointWrite(offset);
 		// advance time and run timer event handler if needed
-		for (unsigned i = (systemTime / TIMER_INTERVAL); i < (pMemoryEvent->time / TIMER_INTERVAL); i++)
+		advanceSystemTime(pMemoryEvent->time);
+		
+		// process the list of actions that is due now, in the given order
+		for (unsigned i = 0; (i < pMemoryEvent->actionCount) && (frame >= 0); i++)
 		{
-			systemTime = (i+1) * TIMER_INTERVAL;  
-			timerEventHandler();
+			pAction = &pMemoryEvent->action[i];
+			switch (pAction->op)
+			{
+			case start: 
+				// required improvement: only start process if a minimum number of free frames exist
+				//						 use getEmptyFrameCount() to check this.
+				logPid(pMemoryEvent->pid, "Started");
+				// set-up the pagetable, using demand-paging results in no allocated frames
+				createPageTable(pMemoryEvent->pid);
+				// for advanced memory management:	allocate an initial number of frames for the process and 
+				//									check if a minimum number of frames can be used
+				break;
+			case end:
+				logPid(pMemoryEvent->pid, "Terminated");
+				// free all frames used by the process
+				deAllocateProcess(pMemoryEvent->pid);
+				break;
+			case forkAction:
+				// the child starts with the pages of the process, shared copy-on-write
+				if (!forkProcess(pMemoryEvent->pid, pAction->page)) frame = NONE;
+				break;
+			case read: 
+			case write:
+				// collect all directly following memory accesses, they are resolved in one call
+				accessCount = 1;
+				while ((i + accessCount < pMemoryEvent->actionCount) && 
+					((pAction[accessCount].op == read) || (pAction[accessCount].op == write)))
+					accessCount++;
+				if (profileEnabled && logEnabled) profileEnter(profileLogging);
+				for (unsigned j = 0; j < accessCount; j++)
+					logPidMemAccess(pMemoryEvent->pid, pAction[j]);
+				if (profileEnabled && logEnabled) profileLeave();
+				if (profileEnabled) profileEnter(profileAccess);
+				// resolve the location of the pages in physical memory, this is the key function for memory management
+				resolved = accessPages(pMemoryEvent->pid, pAction, accessCount, frames);
+				// update memory mapping for simulation
+				for (unsigned j = 0; j < resolved; j++)
+					sim_UpdateMemoryMapping(pMemoryEvent->pid, pAction[j], frames[j]);
+				if (profileEnabled) profileLeave();
+				if (profileEnabled && logEnabled) profileEnter(profileLogging);
+				for (unsigned j = 0; j < resolved; j++)
+					logPidMemPhysical(pMemoryEvent->pid, pAction[j].page, frames[j]);
+				if (profileEnabled && logEnabled) profileLeave();
+				if (resolved < accessCount) frame = frames[resolved];	// error: negative frame
+				i += accessCount - 1;
+				break;
+			default:
+			case error:
+				logPid(pMemoryEvent->pid, "ERROR in action coding");
+				break;
+			}
 		}
-		systemTime = pMemoryEvent->time;	// set new system time according to next event
-		
-		// process the event that is due now
-		switch (pMemoryEvent->action.op)
+		if (frame <0)	break;				// on error exit the simulation loop 
+		if (profileEnabled && logEnabled) profileEnter(profileLogging);
+		logMemoryMapping();			
+		if (profileEnabled && logEnabled) profileLeave();
+	} while (!batchCompleted && !simError);
+	if (profileEnabled) profileLeave();
+	if (checkpointPending) logGeneric("OS-ERROR: Stimulus ended before the time of the checkpoint");
+	return batchCompleted; 
+}
+
+Boolean coreLoopBlockingIO(void)
+{
+	memoryEvent_t memoryEvent;			// next event of the stimulus
+	memoryEvent_t* pMemoryEvent = NULL;	// pointer to that event, NULL at the end of the stimulus
+	memoryEvent_t* pRunEvent;			// event executed next
+	diskRequest_t request;				// page read completing first
+	Boolean completing;					// the next step completes a page read
+	Boolean ok = TRUE;
+	unsigned pid, page, completion;
+	unsigned long long time;			// time of the next step, event times plus the delay of their process
+	int blockedAt;						// action of pRunEvent that caused a page fault
+	if (sim_randomAccess)
+	{
+		logGeneric("OS-ERROR: Blocking page faults need a stimulus file");
+		return FALSE;
+	}
+	if (!registerProcessArray((void**)&deferredHead, sizeof(deferredEvent_t*))
+		|| !registerProcessArray((void**)&deferredTail, sizeof(deferredEvent_t*))
+		|| !registerProcessArray((void**)&deferredPids, sizeof(unsigned))
+		|| !registerProcessArray((void**)&processDelay, sizeof(unsigned long long)))
+	{
+		logGeneric("OS-ERROR: Not enough memory for the waiting events");
+		return FALSE;
+	}
+	deferredCount = deferredEvents = liveProcesses = blockedProcesses = 0;
+	ioStallTime = decompressTime = accessesCompleted = 0;
+	diskInit();
+	loadControlInit();
+	pMemoryEvent = sim_ReadNextEvent(&memoryEvent);
+	while (ok)
+	{
+		// the next step is the earliest of the next completed page read, the
+		// next waiting event of a ready process and the next stimulus event
+		completing = diskNextCompletion(&request);
+		time = completing ? request.completion : ULLONG_MAX;
+		pRunEvent = NULL;
+		// only the processes with waiting events are visited, of those due at
+		// the same time the first in the process table runs first
+		for (unsigned i = 0; i < deferredCount; i++)
+		{
+			pid = deferredPids[i];
+			if (mayRun(pid) && !waitsForFork(&deferredHead[pid]->event)
+				&& ((deferredHead[pid]->event.time + processDelay[pid] < time)
+					|| ((deferredHead[pid]->event.time + processDelay[pid] == time) && (pRunEvent != NULL)
+						&& (pid < pRunEvent->pid))))
+			{
+				time = deferredHead[pid]->event.time + processDelay[pid];
+				pRunEvent = &deferredHead[pid]->event;
+				completing = FALSE;
+			}
+		}
+		// an event of a process lagging behind the stimulus waits for its
+		// process, the stimulus is read ahead until the next step is found
+		while ((pMemoryEvent != NULL) && (pMemoryEvent->time <= time))
+		{
+			pid = pMemoryEvent->pid;
+			stimulusEnd = pMemoryEvent->time;
+			if ((deferredHead[pid] == NULL) && (processDelay[pid] == 0) && mayRun(pid) && !waitsForFork(pMemoryEvent))
+			{
+				time = pMemoryEvent->time;
+				pRunEvent = pMemoryEvent;
+				completing = FALSE;
+				break;
+			}
+			if ((deferredEvents >= DEFERRED_EVENTS_MAX) && (completing || (pRunEvent != NULL)))
+				break;		// the stimulus waits for the step found so far
+			ok = deferEvent(pMemoryEvent, 0);
+			if (mayRun(pid) && !waitsForFork(pMemoryEvent)
+				&& (pMemoryEvent->time + processDelay[pid] < time))
+			{
+				time = pMemoryEvent->time + processDelay[pid];
+				pRunEvent = &deferredTail[pid]->event;
+				completing = FALSE;
+			}
+			pMemoryEvent = sim_ReadNextEvent(&memoryEvent);
+		}
+		if (ok && !completing && (pRunEvent == NULL) && loadControlResumeNext())
+			continue;						// only suspended processes have events left
+		if (!ok || (!completing && (pRunEvent == NULL))) break;	// out of memory or all done
+		if (timeOverflows(time))
+		{
+			ok = FALSE;
+			break;
+		}
+		if (time < systemTime) time = systemTime;
+		// all live processes waited for the disk or were suspended since the last step
+		if ((liveProcesses > 0) && (blockedProcesses + loadControlSuspended == liveProcesses))
+			ioStallTime += time - systemTime;
+		advanceSystemTime((unsigned)time);
+		if (!completing && !mayRun(pRunEvent->pid))
+		{	// suspended by the load control at a timer event before this step
+			if (pRunEvent == pMemoryEvent)
+			{
+				ok = deferEvent(pMemoryEvent, 0);
+				pMemoryEvent = sim_ReadNextEvent(&memoryEvent);
+			}
+			continue;
+		}
+		if (completing)
+		{	// the page is read: the process is ready, its fault completes when it runs
+			diskComplete();
+			processDelay[request.pid] += request.completion - request.submitted;
+			classFaultLatency(request.pid, request.completion - request.submitted);
+			if (latencyEnabled)		// the rest of the event waiting starts with the faulting access
+				latencyFaultServed(request.pid, deferredHead[request.pid]->event.action[0].op, request.submitted,
+					request.completion, FALSE);
+			if (processTable[request.pid].status == suspended)
+			{	// suspended while waiting, it is ready when resumed
+				loadControlReadCompleted(request.pid);
+				logPid(request.pid, "Page read completed, stays suspended");
+				continue;
+			}
+			processTable[request.pid].status = ready;
+			blockedProcesses--;
+			logPid(request.pid, "Page read completed, ready");
+			continue;
+		}
+		pid = pRunEvent->pid;
+		blockedAt = runEventBlockingIO(pRunEvent);
+		if (blockedAt < 0) break;			// unrecoverable error
+		if ((unsigned)blockedAt < pRunEvent->actionCount)
+		{	// page fault: the rest of the event waits for the page read
+			page = pRunEvent->action[blockedAt].page;
+			if (pRunEvent == pMemoryEvent)
+				ok = deferEvent(pMemoryEvent, (unsigned)blockedAt);
+			else
+			{
+				pRunEvent->actionCount -= (unsigned)blockedAt;
+				memmove(pRunEvent->action, &pRunEvent->action[blockedAt], pRunEvent->actionCount * sizeof(action_t));
+			}
+			if (!ok || !diskSubmit(systemTime, pid, page, &completion))
+			{
+				logPid(pid, "OS-ERROR: Page read could not be submitted, the disk queue is full or the time overflows");
+				break;
+			}
+			processTable[pid].status = blocked;
+			processTable[pid].simInfo.IOready = completion;
+			blockedProcesses++;
+			if (logEnabled)
+				printf("%6u : PID %3u : Blocked, reading page %u, ready at %u\n", systemTime, processTable[pid].pid,
+					page, completion);
+		}
+		else if (pRunEvent != pMemoryEvent)
+		{	// the waiting event is done
+			deferredEvent_t* pDone = deferredHead[pid];
+			deferredHead[pid] = pDone->next;
+			if (deferredHead[pid] == NULL)
+			{
+				deferredTail[pid] = NULL;
+				for (unsigned i = 0; i < deferredCount; i++)
+					if (deferredPids[i] == pid)
+					{
+						deferredPids[i] = deferredPids[--deferredCount];
+						break;
+					}
+			}
+			slabFree(pDone);
+			deferredEvents--;
+		}
+		if (pRunEvent == pMemoryEvent)
+			pMemoryEvent = sim_ReadNextEvent(&memoryEvent);
+		logMemoryMapping();
+	}
+	// events left after an error
+	for (unsigned i = 0; i < deferredCount; i++)
+		for (pid = deferredPids[i]; deferredHead[pid] != NULL; )
+		{
+			deferredEvent_t* pDone = deferredHead[pid];
+			deferredHead[pid] = pDone->next;
+			slabFree(pDone);
+			deferredEvents--;
+		}
+	return ok && (pMemoryEvent == NULL) && (diskPending() == 0);
+}
+
+void printBlockingIOStatistics(void)
+{
+	diskStatistics_t stats;
+	diskGetStatistics(&stats);
+	printf("Blocking page faults (disk latency %u, queue depth %u)\n", diskLatency, diskQueueDepth);
+	printf("%-28s %15llu\n", "page reads", stats.reads);
+	printf("%-28s %15.1f\n", "avg. read time", (stats.reads > 0) ? (double)stats.readTime / stats.reads : 0.0);
+	printf("%-28s %15.1f\n", "avg. wait for the disk", (stats.reads > 0) ? (double)stats.queueTime / stats.reads : 0.0);
+	printf("%-28s %15u\n", "max. pending reads", stats.maxPending);
+	printf("%-28s %15llu\n", "blocked time", stats.readTime);
+	printf("%-28s %15llu\n", "stall time (all blocked)", ioStallTime);
+	if (zswapEnabled) printf("%-28s %15llu\n", "decompression time", decompressTime);
+	printf("%-28s %14.1f%%\n", "blocked time overlapped",
+		(stats.readTime > 0) ? 100.0 * (1.0 - (double)ioStallTime / stats.readTime) : 100.0);
+	printf("%-28s %15u\n", "end of the stimulus", stimulusEnd);
+	printf("%-28s %15u\n", "end of the run", systemTime);
+	printf("%-28s %15llu\n", "accesses completed", accessesCompleted);
+	printf("%-28s %15.3f\n", "accesses per time unit", (systemTime > 0) ? (double)accessesCompleted / systemTime : 0.0);
+}
+
+Boolean coreLoopScheduled(void)
+{
+	diskRequest_t request;				// page read completing first
+	action_t action;					// action the running process performs next
+	unsigned pid, used, completion;
+	int frame;
+	Boolean retry;						// the access faulted before, its page was read
+	Boolean ok = TRUE;
+	if (!registerProcessArray((void**)&faultedAccess, sizeof(action_t))
+		|| !registerProcessArray((void**)&faultPending, sizeof(Boolean))
+		|| !workloadInit())
+	{
+		logGeneric("OS-ERROR: Not enough memory for the generated workload");
+		return FALSE;
+	}
+	schedInit();
+	diskInit();
+	for (unsigned i = 1; i < processCount; i++)
+		schedReady(i);
+	while (ok)
+	{
+		// the completed page reads make their processes ready
+		while (diskNextCompletion(&request) && (request.completion <= systemTime))
+		{
+			diskComplete();
+			processTable[request.pid].status = ready;
+			classFaultLatency(request.pid, request.completion - request.submitted);
+			if (latencyEnabled)
+				latencyFaultServed(request.pid, faultedAccess[request.pid].op, request.submitted, request.completion,
+					FALSE);
+			schedReady(request.pid);
+			logPid(request.pid, "Page read completed, ready");
+		}
+		pid = schedNext();
+		if (pid == NOPROCESS)
+		{	// all processes wait for the disk, the CPU idles
+			if (!diskNextCompletion(&request)) break;	// all processes completed
+			schedIdle(request.completion - systemTime);
+			advanceSystemTime(request.completion);
+			continue;
+		}
+		// the process runs until its quantum is over, it blocks or it ends
+		processTable[pid].status = running;
+		for (used = 0; ok && (used < schedulingQuantum); )
+		{
+			retry = faultPending[pid];
+			if (retry)
+			{	// the page was read, the page fault is handled now
+				faultPending[pid] = FALSE;
+				action = faultedAccess[pid];
+			}
+			else
+				action = workloadResume(pid);
+			if (action.op == start)
+			{
+				logPid(pid, "Started");
+				ok = createPageTable(pid);
+				continue;
+			}
+			if (action.op == end)
+			{
+				logPid(pid, "Terminated");
+				deAllocateProcess(pid);
+				processTable[pid].status = ended;
+				schedLeave(pid, completed, used);
+				classReleased(pid);
+				if (latencyEnabled) latencyReleased(pid);
+				releaseProcess(pid);
+				// the next process of the workload takes the released entry
+				if ((pid = workloadSpawn()) != NOPROCESS) schedReady(pid);
+				break;
+			}
+			if ((action.op != read) && (action.op != write))
+			{
+				logPid(pid, "ERROR in action coding");
+				ok = FALSE;
+				break;
+			}
+			if (!retry && isPageFault(pid, action.page))
+			{
+				if (zswapHolds(pid, action.page))
+				{	// decompressed from the pool on the CPU of the process
+					used += zswapDecompressCost;
+					decompressTime += zswapDecompressCost;
+					classFaultLatency(pid, zswapDecompressCost);
+					if (timeOverflows((unsigned long long)systemTime + zswapDecompressCost))
+					{
+						ok = FALSE;
+						break;
+					}
+					if (latencyEnabled)
+						latencyFaultServed(pid, action.op, systemTime, systemTime + zswapDecompressCost, TRUE);
+					advanceSystemTime(systemTime + zswapDecompressCost);
+				}
+				else
+				{	// the process blocks until its page is read
+					if (!diskSubmit(systemTime, pid, action.page, &completion))
+					{
+						logPid(pid, "OS-ERROR: Page read could not be submitted, the disk queue is full or the time overflows");
+						ok = FALSE;
+						break;
+					}
+					faultedAccess[pid] = action;
+					faultPending[pid] = TRUE;
+					processTable[pid].status = blocked;
+					if (logEnabled)
+						printf("%6u : PID %3u : Blocked, reading page %u, ready at %u\n", systemTime,
+							processTable[pid].pid, action.page, completion);
+					schedLeave(pid, io, used);
+					break;
+				}
+			}
+			logPidMemAccess(pid, action);
+			frame = accessPage(pid, action);
+			if (frame < 0)
+			{
+				ok = FALSE;
+				break;
+			}
+			logPidMemPhysical(pid, action.page, frame);
+			accessesCompleted++;
+			used++;
+			if (timeOverflows((unsigned long long)systemTime + 1))
+			{
+				ok = FALSE;
+				break;
+			}
+			advanceSystemTime(systemTime + 1);
+		}
+		if (ok && (used >= schedulingQuantum) && (processTable[pid].status == running))
+		{	// the quantum is over, the process waits at the end of its queue
+			processTable[pid].status = ready;
+			schedLeave(pid, quantumOver, used);
+			schedReady(pid);
+		}
+		logMemoryMapping();
+	}
+	return ok && (workloadStarted() == workloadProcesses) && (diskPending() == 0);
+}
+
+Boolean coreLoopMultiCPU(void)
+{
+	memoryEvent_t memoryEvent;			// event read from the stimulus
+	smpThread_t threads[SMP_MAX_CPUS];
+	unsigned started = 0;				// number of threads running
+	Boolean ok = TRUE;
+	double t0;
+	if (sim_randomAccess)
+	{
+		logGeneric("OS-ERROR: Several CPUs need a stimulus file");
+		return FALSE;
+	}
+	// split the stimulus into the streams of the CPUs
+	for (unsigned cpu = 0; cpu < smpCpuCount; cpu++)
+		memset(&cpuStreams[cpu], 0, sizeof(cpuStream_t));
+	while (ok && (sim_ReadNextEvent(&memoryEvent) != NULL))
+		ok = appendCpuEvent(&cpuStreams[memoryEvent.pid % smpCpuCount], &memoryEvent);
+	if (!ok) logGeneric("OS-ERROR: Not enough memory for the event streams");
+	// the CPUs log concurrently, the output would be unreadable
+	logGeneric("Running the stimulus on several CPUs, console log switched off");
+	logEnabled = FALSE;
+	multiCPUTick = systemTime / TIMER_INTERVAL;
+	smpLockInit(&timerLock);
+	for (unsigned cpu = 0; cpu < smpCpuCount; cpu++)
+		cpuNextTime[cpu] = UINT_MAX;
+	cpuWaiting = cpuFinished = 0;
+	multiCPUBarriers = 0;
+	t0 = smpWallClock();
+	for (; ok && (started < smpCpuCount); started++)
+		ok = smpThreadStart(&threads[started], cpuMain, started);
+	if (!ok) started--;
+	for (unsigned cpu = started; cpu < smpCpuCount; cpu++)
+	{	// no thread: the events of the CPU are not run, the others must not wait for them
+		logGeneric("OS-ERROR: Cannot start the thread of a CPU");
+		cpuStreams[cpu].error = TRUE;
+		finishCpu(cpu);
+	}
+	for (unsigned cpu = 0; cpu < started; cpu++)
+		smpThreadJoin(threads[cpu]);
+	multiCPUSeconds = smpWallClock() - t0;
+	multiCPUAccesses = 0;
+	for (unsigned cpu = 0; cpu < smpCpuCount; cpu++)
+	{
+		multiCPUAccesses += cpuStreams[cpu].accesses;
+		if (cpuStreams[cpu].error) ok = FALSE;
+		free(cpuStreams[cpu].events);
+		free(cpuStreams[cpu].actions);
+	}
+	return ok;
+}
+
+void printMultiCPUStatistics(void)
+{
+	printf("%u CPUs: %llu memory accesses in %.3f s, %.0f accesses/s, %llu timer barriers\n", smpCpuCount,
+		multiCPUAccesses, multiCPUSeconds, (multiCPUSeconds > 0) ? multiCPUAccesses / multiCPUSeconds : 0.0,
+		multiCPUBarriers);
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+Boolean appendCpuEvent(cpuStream_t* stream, const memoryEvent_t* event)
+{
+	void* grown;
+	if (stream->eventCount == stream->eventCapacity)
+	{
+		stream->eventCapacity = (stream->eventCapacity > 0) ? 2 * stream->eventCapacity : 1024;
+		grown = realloc(stream->events, stream->eventCapacity * sizeof(cpuEvent_t));
+		if (grown == NULL) return FALSE;
+		stream->events = grown;
+	}
+	while (stream->actionCount + event->actionCount > stream->actionCapacity)
+	{
+		stream->actionCapacity = (stream->actionCapacity > 0) ? 2 * stream->actionCapacity : 1024;
+		grown = realloc(stream->actions, stream->actionCapacity * sizeof(action_t));
+		if (grown == NULL) return FALSE;
+		stream->actions = grown;
+	}
+	stream->events[stream->eventCount].time = event->time;
+	stream->events[stream->eventCount].pid = event->pid;
+	stream->events[stream->eventCount].firstAction = stream->actionCount;
+	stream->events[stream->eventCount].actionCount = event->actionCount;
+	memcpy(&stream->actions[stream->actionCount], event->action, event->actionCount * sizeof(action_t));
+	stream->actionCount += event->actionCount;
+	stream->eventCount++;
+	return TRUE;
+}
+
+void cpuMain(unsigned cpu)
+{
+	cpuStream_t* stream = &cpuStreams[cpu];
+	cpuEvent_t* event;
+	action_t* pAction;
+	unsigned period = multiCPUTick;		// the CPUs meet only at the end of a period
+	int frame;
+	for (unsigned e = 0; (e < stream->eventCount) && !stream->error; e++)
+	{
+		event = &stream->events[e];
+		smpTime = event->time;
+		if (event->time / TIMER_INTERVAL > period) period = waitForPeriod(cpu, event->time);
+		for (unsigned i = 0; i < event->actionCount; i++)
+		{
+			pAction = &stream->actions[event->firstAction + i];
+			switch (pAction->op)
+			{
+			case start:
+				createPageTable(event->pid);
+				break;
+			case end:
+				deAllocateProcess(event->pid);
+				break;
+			case read:
+			case write:
+				// the thread-safe memory manager resolves the page and
+				// updates the memory map before another CPU can evict it
+				frame = accessPage(event->pid, *pAction);
+				if (frame < 0)
+				{
+					stream->error = TRUE;
+					break;
+				}
+				stream->accesses++;
+				break;
+			case forkAction:
+				// the frames shared after a fork are simulated on a single CPU only
+				stream->error = TRUE;
+				break;
+			default:
+				break;
+			}
+		}
+	}
+	finishCpu(cpu);
+}
+
+unsigned waitForPeriod(unsigned cpu, unsigned time)
+{
+	unsigned period, released;
+	smpLock(&timerLock);
+	while (time / TIMER_INTERVAL > multiCPUTick)
+	{	// the events of the CPU in this period are complete
+		cpuNextTime[cpu] = time;
+		released = multiCPUPeriod;
+		if (++cpuWaiting + cpuFinished == smpCpuCount)
+			endPeriod();
+		else
+			do
+			{	// the last CPU to arrive changes multiCPUPeriod under the lock
+				smpUnlock(&timerLock);
+				smpYield();
+				smpLock(&timerLock);
+			} while (multiCPUPeriod == released);
+	}
+	period = multiCPUTick;
+	smpUnlock(&timerLock);
+	return period;
+}
+
+void finishCpu(unsigned cpu)
+{
+	smpLock(&timerLock);
+	cpuFinished++;
+	if ((cpuWaiting > 0) && (cpuWaiting + cpuFinished == smpCpuCount)) endPeriod();
+	smpUnlock(&timerLock);
+}
+
+void endPeriod(void)
+{
+	unsigned earliest = UINT_MAX;
+	for (unsigned cpu = 0; cpu < smpCpuCount; cpu++)
+	{
+		if (cpuNextTime[cpu] < earliest) earliest = cpuNextTime[cpu];
+		cpuNextTime[cpu] = UINT_MAX;
+	}
+	// the periods without events are skipped in one step, the CPUs with
+	// events in later periods arrive at the barrier again
+	systemTime = (earliest / TIMER_INTERVAL) * TIMER_INTERVAL;
+	timerEventHandlerTicks(earliest / TIMER_INTERVAL - multiCPUTick);
+	multiCPUTick = earliest / TIMER_INTERVAL;
+	multiCPUBarriers++;
+	cpuWaiting = 0;
+	multiCPUPeriod++;
+}
+
+void advanceSystemTime(unsigned time)
+{
+	// no memory access happens between the timer events due before the 
+	// given time, so they are processed in one step (idle time skipping)
+	if ((time / TIMER_INTERVAL) > (systemTime / TIMER_INTERVAL))
+	{
+		unsigned ticks = (time / TIMER_INTERVAL) - (systemTime / TIMER_INTERVAL);
+		systemTime = (time / TIMER_INTERVAL) * TIMER_INTERVAL;
+		if (profileEnabled) profileEnter(profileTimer);
+		timerEventHandlerTicks(ticks);
+		if (profileEnabled) profileLeave();
+	}
+	systemTime = time;
+}
+
+Boolean deferEvent(const memoryEvent_t* event, unsigned firstAction)
+{
+	unsigned count = event->actionCount - firstAction;
+	deferredEvent_t* pDeferred = slabAlloc(NOPROCESS,
+		offsetof(deferredEvent_t, event) + offsetof(memoryEvent_t, action) + count * sizeof(action_t));
+	if (pDeferred == NULL)
+	{
+		logGeneric("OS-ERROR: Not enough memory for the waiting events");
+		return FALSE;
+	}
+	pDeferred->next = NULL;
+	pDeferred->event.time = event->time;
+	pDeferred->event.pid = event->pid;
+	pDeferred->event.actionCount = count;
+	memcpy(pDeferred->event.action, &event->action[firstAction], count * sizeof(action_t));
+	if (deferredHead[event->pid] == NULL)
+	{
+		deferredHead[event->pid] = pDeferred;
+		deferredPids[deferredCount++] = event->pid;
+	}
+	else
+		deferredTail[event->pid]->next = pDeferred;
+	deferredTail[event->pid] = pDeferred;
+	deferredEvents++;
+	return TRUE;
+}
+
+Boolean waitsForFork(const memoryEvent_t* event)
+{
+	return (processTable[event->pid].status == init) && (event->action[0].op != start);
+}
+
+Boolean mayRun(unsigned pid)
+{
+	return (processTable[pid].status != blocked) && (processTable[pid].status != suspended);
+}
+
+Boolean timeOverflows(unsigned long long time)
+{
+	if (time <= UINT_MAX) return FALSE;
+	logGeneric("OS-ERROR: The simulated time exceeds the range of systemTime (32 bits)");
+	return TRUE;
+}
+
+int runEventBlockingIO(memoryEvent_t* event)
+{
+	int frames[MAX_EVENT_ACTIONS];		// physical addresses of a list of memory accesses
+	action_t* pAction;
+	unsigned pid = event->pid;
+	unsigned accessCount, resolved;		// length of a list of memory accesses, resolved part of it
+	for (unsigned i = 0; i < event->actionCount; i++)
+	{
+		pAction = &event->action[i];
+		switch (pAction->op)
 		{
-		case start: 
-			// required improvement: only start process if a minimum number of free frames exist
-			//						 use getEmptyFrameCount() to check this.
-			printf("%6u : PID %3u : Started\n", systemTime, pMemoryEvent->pid);
-			// set-up the pagetable, using demand-paging results in no allocated frames
-			createPageTable(pMemoryEvent->pid);
-			// for advanced memory management:	allocate an initial number of frames for the process and 
-			//									check if a minimum number of frames can be used
+		case start:
+			logPid(pid, "Started");
+			createPageTable(pid);
+			processTable[pid].status = running;
+			liveProcesses++;
 			break;
 		case end:
-			printf("%6u : PID %3u : Terminated\n", systemTime, pMemoryEvent->pid);
-			// free all frames used by the process
-			deAllocateProcess(pMemoryEvent->pid);
+			logPid(pid, "Terminated");
+			deAllocateProcess(pid);
+			processTable[pid].status = ended;
+			liveProcesses--;
+			break;
+		case forkAction:
+			if (!forkProcess(pid, pAction->page)) return NONE;
+			// the child runs from the time of the fork, which may lag behind the stimulus
+			processTable[pAction->page].status = running;
+			processDelay[pAction->page] = processDelay[pid];
+			liveProcesses++;
 			break;
-		case read: 
+		case read:
 		case write:
-			// event contains the page in use
-			logPidMemAccess(pMemoryEvent->pid, pMemoryEvent->action);
-			// resolve the location of the page in physical memory, this is the key function for memory management
-			frame = accessPage(pMemoryEvent->pid, pMemoryEvent->action);
-			// update memory mapping for simulation
-			sim_UpdateMemoryMapping(pMemoryEvent->pid, pMemoryEvent->action, frame);
-			logPidMemPhysical(pMemoryEvent->pid, pMemoryEvent->action.page, frame);
+			accessCount = 0;
+			if (processTable[pid].status == ready)
+			{	// woken by the completed page read: the page fault is handled now,
+				// alone, as it may evict a page of the following accesses
+				processTable[pid].status = running;
+				accessCount = 1;
+			}
+			else
+			{	// collect the directly following accesses up to the next page fault
+				while ((i + accessCount < event->actionCount)
+					&& ((pAction[accessCount].op == read) || (pAction[accessCount].op == write))
+					&& !isPageFault(pid, pAction[accessCount].page))
+					accessCount++;
+				if ((accessCount == 0) && zswapHolds(pid, pAction->page))
+				{	// the page is decompressed from the pool without a disk read, the
+					// process lags behind by the time of the decompression
+					accessCount = 1;
+					if (latencyEnabled)
+						latencyFaultServed(pid, pAction->op, systemTime, systemTime + zswapDecompressCost, TRUE);
+					processDelay[pid] += zswapDecompressCost;
+					decompressTime += zswapDecompressCost;
+					classFaultLatency(pid, zswapDecompressCost);
+				}
+			}
+			if (accessCount == 0) return (int)i;	// page fault: the process blocks
+			for (unsigned j = 0; j < accessCount; j++)
+				logPidMemAccess(pid, pAction[j]);
+			resolved = accessPages(pid, pAction, accessCount, frames);
+			for (unsigned j = 0; j < resolved; j++)
+			{
+				sim_UpdateMemoryMapping(pid, pAction[j], frames[j]);
+				logPidMemPhysical(pid, pAction[j].page, frames[j]);
+			}
+			accessesCompleted += resolved;
+			if (resolved < accessCount) return NONE;
+			i += accessCount - 1;
 			break;
 		default:
 		case error:
-			printf("%6u : PID %3u : ERROR in action coding\n", systemTime, pMemoryEvent->pid);
+			logPid(pid, "ERROR in action coding");
 			break;
 		}
-		if (frame <0)	break;				// on error exit the simulation loop 
-		logMemoryMapping();			
-	} while (!batchCompleted && !simError);
-	return batchCompleted; 
+	}
+	return (int)event->actionCount;
 }
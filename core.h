@@ -8,8 +8,9 @@
 
 
 
-void initOS(void);
+Boolean initOS(void);
 /* all initialisation steps are started in this function					*/
+/* Returns FALSE if a file requested by the options cannot be created		*/
 
 void shutdownOS(void);
 /* clear up and de-allocate memory used by the OS							*/
@@ -20,4 +21,50 @@ Boolean coreLoop(void);
 /* returns TRUE if the stimulus was completed without error					*/			
 /* returns FALSE when an error occurres that prevents completion of the sim */
 
+Boolean coreLoopBlockingIO(void);
+/* variant of coreLoop() with blocking page faults: an access to an absent	*/
+/* page submits a read to the simulated disk (see diskqueue.h) and blocks	*/
+/* the process until the read completes. The page fault is handled when the	*/
+/* process runs again, the other processes run meanwhile. The later events	*/
+/* of a process are delayed by the time it was blocked, i.e. the time		*/
+/* between its events in the stimulus is kept as computation time.			*/
+/* returns TRUE if the stimulus was completed without error					*/
+
+void printBlockingIOStatistics(void);
+/* prints the statistics of the page reads of the last coreLoopBlockingIO()	*/
+/* and how much of the time processes were blocked overlapped with the		*/
+/* execution of other processes												*/
+
+Boolean coreLoopScheduled(void);
+/* variant of coreLoop() running the generated workload (see workload.h)	*/
+/* instead of the stimulus file. The scheduler (see scheduler.h) gives the	*/
+/* CPU to the processes, each of them resumes its coroutine for one access	*/
+/* per time unit. A page fault not served from the compressed pool blocks	*/
+/* the process until the simulated disk read it (see diskqueue.h), the		*/
+/* fault is handled when the process runs again. The CPU idles while all	*/
+/* processes wait for the disk.												*/
+/* returns TRUE if the workload was completed without error					*/
+
+Boolean coreLoopMultiCPU(void);
+/* variant of coreLoop() for smpCpuCount simulated CPUs, each running on a	*/
+/* thread of its own. The stimulus is read completely first and split by	*/
+/* process: the events of PID p are executed by CPU p % smpCpuCount in		*/
+/* their order. Within a timer period the CPUs run independently, each		*/
+/* evicting from a shard of the frames with replacement data of its own		*/
+/* first (see initMultiCPU()). They meet only at a barrier at the end of	*/
+/* the period, where the last CPU to arrive runs the timer events. So the	*/
+/* aging counters see the same periods as on a single CPU, but the page		*/
+/* faults depend on the interleaving of the CPUs within a period			*/
+/* The console log is switched off, the throughput of the memory accesses	*/
+/* is stored in multiCPUSeconds/multiCPUAccesses, bench/bench.c reports it	*/
+/* for growing numbers of CPUs												*/
+/* returns TRUE if the stimulus was completed without error					*/
+
+void printMultiCPUStatistics(void);
+/* prints the throughput of the last coreLoopMultiCPU() and the number of	*/
+/* timer periods the CPUs met at the barrier								*/
+
+extern double multiCPUSeconds;				// duration of the last multi-CPU run
+extern unsigned long long multiCPUAccesses;	// memory accesses of the last multi-CPU run
+
 #endif /* __CORE__ */
\ No newline at end of file
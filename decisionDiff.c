@@ -0,0 +1,336 @@
+/* decisionDiff : compares two binary logs of page replacement decisions	*/
+/* written by the OS (see decisionlog.h) and reports the first divergence	*/
+/* and aggregate differences. Both logs are streamed record by record, so	*/
+/* logs of arbitrary size can be compared in constant memory (apart from	*/
+/* the faults of one point in time and the per-process counters).			*/
+/* After the first divergence the runs fault on different pages, so the		*/
+/* faults are aligned by time, PID and page instead of by their position:	*/
+/* faults of both runs are compared, the others are counted per log.		*/
+/*																			*/
+/* usage: decisionDiff <log A> <log B>										*/
+/* Returns 0 if the logs are identical, 1 if they differ, 2 on errors, e.g.	*/
+/* if a log is truncated within a record									*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "bs_types.h"
+#include "global.h"
+#include "decisionlog.h"
+
+#define DIFF_STEP_SIZE 256			// initial room for the faults of one point in time
+
+/* counters of one process in both logs */
+typedef struct pidCounters_struct
+{
+	unsigned pid;
+	unsigned long long faults[2];		// faults of the process in log A and B
+	unsigned long long evictions[2];	// pages of the process chosen as victim
+} pidCounters_t;
+
+/* a fault and its position among the faults of its point in time */
+typedef struct stepFault_struct
+{
+	decisionRecord_t record;
+	unsigned order;
+} stepFault_t;
+
+/* the faults of one log at one point in time, the unit of the alignment */
+typedef struct logStep_struct
+{
+	decisionLogReader_t* reader;
+	unsigned log;					// 0 for log A, 1 for log B
+	decisionRecord_t next;			// first fault of the next point in time
+	Boolean haveNext;				// FALSE at the end of the log
+	stepFault_t* faults;			// faults of the step in the order of the log
+	unsigned count;					// number of faults in the step, 0 at the end of the log
+	unsigned capacity;				// size of faults
+	unsigned long long first;		// number of the first fault of the step in the log
+	unsigned long long records;		// faults read so far
+	unsigned long long evictions;	// faults read so far that required a victim
+} logStep_t;
+
+/* counters of the processes, found by the hash of their PID */
+pidCounters_t* pidCounters = NULL;	// in the order of their first fault
+unsigned pidCount = 0;
+unsigned pidCapacity = 0;			// size of pidCounters
+unsigned* pidHash = NULL;			// index + 1 of the counters, 0: empty
+unsigned pidHashBits = 0;			// the hash has 2^pidHashBits entries
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+Boolean readStep(logStep_t* step);
+/* reads the faults of the next point in time of the log into the step and	*/
+/* counts them. step->count is 0 at the end of the log. Returns FALSE if	*/
+/* out of memory															*/
+
+pidCounters_t* getCounters(unsigned pid);
+/* returns the counters of the given pid, NULL if out of memory				*/
+
+unsigned hashPid(unsigned pid);
+/* returns the first entry of the hash to look for the PID					*/
+
+int compareFaults(const void* a, const void* b);
+/* orders faults by PID, page and their order in the log, for qsort()		*/
+
+int comparePids(const void* a, const void* b);
+/* orders counters by PID, for qsort()										*/
+
+Boolean sameDecision(const decisionRecord_t* a, const decisionRecord_t* b);
+/* predicate: both records describe the same fault handled the same way	*/
+
+void printRecord(const char* label, const decisionRecord_t* record);
+/* prints one record in human readable form									*/
+
+/* ------------------------------------------------------------------------ */
+
+int main(int argc, char* argv[])
+{
+	logStep_t stepA = { 0 }, stepB = { 0 };
+	decisionRecord_t firstA, firstB;
+	Boolean diverged = FALSE, haveFirstA = FALSE, haveFirstB = FALSE;
+	unsigned long long firstIndex = 0, common = 0, differing = 0, victimDiffering = 0;
+	unsigned long long onlyA = 0, onlyB = 0;
+	unsigned i, j;
+	int order;
+
+	if (argc != 3)
+	{
+		fprintf(stderr, "usage: %s <decision log A> <decision log B>\n", argv[0]);
+		return 2;
+	}
+	// the readers contain the I/O buffers, keep them off the stack
+	stepA.reader = malloc(sizeof(decisionLogReader_t));
+	stepB.reader = malloc(sizeof(decisionLogReader_t));
+	if ((stepA.reader == NULL) || (stepB.reader == NULL)) return 2;
+	if (!decisionLogReaderOpen(stepA.reader, argv[1]))
+	{
+		fprintf(stderr, "Error opening decision log %s\n", argv[1]);
+		return 2;
+	}
+	if (!decisionLogReaderOpen(stepB.reader, argv[2]))
+	{
+		fprintf(stderr, "Error opening decision log %s\n", argv[2]);
+		return 2;
+	}
+	if (stepA.reader->frames != stepB.reader->frames)
+		printf("Note: logs were recorded with %u and %u frames\n", stepA.reader->frames, stepB.reader->frames);
+
+	// walk both logs one point in time after the other
+	stepB.log = 1;
+	stepA.haveNext = decisionLogRead(stepA.reader, &stepA.next);
+	stepB.haveNext = decisionLogRead(stepB.reader, &stepB.next);
+	if (!readStep(&stepA) || !readStep(&stepB)) return 2;
+	while ((stepA.count > 0) || (stepB.count > 0))
+	{
+		if (!diverged)
+		{	// up to here the logs are identical, so the steps start at the same position
+			for (i = 0; (i < stepA.count) && (i < stepB.count)
+				&& sameDecision(&stepA.faults[i].record, &stepB.faults[i].record); i++);
+			if ((i < stepA.count) || (i < stepB.count))
+			{
+				diverged = TRUE;
+				firstIndex = stepA.first + i;
+				haveFirstA = (i < stepA.count) || stepA.haveNext;
+				firstA = (i < stepA.count) ? stepA.faults[i].record : stepA.next;
+				haveFirstB = (i < stepB.count) || stepB.haveNext;
+				firstB = (i < stepB.count) ? stepB.faults[i].record : stepB.next;
+			}
+		}
+		if ((stepB.count == 0) || ((stepA.count > 0) && (stepA.faults[0].record.time < stepB.faults[0].record.time)))
+		{	// no fault of run B at this time
+			onlyA += stepA.count;
+			if (!readStep(&stepA)) return 2;
+			continue;
+		}
+		if ((stepA.count == 0) || (stepB.faults[0].record.time < stepA.faults[0].record.time))
+		{	// no fault of run A at this time
+			onlyB += stepB.count;
+			if (!readStep(&stepB)) return 2;
+			continue;
+		}
+		// pair the faults of the same page, the n-th of A with the n-th of B
+		qsort(stepA.faults, stepA.count, sizeof(stepFault_t), compareFaults);
+		qsort(stepB.faults, stepB.count, sizeof(stepFault_t), compareFaults);
+		for (i = j = 0; (i < stepA.count) || (j < stepB.count); )
+		{
+			if (i == stepA.count) order = 1;
+			else if (j == stepB.count) order = -1;
+			else if (stepA.faults[i].record.pid != stepB.faults[j].record.pid)
+				order = (stepA.faults[i].record.pid < stepB.faults[j].record.pid) ? -1 : 1;
+			else if (stepA.faults[i].record.page != stepB.faults[j].record.page)
+				order = (stepA.faults[i].record.page < stepB.faults[j].record.page) ? -1 : 1;
+			else order = 0;
+			if (order < 0) { onlyA++; i++; continue; }
+			if (order > 0) { onlyB++; j++; continue; }
+			common++;
+			if (!sameDecision(&stepA.faults[i].record, &stepB.faults[j].record)) differing++;
+			if ((stepA.faults[i].record.victimPid != stepB.faults[j].record.victimPid)
+				|| ((stepA.faults[i].record.victimPid != NOPROCESS)
+					&& (stepA.faults[i].record.victimPage != stepB.faults[j].record.victimPage)))
+				victimDiffering++;
+			i++;
+			j++;
+		}
+		if (!readStep(&stepA) || !readStep(&stepB)) return 2;
+	}
+	decisionLogReaderClose(stepA.reader);
+	decisionLogReaderClose(stepB.reader);
+	if (stepA.reader->corrupt || stepB.reader->corrupt)
+	{	// a damaged log would be reported as ending early
+		fprintf(stderr, "Decision log %s is corrupt after %llu decisions\n", stepA.reader->corrupt ? argv[1] : argv[2],
+			stepA.reader->corrupt ? stepA.reader->count : stepB.reader->count);
+		return 2;
+	}
+
+	// report
+	if (!diverged)
+		printf("Logs are identical: %llu decisions\n", stepA.records);
+	else
+	{
+		printf("First divergence at decision %llu\n", firstIndex);
+		if (haveFirstA && haveFirstB)
+		{
+			printRecord("A", &firstA);
+			printRecord("B", &firstB);
+		}
+		else
+			printf("  log %s ends here\n", haveFirstA ? "B" : "A");
+	}
+	printf("%-28s %15s %15s\n", "", "A", "B");
+	printf("%-28s %15llu %15llu\n", "page faults", stepA.records, stepB.records);
+	printf("%-28s %15llu %15llu\n", "evictions", stepA.evictions, stepB.evictions);
+	printf("%-28s %15llu %15llu\n", "faults of one run only", onlyA, onlyB);
+	printf("%-28s %15llu\n", "faults of both runs", common);
+	printf("%-28s %15llu\n", "differing decisions", differing);
+	printf("%-28s %15llu\n", "differing victims", victimDiffering);
+	printf("Per process (faults / evictions), only processes that differ:\n");
+	qsort(pidCounters, pidCount, sizeof(pidCounters_t), comparePids);
+	for (i = 0; i < pidCount; i++)
+	{
+		pidCounters_t* c = &pidCounters[i];
+		if ((c->faults[0] == c->faults[1]) && (c->evictions[0] == c->evictions[1])) continue;
+		printf("  PID %3u  %12llu / %-12llu %12llu / %-12llu\n", c->pid,
+			c->faults[0], c->evictions[0], c->faults[1], c->evictions[1]);
+	}
+	free(stepA.faults);
+	free(stepB.faults);
+	free(pidCounters);
+	free(pidHash);
+	free(stepA.reader);
+	free(stepB.reader);
+	return diverged ? 1 : 0;
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+Boolean readStep(logStep_t* step)
+{
+	pidCounters_t* counters;
+	void* grown;
+	step->first += step->count;
+	step->count = 0;
+	while (step->haveNext && ((step->count == 0) || (step->next.time == step->faults[0].record.time)))
+	{
+		if (step->count == step->capacity)
+		{
+			step->capacity = (step->capacity > 0) ? 2 * step->capacity : DIFF_STEP_SIZE;
+			grown = realloc(step->faults, step->capacity * sizeof(stepFault_t));
+			if (grown == NULL) return FALSE;
+			step->faults = grown;
+		}
+		step->faults[step->count].record = step->next;
+		step->faults[step->count].order = step->count;
+		step->count++;
+		// count the fault for the summary
+		if ((counters = getCounters(step->next.pid)) == NULL) return FALSE;
+		counters->faults[step->log]++;
+		step->records++;
+		if (step->next.victimPid != NOPROCESS)
+		{
+			if ((counters = getCounters(step->next.victimPid)) == NULL) return FALSE;
+			counters->evictions[step->log]++;
+			step->evictions++;
+		}
+		step->haveNext = decisionLogRead(step->reader, &step->next);
+	}
+	return TRUE;
+}
+
+pidCounters_t* getCounters(unsigned pid)
+{
+	unsigned h, bits;
+	unsigned* hash;
+	void* grown;
+	if (pidHash != NULL)
+		for (h = hashPid(pid); pidHash[h] != 0; h = (h + 1) & ((1u << pidHashBits) - 1))
+			if (pidCounters[pidHash[h] - 1].pid == pid) return &pidCounters[pidHash[h] - 1];
+	if (pidCount == pidCapacity)
+	{
+		pidCapacity = (pidCapacity > 0) ? 2 * pidCapacity : 64;
+		grown = realloc(pidCounters, pidCapacity * sizeof(pidCounters_t));
+		if (grown == NULL) return NULL;
+		pidCounters = grown;
+	}
+	memset(&pidCounters[pidCount], 0, sizeof(pidCounters_t));
+	pidCounters[pidCount].pid = pid;
+	pidCount++;
+	if (2 * pidCount >= (1u << pidHashBits))
+	{	// a hash of double size, all processes are entered again
+		bits = (pidHashBits == 0) ? 8 : pidHashBits + 1;
+		hash = calloc((size_t)1 << bits, sizeof(unsigned));
+		if (hash == NULL) return NULL;
+		free(pidHash);
+		pidHash = hash;
+		pidHashBits = bits;
+		for (unsigned index = 0; index + 1 < pidCount; index++)
+		{
+			for (h = hashPid(pidCounters[index].pid); pidHash[h] != 0; h = (h + 1) & ((1u << bits) - 1));
+			pidHash[h] = index + 1;
+		}
+	}
+	for (h = hashPid(pid); pidHash[h] != 0; h = (h + 1) & ((1u << pidHashBits) - 1));
+	pidHash[h] = pidCount;
+	return &pidCounters[pidCount - 1];
+}
+
+unsigned hashPid(unsigned pid)
+{
+	// multiplicative hashing, the PIDs of a file are often consecutive
+	return (unsigned)((pid * 2654435769u) >> (32 - pidHashBits));
+}
+
+int compareFaults(const void* a, const void* b)
+{
+	const stepFault_t* x = a;
+	const stepFault_t* y = b;
+	if (x->record.pid != y->record.pid) return (x->record.pid < y->record.pid) ? -1 : 1;
+	if (x->record.page != y->record.page) return (x->record.page < y->record.page) ? -1 : 1;
+	return (x->order < y->order) ? -1 : (x->order > y->order);
+}
+
+int comparePids(const void* a, const void* b)
+{
+	const pidCounters_t* x = a;
+	const pidCounters_t* y = b;
+	return (x->pid < y->pid) ? -1 : (x->pid > y->pid);
+}
+
+Boolean sameDecision(const decisionRecord_t* a, const decisionRecord_t* b)
+{
+	return (a->time == b->time) && (a->pid == b->pid) && (a->page == b->page)
+		&& (a->frame == b->frame) && (a->victimPid == b->victimPid)
+		&& ((a->victimPid == NOPROCESS) || (a->victimPage == b->victimPage));
+}
+
+void printRecord(const char* label, const decisionRecord_t* record)
+{
+	printf("  %s: %6u : PID %3u : page %u into frame %d, ", label, record->time,
+		record->pid, record->page, record->frame);
+	if (record->victimPid == NOPROCESS)
+		printf("empty frame\n");
+	else
+		printf("evicting PID %u page %u\n", record->victimPid, record->victimPage);
+}
@@ -0,0 +1,182 @@
+/* Implementation of the binary log of the page replacement decisions		*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "decisionlog.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in decisionlog.h*/
+char decisionLogFileName[FILENAME_LENGTH] = DECISION_LOG_FILENAME;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+FILE* decisionLogFile = NULL;			// NULL: log disabled
+unsigned char decisionLogBuffer[DECISIONLOG_BUFFER_SIZE];
+size_t decisionLogFill = 0;				// bytes used in decisionLogBuffer
+unsigned decisionLogLastTime = 0;		// time of the previous record
+Boolean decisionLogError = FALSE;		// a write error occured
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+void putVarint(unsigned long long value);
+/* appends the value as LEB128 varint to the write buffer					*/
+
+void flushDecisionLog(void);
+/* writes the buffer to the file											*/
+
+Boolean getVarint(decisionLogReader_t* reader, unsigned long long* value);
+/* decodes the next varint, refilling the buffer as needed					*/
+/* Returns FALSE at the end of the file or on a truncated varint, which		*/
+/* also sets reader->corrupt, as does a read error							*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+Boolean decisionLogOpen(const char* filename, unsigned frames)
+{
+	if ((filename == NULL) || (strlen(filename) == 0)) return TRUE;	// log disabled
+	decisionLogFile = fopen(filename, "wb");
+	if (decisionLogFile == NULL) return FALSE;
+	decisionLogFill = 0;
+	decisionLogLastTime = 0;
+	decisionLogError = FALSE;
+	memcpy(decisionLogBuffer, "BSDL", 4);
+	decisionLogFill = 4;
+	putVarint(DECISIONLOG_VERSION);
+	putVarint(frames);
+	return TRUE;
+}
+
+void decisionLogFault(unsigned time, unsigned pid, unsigned page, int frame,
+	unsigned victimPid, unsigned victimPage)
+{
+	long long delta;
+	if (decisionLogFile == NULL) return;
+	// a record has at most 6 varints of 10 bytes, make room for it
+	if (decisionLogFill + 60 > DECISIONLOG_BUFFER_SIZE) flushDecisionLog();
+	delta = (long long)time - (long long)decisionLogLastTime;
+	decisionLogLastTime = time;
+	putVarint((unsigned long long)((delta << 1) ^ (delta >> 63)));	// zigzag
+	putVarint(pid);
+	putVarint(page);
+	putVarint((unsigned)frame);
+	putVarint(victimPid);
+	if (victimPid != NOPROCESS) putVarint(victimPage);
+}
+
+Boolean decisionLogClose(void)
+{
+	Boolean ok;
+	if (decisionLogFile == NULL) return TRUE;
+	flushDecisionLog();
+	ok = (fclose(decisionLogFile) == 0) && !decisionLogError;
+	decisionLogFile = NULL;
+	return ok;
+}
+
+Boolean decisionLogReaderOpen(decisionLogReader_t* reader, const char* filename)
+{
+	unsigned long long version, frames;
+	reader->file = fopen(filename, "rb");
+	reader->fill = 0;
+	reader->pos = 0;
+	reader->lastTime = 0;
+	reader->frames = 0;
+	reader->count = 0;
+	reader->corrupt = FALSE;
+	if (reader->file == NULL) return FALSE;
+	reader->fill = fread(reader->buffer, 1, DECISIONLOG_BUFFER_SIZE, reader->file);
+	if ((reader->fill < 4) || (memcmp(reader->buffer, "BSDL", 4) != 0))
+	{
+		decisionLogReaderClose(reader);
+		return FALSE;
+	}
+	reader->pos = 4;
+	if (!getVarint(reader, &version) || (version != DECISIONLOG_VERSION)
+		|| !getVarint(reader, &frames))
+	{
+		decisionLogReaderClose(reader);
+		return FALSE;
+	}
+	reader->frames = (unsigned)frames;
+	return TRUE;
+}
+
+Boolean decisionLogRead(decisionLogReader_t* reader, decisionRecord_t* record)
+{
+	unsigned long long zigzag, pid, page, frame, victimPid, victimPage = 0;
+	long long delta;
+	if (reader->file == NULL) return FALSE;
+	if (!getVarint(reader, &zigzag)) return FALSE;		// regular end of the log, unless corrupt
+	if (!getVarint(reader, &pid) || !getVarint(reader, &page) || !getVarint(reader, &frame)
+		|| !getVarint(reader, &victimPid) || ((victimPid != NOPROCESS) && !getVarint(reader, &victimPage)))
+	{	// truncated record
+		reader->corrupt = TRUE;
+		return FALSE;
+	}
+	delta = (long long)(zigzag >> 1) ^ -(long long)(zigzag & 1);
+	reader->lastTime = (unsigned)((long long)reader->lastTime + delta);
+	record->time = reader->lastTime;
+	record->pid = (unsigned)pid;
+	record->page = (unsigned)page;
+	record->frame = (int)frame;
+	record->victimPid = (unsigned)victimPid;
+	record->victimPage = (unsigned)victimPage;
+	reader->count++;
+	return TRUE;
+}
+
+void decisionLogReaderClose(decisionLogReader_t* reader)
+{
+	if (reader->file != NULL) fclose(reader->file);
+	reader->file = NULL;
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+void putVarint(unsigned long long value)
+{
+	while (value >= 0x80)
+	{
+		decisionLogBuffer[decisionLogFill++] = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+	decisionLogBuffer[decisionLogFill++] = (unsigned char)value;
+}
+
+void flushDecisionLog(void)
+{
+	if (fwrite(decisionLogBuffer, 1, decisionLogFill, decisionLogFile) != decisionLogFill)
+		decisionLogError = TRUE;
+	decisionLogFill = 0;
+}
+
+Boolean getVarint(decisionLogReader_t* reader, unsigned long long* value)
+{
+	unsigned long long result = 0;
+	unsigned shift = 0;
+	unsigned char byte;
+	do {
+		if (reader->pos >= reader->fill)
+		{	// buffer exhausted: stream in the next block of the file
+			reader->fill = fread(reader->buffer, 1, DECISIONLOG_BUFFER_SIZE, reader->file);
+			reader->pos = 0;
+			if (reader->fill == 0)
+			{	// the end of the file is regular only before the first byte of a varint
+				if ((shift > 0) || ferror(reader->file)) reader->corrupt = TRUE;
+				return FALSE;
+			}
+		}
+		byte = reader->buffer[reader->pos++];
+		if (shift < 64) result |= (unsigned long long)(byte & 0x7f) << shift;
+		shift += 7;
+	} while (byte & 0x80);
+	*value = result;
+	return TRUE;
+}
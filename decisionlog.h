@@ -0,0 +1,69 @@
+/* Include-file defining the binary log of the page replacement decisions	*/
+/* Every page fault handled by accessPage() is recorded with the faulting	*/
+/* page, the frame it was placed in and the victim chosen by				*/
+/* pageReplacement(), if any. Two logs of runs with different policies can	*/
+/* be compared with the tool decisionDiff.									*/
+/*																			*/
+/* File format (all numbers are LEB128 varints):							*/
+/*   header : "BSDL" <version> <number of frames>							*/
+/*   record : <zigzag time delta> <pid> <page> <frame> <victim pid>			*/
+/*            [<victim page>]   (only present if victim pid != NOPROCESS)	*/
+#ifndef __DECISIONLOG__
+#define __DECISIONLOG__
+
+#include <stdio.h>
+#include "bs_types.h"
+
+#define DECISIONLOG_VERSION 1
+#define DECISIONLOG_BUFFER_SIZE 65536	// size of the I/O buffers in bytes
+
+/* one recorded page fault */
+typedef struct decisionRecord_struct
+{
+	unsigned time;			// systemTime of the fault
+	unsigned pid;			// faulting process
+	unsigned page;			// faulting page
+	int frame;				// frame the page was moved into
+	unsigned victimPid;		// process of the evicted page, NOPROCESS if an empty frame was used
+	unsigned victimPage;	// evicted page, only valid if victimPid != NOPROCESS
+} decisionRecord_t;
+
+/* state of a streaming reader, the log is never loaded as a whole */
+typedef struct decisionLogReader_struct
+{
+	FILE* file;
+	unsigned char buffer[DECISIONLOG_BUFFER_SIZE];
+	size_t fill;			// number of valid bytes in buffer
+	size_t pos;				// next byte to decode
+	unsigned lastTime;		// time of the previous record, times are delta coded
+	unsigned frames;		// number of frames of the recorded run
+	unsigned long long count;	// number of records read so far
+	Boolean corrupt;		// the log ends within a record or could not be read
+} decisionLogReader_t;
+
+extern char decisionLogFileName[];	// log written by the OS, empty: no log
+
+Boolean decisionLogOpen(const char* filename, unsigned frames);
+/* creates the decision log and writes the header							*/
+/* An empty filename leaves the log disabled and returns TRUE				*/
+/* Returns FALSE if the file cannot be created								*/
+
+void decisionLogFault(unsigned time, unsigned pid, unsigned page, int frame,
+	unsigned victimPid, unsigned victimPage);
+/* records one page fault, does nothing if the log is not open				*/
+
+Boolean decisionLogClose(void);
+/* flushes and closes the decision log, returns FALSE on a write error		*/
+
+Boolean decisionLogReaderOpen(decisionLogReader_t* reader, const char* filename);
+/* opens a decision log for streaming and checks its header					*/
+/* Returns FALSE if the file cannot be opened or is not a decision log		*/
+
+Boolean decisionLogRead(decisionLogReader_t* reader, decisionRecord_t* record);
+/* decodes the next record, returns FALSE at the end of the log and if the	*/
+/* log is corrupt, which sets reader->corrupt								*/
+
+void decisionLogReaderClose(decisionLogReader_t* reader);
+/* closes the log opened by decisionLogReaderOpen()							*/
+
+#endif  /* __DECISIONLOG__ */
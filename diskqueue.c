@@ -0,0 +1,91 @@
+/* Implementation of the simulated disk holding the paged out pages			*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "diskqueue.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in diskqueue.h	*/
+unsigned diskLatency = DISK_LATENCY;
+unsigned diskQueueDepth = DISK_QUEUE_DEPTH;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+
+// a blocked process has at most one read pending, the ring has an entry for
+// each entry of the process table
+#define DISK_RING_SIZE processTableSize
+
+diskRequest_t* diskRing = NULL;			// pending reads in submission order
+unsigned diskHead = 0;					// index of the read completing first
+unsigned diskCount = 0;					// number of pending reads
+unsigned diskSlotFree[DISK_MAX_DEPTH];	// time each slot finishes its last read
+diskStatistics_t diskStats;
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+void diskInit(void)
+{
+	registerProcessArray((void**)&diskRing, sizeof(diskRequest_t));
+	diskHead = 0;
+	diskCount = 0;
+	if (diskQueueDepth < 1) diskQueueDepth = 1;
+	if (diskQueueDepth > DISK_MAX_DEPTH) diskQueueDepth = DISK_MAX_DEPTH;
+	for (unsigned slot = 0; slot < DISK_MAX_DEPTH; slot++)
+		diskSlotFree[slot] = 0;
+	memset(&diskStats, 0, sizeof(diskStats));
+}
+
+Boolean diskSubmit(unsigned time, unsigned pid, unsigned page, unsigned* completion)
+{
+	diskRequest_t* request;
+	unsigned slot, start;
+	if (diskCount == DISK_RING_SIZE) return FALSE;
+	// all reads take the same time: the slots are used in turn, the next
+	// one is always the one that becomes free first
+	slot = (unsigned)(diskStats.reads % diskQueueDepth);
+	start = (diskSlotFree[slot] > time) ? diskSlotFree[slot] : time;
+	if ((unsigned long long)start + diskLatency > UINT_MAX) return FALSE;	// beyond the range of the time
+	diskSlotFree[slot] = start + diskLatency;
+	request = &diskRing[(diskHead + diskCount) % DISK_RING_SIZE];
+	request->pid = pid;
+	request->page = page;
+	request->submitted = time;
+	request->completion = start + diskLatency;
+	diskCount++;
+	diskStats.reads++;
+	diskStats.queueTime += start - time;
+	diskStats.readTime += request->completion - time;
+	if (diskCount > diskStats.maxPending) diskStats.maxPending = diskCount;
+	*completion = request->completion;
+	return TRUE;
+}
+
+Boolean diskNextCompletion(diskRequest_t* request)
+{
+	if (diskCount == 0) return FALSE;
+	*request = diskRing[diskHead];
+	return TRUE;
+}
+
+void diskComplete(void)
+{
+	if (diskCount == 0) return;
+	diskHead = (diskHead + 1) % DISK_RING_SIZE;
+	diskCount--;
+}
+
+unsigned diskPending(void)
+{
+	return diskCount;
+}
+
+void diskGetStatistics(diskStatistics_t* stats)
+{
+	*stats = diskStats;
+}
@@ -0,0 +1,57 @@
+/* Include-file defining the simulated disk holding the paged out pages		*/
+/* With blocking page faults a fault reads the page from this disk and the	*/
+/* faulting process is blocked until the read completes. The disk serves	*/
+/* up to diskQueueDepth reads at the same time, each of them takes			*/
+/* diskLatency time units. Further reads wait in FIFO order for a free		*/
+/* slot. As all reads take the same time, they complete in the order they	*/
+/* were submitted and the pending reads form a simple ring buffer.			*/
+#ifndef __DISKQUEUE__
+#define __DISKQUEUE__
+
+#include "bs_types.h"
+
+#define DISK_MAX_DEPTH 64		// maximum number of reads served at the same time
+
+/* one page read, submitted on a page fault */
+typedef struct diskRequest_struct
+{
+	unsigned pid;			// blocked process
+	unsigned page;			// page to be read
+	unsigned submitted;		// systemTime of the page fault
+	unsigned completion;	// systemTime the page is in memory
+} diskRequest_t;
+
+/* statistics of the disk, for the report at the end of the run				*/
+typedef struct diskStatistics_struct
+{
+	unsigned long long reads;		// reads submitted
+	unsigned long long queueTime;	// sum of the times spent waiting for a free slot
+	unsigned long long readTime;	// sum of the times from submission to completion
+	unsigned maxPending;			// maximum number of reads submitted but not completed
+} diskStatistics_t;
+
+extern unsigned diskLatency;		// duration of a read, 0: page faults complete instantly
+extern unsigned diskQueueDepth;		// number of reads served at the same time
+
+void diskInit(void);
+/* removes all pending reads and clears the statistics						*/
+
+Boolean diskSubmit(unsigned time, unsigned pid, unsigned page, unsigned* completion);
+/* submits a read of the page at the given time and returns the time it		*/
+/* completes. Returns FALSE if one read per process is already pending		*/
+/* or if the completion is beyond the range of the time (32 bits)			*/
+
+Boolean diskNextCompletion(diskRequest_t* request);
+/* returns the pending read that completes first, without removing it		*/
+/* Returns FALSE if no read is pending										*/
+
+void diskComplete(void);
+/* removes the read that completes first, see diskNextCompletion()			*/
+
+unsigned diskPending(void);
+/* returns the number of reads submitted but not yet completed				*/
+
+void diskGetStatistics(diskStatistics_t* stats);
+/* returns the current statistics											*/
+
+#endif  /* __DISKQUEUE__ */
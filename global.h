@@ -6,6 +6,7 @@
 #define	_CRT_SECURE_NO_WARNINGS		// suppress legacy warnings 
 
 #include <stdlib.h>
+#include <limits.h>
 #include <time.h>
 #include "bs_types.h"
 #include "core.h"
@@ -14,15 +15,127 @@
 #include "log.h"
 #include "simruntime.h"
 #include "timer.h"
+#include "decisionlog.h"
+#include "aging.h"
+#include "adaptive.h"
+#include "smp.h"
+#include "diskqueue.h"
+#include "backingstore.h"
+#include "zswap.h"
+#include "numa.h"
+#include "buddy.h"
+#include "hugepage.h"
+#include "slab.h"
+#include "procclass.h"
+#include "owner.h"
+#include "loadcontrol.h"
+#include "workload.h"
+#include "scheduler.h"
+#include "localsim.h"
+#include "checkpoint.h"
+#include "latency.h"
+#include "profile.h"
+#include "stimulus.h"
 
 
-// Number of possible concurrent processes, i.e. size of the process table 
+// Initial size of the process table, it grows with the processes read from
+// the process file, whose PIDs may be spread over the whole range
 #define MAX_PROCESSES (unsigned)100
 
 // Size of the physical memory available to user processes in frames
 // This value shall be changed to a suitable number for more realistic testing. 
 // The system must run for an arbitrary (but reasonable) memory size
+// May be overridden at compile time, e.g. -DMEMORYSIZE=1024 for the benchmarks
+#ifndef MEMORYSIZE
 #define MEMORYSIZE 4
+#endif
+
+// Page replacement algorithm used by default, see replacementPolicy_t in bs_types.h
+// The algorithm may be changed at runtime with the command line option -P, e.g. -P arc
+#define REPLACEMENT_POLICY randomReplacement
+
+// Number of empty frames each simulated CPU may keep in its own cache, used
+// when the simulation runs with several CPUs (command line option -c)
+#define FRAME_CACHE_SIZE 64
+
+// Blocking page faults: duration of a page read from the disk and number of
+// reads the disk serves at the same time. A latency of 0 lets page faults
+// complete instantly. May be changed at runtime with the option -i
+#define DISK_LATENCY 0
+#define DISK_QUEUE_DEPTH 1
+// The events of processes lagging behind the stimulus wait for them. Beyond
+// this number of waiting events the stimulus is not read further ahead, the
+// other processes wait for the lagging ones instead
+#define DEFERRED_EVENTS_MAX 4096
+
+// Compressed swap tier: size of the pool in KiB holding the pages moved out
+// compressed, 0 disables it, and the time a blocking page fault served from
+// the pool takes for the decompression. May be changed at runtime with -z
+#define ZSWAP_POOL_SIZE 0
+#define ZSWAP_DECOMPRESS_COST 1
+
+// Physical memory with several nodes (NUMA): number of nodes, placement of
+// the pages and the cost of an access to the local and to a remote node, the
+// costs are relative distances like in the ACPI SLIT. One node is a uniform
+// memory. May be changed at runtime with the options -n and -m
+#define NUMA_NODES 1
+#define NUMA_PLACEMENT numaFirstTouch
+#define NUMA_LOCAL_COST 10
+#define NUMA_REMOTE_COST 21
+
+// Huge pages of 2^HUGEPAGE_ORDER pages, 0 disables them. May be changed at
+// runtime with the option -H
+#define HUGEPAGE_ORDER 0
+
+// Weighted page replacement (-P weighted): weight of the pages and protected
+// minimum resident set of the processes of each class, in the order of
+// processType_t (os, interactive, batch, background, foreground). A higher
+// weight keeps the pages longer. May be changed at runtime with the option -w
+#define CLASS_WEIGHTS { 8, 4, 1, 1, 2 }
+#define CLASS_MIN_RESIDENT { 0, 4, 0, 0, 0 }
+
+// Load control with blocking page faults: a process is suspended if at least
+// LOAD_CONTROL_HIGH percent of the accesses in a timer period fault, 0 disables
+// it, and resumed if less than LOAD_CONTROL_LOW percent fault. May be changed
+// at runtime with the option -l
+#define LOAD_CONTROL_HIGH 0
+#define LOAD_CONTROL_LOW 10
+
+// Generated workload instead of the stimulus file: number of processes, 0
+// uses the stimulus file, and how many of them are live at the same time.
+// The processes access WORKLOAD_LENGTH pages of WORKLOAD_SIZE on average, in
+// windows of WORKLOAD_WINDOW pages moving every WORKLOAD_PHASE accesses,
+// WORKLOAD_WRITES percent of them write. May be changed at runtime with -g
+#define WORKLOAD_PROCESSES 0
+#define WORKLOAD_LIVE 8
+#define WORKLOAD_SIZE 32
+#define WORKLOAD_LENGTH 1000
+#define WORKLOAD_WINDOW 6
+#define WORKLOAD_PHASE 100
+#define WORKLOAD_WRITES 25
+
+// Scheduler of the generated workload: policy, see schedulingPolicy_t in
+// bs_types.h, quantum in accesses and the priority of each class in the
+// order of processType_t, 0 is the highest. May be changed at runtime with -S
+#define SCHEDULING_POLICY roundRobinScheduling
+#define SCHEDULING_QUANTUM 20
+#define SCHEDULING_PRIORITIES { 0, 1, 3, 4, 2 }
+
+// Local quotas: each process replaces only its own pages within
+// LOCAL_QUOTA frames, 0 simulates the global replacement. With one of
+// LOCAL_THREADS the processes run through coreLoop(), with more they are
+// simulated as shards on a pool of threads. May be changed at runtime with -L
+#define LOCAL_QUOTA 0
+#define LOCAL_THREADS 1
+
+// The reader hands the events of a shard to the threads in batches of about
+// LOCAL_BATCH_SIZE bytes and waits while LOCAL_QUEUE_SIZE bytes are queued
+#define LOCAL_BATCH_SIZE 16384
+#define LOCAL_QUEUE_SIZE (16u << 20)
+
+// Page tables and the other data of the OS are allocated by the slab
+// allocator, FALSE selects malloc(). May be changed at runtime with -a
+#define SLAB_ALLOCATOR TRUE
 
 // Period of the timer. on all multiples of this value the timer ISR ist called by the simulation
 #define TIMER_INTERVAL 50			// *** This value must not be changed! ***
@@ -31,13 +144,30 @@
 // name of the file with process definitions
 #define PROCESS_FILENAME "processes.txt"
 // name of the file with the simulation run an empty file name switches to random event stimulus
+// The file may also be compressed with the tool stimulusPack, see stimulus.h
 #define RUN_FILENAME "run.txt"
 //#define RUN_FILENAME ""
+// name of the binary log of page replacement decisions, an empty file name disables the log
+#define DECISION_LOG_FILENAME ""
+// name of the swap file of the backing store, an empty file name disables real page contents
+#define BACKINGSTORE_FILENAME ""
+// names of the snapshot written at a checkpoint and of the one restored, an
+// empty file name disables them. May be changed at runtime with -C resp. -R
+#define CHECKPOINT_FILENAME ""
+#define RESTORE_FILENAME ""
+// latency histograms printed at the end and name of the timeline of the
+// faults, evictions and timer events, an empty file name disables it. May be
+// changed at runtime with -t resp. -T
+#define LATENCY_HISTOGRAMS FALSE
+#define LATENCY_TRACE_FILENAME ""
+// profile of the phases of the main loop with the hardware counters of the
+// CPU, printed at the end. May be changed at runtime with -k
+#define PROFILE_ENABLED FALSE
 
 /* ----------------------------------------------------------------	*/
 /* Define global variables that will be visible in all sourcefiles	*/
 extern unsigned int	maxPID;				// largest valid PID
-extern PCB_t processTable[MAX_PROCESSES + 1]; 	// the process table
+extern PCB_t* processTable; 			// the process table, see processcontrol.h
 extern unsigned systemTime; 			// the current system time (up time)
 
 /* ----------------------------------------------------------------	*/
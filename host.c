@@ -0,0 +1,253 @@
+/* Implementation of the services of the host used by the checkpoints, the	*/
+/* latency histograms and the profile										*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#endif
+#ifdef __linux__
+#include <errno.h>
+#include <string.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define HOST_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HOST_TSC
+#endif
+#include <stdio.h>
+#include "host.h"
+
+#define HOST_CALIBRATION_TIME 2000000	// nanoseconds hostTicks() is calibrated for
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+int hostCounterFd[HOST_COUNTERS] = { -1, -1, -1, -1 };	// -1: counter not open
+int hostCounterLeader = -1;					// descriptor of the group, read for all counters
+int hostCounterOrder[HOST_COUNTERS];		// counters in the order of the group
+int hostCounterCount = 0;					// counters in the group
+const char* hostCounterError = "not opened";
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+#ifdef _WIN32
+
+const void* hostMapFile(const char* filename, size_t* bytes)
+{
+	HANDLE file, mapping;
+	LARGE_INTEGER size;
+	const void* data = NULL;
+	file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return NULL;
+	if (GetFileSizeEx(file, &size) && (size.QuadPart > 0))
+	{
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping != NULL)
+		{	// the view keeps the mapping alive
+			data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+		}
+		*bytes = (size_t)size.QuadPart;
+	}
+	CloseHandle(file);
+	return data;
+}
+
+void hostUnmapFile(const void* data, size_t bytes)
+{
+	(void)bytes;
+	UnmapViewOfFile(data);
+}
+
+int hostForkOutput(FILE* output)
+{
+	(void)output;
+	return -1;				// Windows cannot fork a process
+}
+
+int hostWaitChild(int child)
+{
+	(void)child;
+	return -1;
+}
+
+unsigned long long hostNanoseconds(void)
+{
+	LARGE_INTEGER count, frequency;
+	QueryPerformanceCounter(&count);
+	QueryPerformanceFrequency(&frequency);
+	// split, the product of the count and 10^9 overflows after some hours
+	return (unsigned long long)(count.QuadPart / frequency.QuadPart) * 1000000000ull
+		+ (unsigned long long)(count.QuadPart % frequency.QuadPart) * 1000000000ull / (unsigned long long)frequency.QuadPart;
+}
+
+#else
+
+const void* hostMapFile(const char* filename, size_t* bytes)
+{
+	struct stat info;
+	void* data = MAP_FAILED;
+	int file = open(filename, O_RDONLY);
+	if (file < 0) return NULL;
+	if ((fstat(file, &info) == 0) && (info.st_size > 0))
+	{
+		data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		*bytes = (size_t)info.st_size;
+	}
+	close(file);			// the mapping stays valid
+	return (data == MAP_FAILED) ? NULL : data;
+}
+
+void hostUnmapFile(const void* data, size_t bytes)
+{
+	munmap((void*)data, bytes);
+}
+
+int hostForkOutput(FILE* output)
+{
+	pid_t child;
+	fflush(stdout);			// the buffered output belongs to the parent only
+	fflush(output);
+	child = fork();
+	if (child != 0) return (child < 0) ? -1 : (int)child;
+	if (dup2(fileno(output), STDOUT_FILENO) < 0) _exit(1);
+	return 0;
+}
+
+int hostWaitChild(int child)
+{
+	int status;
+	if (waitpid((pid_t)child, &status, 0) < 0) return -1;
+	return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+unsigned long long hostNanoseconds(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+#endif
+
+unsigned long long hostTicks(void)
+{
+#ifdef HOST_TSC
+	return __rdtsc();
+#else
+	return hostNanoseconds();
+#endif
+}
+
+double hostNanosecondsPerTick(void)
+{
+#ifdef HOST_TSC
+	unsigned long long startTime = hostNanoseconds(), startTicks = hostTicks(), time;
+	while ((time = hostNanoseconds()) - startTime < HOST_CALIBRATION_TIME);
+	return (double)(time - startTime) / (double)(hostTicks() - startTicks);
+#else
+	return 1.0;
+#endif
+}
+
+#ifdef __linux__
+
+int hostCountersOpen(int available[HOST_COUNTERS])
+{
+	const unsigned long long config[HOST_COUNTERS] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+	struct perf_event_attr attr;
+	hostCounterCount = 0;
+	hostCounterError = NULL;
+	for (int i = 0; i < HOST_COUNTERS; i++)
+	{
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = config[i];
+		attr.disabled = (hostCounterLeader < 0);	// the group starts when it is complete
+		attr.exclude_kernel = 1;				// also allowed with perf_event_paranoid 2
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		hostCounterFd[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, hostCounterLeader, 0);
+		available[i] = (hostCounterFd[i] >= 0);
+		if (hostCounterFd[i] < 0)
+		{
+			if (hostCounterError == NULL) hostCounterError = strerror(errno);
+			continue;
+		}
+		if (hostCounterLeader < 0) hostCounterLeader = hostCounterFd[i];
+		hostCounterOrder[hostCounterCount++] = i;
+	}
+	if (hostCounterLeader >= 0)
+		ioctl(hostCounterLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	return hostCounterCount;
+}
+
+int hostCountersRead(unsigned long long values[HOST_COUNTERS])
+{
+	// number of counters, time enabled, time running, the counts in the order of the group
+	unsigned long long data[3 + HOST_COUNTERS];
+	double scale;
+	for (int i = 0; i < HOST_COUNTERS; i++)
+		values[i] = 0;
+	if (hostCounterLeader < 0) return 0;
+	if (read(hostCounterLeader, data, sizeof(data)) < (ssize_t)(3 * sizeof(data[0]))) return 0;
+	scale = ((data[2] > 0) && (data[2] < data[1])) ? (double)data[1] / (double)data[2] : 1.0;
+	for (unsigned long long i = 0; (i < data[0]) && (i < (unsigned long long)hostCounterCount); i++)
+		values[hostCounterOrder[i]] = (scale == 1.0) ? data[3 + i] : (unsigned long long)(data[3 + i] * scale);
+	return 1;
+}
+
+void hostCountersClose(void)
+{
+	for (int i = 0; i < HOST_COUNTERS; i++)
+	{
+		if (hostCounterFd[i] >= 0) close(hostCounterFd[i]);
+		hostCounterFd[i] = -1;
+	}
+	hostCounterLeader = -1;
+	hostCounterCount = 0;
+}
+
+#else
+
+int hostCountersOpen(int available[HOST_COUNTERS])
+{
+	for (int i = 0; i < HOST_COUNTERS; i++)
+		available[i] = 0;
+	hostCounterError = "perf_event_open() is only provided by Linux";
+	return 0;
+}
+
+int hostCountersRead(unsigned long long values[HOST_COUNTERS])
+{
+	for (int i = 0; i < HOST_COUNTERS; i++)
+		values[i] = 0;
+	return 0;
+}
+
+void hostCountersClose(void)
+{
+}
+
+#endif
+
+const char* hostCountersError(void)
+{
+	return (hostCounterError != NULL) ? hostCounterError : "all counters available";
+}
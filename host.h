@@ -0,0 +1,65 @@
+/* Include-file defining the services of the host used by the checkpoints,	*/
+/* the latency histograms and the profile: mapping a snapshot file into		*/
+/* memory, running variants of the simulation in child processes, reading	*/
+/* a monotonic clock and the hardware counters of the CPU. The functions	*/
+/* are thin wrappers of the POSIX, Linux resp. Win32 calls. As swapfile.h,	*/
+/* this header must not include bs_types.h, as the system headers declare	*/
+/* read() and write().														*/
+#ifndef __HOST__
+#define __HOST__
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define HOST_COUNTERS 4		// cycles, instructions, last level cache misses, branch misses
+
+const void* hostMapFile(const char* filename, size_t* bytes);
+/* maps the whole file read-only into memory and stores its length in		*/
+/* *bytes. Returns the address of the first byte, NULL on error				*/
+
+void hostUnmapFile(const void* data, size_t bytes);
+/* releases a mapping of hostMapFile()										*/
+
+int hostForkOutput(FILE* output);
+/* creates a child process running on from the point of the call, its		*/
+/* standard output is written to the given file. Returns 0 in the child,	*/
+/* the process ID of the child in the parent and -1 if no child could be	*/
+/* created, e.g. on Windows													*/
+
+int hostWaitChild(int child);
+/* waits for the end of the child, returns its exit code, -1 on error		*/
+
+unsigned long long hostNanoseconds(void);
+/* returns the time of a monotonic clock in nanoseconds, from an arbitrary	*/
+/* start																	*/
+
+unsigned long long hostTicks(void);
+/* returns the fastest counter of the host, the time stamp counter on x86	*/
+/* CPUs, which takes a fraction of the time of hostNanoseconds(), else		*/
+/* hostNanoseconds()														*/
+
+double hostNanosecondsPerTick(void);
+/* calibrates hostTicks() against hostNanoseconds() for 2 milliseconds and	*/
+/* returns the length of a tick in nanoseconds, 1.0 without a time stamp	*/
+/* counter																	*/
+
+int hostCountersOpen(int available[HOST_COUNTERS]);
+/* opens the hardware counters of the calling thread in user mode with		*/
+/* perf_event_open() as one group, so that they are read together. A		*/
+/* counter the CPU or the kernel does not provide is left out and marked	*/
+/* 0 in available[]. Returns the number of counters opened, 0 e.g. in a		*/
+/* virtual machine without a PMU, if perf_event_paranoid forbids them or	*/
+/* on other hosts than Linux, see hostCountersError()						*/
+
+int hostCountersRead(unsigned long long values[HOST_COUNTERS]);
+/* reads the counts since hostCountersOpen(), scaled up by the share of the	*/
+/* time the group was counting if the kernel multiplexed the counters.		*/
+/* Unavailable counters read 0. Returns 0 on error							*/
+
+const char* hostCountersError(void);
+/* returns the reason the first counter could not be opened					*/
+
+void hostCountersClose(void);
+/* closes the counters opened by hostCountersOpen()							*/
+
+#endif  /* __HOST__ */
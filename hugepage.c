@@ -0,0 +1,125 @@
+/* Implementation of the huge pages (superpages)							*/
+/* for comments on the global functions see the associated .h-file			*/
+/* The pages are moved by the memory manager, this module decides which		*/
+/* regions are promoted and keeps the statistics.							*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <stdio.h>
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "hugepage.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in hugepage.h	*/
+unsigned hugePageOrder = HUGEPAGE_ORDER;
+Boolean hugePagesEnabled = FALSE;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+extern frameTableEntry_t frameTable[];		// owned by the memory manager
+hugePageStatistics_t hugePageStats;
+// the regions demoted last, a ring of HUGEPAGE_RECENT entries
+unsigned recentPid[HUGEPAGE_RECENT];
+unsigned recentRegion[HUGEPAGE_RECENT];
+unsigned long long recentTick[HUGEPAGE_RECENT];		// sample (timer event) of the demotion
+unsigned recentCount = 0;							// entries used, the next one is overwritten
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+void hugePageInit(void)
+{
+	if (hugePageOrder > HUGEPAGE_MAX_ORDER) hugePageOrder = HUGEPAGE_MAX_ORDER;
+	if ((1u << hugePageOrder) > MEMORYSIZE) hugePageOrder = 0;
+	memset(&hugePageStats, 0, sizeof(hugePageStats));
+	recentCount = 0;
+	hugePagesEnabled = (hugePageOrder > 0);
+}
+
+Boolean hugePageIsCandidate(unsigned pid, unsigned region)
+{
+	pageTableEntry_t* pTable = processTable[pid].pageTable;
+	unsigned first = region << hugePageOrder;
+	unsigned size = 1u << hugePageOrder;
+	unsigned referenced = 0;
+	if ((pTable == NULL) || (first + size > processTable[pid].size) || pTable[first].huge)
+		return FALSE;
+	for (unsigned page = first; page < first + size; page++)
+	{
+		// a frame shared after a fork is mapped by each sharer on its own
+		if (!pTable[page].present || (frameTable[pTable[page].frame].sharers > 1)) return FALSE;
+		if (pTable[page].referenced) referenced++;
+	}
+	if (referenced * 100 < size * HUGEPAGE_HOT_PERCENT) return FALSE;
+	hugePageStats.candidates++;
+	for (unsigned i = 0; (i < recentCount) && (i < HUGEPAGE_RECENT); i++)
+		if ((recentPid[i] == pid) && (recentRegion[i] == region)
+			&& (hugePageStats.samples - recentTick[i] < HUGEPAGE_BACKOFF_TICKS))
+		{	// it would be split again by the next eviction
+			hugePageStats.deferred++;
+			return FALSE;
+		}
+	return TRUE;
+}
+
+void hugePagePromoted(Boolean compacted, unsigned pagesMoved)
+{
+	hugePageStats.promotions++;
+	if (compacted) hugePageStats.compactions++;
+	hugePageStats.pagesMoved += pagesMoved;
+	hugePageStats.hugePages++;
+	if (hugePageStats.hugePages > hugePageStats.maxHugePages)
+		hugePageStats.maxHugePages = hugePageStats.hugePages;
+}
+
+void hugePageDemoted(unsigned pid, unsigned region, Boolean evicted)
+{
+	unsigned i = recentCount % HUGEPAGE_RECENT;
+	hugePageStats.hugePages--;
+	if (!evicted) return;
+	hugePageStats.demotions++;
+	recentPid[i] = pid;
+	recentRegion[i] = region;
+	recentTick[i] = hugePageStats.samples;
+	recentCount++;
+}
+
+void hugePageSample(unsigned resident, unsigned freeFrames, unsigned freeHuge)
+{
+	hugePageStats.samples++;
+	hugePageStats.sampledResident += resident;
+	// a huge page needs one mapping instead of one per page
+	hugePageStats.sampledMappings += resident - hugePageStats.hugePages * ((1u << hugePageOrder) - 1);
+	hugePageStats.sampledFree += freeFrames;
+	hugePageStats.sampledUnusable += freeFrames - freeHuge;
+}
+
+void hugePageGetStatistics(hugePageStatistics_t* stats)
+{
+	*stats = hugePageStats;
+}
+
+void hugePagePrintStatistics(void)
+{
+	hugePageStatistics_t s;
+	hugePageGetStatistics(&s);
+	printf("Huge pages (%u pages each)\n", 1u << hugePageOrder);
+	printf("%-28s %15llu\n", "regions hot and resident", s.candidates);
+	printf("%-28s %15llu\n", "deferred after a demotion", s.deferred);
+	printf("%-28s %15llu\n", "promotions", s.promotions);
+	printf("%-28s %15llu\n", "promotions by compaction", s.compactions);
+	printf("%-28s %14.1f%%\n", "promotion success rate", (s.candidates > 0) ? 100.0 * s.promotions / s.candidates : 0.0);
+	printf("%-28s %15llu\n", "pages moved", s.pagesMoved);
+	printf("%-28s %15llu\n", "demotions", s.demotions);
+	printf("%-28s %15u\n", "max. huge pages", s.maxHugePages);
+	printf("%-28s %15.1f\n", "avg. resident pages", (s.samples > 0) ? (double)s.sampledResident / s.samples : 0.0);
+	printf("%-28s %15.1f\n", "avg. mappings", (s.samples > 0) ? (double)s.sampledMappings / s.samples : 0.0);
+	printf("%-28s %15.2f\n", "pages per mapping (reach)",
+		(s.sampledMappings > 0) ? (double)s.sampledResident / s.sampledMappings : 0.0);
+	printf("%-28s %15.1f\n", "avg. empty frames", (s.samples > 0) ? (double)s.sampledFree / s.samples : 0.0);
+	// unusable free space index: share of the empty frames no huge page fits in
+	printf("%-28s %14.1f%%\n", "fragmentation",
+		(s.sampledFree > 0) ? 100.0 * s.sampledUnusable / s.sampledFree : 0.0);
+}
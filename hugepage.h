@@ -0,0 +1,76 @@
+/* Include-file defining the huge pages (superpages)						*/
+/* The logical memory of a process is split into aligned regions of			*/
+/* 2^hugePageOrder pages. A region that is fully resident and hot, i.e.		*/
+/* at least HUGEPAGE_HOT_PERCENT of its pages were referenced since the		*/
+/* last timer event, is promoted at the timer event: its pages are moved	*/
+/* into an aligned run of frames and mapped by one entry. The run is an		*/
+/* empty block of the buddy allocator if one exists, else the run holding	*/
+/* most of the pages of the region is compacted by exchanging frames with	*/
+/* the pages in it. A huge page is demoted to base pages when one of its	*/
+/* pages is evicted.														*/
+/* Against the churn of promotions and demotions when the memory is full,	*/
+/* a region is only compacted if a huge page of frames is empty, and a		*/
+/* region demoted by an eviction is not promoted again for					*/
+/* HUGEPAGE_BACKOFF_TICKS timer events.										*/
+/* There is no TLB in the simulation: the benefit is reported as the		*/
+/* number of mappings (TLB or page table entries) needed for the resident	*/
+/* pages, sampled at every timer event.										*/
+#ifndef __HUGEPAGE__
+#define __HUGEPAGE__
+
+#include "bs_types.h"
+
+#define HUGEPAGE_MAX_ORDER 9			// largest huge page: 512 base pages
+#define HUGEPAGE_HOT_PERCENT 50			// referenced pages making a resident region hot
+#define HUGEPAGE_PROMOTE_LIMIT 4		// regions promoted per timer event at most
+#define HUGEPAGE_BACKOFF_TICKS 16		// timer events a demoted region is not promoted again
+#define HUGEPAGE_RECENT 64				// demoted regions remembered for the backoff
+
+/* statistics of the huge pages, for the report at the end of the run		*/
+typedef struct hugePageStatistics_struct
+{
+	unsigned long long candidates;		// regions found fully resident and hot
+	unsigned long long deferred;		// of these, not promoted as they were demoted recently
+	unsigned long long promotions;		// regions promoted to a huge page
+	unsigned long long compactions;		// of these, promoted by exchanging frames
+	unsigned long long pagesMoved;		// pages moved to promote the regions
+	unsigned long long demotions;		// huge pages split as a page was evicted
+	unsigned long long samples;			// timer events sampled
+	unsigned long long sampledResident;	// sum of the resident pages at each sample
+	unsigned long long sampledMappings;	// sum of the mappings needed for them
+	unsigned long long sampledFree;		// sum of the empty frames
+	unsigned long long sampledUnusable;	// sum of the empty frames not in a huge block
+	unsigned hugePages;					// current number of huge pages
+	unsigned maxHugePages;				// largest number of huge pages
+} hugePageStatistics_t;
+
+extern unsigned hugePageOrder;			// a huge page has 2^hugePageOrder pages, 0: no huge pages
+extern Boolean hugePagesEnabled;		// set by hugePageInit()
+
+void hugePageInit(void);
+/* clears the statistics, enables the huge pages for an order > 0			*/
+
+Boolean hugePageIsCandidate(unsigned pid, unsigned region);
+/* returns TRUE if the region of the process is fully resident, hot, not	*/
+/* shared with another process, not yet a huge page and not demoted in		*/
+/* the last HUGEPAGE_BACKOFF_TICKS timer events								*/
+
+void hugePagePromoted(Boolean compacted, unsigned pagesMoved);
+/* records a promotion, compacted if frames were exchanged					*/
+
+void hugePageDemoted(unsigned pid, unsigned region, Boolean evicted);
+/* records that the huge page of the region was split (evicted) or			*/
+/* released at the end of its process										*/
+
+void hugePageSample(unsigned resident, unsigned freeFrames, unsigned freeHuge);
+/* records the resident pages and the empty frames, freeHuge of them in		*/
+/* blocks a huge page fits in												*/
+
+void hugePageGetStatistics(hugePageStatistics_t* stats);
+/* returns the current statistics											*/
+
+void hugePagePrintStatistics(void);
+/* prints the promotion success rate, the mappings saved and the			*/
+/* fragmentation of the empty frames										*/
+
+#endif  /* __HUGEPAGE__ */
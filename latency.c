@@ -0,0 +1,386 @@
+/* Implementation of the latency histograms and the timeline of a run		*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <stddef.h>
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "host.h"
+#include "latency.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in latency.h	*/
+Boolean latencyHistograms = LATENCY_HISTOGRAMS;
+char latencyTraceFileName[FILENAME_LENGTH] = LATENCY_TRACE_FILENAME;
+Boolean latencyEnabled = FALSE;
+operation_t latencyOperation = read;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+// the array grows with the process table, see registerProcessArray()
+latencyProcess_t** latencyProcesses = NULL;	// NULL: nothing recorded for the process yet
+latencyHistogram_t latencyTimerHistogram;	// wall-clock time of the timer events
+latencyHistogram_t latencyTotal[2];			// sum of the processes, for the statistics
+latencyProcess_t latencyReleasedSum;		// sum of the released processes
+double latencyTickLength = 1.0;				// nanoseconds per tick of hostTicks()
+FILE* latencyTraceFile = NULL;				// NULL: timeline disabled
+char latencyTraceBuffer[LATENCY_TRACE_BUFFER_SIZE];
+size_t latencyTraceFill = 0;				// bytes used in latencyTraceBuffer
+Boolean latencyTraceError = FALSE;			// a write error occured
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+latencyProcess_t* getLatencyProcess(unsigned pid);
+/* returns the histograms of the process, allocated on first use, NULL if	*/
+/* out of memory															*/
+
+void recordLatency(latencyHistogram_t* histogram, unsigned long long value);
+/* increments the bucket of the value, values above UINT_MAX are counted	*/
+/* as UINT_MAX																*/
+
+void recordTicks(latencyHistogram_t* histogram, unsigned long long started);
+/* records the wall-clock time since started in nanoseconds					*/
+
+unsigned latencyBucket(unsigned value);
+/* returns the index of the bucket of the value								*/
+
+unsigned latencyBucketHigh(unsigned bucket);
+/* returns the highest value counted by the bucket							*/
+
+unsigned latencyPercentile(const latencyHistogram_t* histogram, double fraction);
+/* returns the value not exceeded by the given fraction of the values		*/
+
+void addLatencyHistogram(latencyHistogram_t* sum, const latencyHistogram_t* histogram);
+/* adds the values of the histogram to sum									*/
+
+void printLatencyHistogram(const char* label, const latencyHistogram_t* histogram);
+/* prints one line of the statistics, nothing for an empty histogram		*/
+
+void printLatencyKind(const char* kind, size_t offset);
+/* prints the totals and the processes of the histograms at the given		*/
+/* offset in latencyProcess_t												*/
+
+void startTraceEvent(const char* name, const char* phase, unsigned time, unsigned pid);
+/* writes the start of an event of the timeline up to its arguments,		*/
+/* naming the row of the process on its first event							*/
+
+void putTrace(const char* text);
+/* appends the text to the buffer of the timeline							*/
+
+void putTraceNumber(unsigned long long value);
+/* appends the value in decimal to the buffer of the timeline				*/
+
+void flushTrace(void);
+/* writes the buffer to the file											*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+Boolean latencyOpen(void)
+{
+	latencyEnabled = latencyHistograms || (latencyTraceFileName[0] != '\0');
+	memset(&latencyTimerHistogram, 0, sizeof(latencyTimerHistogram));
+	memset(&latencyReleasedSum, 0, sizeof(latencyReleasedSum));
+	if (!latencyEnabled) return TRUE;
+	if (!registerProcessArray((void**)&latencyProcesses, sizeof(latencyProcess_t*)))
+	{
+		latencyEnabled = FALSE;
+		return FALSE;
+	}
+	if (latencyHistograms) latencyTickLength = hostNanosecondsPerTick();
+	if (latencyTraceFileName[0] == '\0') return TRUE;
+	latencyTraceFile = fopen(latencyTraceFileName, "wb");
+	if (latencyTraceFile == NULL) return FALSE;
+	latencyTraceError = FALSE;
+	latencyTraceFill = (size_t)snprintf(latencyTraceBuffer, LATENCY_TRACE_BUFFER_SIZE,
+		"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"%s, %u frames\"}},\n"
+		"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"OS\"}}",
+		getReplacementPolicyName(replacementPolicy), MEMORYSIZE);
+	return TRUE;
+}
+
+unsigned long long latencyStart(operation_t op)
+{
+	latencyOperation = op;
+	return latencyHistograms ? hostTicks() : 0;
+}
+
+unsigned long long latencyClock(void)
+{
+	return latencyHistograms ? hostTicks() : 0;
+}
+
+void latencyAccessed(unsigned pid, operation_t op, unsigned long long started)
+{
+	latencyProcess_t* process;
+	if (!latencyHistograms || ((process = getLatencyProcess(pid)) == NULL)) return;
+	recordTicks(&process->access[op == write], started);
+}
+
+void latencyReplaced(unsigned pid, unsigned long long started)
+{
+	latencyProcess_t* process;
+	if (!latencyHistograms || ((process = getLatencyProcess(pid)) == NULL)) return;
+	recordTicks(&process->replacement[latencyOperation == write], started);
+}
+
+void latencyTimer(unsigned ticks, unsigned long long started)
+{
+	if (latencyHistograms) recordTicks(&latencyTimerHistogram, started);
+	if (latencyTraceFile == NULL) return;
+	startTraceEvent("timer", "i", systemTime, NOPROCESS);
+	putTrace("\"s\":\"g\",\"args\":{\"ticks\":");
+	putTraceNumber(ticks);
+	putTrace("}}");
+}
+
+void latencyFault(unsigned pid, unsigned page, int frame)
+{
+	if (latencyTraceFile == NULL) return;
+	startTraceEvent("fault", "i", systemTime, pid);
+	putTrace("\"s\":\"t\",\"args\":{\"page\":");
+	putTraceNumber(page);
+	putTrace(",\"frame\":");
+	putTraceNumber((unsigned)frame);
+	putTrace((latencyOperation == write) ? ",\"op\":\"write\"}}" : ",\"op\":\"read\"}}");
+}
+
+void latencyEvicted(unsigned pid, unsigned victimPid, unsigned victimPage, int frame)
+{
+	if (latencyTraceFile == NULL) return;
+	// shown in the row of the process losing the page
+	startTraceEvent("evict", "i", systemTime, victimPid);
+	putTrace("\"s\":\"t\",\"args\":{\"page\":");
+	putTraceNumber(victimPage);
+	putTrace(",\"frame\":");
+	putTraceNumber((unsigned)frame);
+	putTrace(",\"for\":");
+	putTraceNumber(processTable[pid].pid);
+	putTrace("}}");
+}
+
+void latencyFaultServed(unsigned pid, operation_t op, unsigned submitted, unsigned completed,
+	Boolean decompressed)
+{
+	latencyProcess_t* process;
+	if (latencyHistograms && ((process = getLatencyProcess(pid)) != NULL))
+		recordLatency(&process->service[op == write], completed - submitted);
+	if (latencyTraceFile == NULL) return;
+	startTraceEvent(decompressed ? "decompression" : "page read", "X", submitted, pid);
+	putTrace("\"dur\":");
+	putTraceNumber(completed - submitted);
+	putTrace((op == write) ? ",\"args\":{\"op\":\"write\"}}" : ",\"args\":{\"op\":\"read\"}}");
+}
+
+void latencyReleased(unsigned pid)
+{
+	latencyProcess_t* process = latencyProcesses[pid];
+	if (process == NULL) return;
+	for (unsigned op = 0; op < 2; op++)
+	{
+		addLatencyHistogram(&latencyReleasedSum.access[op], &process->access[op]);
+		addLatencyHistogram(&latencyReleasedSum.replacement[op], &process->replacement[op]);
+		addLatencyHistogram(&latencyReleasedSum.service[op], &process->service[op]);
+	}
+	free(process);
+	latencyProcesses[pid] = NULL;
+}
+
+void latencyPrintStatistics(void)
+{
+	printf("Latency histograms (wall-clock in ns, page fault service in time units)\n");
+	printf("%-28s %10s %10s %10s %10s %10s %10s %10s\n", "", "count", "mean", "p50", "p90", "p99", "p99.9",
+		"max");
+	printLatencyKind("accessPage()", offsetof(latencyProcess_t, access));
+	printLatencyKind("pageReplacement()", offsetof(latencyProcess_t, replacement));
+	printLatencyKind("page fault service", offsetof(latencyProcess_t, service));
+	printLatencyHistogram("timerEventHandler()", &latencyTimerHistogram);
+}
+
+Boolean latencyClose(void)
+{
+	Boolean ok = TRUE;
+	if (latencyTraceFile != NULL)
+	{
+		putTrace("\n]}\n");
+		flushTrace();
+		ok = (fclose(latencyTraceFile) == 0) && !latencyTraceError;
+		latencyTraceFile = NULL;
+	}
+	if (latencyProcesses != NULL)
+		for (unsigned index = 0; index < processCount; index++)
+		{
+			free(latencyProcesses[index]);
+			latencyProcesses[index] = NULL;
+		}
+	latencyEnabled = FALSE;
+	return ok;
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+latencyProcess_t* getLatencyProcess(unsigned pid)
+{
+	if (latencyProcesses[pid] == NULL)
+		latencyProcesses[pid] = calloc(1, sizeof(latencyProcess_t));
+	return latencyProcesses[pid];
+}
+
+void recordLatency(latencyHistogram_t* histogram, unsigned long long value)
+{
+	unsigned v = (value > UINT_MAX) ? UINT_MAX : (unsigned)value;
+	if ((histogram->count == 0) || (v < histogram->min)) histogram->min = v;
+	if (v > histogram->max) histogram->max = v;
+	histogram->count++;
+	histogram->sum += v;
+	histogram->bucket[latencyBucket(v)]++;
+}
+
+void recordTicks(latencyHistogram_t* histogram, unsigned long long started)
+{
+	recordLatency(histogram, (unsigned long long)((double)(hostTicks() - started) * latencyTickLength));
+}
+
+unsigned latencyBucket(unsigned value)
+{
+	unsigned msb = 0;					// position of the highest bit set
+	unsigned shift;
+	if (value < (2u << LATENCY_SUB_BITS)) return value;
+	for (unsigned step = 16; step > 0; step >>= 1)
+		if ((value >> (msb + step)) != 0) msb += step;
+	// the highest LATENCY_SUB_BITS + 1 bits select the bucket
+	shift = msb - LATENCY_SUB_BITS;
+	return ((shift + 1) << LATENCY_SUB_BITS) + (value >> shift) - (1u << LATENCY_SUB_BITS);
+}
+
+unsigned latencyBucketHigh(unsigned bucket)
+{
+	unsigned shift;
+	if (bucket < (2u << LATENCY_SUB_BITS)) return bucket;
+	shift = (bucket >> LATENCY_SUB_BITS) - 1;
+	return (((1u << LATENCY_SUB_BITS) + (bucket & ((1u << LATENCY_SUB_BITS) - 1))) << shift)
+		+ ((1u << shift) - 1);
+}
+
+unsigned latencyPercentile(const latencyHistogram_t* histogram, double fraction)
+{
+	unsigned long long target = (unsigned long long)(fraction * histogram->count + 0.999999);
+	unsigned long long seen = 0;
+	unsigned value;
+	if (target < 1) target = 1;
+	for (unsigned bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+	{
+		seen += histogram->bucket[bucket];
+		if (seen >= target)
+		{	// the highest value of the bucket, the recorded extremes are exact
+			value = latencyBucketHigh(bucket);
+			if (value > histogram->max) value = histogram->max;
+			return (value < histogram->min) ? histogram->min : value;
+		}
+	}
+	return histogram->max;
+}
+
+void addLatencyHistogram(latencyHistogram_t* sum, const latencyHistogram_t* histogram)
+{
+	if (histogram->count == 0) return;
+	if ((sum->count == 0) || (histogram->min < sum->min)) sum->min = histogram->min;
+	if (histogram->max > sum->max) sum->max = histogram->max;
+	sum->count += histogram->count;
+	sum->sum += histogram->sum;
+	for (unsigned bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+		sum->bucket[bucket] += histogram->bucket[bucket];
+}
+
+void printLatencyHistogram(const char* label, const latencyHistogram_t* histogram)
+{
+	if (histogram->count == 0) return;
+	printf("%-28s %10llu %10.1f %10u %10u %10u %10u %10u\n", label, histogram->count,
+		(double)histogram->sum / histogram->count, latencyPercentile(histogram, 0.5),
+		latencyPercentile(histogram, 0.9), latencyPercentile(histogram, 0.99),
+		latencyPercentile(histogram, 0.999), histogram->max);
+}
+
+void printLatencyKind(const char* kind, size_t offset)
+{
+	const latencyHistogram_t* histograms;
+	char label[64];
+	memcpy(latencyTotal, (const char*)&latencyReleasedSum + offset, sizeof(latencyTotal));
+	for (unsigned index = 1; index < processCount; index++)
+		if (latencyProcesses[index] != NULL)
+		{
+			histograms = (const latencyHistogram_t*)((const char*)latencyProcesses[index] + offset);
+			addLatencyHistogram(&latencyTotal[0], &histograms[0]);
+			addLatencyHistogram(&latencyTotal[1], &histograms[1]);
+		}
+	for (unsigned op = 0; op < 2; op++)
+	{
+		snprintf(label, sizeof(label), "%s %s", kind, (op == 0) ? "read" : "write");
+		printLatencyHistogram(label, &latencyTotal[op]);
+	}
+	for (unsigned index = 1; index < processCount; index++)
+		if (latencyProcesses[index] != NULL)
+			for (unsigned op = 0; op < 2; op++)
+			{
+				histograms = (const latencyHistogram_t*)((const char*)latencyProcesses[index] + offset);
+				snprintf(label, sizeof(label), "  PID %3u %s", processTable[index].pid, (op == 0) ? "read" : "write");
+				printLatencyHistogram(label, &histograms[op]);
+			}
+}
+
+void startTraceEvent(const char* name, const char* phase, unsigned time, unsigned pid)
+{
+	latencyProcess_t* process;
+	unsigned tid = (pid == NOPROCESS) ? 0 : processTable[pid].pid;
+	// room for the naming of the row and the event
+	if (latencyTraceFill + 2 * LATENCY_TRACE_EVENT_MAX > LATENCY_TRACE_BUFFER_SIZE) flushTrace();
+	if ((pid != NOPROCESS) && ((process = getLatencyProcess(pid)) != NULL) && !process->named)
+	{	// the viewer shows a row per thread, one for each process
+		process->named = TRUE;
+		putTrace(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+		putTraceNumber(tid);
+		putTrace(",\"args\":{\"name\":\"PID ");
+		putTraceNumber(tid);
+		putTrace("\"}}");
+	}
+	putTrace(",\n{\"name\":\"");
+	putTrace(name);
+	putTrace("\",\"ph\":\"");
+	putTrace(phase);
+	putTrace("\",\"ts\":");
+	putTraceNumber(time);
+	putTrace(",\"pid\":1,\"tid\":");
+	putTraceNumber(tid);
+	putTrace(",");
+}
+
+void putTrace(const char* text)
+{
+	size_t length = strlen(text);
+	memcpy(&latencyTraceBuffer[latencyTraceFill], text, length);
+	latencyTraceFill += length;
+}
+
+void putTraceNumber(unsigned long long value)
+{
+	char digits[20];
+	unsigned count = 0;
+	do {	// the digits from the lowest one
+		digits[count++] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value > 0);
+	while (count > 0)
+		latencyTraceBuffer[latencyTraceFill++] = digits[--count];
+}
+
+void flushTrace(void)
+{
+	if (fwrite(latencyTraceBuffer, 1, latencyTraceFill, latencyTraceFile) != latencyTraceFill)
+		latencyTraceError = TRUE;
+	latencyTraceFill = 0;
+}
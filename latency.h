@@ -0,0 +1,96 @@
+/* Include-file defining the latency histograms and the timeline of a run	*/
+/* The histograms count the wall-clock time spent in accessPage(),			*/
+/* pageReplacement() and timerEventHandler() in nanoseconds, and the		*/
+/* simulated time a page fault waited for the disk or the decompression.	*/
+/* They are kept per process and per operation (read/write) and are			*/
+/* log-bucketed as HDR histograms: the values below 32 have a bucket each,	*/
+/* above each power of two is split into 16 buckets, so that a percentile	*/
+/* is exact to 1/16 of its value with a fixed number of buckets. Recording	*/
+/* a value only increments its bucket, the histograms of the processes are	*/
+/* added up for the totals. The wall-clock time is read from the time		*/
+/* stamp counter where available, see hostTicks().							*/
+/* The timeline is a Chrome trace (JSON), to be loaded into a trace viewer	*/
+/* such as chrome://tracing or Perfetto. It holds the page faults, the		*/
+/* evictions and the timer events as instants and the waits for the disk	*/
+/* as spans, one row per process, in simulated time (1 unit is shown as 1	*/
+/* microsecond). The events are formatted into a large buffer by hand.		*/
+/* Both are recorded on a single CPU only.									*/
+#ifndef __LATENCY__
+#define __LATENCY__
+
+#include "bs_types.h"
+
+#define LATENCY_SUB_BITS 4				// 2^LATENCY_SUB_BITS buckets per power of two
+#define LATENCY_BUCKETS ((32 - LATENCY_SUB_BITS + 1) << LATENCY_SUB_BITS)	// values up to UINT_MAX
+#define LATENCY_TRACE_BUFFER_SIZE (1 << 20)	// size of the I/O buffer of the timeline in bytes
+#define LATENCY_TRACE_EVENT_MAX 256		// longest event of the timeline in bytes
+
+/* log-bucketed histogram of 32 bit values									*/
+typedef struct latencyHistogram_struct
+{
+	unsigned long long count;			// values recorded
+	unsigned long long sum;				// for the mean
+	unsigned min, max;					// exact, the buckets only bound them
+	unsigned long long bucket[LATENCY_BUCKETS];
+} latencyHistogram_t;
+
+/* histograms of one entry of the process table, index 0 reads, 1 writes	*/
+typedef struct latencyProcess_struct
+{
+	latencyHistogram_t access[2];		// wall-clock time of accessPage()
+	latencyHistogram_t replacement[2];	// wall-clock time of pageReplacement() in its faults
+	latencyHistogram_t service[2];		// simulated time its page faults waited
+	Boolean named;						// the row of the process in the timeline is named
+} latencyProcess_t;
+
+extern Boolean latencyHistograms;		// record the histograms, printed at the end
+extern char latencyTraceFileName[];		// timeline written by the OS, empty: none
+extern Boolean latencyEnabled;			// histograms or timeline recorded, checked by the callers
+extern operation_t latencyOperation;	// operation of the running accessPage()
+
+Boolean latencyOpen(void);
+/* clears the histograms and creates the timeline if requested. Sets		*/
+/* latencyEnabled. Returns FALSE if the timeline cannot be created			*/
+
+unsigned long long latencyStart(operation_t op);
+/* called by accessPage() before an access of the given operation, returns	*/
+/* the wall-clock time in ticks of hostTicks(), 0 without histograms		*/
+
+unsigned long long latencyClock(void);
+/* returns the wall-clock time in ticks of hostTicks(), 0 without			*/
+/* histograms																*/
+
+void latencyAccessed(unsigned pid, operation_t op, unsigned long long started);
+/* records the time of an accessPage() of the process started at the given	*/
+/* time																		*/
+
+void latencyReplaced(unsigned pid, unsigned long long started);
+/* records the time of a pageReplacement() in a page fault of the process	*/
+
+void latencyTimer(unsigned ticks, unsigned long long started);
+/* records the time of a timerEventHandler() for the given ticks			*/
+
+void latencyFault(unsigned pid, unsigned page, int frame);
+/* adds a page fault of the process to the timeline							*/
+
+void latencyEvicted(unsigned pid, unsigned victimPid, unsigned victimPage, int frame);
+/* adds the eviction of a page for a page fault of pid to the timeline		*/
+
+void latencyFaultServed(unsigned pid, operation_t op, unsigned submitted, unsigned completed,
+	Boolean decompressed);
+/* records the simulated time a page fault of the process waited from		*/
+/* submitted to completed, for a disk read or a decompression				*/
+
+void latencyReleased(unsigned pid);
+/* adds the histograms of the process to the totals and frees them, called	*/
+/* before its entry of the process table is reused							*/
+
+void latencyPrintStatistics(void);
+/* prints count, mean, percentiles and maximum of the histograms, the		*/
+/* totals of each kind first, then the processes not released				*/
+
+Boolean latencyClose(void);
+/* completes and closes the timeline and releases the histograms, returns	*/
+/* FALSE on a write error													*/
+
+#endif  /* __LATENCY__ */
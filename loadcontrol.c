@@ -0,0 +1,195 @@
+/* Implementation of the load control (medium-term scheduler)				*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <stdio.h>
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "loadcontrol.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in loadcontrol.h	*/
+unsigned loadControlHigh = LOAD_CONTROL_HIGH;
+unsigned loadControlLow = LOAD_CONTROL_LOW;
+unsigned loadControlSuspended = 0;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+extern unsigned long long* processDelay;			// owned by the loop with blocking page faults
+extern unsigned blockedProcesses;
+
+Boolean loadControlActive = FALSE;		// set by loadControlInit()
+// the arrays grow with the process table, see registerProcessArray()
+unsigned* suspendedPids = NULL;			// the suspended processes, suspended longest first
+unsigned* suspendedAt = NULL;			// time each process was suspended
+status_t* statusBefore = NULL;			// status of each process when it was suspended
+unsigned loadControlTicks = 0;			// number of timer events since loadControlInit()
+unsigned* suspendedAtTick = NULL;		// timer event each process was suspended at
+unsigned lastSuspensionTick = 0;		// timer event of the last suspension
+unsigned long long windowFaults = 0;	// faults and accesses since the last suspension
+unsigned long long windowAccesses = 0;
+unsigned long long suspensionFaults = 0;	// the same up to the last suspension
+unsigned long long suspensionAccesses = 0;
+unsigned long long lastAccesses = 0;	// accesses and faults at the last timer event
+unsigned long long lastFaults = 0;
+loadControlStatistics_t loadControlStats;
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+Boolean suspendLargestProcess(void);
+/* suspends the process holding the most frames of those that may run,		*/
+/* if at least one other process remains. Returns FALSE if none is			*/
+/* suspended																*/
+
+unsigned activeProcesses(void);
+/* returns the number of live processes not suspended						*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+void loadControlInit(void)
+{
+	classStatistics_t stats[CLASS_COUNT];
+	registerProcessArray((void**)&suspendedPids, sizeof(unsigned));
+	registerProcessArray((void**)&suspendedAt, sizeof(unsigned));
+	registerProcessArray((void**)&suspendedAtTick, sizeof(unsigned));
+	registerProcessArray((void**)&statusBefore, sizeof(status_t));
+	loadControlSuspended = 0;
+	loadControlTicks = lastSuspensionTick = 0;
+	windowFaults = windowAccesses = suspensionFaults = suspensionAccesses = 0;
+	// the accesses and faults are counted per class by procclass.c
+	classGetStatistics(stats);
+	lastAccesses = lastFaults = 0;
+	for (unsigned i = 0; i < CLASS_COUNT; i++)
+	{
+		lastAccesses += stats[i].accesses;
+		lastFaults += stats[i].faults;
+	}
+	memset(&loadControlStats, 0, sizeof(loadControlStats));
+	loadControlActive = (loadControlHigh > 0);
+}
+
+void loadControlTick(void)
+{
+	classStatistics_t stats[CLASS_COUNT];
+	unsigned long long accesses = 0, faults = 0;
+	if (!loadControlActive) return;
+	loadControlTicks++;
+	classGetStatistics(stats);
+	for (unsigned i = 0; i < CLASS_COUNT; i++)
+	{
+		accesses += stats[i].accesses;
+		faults += stats[i].faults;
+	}
+	// fault rate of the period, idle periods give no evidence either way
+	accesses -= lastAccesses;
+	faults -= lastFaults;
+	lastAccesses += accesses;
+	lastFaults += faults;
+	windowAccesses += accesses;
+	windowFaults += faults;
+	if ((loadControlSuspended > 0) && (activeProcesses() == 0))
+		loadControlResumeNext();			// nothing else can run
+	else if (accesses == 0)
+		return;
+	else if (100 * faults >= loadControlHigh * accesses)
+	{
+		loadControlStats.thrashingPeriods++;
+		// the others first fault the frames of the suspended process in, another one
+		// is suspended if that lowered the fault rate, else suspending does not help
+		if (((loadControlSuspended == 0)
+				|| ((loadControlTicks - lastSuspensionTick >= LOAD_CONTROL_MIN_TICKS)
+					&& (windowFaults * suspensionAccesses < suspensionFaults * windowAccesses)))
+			&& suspendLargestProcess())
+		{
+			lastSuspensionTick = loadControlTicks;
+			suspensionFaults = windowFaults;
+			suspensionAccesses = windowAccesses;
+			windowFaults = windowAccesses = 0;
+		}
+	}
+	else if ((100 * faults < loadControlLow * accesses) && (loadControlSuspended > 0)
+		&& (loadControlTicks - suspendedAtTick[suspendedPids[0]] >= LOAD_CONTROL_MIN_TICKS))
+		loadControlResumeNext();
+}
+
+Boolean loadControlResumeNext(void)
+{
+	unsigned pid;
+	if (loadControlSuspended == 0) return FALSE;
+	pid = suspendedPids[0];
+	memmove(suspendedPids, suspendedPids + 1, --loadControlSuspended * sizeof(unsigned));
+	processTable[pid].status = statusBefore[pid];
+	if (statusBefore[pid] == blocked) blockedProcesses++;	// still waits for its page read
+	// the process lags behind the stimulus by the time it was suspended
+	processDelay[pid] += systemTime - suspendedAt[pid];
+	loadControlStats.suspendedTime += systemTime - suspendedAt[pid];
+	loadControlStats.resumptions++;
+	logPid(pid, "Resumed by the load control");
+	return TRUE;
+}
+
+void loadControlReadCompleted(unsigned pid)
+{
+	statusBefore[pid] = ready;
+}
+
+void loadControlGetStatistics(loadControlStatistics_t* stats)
+{
+	*stats = loadControlStats;
+}
+
+void loadControlPrintStatistics(void)
+{
+	loadControlStatistics_t s;
+	loadControlGetStatistics(&s);
+	printf("Load control (suspend at %u%%, resume below %u%% faults)\n", loadControlHigh, loadControlLow);
+	printf("%-28s %15llu\n", "thrashing periods", s.thrashingPeriods);
+	printf("%-28s %15llu\n", "processes suspended", s.suspensions);
+	printf("%-28s %15llu\n", "processes resumed", s.resumptions);
+	printf("%-28s %15u\n", "max. suspended at once", s.maxSuspended);
+	printf("%-28s %15llu\n", "pages swapped out", s.pagesSwappedOut);
+	printf("%-28s %15llu\n", "suspended time", s.suspendedTime);
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+Boolean suspendLargestProcess(void)
+{
+	unsigned pid, victim = NOPROCESS, pages;
+	if (activeProcesses() < 2) return FALSE;	// the last process keeps running
+	// when thrashing most processes wait for a page read, it completes while
+	// the process is suspended
+	for (unsigned i = 0; i < liveProcessCount; i++)
+	{
+		pid = liveProcessList[i];
+		if (((processTable[pid].status == running) || (processTable[pid].status == ready)
+				|| (processTable[pid].status == blocked))
+			&& ((victim == NOPROCESS) || (processTable[pid].residentCount > processTable[victim].residentCount)))
+			victim = pid;
+	}
+	if (victim == NOPROCESS) return FALSE;
+	pages = swapOutProcess(victim);
+	statusBefore[victim] = processTable[victim].status;
+	if (statusBefore[victim] == blocked) blockedProcesses--;
+	processTable[victim].status = suspended;
+	suspendedAt[victim] = systemTime;
+	suspendedAtTick[victim] = loadControlTicks;
+	suspendedPids[loadControlSuspended++] = victim;
+	if (loadControlSuspended > loadControlStats.maxSuspended) loadControlStats.maxSuspended = loadControlSuspended;
+	loadControlStats.suspensions++;
+	loadControlStats.pagesSwappedOut += pages;
+	if (logEnabled)
+		printf("%6u : PID %3u : Suspended by the load control, %u pages swapped out\n", systemTime,
+			processTable[victim].pid, pages);
+	return TRUE;
+}
+
+unsigned activeProcesses(void)
+{
+	return liveProcessCount - loadControlSuspended;
+}
@@ -0,0 +1,63 @@
+/* Include-file defining the load control (medium-term scheduler) of the	*/
+/* loop with blocking page faults, see coreLoopBlockingIO().				*/
+/* At each timer event the page faults of the last period are compared		*/
+/* with the memory accesses completed in it. If at least loadControlHigh	*/
+/* percent of the accesses faulted, the memory is thrashing: the process	*/
+/* holding the most frames is suspended. While processes are suspended,		*/
+/* another one is suspended at least LOAD_CONTROL_MIN_TICKS timer events	*/
+/* after the last suspension and only if the fault rate since then is		*/
+/* lower than before it: if the last suspension did not lower it, the		*/
+/* processes do not thrash for lack of frames and further ones would only	*/
+/* take away the overlap of their page reads.								*/
+/* All resident pages of the suspended process are moved out at once		*/
+/* (swapOutProcess()), its page table is kept and its events wait until it	*/
+/* is resumed, a page read it waits for completes meanwhile.				*/
+/* If less than loadControlLow percent faulted, the process suspended		*/
+/* longest is resumed, after at least LOAD_CONTROL_MIN_TICKS timer events.	*/
+/* Its pages fault back in on demand, the time it was suspended delays its	*/
+/* later events like the time blocked on a page read.						*/
+/* A suspended process is also resumed if no other process can run.			*/
+#ifndef __LOADCONTROL__
+#define __LOADCONTROL__
+
+#include "bs_types.h"
+
+#define LOAD_CONTROL_MIN_TICKS 4	// timer events a process stays suspended at least, and between suspensions
+
+/* statistics of the load control, for the report at the end of the run		*/
+typedef struct loadControlStatistics_struct
+{
+	unsigned long long thrashingPeriods;	// timer periods with a fault rate of at least loadControlHigh
+	unsigned long long suspensions;			// processes suspended
+	unsigned long long resumptions;			// processes resumed
+	unsigned long long pagesSwappedOut;		// resident pages moved out with the suspended processes
+	unsigned long long suspendedTime;		// sum of the times the processes were suspended
+	unsigned maxSuspended;					// processes suspended at the same time at most
+} loadControlStatistics_t;
+
+extern unsigned loadControlHigh;		// fault rate in percent to suspend a process, 0: off
+extern unsigned loadControlLow;			// fault rate in percent to resume a process
+extern unsigned loadControlSuspended;	// number of processes suspended now
+
+void loadControlInit(void);
+/* clears the suspended processes and the statistics, called by the loop	*/
+/* with blocking page faults, which the load control is active in			*/
+
+void loadControlTick(void);
+/* called by the timer event handler: detects thrashing from the page		*/
+/* faults and accesses since the last call, suspends or resumes a process	*/
+
+Boolean loadControlResumeNext(void);
+/* resumes the process suspended longest, returns FALSE if none is			*/
+
+void loadControlReadCompleted(unsigned pid);
+/* the page read the suspended process waited for completed, the process	*/
+/* is ready when it is resumed												*/
+
+void loadControlGetStatistics(loadControlStatistics_t* stats);
+/* returns the current statistics											*/
+
+void loadControlPrintStatistics(void);
+/* prints the thrashing periods, the suspensions and the pages swapped out	*/
+
+#endif  /* __LOADCONTROL__ */
@@ -0,0 +1,856 @@
+/* Implementation of the simulation of the processes under local quotas		*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "localsim.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in localsim.h	*/
+unsigned localQuota = LOCAL_QUOTA;
+unsigned localThreads = LOCAL_THREADS;
+Boolean localCheck = FALSE;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+
+/* an event in a batch, its actions follow it								*/
+typedef struct localEvent_struct
+{
+	unsigned time;
+	unsigned pid;
+	unsigned actionCount;
+} localEvent_t;
+
+/* events of the processes of a shard handed from the reader to the			*/
+/* threads, stored one after the other in data								*/
+typedef struct localBatch_struct
+{
+	struct localBatch_struct* next;
+	size_t size;				// bytes used in data
+	size_t capacity;			// bytes allocated for data
+	char data[];
+} localBatch_t;
+
+/* the page faults of one timer period, a timeline lists the periods with	*/
+/* faults by ascending period												*/
+typedef struct localPeriod_struct
+{
+	unsigned period;
+	unsigned faults;
+} localPeriod_t;
+
+/* the pages of a running process within its quota, the arrays follow the	*/
+/* structure in the same allocation											*/
+typedef struct localProcess_struct
+{
+	unsigned size;				// pages of the process
+	unsigned used;				// frames 0..used-1 hold pages
+	unsigned tick;				// timer period the counters are updated to
+	int* frameOfPage;			// frame of each page, NONE if not resident
+	unsigned* pageOfFrame;
+	agingCounter_t* counter;	// aging counters of the frames, see aging.h
+	agingCounter_t* empty;		// AGING_EMPTY for the frames without a page, 0 otherwise
+	unsigned char* referenced;
+	unsigned char* modified;
+} localProcess_t;
+
+/* a family of processes, one started by the stimulus and the children		*/
+/* forked by it or by them, with the batches waiting for a thread			*/
+typedef struct localShard_struct
+{
+	smpLock_t lock;				// guards head, tail and queued
+	localBatch_t* head;			// batches waiting, oldest first
+	localBatch_t* tail;
+	Boolean queued;				// in a deque or run by a thread
+	unsigned home;				// thread whose deque the shard joins
+	localBatch_t* open;			// batch filled by the reader
+	localPeriod_t* timeline;	// page faults of the periods with faults
+	unsigned timelineCount;		// entries of the timeline
+	unsigned timelineCapacity;
+	char* error;				// error that stopped the shard, NULL if none
+	unsigned errorPid;			// process of the error
+	struct localShard_struct* nextShard;	// all shards, for the merge
+} localShard_t;
+
+/* the shards with batches waiting for a thread, a ring: the owner takes	*/
+/* them from the head, the thieves from the tail							*/
+typedef struct localDeque_struct
+{
+	smpLock_t lock;
+	localShard_t** shards;		// processCount entries, a shard is in one deque at most
+	unsigned head;
+	unsigned count;
+	unsigned long long steals;	// shards this thread took from other deques, once per batch run
+} localDeque_t;
+
+// the arrays grow with the process table, see registerProcessArray()
+localShard_t** shardOfProcess = NULL;		// shard of each process, NULL if none
+localProcess_t** localProcesses = NULL;		// pages of each running process of the shards
+localStatistics_t* localProcessStats = NULL;	// counters of each process
+localShard_t* localShardList = NULL;
+unsigned localShardCount = 0;
+localDeque_t localDeques[SMP_MAX_CPUS];
+smpLock_t localQueueLock;				// guards localQueued, localQueuedPeak and localReadDone
+unsigned long long localQueued = 0;		// bytes of the batches waiting
+unsigned long long localQueuedPeak = 0;
+Boolean localReadDone = FALSE;			// all batches are queued
+unsigned localLastTime = 0;				// time of the last event read
+localShard_t localReference;			// timeline of the run through coreLoop()
+localStatistics_t localStats;			// merged results of the last run
+localPeriod_t* localTimeline = NULL;	// merged page faults of the periods with faults
+unsigned localTimelineCount = 0;
+unsigned localPeriods = 0;				// timer periods up to the last event
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+Boolean runReference(void);
+/* runs the stimulus through coreLoop() and merges the counters, returns	*/
+/* FALSE on errors															*/
+
+Boolean runShards(void);
+/* streams the stimulus to the shards on the thread pool and merges their	*/
+/* results, returns FALSE on errors											*/
+
+Boolean readStimulus(void);
+/* reads the stimulus into the batches of the shards and queues them,		*/
+/* runs shards itself while LOCAL_QUEUE_SIZE bytes wait. Returns FALSE if	*/
+/* out of memory or for a fork of a process started before					*/
+
+Boolean appendEvent(localShard_t* shard, const memoryEvent_t* event);
+/* appends the event to the open batch of the shard, returns FALSE if out	*/
+/* of memory																*/
+
+Boolean queueFull(void);
+/* predicate: LOCAL_QUEUE_SIZE bytes of batches or more are waiting			*/
+
+void queueBatch(localShard_t* shard);
+/* hands the open batch of the shard to the threads, the shard joins the	*/
+/* deque of its thread unless it is queued already							*/
+
+void localWorker(unsigned thread);
+/* runs the shards of its deque and steals from the others until all		*/
+/* batches are done, runs on a thread of the pool							*/
+
+Boolean runQueuedShard(unsigned thread, unsigned long long* steals);
+/* takes a shard from the deque of the thread, else from another one, and	*/
+/* runs its batches. Returns FALSE if no shard is waiting					*/
+
+void runShard(localShard_t* shard);
+/* runs the batches of the shard until none is waiting						*/
+
+Boolean runEvent(localShard_t* shard, const localEvent_t* event, const action_t* actions);
+/* simulates the actions of the event with local aging replacement,			*/
+/* returns FALSE on errors, which stop the shard							*/
+
+localProcess_t* newProcess(unsigned size, unsigned tick);
+/* allocates the pages of a process with no resident page, NULL if out of	*/
+/* memory																	*/
+
+Boolean countShardFault(localShard_t* shard, unsigned period);
+/* counts a page fault in the timeline of the shard, the periods come in	*/
+/* ascending order. Returns FALSE if out of memory							*/
+
+Boolean mergeResults(void);
+/* sums up the counters of the processes and merges the timelines of the	*/
+/* shards and of the run through coreLoop(). Returns FALSE if a shard		*/
+/* stopped on an error or out of memory										*/
+
+void freeShards(void);
+/* frees the shards with their batches and the pages of their processes		*/
+
+Boolean sameStatistics(const localStatistics_t* a, const localStatistics_t* b);
+/* predicate: the counters are equal										*/
+
+int comparePeriod(const void* a, const void* b);
+/* orders the entries of timelines by ascending period						*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+Boolean setLocalQuota(const char* spec)
+{
+	unsigned quota, threads = 1;
+	char check[8] = "";
+	int fields = sscanf(spec, "%u,%u,%7s", &quota, &threads, check);
+	if ((fields < 1) || (quota == 0) || (threads == 0) || (threads > SMP_MAX_CPUS)
+		|| ((fields == 3) && ((strcmp(check, "check") != 0) || (threads == 1))))
+		return FALSE;
+	localQuota = quota;
+	localThreads = threads;
+	localCheck = (fields == 3);
+	return TRUE;
+}
+
+Boolean localSimRun(void)
+{
+	long start = sim_StimulusOffset();	// the check reads the stimulus again from here
+	localStatistics_t* shardStats = NULL;	// counters of the processes in the shards
+	localPeriod_t* shardTimeline;
+	unsigned shardTimelineCount, shardPeriods;
+	Boolean ok;
+	if (sim_randomAccess)
+	{
+		logGeneric("OS-ERROR: Local quotas need a stimulus file");
+		return FALSE;
+	}
+	if (!registerProcessArray((void**)&localProcessStats, sizeof(localStatistics_t)))
+	{
+		logGeneric("OS-ERROR: Not enough memory for the counters of the processes");
+		return FALSE;
+	}
+	if (localThreads == 1) return runReference();
+	ok = runShards();
+	if (!ok || !localCheck) return ok;
+	// the run through coreLoop() sets the results, the ones of the shards are kept
+	shardStats = malloc(processCount * sizeof(localStatistics_t));
+	if (shardStats == NULL)
+	{
+		logGeneric("OS-ERROR: Not enough memory for the check");
+		return FALSE;
+	}
+	memcpy(shardStats, localProcessStats, processCount * sizeof(localStatistics_t));
+	shardTimeline = localTimeline;
+	shardTimelineCount = localTimelineCount;
+	shardPeriods = localPeriods;
+	localTimeline = NULL;
+	if (!sim_SeekStimulus(start))
+	{
+		logGeneric("OS-ERROR: The stimulus cannot be read again for the check");
+		ok = FALSE;
+	}
+	else
+		ok = runReference();
+	if (ok && (localPeriods != shardPeriods))
+	{
+		printf("Check: %u timer periods in the shards, %u in coreLoop()\n", shardPeriods, localPeriods);
+		ok = FALSE;
+	}
+	for (unsigned pid = 1; ok && (pid < processCount); pid++)
+		if (!sameStatistics(&shardStats[pid], &localProcessStats[pid]))
+		{
+			printf("Check: PID %u has %llu accesses, %llu page faults, %llu evictions in the shards, "
+				"%llu, %llu, %llu in coreLoop()\n", processTable[pid].pid, shardStats[pid].accesses,
+				shardStats[pid].faults, shardStats[pid].evictions, localProcessStats[pid].accesses,
+				localProcessStats[pid].faults, localProcessStats[pid].evictions);
+			ok = FALSE;
+		}
+	for (unsigned p = 0; ok && (p < localTimelineCount); p++)
+		if ((p >= shardTimelineCount) || (shardTimeline[p].period != localTimeline[p].period)
+			|| (shardTimeline[p].faults != localTimeline[p].faults))
+		{
+			printf("Check: the timelines differ from time %u on\n", localTimeline[p].period * TIMER_INTERVAL);
+			ok = FALSE;
+		}
+	if (ok && (shardTimelineCount != localTimelineCount))
+	{
+		printf("Check: the timelines differ in length\n");
+		ok = FALSE;
+	}
+	if (ok)
+		printf("Check: the shards match the run through coreLoop()\n");
+	else
+		logGeneric("OS-ERROR: The shards differ from the run through coreLoop()");
+	free(localTimeline);
+	localTimeline = shardTimeline;
+	localTimelineCount = shardTimelineCount;
+	localPeriods = shardPeriods;
+	memcpy(localProcessStats, shardStats, processCount * sizeof(localStatistics_t));
+	free(shardStats);
+	return ok;
+}
+
+int localSelectVictim(unsigned pid, const unsigned char referenced[])
+{
+	pageTableEntry_t* pTable = processTable[pid].pageTable;
+	agingCounter_t key, minimum = AGING_EMPTY;
+	int victim = NONE;
+	// the lowest page with the smallest counter, as agingSelectVictimLocal()
+	for (int i = processTable[pid].residentPages; i != NONE; i = pTable[i].listNext)
+	{
+		key = agingGetKey(referenced, pTable[i].frame);
+		if ((victim == NONE) || (key < minimum) || ((key == minimum) && (i < victim)))
+		{
+			minimum = key;
+			victim = i;
+		}
+	}
+	return (victim == NONE) ? NONE : pTable[victim].frame;
+}
+
+void localAccessed(unsigned pid, unsigned count)
+{
+	localProcessStats[pid].accesses += count;
+}
+
+void localFaulted(unsigned pid)
+{
+	localStatistics_t* stats = &localProcessStats[pid];
+	stats->faults++;
+	if (processTable[pid].residentCount > stats->maxResident) stats->maxResident = processTable[pid].residentCount;
+	if (!countShardFault(&localReference, systemTime / TIMER_INTERVAL))
+	{
+		localReference.error = "OS-ERROR: Not enough memory for the timeline";
+		localReference.errorPid = pid;
+	}
+}
+
+void localEvicted(unsigned pid, Boolean atQuota, Boolean modified)
+{
+	localStatistics_t* stats = &localProcessStats[pid];
+	if (!atQuota)
+		stats->overflow++;
+	else
+	{
+		stats->evictions++;
+		if (modified) stats->writebacks++;
+	}
+}
+
+void localForked(unsigned child, unsigned missing)
+{
+	localStatistics_t* stats = &localProcessStats[child];
+	stats->overflow += missing;
+	if (processTable[child].residentCount > stats->maxResident) stats->maxResident = processTable[child].residentCount;
+}
+
+void localGetStatistics(localStatistics_t* stats)
+{
+	*stats = localStats;
+}
+
+void localPrintStatistics(void)
+{
+	localStatistics_t s;
+	localPeriod_t busiest = { 0, 0 };	// the earliest of the periods with the most faults
+	localGetStatistics(&s);
+	for (unsigned p = 0; (p < localTimelineCount) && (localTimeline != NULL); p++)
+		if (localTimeline[p].faults > busiest.faults) busiest = localTimeline[p];
+	printf("Local replacement (aging, quota %u frames)\n", localQuota);
+	printf("%-28s %15llu\n", "memory accesses", s.accesses);
+	printf("%-28s %15llu\n", "page faults", s.faults);
+	printf("%-28s %14.1f%%\n", "fault rate", (s.accesses > 0) ? 100.0 * s.faults / s.accesses : 0.0);
+	printf("%-28s %15llu\n", "evictions", s.evictions);
+	printf("%-28s %15llu\n", "modified pages written", s.writebacks);
+	if (s.overflow > 0)		// the processes interacted, MEMORYSIZE is too small for the quotas
+		printf("%-28s %15llu\n", "pages over the memory size", s.overflow);
+	printf("%-28s %15u\n", "max. frames of a process", s.maxResident);
+	printf("%-28s %15u\n", "timer periods", localPeriods);
+	printf("%-28s %15u\n", "max. faults in a period", busiest.faults);
+	printf("%-28s %15u\n", "start of that period", busiest.period * TIMER_INTERVAL);
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+Boolean runReference(void)
+{
+	memset(localProcessStats, 0, processCount * sizeof(localStatistics_t));
+	localReference.timelineCount = 0;
+	localReference.error = NULL;
+	if (!coreLoop()) return FALSE;
+	localPeriods = systemTime / TIMER_INTERVAL + 1;
+	return mergeResults();
+}
+
+Boolean runShards(void)
+{
+	smpThread_t threads[SMP_MAX_CPUS];
+	unsigned started = 0;				// number of threads running
+	unsigned long long steals = 0;		// shards the reader took while the queue was full
+	Boolean ok;
+	double t0;
+	ok = registerProcessArray((void**)&shardOfProcess, sizeof(localShard_t*))
+		&& registerProcessArray((void**)&localProcesses, sizeof(localProcess_t*));
+	localShardList = NULL;
+	localShardCount = 0;
+	smpLockInit(&localQueueLock);
+	localQueued = localQueuedPeak = 0;
+	localReadDone = FALSE;
+	localLastTime = 0;
+	for (unsigned t = 0; t < localThreads; t++)
+	{
+		smpLockInit(&localDeques[t].lock);
+		localDeques[t].shards = malloc(processCount * sizeof(localShard_t*));
+		localDeques[t].head = localDeques[t].count = 0;
+		localDeques[t].steals = 0;
+		if (localDeques[t].shards == NULL) ok = FALSE;
+	}
+	if (!ok)
+		logGeneric("OS-ERROR: Not enough memory for the shards");
+	else
+	{
+		t0 = smpWallClock();
+		// a thread that cannot be started leaves its shards to the thieves
+		while ((started < localThreads) && smpThreadStart(&threads[started], localWorker, started))
+			started++;
+		ok = readStimulus();
+		for (localShard_t* shard = localShardList; shard != NULL; shard = shard->nextShard)
+			if (shard->open != NULL) queueBatch(shard);
+		smpLock(&localQueueLock);
+		localReadDone = TRUE;
+		smpUnlock(&localQueueLock);
+		// the reader helps with the last shards
+		while (runQueuedShard(localThreads, &steals));
+		for (unsigned t = 0; t < started; t++)
+			smpThreadJoin(threads[t]);
+		for (unsigned t = 0; t < localThreads; t++)
+			steals += localDeques[t].steals;
+		printf("%u threads: %u shards simulated in %.3f s, %llu steals, at most %llu KiB queued\n",
+			localThreads, localShardCount, smpWallClock() - t0, steals, (localQueuedPeak + 1023) / 1024);
+		localPeriods = localLastTime / TIMER_INTERVAL + 1;
+		if (ok) ok = mergeResults();
+	}
+	for (unsigned t = 0; t < localThreads; t++)
+	{
+		free(localDeques[t].shards);
+		localDeques[t].shards = NULL;
+	}
+	freeShards();
+	return ok;
+}
+
+Boolean readStimulus(void)
+{
+	memoryEvent_t memoryEvent;			// event read from the stimulus
+	localShard_t* shard;
+	unsigned child;
+	Boolean ends;						// a process of the shard ends with the event
+	unsigned long long steals = 0;
+	while (sim_ReadNextEvent(&memoryEvent) != NULL)
+	{
+		localLastTime = memoryEvent.time;
+		if (memoryEvent.pid == NOPROCESS) continue;		// PID not in the process file
+		shard = shardOfProcess[memoryEvent.pid];
+		if (shard == NULL)
+		{
+			shard = calloc(1, sizeof(localShard_t));
+			if (shard == NULL)
+			{
+				logGeneric("OS-ERROR: Not enough memory for the shards");
+				return FALSE;
+			}
+			smpLockInit(&shard->lock);
+			shard->home = localShardCount++ % localThreads;
+			shard->nextShard = localShardList;
+			localShardList = shard;
+			shardOfProcess[memoryEvent.pid] = shard;
+		}
+		ends = FALSE;
+		for (unsigned i = 0; i < memoryEvent.actionCount; i++)
+		{
+			if (memoryEvent.action[i].op == end) ends = TRUE;
+			if (memoryEvent.action[i].op != forkAction) continue;
+			// a forked child joins the shard of its parent
+			child = memoryEvent.action[i].page;
+			if ((child == NOPROCESS) || (child >= processCount)) continue;	// stops the shard
+			if ((shardOfProcess[child] != NULL) && (shardOfProcess[child] != shard))
+			{
+				logPid(memoryEvent.pid, "OS-ERROR: Fork of a process that is not defined or already started");
+				return FALSE;
+			}
+			shardOfProcess[child] = shard;
+		}
+		if (!appendEvent(shard, &memoryEvent))
+		{
+			logGeneric("OS-ERROR: Not enough memory for the shards");
+			return FALSE;
+		}
+		// the batches of the ended processes go, so the open ones stay few
+		if (ends || (shard->open->size >= LOCAL_BATCH_SIZE)) queueBatch(shard);
+		while (queueFull())
+			if (!runQueuedShard(localThreads, &steals)) smpYield();
+	}
+	return TRUE;
+}
+
+Boolean appendEvent(localShard_t* shard, const memoryEvent_t* event)
+{
+	localBatch_t* batch = shard->open;
+	size_t length = sizeof(localEvent_t) + event->actionCount * sizeof(action_t);
+	size_t capacity = (batch != NULL) ? batch->capacity : 256;
+	localEvent_t* stored;
+	while (capacity < ((batch != NULL) ? batch->size : 0) + length)
+		capacity *= 2;
+	if ((batch == NULL) || (capacity > batch->capacity))
+	{
+		batch = realloc(batch, offsetof(localBatch_t, data) + capacity);
+		if (batch == NULL) return FALSE;
+		if (shard->open == NULL) batch->size = 0;
+		batch->capacity = capacity;
+		shard->open = batch;
+	}
+	// the events and actions are multiples of 4 bytes, so each event is aligned
+	stored = (localEvent_t*)(batch->data + batch->size);
+	stored->time = event->time;
+	stored->pid = event->pid;
+	stored->actionCount = event->actionCount;
+	memcpy(stored + 1, event->action, event->actionCount * sizeof(action_t));
+	batch->size += length;
+	return TRUE;
+}
+
+void queueBatch(localShard_t* shard)
+{
+	localBatch_t* batch = shard->open;
+	localDeque_t* deque = &localDeques[shard->home];
+	Boolean joins;
+	shard->open = NULL;
+	batch->next = NULL;
+	smpLock(&localQueueLock);
+	localQueued += batch->size;
+	if (localQueued > localQueuedPeak) localQueuedPeak = localQueued;
+	smpUnlock(&localQueueLock);
+	smpLock(&shard->lock);
+	if (shard->tail != NULL)
+		shard->tail->next = batch;
+	else
+		shard->head = batch;
+	shard->tail = batch;
+	joins = !shard->queued;
+	shard->queued = TRUE;
+	smpUnlock(&shard->lock);
+	if (!joins) return;
+	smpLock(&deque->lock);
+	deque->shards[(deque->head + deque->count++) % processCount] = shard;
+	smpUnlock(&deque->lock);
+}
+
+Boolean queueFull(void)
+{
+	Boolean full;
+	smpLock(&localQueueLock);
+	full = (localQueued >= LOCAL_QUEUE_SIZE);
+	smpUnlock(&localQueueLock);
+	return full;
+}
+
+void localWorker(unsigned thread)
+{
+	Boolean done;
+	for (;;)
+	{
+		smpLock(&localQueueLock);
+		done = localReadDone;			// read first: all batches were queued before
+		smpUnlock(&localQueueLock);
+		if (runQueuedShard(thread, &localDeques[thread].steals)) continue;
+		if (done) return;
+		smpYield();
+	}
+}
+
+Boolean runQueuedShard(unsigned thread, unsigned long long* steals)
+{
+	localDeque_t* deque;
+	localShard_t* shard = NULL;
+	// the own shards first, then the one queued last in another deque
+	for (unsigned i = 0; (i < localThreads) && (shard == NULL); i++)
+	{
+		unsigned t = (thread + i) % localThreads;
+		deque = &localDeques[t];
+		smpLock(&deque->lock);
+		if (deque->count > 0)
+		{
+			if (t == thread)
+			{
+				shard = deque->shards[deque->head];
+				deque->head = (deque->head + 1) % processCount;
+				deque->count--;
+			}
+			else
+				shard = deque->shards[(deque->head + --deque->count) % processCount];
+		}
+		smpUnlock(&deque->lock);
+		if ((shard != NULL) && (t != thread)) (*steals)++;
+	}
+	if (shard == NULL) return FALSE;
+	runShard(shard);
+	return TRUE;
+}
+
+void runShard(localShard_t* shard)
+{
+	localBatch_t* batch;
+	const localEvent_t* event;
+	size_t offset;
+	for (;;)
+	{
+		smpLock(&shard->lock);
+		batch = shard->head;
+		if (batch != NULL)
+		{
+			shard->head = batch->next;
+			if (shard->head == NULL) shard->tail = NULL;
+		}
+		else
+			shard->queued = FALSE;		// the reader queues it again with its next batch
+		smpUnlock(&shard->lock);
+		if (batch == NULL) return;
+		for (offset = 0; (offset < batch->size) && (shard->error == NULL); )
+		{
+			event = (const localEvent_t*)(batch->data + offset);
+			offset += sizeof(localEvent_t) + event->actionCount * sizeof(action_t);
+			runEvent(shard, event, (const action_t*)(event + 1));
+		}
+		smpLock(&localQueueLock);
+		localQueued -= batch->size;
+		smpUnlock(&localQueueLock);
+		free(batch);
+	}
+}
+
+Boolean runEvent(localShard_t* shard, const localEvent_t* event, const action_t* actions)
+{
+	unsigned pid = event->pid;
+	unsigned period = event->time / TIMER_INTERVAL;
+	unsigned quota = localQuota;
+	localProcess_t* process = localProcesses[pid];
+	localProcess_t* child;
+	localStatistics_t* stats = &localProcessStats[pid];
+	unsigned page;
+	int frame;
+	if ((process != NULL) && (period > process->tick))
+	{	// the timer events since the last event of the process
+		agingTickLocal(process->counter, process->empty, process->referenced, (int)quota, period - process->tick);
+		memset(process->referenced, 0, quota);
+		process->tick = period;
+	}
+	for (unsigned i = 0; i < event->actionCount; i++)
+	{
+		switch (actions[i].op)
+		{
+		case start:
+			// the process starts with no resident pages
+			free(process);
+			process = localProcesses[pid] = newProcess(processTable[pid].size, period);
+			if (process == NULL) shard->error = "OS-ERROR: Not enough memory for the shards";
+			break;
+		case end:
+			free(process);
+			process = localProcesses[pid] = NULL;
+			break;
+		case forkAction:
+			// the child has the size of its parent and copies of its resident pages,
+			// moved in at the fork like faulted pages
+			page = actions[i].page;
+			if ((process == NULL) || (page == NOPROCESS) || (page == pid) || (page >= processCount)
+				|| !processTable[page].valid || (localProcesses[page] != NULL))
+			{
+				shard->error = "OS-ERROR: Fork of a process that is not defined or already started";
+				break;
+			}
+			child = localProcesses[page] = newProcess(process->size, period);
+			if (child == NULL)
+			{
+				shard->error = "OS-ERROR: Not enough memory for the shards";
+				break;
+			}
+			for (unsigned f = 0; f < process->used; f++)
+			{
+				child->frameOfPage[process->pageOfFrame[f]] = (int)f;
+				child->pageOfFrame[f] = process->pageOfFrame[f];
+				child->counter[f] = child->empty[f] = 0;
+				child->referenced[f] = 1;
+				child->modified[f] = process->modified[f];
+			}
+			child->used = process->used;
+			if (child->used > localProcessStats[page].maxResident) localProcessStats[page].maxResident = child->used;
+			break;
+		case read:
+		case write:
+			if ((process == NULL) || (actions[i].page >= process->size))
+			{
+				shard->error = "OS-ERROR: Access to a page outside of the logical memory";
+				break;
+			}
+			stats->accesses++;
+			frame = process->frameOfPage[actions[i].page];
+			if (frame == NONE)
+			{
+				stats->faults++;
+				if (!countShardFault(shard, period)) shard->error = "OS-ERROR: Not enough memory for the timeline";
+				if (process->used < quota)
+					frame = (int)process->used++;
+				else
+				{	// the page least used recently, all frames hold pages
+					frame = agingSelectVictimLocal(process->counter, process->empty, process->referenced,
+						process->pageOfFrame, (int)quota);
+					stats->evictions++;
+					if (process->modified[frame]) stats->writebacks++;
+					process->frameOfPage[process->pageOfFrame[frame]] = NONE;
+				}
+				process->frameOfPage[actions[i].page] = frame;
+				process->pageOfFrame[frame] = actions[i].page;
+				process->counter[frame] = process->empty[frame] = 0;
+				process->modified[frame] = 0;
+				if (process->used > stats->maxResident) stats->maxResident = process->used;
+			}
+			process->referenced[frame] = 1;
+			if (actions[i].op == write) process->modified[frame] = 1;
+			break;
+		default:
+			break;						// ignored like by coreLoop()
+		}
+		if (shard->error != NULL)
+		{
+			shard->errorPid = pid;
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+localProcess_t* newProcess(unsigned size, unsigned tick)
+{
+	unsigned quota = localQuota;
+	localProcess_t* process = malloc(sizeof(localProcess_t) + size * sizeof(int)
+		+ quota * (sizeof(unsigned) + 2 * sizeof(agingCounter_t) + 2));
+	if (process == NULL) return NULL;
+	process->size = size;
+	process->used = 0;
+	process->tick = tick;
+	process->frameOfPage = (int*)(process + 1);
+	process->pageOfFrame = (unsigned*)(process->frameOfPage + size);
+	process->counter = (agingCounter_t*)(process->pageOfFrame + quota);
+	process->empty = process->counter + quota;
+	process->referenced = (unsigned char*)(process->empty + quota);
+	process->modified = process->referenced + quota;
+	for (unsigned page = 0; page < size; page++)
+		process->frameOfPage[page] = NONE;
+	for (unsigned f = 0; f < quota; f++)
+		process->counter[f] = process->empty[f] = AGING_EMPTY;
+	memset(process->referenced, 0, 2 * quota);
+	return process;
+}
+
+Boolean countShardFault(localShard_t* shard, unsigned period)
+{
+	void* grown;
+	if ((shard->timelineCount > 0) && (shard->timeline[shard->timelineCount - 1].period == period))
+	{
+		shard->timeline[shard->timelineCount - 1].faults++;
+		return TRUE;
+	}
+	if (shard->timelineCount == shard->timelineCapacity)
+	{
+		shard->timelineCapacity = (shard->timelineCapacity > 0) ? 2 * shard->timelineCapacity : 64;
+		grown = realloc(shard->timeline, shard->timelineCapacity * sizeof(localPeriod_t));
+		if (grown == NULL) return FALSE;
+		shard->timeline = grown;
+	}
+	shard->timeline[shard->timelineCount].period = period;
+	shard->timeline[shard->timelineCount].faults = 1;
+	shard->timelineCount++;
+	return TRUE;
+}
+
+Boolean mergeResults(void)
+{
+	localStatistics_t* s;
+	Boolean ok = TRUE;
+	unsigned merged = 0;
+	memset(&localStats, 0, sizeof(localStats));
+	for (unsigned pid = 1; pid < processCount; pid++)
+	{
+		s = &localProcessStats[pid];
+		localStats.accesses += s->accesses;
+		localStats.faults += s->faults;
+		localStats.evictions += s->evictions;
+		localStats.writebacks += s->writebacks;
+		localStats.overflow += s->overflow;
+		if (s->maxResident > localStats.maxResident) localStats.maxResident = s->maxResident;
+		if (logEnabled && (s->accesses > 0))
+			printf("%6u : PID %3u : %llu accesses, %llu page faults, %llu evictions, %u frames used\n", systemTime,
+				processTable[pid].pid, s->accesses, s->faults, s->evictions, s->maxResident);
+	}
+	// only the periods with faults are stored, a sparse trace may span many more
+	localTimelineCount = localReference.timelineCount;
+	for (localShard_t* shard = localShardList; shard != NULL; shard = shard->nextShard)
+		localTimelineCount += shard->timelineCount;
+	free(localTimeline);
+	localTimeline = malloc((localTimelineCount + 1) * sizeof(localPeriod_t));
+	if (localTimeline == NULL)
+	{
+		logGeneric("OS-ERROR: Not enough memory for the timeline");
+		localTimelineCount = 0;
+		return FALSE;
+	}
+	localTimelineCount = localReference.timelineCount;
+	if (localTimelineCount > 0)
+		memcpy(localTimeline, localReference.timeline, localTimelineCount * sizeof(localPeriod_t));
+	if (localReference.error != NULL)
+	{
+		logPid(localReference.errorPid, localReference.error);
+		ok = FALSE;
+	}
+	for (localShard_t* shard = localShardList; shard != NULL; shard = shard->nextShard)
+	{
+		if (shard->timelineCount > 0) memcpy(&localTimeline[localTimelineCount], shard->timeline, shard->timelineCount * sizeof(localPeriod_t));
+		localTimelineCount += shard->timelineCount;
+		if (shard->error != NULL)
+		{
+			logPid(shard->errorPid, shard->error);
+			ok = FALSE;
+		}
+	}
+	if (localTimelineCount > 0)
+	{	// sum up the entries of the same period
+		qsort(localTimeline, localTimelineCount, sizeof(localPeriod_t), comparePeriod);
+		for (unsigned p = 1; p < localTimelineCount; p++)
+			if (localTimeline[p].period == localTimeline[merged].period)
+				localTimeline[merged].faults += localTimeline[p].faults;
+			else
+				localTimeline[++merged] = localTimeline[p];
+		localTimelineCount = merged + 1;
+	}
+	if (logEnabled)
+		for (unsigned p = 0; p < localTimelineCount; p++)
+			printf("%6u : Local: %u page faults in the timer period\n", localTimeline[p].period * TIMER_INTERVAL,
+				localTimeline[p].faults);
+	return ok;
+}
+
+void freeShards(void)
+{
+	localShard_t* shard;
+	localBatch_t* batch;
+	for (unsigned pid = 1; (pid < processCount) && (localProcesses != NULL); pid++)
+	{
+		free(localProcesses[pid]);
+		localProcesses[pid] = NULL;
+	}
+	while (localShardList != NULL)
+	{
+		shard = localShardList;
+		localShardList = shard->nextShard;
+		while (shard->head != NULL)
+		{	// left by an error of the reader
+			batch = shard->head;
+			shard->head = batch->next;
+			free(batch);
+		}
+		free(shard->open);
+		free(shard->timeline);
+		free(shard);
+	}
+	localShardCount = 0;
+}
+
+Boolean sameStatistics(const localStatistics_t* a, const localStatistics_t* b)
+{
+	return (a->accesses == b->accesses) && (a->faults == b->faults) && (a->evictions == b->evictions)
+		&& (a->writebacks == b->writebacks) && (a->overflow == b->overflow) && (a->maxResident == b->maxResident);
+}
+
+int comparePeriod(const void* a, const void* b)
+{
+	unsigned x = ((const localPeriod_t*)a)->period, y = ((const localPeriod_t*)b)->period;
+	return (x < y) ? -1 : (x > y);
+}
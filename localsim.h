@@ -0,0 +1,81 @@
+/* Include-file defining the simulation of the processes under fixed local	*/
+/* quotas: each process holds at most localQuota frames and replaces only	*/
+/* its own pages by the aging algorithm, the one with the smallest counter,	*/
+/* the lowest page of these on ties. A forked child gets copies of the		*/
+/* resident pages of its parent, moved in at the fork, instead of sharing	*/
+/* them, so the processes do not interact through the memory as long as		*/
+/* MEMORYSIZE frames hold the quotas of all live processes.					*/
+/* With one thread (sequential run) the stimulus runs through coreLoop()	*/
+/* and the memory manager, which enforces the quotas. With more threads		*/
+/* the stimulus is streamed in batches to the shards, one per family of		*/
+/* processes (a process and the children it forked), each simulated with	*/
+/* page tables and aging counters of its own, the timer events taken from	*/
+/* the times of its events. The reader stops while LOCAL_QUEUE_SIZE bytes	*/
+/* of batches wait, so the stimulus is never held in memory as a whole.		*/
+/* A shard with batches waiting joins the deque of its thread, a thread		*/
+/* runs the shards of its own deque and, when it is empty, steals the		*/
+/* shard queued last in the deque of another thread. At the end the			*/
+/* counters of the processes and the page fault timelines of the shards		*/
+/* are merged in the order of the process table, so the results do not		*/
+/* depend on the number of threads or on which thread ran which shard.		*/
+/* With check the stimulus runs through coreLoop() after the shards and		*/
+/* the results of both runs have to be identical.							*/
+#ifndef __LOCALSIM__
+#define __LOCALSIM__
+
+#include "bs_types.h"
+
+/* counters of a process and, summed up, of all processes					*/
+typedef struct localStatistics_struct
+{
+	unsigned long long accesses;		// read and write actions
+	unsigned long long faults;			// accesses to a page not resident
+	unsigned long long evictions;		// pages replaced as the process used its quota
+	unsigned long long writebacks;		// modified pages among them
+	unsigned long long overflow;		// page faults and fork copies finding the memory full before the quota
+	unsigned maxResident;				// largest number of frames used by one process
+} localStatistics_t;
+
+extern unsigned localQuota;			// frames of each process, 0: the global replacement is simulated
+extern unsigned localThreads;		// threads of the pool, 1: sequential run through coreLoop()
+extern Boolean localCheck;			// compare the shards with the sequential run
+
+Boolean setLocalQuota(const char* spec);
+/* sets the quota, the threads and the check from a string of the form		*/
+/* <frames>[,<threads>[,check]], returns FALSE on syntax errors and for a	*/
+/* check without threads													*/
+
+Boolean localSimRun(void);
+/* runs the stimulus through coreLoop() or simulates the shards on the		*/
+/* thread pool and merges their results, then runs the check if requested.	*/
+/* Returns FALSE on errors, e.g. out of memory, or if the check fails		*/
+
+int localSelectVictim(unsigned pid, const unsigned char referenced[]);
+/* returns the frame of the resident page of the process the shards would	*/
+/* replace, see agingSelectVictimLocal(). Called by the memory manager for	*/
+/* a process using its quota												*/
+
+void localAccessed(unsigned pid, unsigned count);
+/* counts read and write actions of the process in the run through			*/
+/* coreLoop()																*/
+
+void localFaulted(unsigned pid);
+/* counts a page fault of the process in the run through coreLoop(), after	*/
+/* the page was moved in													*/
+
+void localEvicted(unsigned pid, Boolean atQuota, Boolean modified);
+/* counts the replacement of a page for a page fault of the process in the	*/
+/* run through coreLoop(), an eviction of its own page if atQuota, else an	*/
+/* overflow as the memory was full before the process used its quota		*/
+
+void localForked(unsigned child, unsigned missing);
+/* counts the pages the child got at its fork in the run through coreLoop()	*/
+/* and the missing ones, which found no empty frame							*/
+
+void localGetStatistics(localStatistics_t* stats);
+/* returns the merged counters of the last run								*/
+
+void localPrintStatistics(void);
+/* prints the merged counters and the busiest period of the timeline		*/
+
+#endif  /* __LOCALSIM__ */
@@ -20,23 +20,30 @@ extern sim_frame_t sim_memoryMap[MEMORYSIZE];	// Array storing the use of physic
 // array with strings associated to scheduling events for log outputs
 char eventString[3][12] = {"completed", "io", "quantumOver"};
 
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in log.h		*/
+Boolean logEnabled = TRUE;		// output of all log functions
+
 /* ---------------------------------------------------------------- */
 /*                Externally available functions					*/
 /* ---------------------------------------------------------------- */
 
 void logGeneric(char* message)
 {
+	if (!logEnabled) return;
 	printf("%6u : %s\n", systemTime, message); 
 }
 	
 void logPid(unsigned pid, char * message)
 {
-	printf("%6u : PID %3u : %s\n", systemTime, pid, message); 
+	if (!logEnabled) return;
+	printf("%6u : PID %3u : %s\n", systemTime, processTable[pid].pid, message); 
 }
 		
 void logPidMemAccess(unsigned pid, action_t action)
 {
-	printf("%6u : PID %3u : ", systemTime, pid);
+	if (!logEnabled) return;
+	printf("%6u : PID %3u : ", systemTime, processTable[pid].pid);
 	if (action.op == write) printf("Write");
 	if (action.op == read) printf(" Read");
 	printf("-Access to Page: %3u\n", action.page);
@@ -44,14 +51,23 @@ void logPidMemAccess(unsigned pid, action_t action)
 
 void logPidMemPhysical(unsigned pid, unsigned page, unsigned frame)
 {
+	if (!logEnabled) return;
 	printf("%6u : PID %3u : Resolving page %2u in frame %2u\n", 
-		systemTime, pid, page, frame);
+		systemTime, processTable[pid].pid, page, frame);
+}
+
+void logPidSchedulingEvent(unsigned pid, schedulingEvent_t event, unsigned used)
+{
+	if (!logEnabled) return;
+	printf("%6u : PID %3u : Scheduling event %s after %u time units, used CPU %u\n",
+		systemTime, processTable[pid].pid, eventString[event], used, processTable[pid].usedCPU);
 }
 
 void logMemoryMapping(void)
 /* prints out a memory map showing the use of all frames of the physical mem*/
 {
 	int frame;
+	if (!logEnabled) return;
 	printf("%6u : Current allocation of physical memory: [PID, page] per frame\n",
 		systemTime);
 	printf("\t   00      01      02      03      04      05      06      07   \n");
@@ -62,7 +78,7 @@ void logMemoryMapping(void)
 		{
 			frame = (row * 8 + column);
 			if (frame >= MEMORYSIZE) break;
-			printf("[%2u,", sim_memoryMap[frame].pid);
+			printf("[%2u,", processTable[sim_memoryMap[frame].pid].pid);
 			if (sim_memoryMap[frame].pid == 0)
 				printf("--]\t");
 			else
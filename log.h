@@ -9,6 +9,7 @@
 #include "bs_types.h"
 #include "global.h"
 
+extern Boolean logEnabled;		// output of all log functions, cleared e.g. for benchmarking
 
 void logGeneric(char* message);
 /* print the given general string to stdout and/or a log file 				*/
@@ -27,6 +28,10 @@ void logPidMemPhysical(unsigned pid, unsigned page, unsigned frame);
 /* print the resolved pair of virtual address (page) to			 			*/
 /* physical address (frame) with the PID at the current systemTime			*/
 
+void logPidSchedulingEvent(unsigned pid, schedulingEvent_t event, unsigned used);
+/* print the scheduling event that made the process leave the CPU, after	*/
+/* it ran for the given time, see scheduler.h								*/
+
 void logMemoryMapping(void); 
 /* prints out a memory map showing the use of all frames of the physical mem*/
 
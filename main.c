@@ -2,7 +2,9 @@
 //
 
 #include <stdio.h>
+#ifdef _WIN32
 #include <tchar.h>
+#endif
 
 
 #include "bs_types.h"
@@ -13,17 +15,244 @@
 /* ----------------------------------------------------------------	*/
 /* Declare global variables according to definition in global.h	*/
 unsigned systemTime = 0; 		// the current system time (up time)
-extern PCB_t processTable[]; 	// the process table
+extern PCB_t* processTable; 	// the process table
+Boolean printStatistics = FALSE;	// print the replacement statistics at the end
+Boolean multiCPU = FALSE;			// run the stimulus on smpCpuCount CPUs
+
+Boolean parseArguments(int argc, char *argv[]);
+/* evaluates the optional command line arguments, all of them override the	*/
+/* defaults given in global.h:												*/
+/*   -p <file>  file with the process definitions							*/
+/*   -r <file>  stimulus file, "" selects the random stimulus				*/
+/*   -d <file>  write the binary log of replacement decisions to <file>		*/
+/*   -P <name>  page replacement algorithm, e.g. random, aging or arc		*/
+/*   -q         quiet, suppress the console log, also the lines of the		*/
+/*              processes started, terminated and with wrong actions,		*/
+/*              which the original tool printed always						*/
+/*   -s         print the page replacement statistics at the end			*/
+/*   -c <n>     run the stimulus on n simulated CPUs, see coreLoopMultiCPU()*/
+/*   -b <file>  real page contents, moved out to the swap file <file>		*/
+/*   -B <file>  as -b, bypassing the page cache of the host (direct I/O)		*/
+/*   -i <latency>[,<depth>]  blocking page faults, read from a disk with	*/
+/*              the given latency and queue depth, see coreLoopBlockingIO()	*/
+/*   -z <KiB>[,<cost>]  compressed pool of the given size for the pages		*/
+/*              moved out, cost is the time of a decompression, see zswap.h	*/
+/*   -n <nodes>[,<placement>]  physical memory split into NUMA nodes, the	*/
+/*              placement is firsttouch or interleave, see numa.h			*/
+/*   -m         migrate hot pages accessed remotely to their home node		*/
+/*   -H <order> huge pages of 2^order pages, see hugepage.h					*/
+/*   -a         allocate the page tables and other OS data by malloc()		*/
+/*              instead of the slab allocator, see slab.h					*/
+/*   -w <class>=<weight>[:<pages>],...  weights and protected resident sets	*/
+/*              of the process classes for -P weighted, see procclass.h		*/
+/*   -o <owner>=<limit>[:<reservation>[:<parent>]],...  memory limits of	*/
+/*              the owners of the processes in frames, see owner.h			*/
+/*   -l <high>[,<low>]  load control of the blocking page faults, suspend	*/
+/*              at high, resume below low percent faults, see loadcontrol.h	*/
+/*   -g <processes>[,<live>]  generated workload of coroutines instead of	*/
+/*              the process and stimulus files, see workload.h				*/
+/*   -S <policy>[,<quantum>]  scheduler of the generated workload, rr or	*/
+/*              priority, see scheduler.h									*/
+/*   -L <frames>[,<threads>[,check]]  local quotas, the processes run		*/
+/*              through coreLoop() or as shards on a pool of threads, check	*/
+/*              compares the shards with coreLoop(), see localsim.h			*/
+/*   -C <time>,<file>  write a snapshot before the first event at the time	*/
+/*   -R <file>  continue from a snapshot, see checkpoint.h					*/
+/*   -V <policy>,...  after -R, run one variant per replacement algorithm	*/
+/*              in parallel child processes									*/
+/*   -t         print latency histograms of the page faults, see latency.h	*/
+/*   -T <file>  write a timeline of the faults, evictions and timer events	*/
+/*              as Chrome trace (JSON) to <file>							*/
+/*   -k         profile the phases of the main loop with the hardware		*/
+/*              counters of the CPU, see profile.h							*/
+/* Returns FALSE on unknown arguments after printing the usage				*/
 
 int main(int argc, char *argv[])
 {	// starting point, all processing is done in called functions
-	initOS();					// initialise operating system
-	sim_initSim();				// initialise simulation run-time environment
+	Boolean completed;			// the main loop ran the whole stimulus
+	if (!parseArguments(argc, argv)) return 1;
+	if ((restoreFileName[0] != '\0') && !checkpointOpen()) return 1;
+	if ((checkpointVariantCount > 0) && (checkpointForkVariants() < 0))
+		return 0;				// all variants ran in child processes
+	if (!initOS()) return 1;	// initialise operating system
+	if (workloadProcesses == 0)
+		sim_initSim();			// initialise simulation run-time environment
+	if ((restoreFileName[0] != '\0') && !checkpointRestore())
+		return 1;				// the snapshot does not fit the process file or the options
 	logGeneric("Starting Batch-run");
-	coreLoop();					// start main loop of the OS
+	if (localQuota > 0)
+		completed = localSimRun();			// through coreLoop() or as shards on the thread pool
+	else if (workloadProcesses > 0)
+		completed = coreLoopScheduled();	// start main loop of the OS, the processes are coroutines
+	else if (multiCPU)
+		completed = coreLoopMultiCPU();		// start main loop of the OS, one thread per CPU
+	else if (diskLatency > 0)
+		completed = coreLoopBlockingIO();	// start main loop of the OS, page faults block the process
+	else
+		completed = coreLoop();				// start main loop of the OS
+	if (multiCPU) printMultiCPUStatistics();
+	if (!completed)
+	{	// the statistics of a part of the stimulus would be misleading
+		printf("Batch aborted, see the log for the error\n");
+		sim_shutdownSim();
+		shutdownOS();
+		fflush(stdout);
+		return 1;
+	}
 	logGeneric("Batch complete, shutting down");
+	if (printStatistics && (localQuota == 0)) printReplacementStatistics();
+	if (printStatistics && (localQuota > 0)) localPrintStatistics();
+	if (printStatistics && (workloadProcesses > 0)) schedPrintStatistics();
+	if (printStatistics && (diskLatency > 0) && (workloadProcesses == 0)) printBlockingIOStatistics();
+	if (printStatistics && backingStoreEnabled) backingStorePrintStatistics();
+	if (printStatistics && zswapEnabled) zswapPrintStatistics();
+	if (printStatistics && numaEnabled) numaPrintStatistics();
+	if (printStatistics && hugePagesEnabled) hugePagePrintStatistics();
+	if (printStatistics) slabPrintStatistics();
+	if (printStatistics && !multiCPU && (localQuota == 0)
+		&& (classesConfigured || (replacementPolicy == weightedReplacement) || (workloadProcesses > 0)))
+		classPrintStatistics();
+	if (printStatistics && ownersEnabled) ownerPrintStatistics();
+	if (printStatistics && (loadControlHigh > 0)) loadControlPrintStatistics();
+	if (latencyHistograms) latencyPrintStatistics();
+	if (profileEnabled) profilePrintStatistics();
 	sim_shutdownSim();				// shut down simulation envoronment
 	shutdownOS();				// shut down operating system
 	fflush(stdout);				// make sure the output on the console is complete 
 	return 0;					// Use bash-convention: Returnvalue of Zero means "success"
-}
\ No newline at end of file
+}
+
+Boolean parseArguments(int argc, char *argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-p") == 0) && (i + 1 < argc))
+			snprintf(sim_processFileName, FILENAME_LENGTH, "%s", argv[++i]);
+		else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+			snprintf(sim_runFileName, FILENAME_LENGTH, "%s", argv[++i]);
+		else if ((strcmp(argv[i], "-d") == 0) && (i + 1 < argc))
+			snprintf(decisionLogFileName, FILENAME_LENGTH, "%s", argv[++i]);
+		else if ((strcmp(argv[i], "-P") == 0) && (i + 1 < argc) && selectReplacementPolicy(argv[i + 1]))
+			i++;
+		else if (strcmp(argv[i], "-q") == 0)
+			logEnabled = FALSE;
+		else if (strcmp(argv[i], "-s") == 0)
+			printStatistics = TRUE;
+		else if ((strcmp(argv[i], "-c") == 0) && (i + 1 < argc) && (atoi(argv[i + 1]) >= 1)
+			&& (atoi(argv[i + 1]) <= SMP_MAX_CPUS))
+		{
+			smpCpuCount = (unsigned)atoi(argv[++i]);
+			multiCPU = TRUE;
+		}
+		else if (((strcmp(argv[i], "-b") == 0) || (strcmp(argv[i], "-B") == 0)) && (i + 1 < argc))
+		{
+			backingStoreDirect = (argv[i][1] == 'B');
+			snprintf(backingStoreFileName, FILENAME_LENGTH, "%s", argv[++i]);
+		}
+		else if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc)
+			&& (sscanf(argv[i + 1], "%u,%u", &diskLatency, &diskQueueDepth) >= 1))
+			i++;
+		else if ((strcmp(argv[i], "-z") == 0) && (i + 1 < argc)
+			&& (sscanf(argv[i + 1], "%u,%u", &zswapPoolSize, &zswapDecompressCost) >= 1))
+			i++;
+		else if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc) && (atoi(argv[i + 1]) >= 1)
+			&& ((strchr(argv[i + 1], ',') == NULL) || selectNumaPlacement(strchr(argv[i + 1], ',') + 1)))
+			numaNodeCount = (unsigned)atoi(argv[++i]);
+		else if (strcmp(argv[i], "-m") == 0)
+			numaMigration = TRUE;
+		else if ((strcmp(argv[i], "-H") == 0) && (i + 1 < argc) && (atoi(argv[i + 1]) >= 0)
+			&& (atoi(argv[i + 1]) <= HUGEPAGE_MAX_ORDER))
+			hugePageOrder = (unsigned)atoi(argv[++i]);
+		else if (strcmp(argv[i], "-a") == 0)
+			slabEnabled = FALSE;
+		else if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc) && setClassWeights(argv[i + 1]))
+			i++;
+		else if ((strcmp(argv[i], "-o") == 0) && (i + 1 < argc) && setOwnerLimits(argv[i + 1]))
+			i++;
+		else if ((strcmp(argv[i], "-l") == 0) && (i + 1 < argc)
+			&& (sscanf(argv[i + 1], "%u,%u", &loadControlHigh, &loadControlLow) >= 1))
+			i++;
+		else if ((strcmp(argv[i], "-g") == 0) && (i + 1 < argc) && setWorkload(argv[i + 1]))
+			i++;
+		else if ((strcmp(argv[i], "-S") == 0) && (i + 1 < argc) && setSchedulingPolicy(argv[i + 1]))
+			i++;
+		else if ((strcmp(argv[i], "-L") == 0) && (i + 1 < argc) && setLocalQuota(argv[i + 1]))
+			i++;
+		else if ((strcmp(argv[i], "-C") == 0) && (i + 1 < argc) && setCheckpoint(argv[i + 1]))
+			i++;
+		else if ((strcmp(argv[i], "-R") == 0) && (i + 1 < argc))
+			snprintf(restoreFileName, FILENAME_LENGTH, "%s", argv[++i]);
+		else if ((strcmp(argv[i], "-V") == 0) && (i + 1 < argc) && setCheckpointVariants(argv[i + 1]))
+			i++;
+		else if (strcmp(argv[i], "-t") == 0)
+			latencyHistograms = TRUE;
+		else if ((strcmp(argv[i], "-T") == 0) && (i + 1 < argc))
+			snprintf(latencyTraceFileName, FILENAME_LENGTH, "%s", argv[++i]);
+		else if (strcmp(argv[i], "-k") == 0)
+			profileEnabled = TRUE;
+		else
+		{
+			printf("usage: %s [-p processfile] [-r runfile] [-d decisionlog] [-P policy] [-q] [-s] [-c cpus] [-i latency[,depth]] [-b|-B swapfile] [-z KiB[,cost]] [-n nodes[,placement]] [-m] [-H order] [-a] [-w class=weight[:pages],...] [-o owner=limit[:reservation[:parent]],...] [-l high[,low]] [-g processes[,live]] [-S policy[,quantum]] [-L frames[,threads[,check]]] [-C time,file] [-R file] [-V policy,...] [-t] [-T tracefile] [-k]\n", argv[0]);
+			return FALSE;
+		}
+	}
+	if ((numaNodeCount > 1) && (hugePageOrder > 0))
+	{	// the nodes keep their empty frames apart from the buddy allocator
+		printf("Huge pages cannot be combined with NUMA nodes\n");
+		return FALSE;
+	}
+	if (multiCPU && ((diskLatency > 0) || (backingStoreFileName[0] != '\0') || (zswapPoolSize > 0)
+		|| (numaNodeCount > 1) || (hugePageOrder > 0) || (replacementPolicy == weightedReplacement) || ownersEnabled))
+	{	// the memory manager shares only the frames and the replacement data between CPUs
+		printf("Several CPUs cannot be combined with -i, -b, -z, -n, -H, -P weighted and -o\n");
+		return FALSE;
+	}
+	if ((workloadProcesses > 0) && multiCPU)
+	{	// the coroutines are resumed by the scheduler of a single CPU
+		printf("The generated workload runs on a single CPU\n");
+		return FALSE;
+	}
+	if ((loadControlHigh > 0) && ((diskLatency == 0) || multiCPU || (workloadProcesses > 0)))
+	{	// only the loop with blocking page faults suspends processes
+		printf("The load control needs blocking page faults on a single CPU\n");
+		return FALSE;
+	}
+	if ((localQuota > 0) && (multiCPU || (diskLatency > 0) || (loadControlHigh > 0) || (workloadProcesses > 0)))
+	{	// one CPU without blocking faults, the shards have no main loop
+		printf("Local quotas cannot be combined with -c, -i, -l and -g\n");
+		return FALSE;
+	}
+	if ((localQuota > 0) && ((replacementPolicy != agingReplacement) || (backingStoreFileName[0] != '\0')
+		|| (zswapPoolSize > 0) || (numaNodeCount > 1) || (hugePageOrder > 0) || ownersEnabled))
+	{	// each process replaces its own pages by aging, without the frames of the others
+		printf("Local quotas need -P aging and cannot be combined with -b, -z, -n, -H and -o\n");
+		return FALSE;
+	}
+	if (((checkpointFileName[0] != '\0') || (restoreFileName[0] != '\0'))
+		&& (multiCPU || (diskLatency > 0) || (workloadProcesses > 0) || (localQuota > 0)))
+	{	// only the main loop on a single CPU takes checkpoints
+		printf("Checkpoints cannot be combined with -c, -i, -l, -g and -L\n");
+		return FALSE;
+	}
+	if ((checkpointVariantCount > 0) && (restoreFileName[0] == '\0'))
+	{	// the variants share the state of the snapshot
+		printf("Variants need a snapshot to continue from (-R)\n");
+		return FALSE;
+	}
+	if ((latencyHistograms || (latencyTraceFileName[0] != '\0')) && (multiCPU || (localQuota > 0)))
+	{	// the histograms and the timeline are not shared by threads
+		printf("Latencies are recorded on a single CPU, not with -c and -L\n");
+		return FALSE;
+	}
+	if ((latencyTraceFileName[0] != '\0') && (checkpointVariantCount > 0))
+	{	// the variants would write the same file
+		printf("A timeline cannot be written by variants (-V)\n");
+		return FALSE;
+	}
+	if (profileEnabled && (multiCPU || (diskLatency > 0) || (workloadProcesses > 0) || (localQuota > 0)))
+	{	// the phases are those of coreLoop()
+		printf("The profile covers the main loop, not -c, -i, -l, -g and -L\n");
+		return FALSE;
+	}
+	return TRUE;
+}
@@ -8,6 +8,39 @@ Boolean memoryManagerInitialised = FALSE;
 unsigned emptyFrameCounter = 0;		// number of empty Frames 
 frameList_t emptyFrameList = NULL;
 frameListEntry_t *emptyFrameListTail = NULL;
+Boolean referencedSinceTimer = FALSE;	// set with any R-bit, cleared by the timer
+replacementPolicy_t replacementPolicy = REPLACEMENT_POLICY;
+frameTableEntry_t frameTable[MEMORYSIZE];	// the page residing in each frame
+unsigned char frameReferenced[MEMORYSIZE];	// R-bit of the page in each frame, kept contiguous for the timer
+int referencedFrames[MEMORYSIZE];			// list of the frames with R-bit set since the last timer event
+unsigned referencedFrameCount = 0;			// number of entries in referencedFrames
+unsigned long long pageFaultCount = 0;		// page faults since the start
+unsigned long long evictionCount = 0;		// page faults that evicted a page
+unsigned long long forkCount = 0;			// processes forked
+unsigned long long pagesSharedAtFork = 0;	// resident pages shared with the children
+unsigned long long copyOnWriteCount = 0;	// shared pages copied as a process wrote to them
+unsigned framesSaved = 0;					// frames a private copy of each shared page would need
+unsigned maxFramesSaved = 0;
+unsigned long long framesSavedSum = 0;		// sum of framesSaved at the timer events
+unsigned long long framesSavedSamples = 0;
+#define UNLISTED -2							// listPrev of a page in neither list of its process
+int nodeHand[NUMA_MAX_NODES];				// aging hand of each node with several nodes
+// state of the memory manager with several CPUs (smpCpuCount > 1)
+smpLock_t* pidLock = NULL;				// protects the page table of each process, grows with the process table
+smpLock_t shardLock[SMP_MAX_CPUS];			// protects the replacement data of the frames of a shard
+smpLock_t emptyFrameLock;					// protects the list of empty frames
+smpLock_t decisionLogLock;					// serialises the decision log
+unsigned shardCount = 1;					// frames are split into this many shards
+int shardFirst[SMP_MAX_CPUS + 1];			// first frame of each shard, shardFirst[shardCount] = MEMORYSIZE
+int shardHand[SMP_MAX_CPUS];				// aging hand of each shard
+unsigned shardReferencedCount[SMP_MAX_CPUS];	// frames of each shard in referencedFrames, from shardFirst[shard] on
+unsigned shardRandom[SMP_MAX_CPUS];			// random replacement: state of the generator per shard
+int frameCache[SMP_MAX_CPUS][FRAME_CACHE_SIZE];	// empty frames cached per CPU
+unsigned frameCacheCount[SMP_MAX_CPUS];		// number of frames in each cache
+smpLock_t frameCacheLock[SMP_MAX_CPUS];		// protects each cache, other CPUs may steal from it
+unsigned frameCacheBatch = 1;				// frames spilled from a cache to the list at once
+// names of the replacement algorithms, in the order of replacementPolicy_t
+const char* replacementPolicyNames[] = { "random", "aging", "weighted", "arc", "car", "2q", "lirs", "clockpro" };
 
 /* ------------------------------------------------------------------------ */
 /*		               Declarations of local helper functions				*/
@@ -16,16 +49,77 @@ frameListEntry_t *emptyFrameListTail = NULL;
 Boolean isPagePresent(unsigned pid, unsigned page);
 /* Predicate returning the present/absent status of the page in memory		*/
 
+int handlePageFault(unsigned pid, unsigned page);
+/* brings the absent page into memory, evicting a page if no empty frame	*/
+/* exists. Returns the frame the page was moved into						*/
+
+int getFrameForPage(unsigned pid, unsigned page, unsigned *victimPid, unsigned *victimPage);
+/* returns an empty frame for the page, evicting a page if no empty frame	*/
+/* exists. victimPid is NOPROCESS if no page was evicted					*/
+
+int breakCopyOnWrite(unsigned pid, unsigned page);
+/* gives the process a private copy of the shared page it writes to,		*/
+/* returns the frame of the copy											*/
+
+void unmapSharer(unsigned pid, unsigned page);
+/* removes the process from the sharers of the frame of the page, the		*/
+/* frame stays in use by the others											*/
+
+void pageMovedIn(unsigned pid, unsigned page);
+/* moves the page to the list of the resident pages of the process			*/
+
+void pageMovedOut(unsigned pid, unsigned page);
+/* removes the page from the list of the resident pages of the process and	*/
+/* adds it to the list of the pages moved out, if data is kept for it		*/
+
+void unlistPage(unsigned pid, unsigned page);
+/* removes the page from the list of the process it is in, if any			*/
+
+void releasePage(unsigned pid, unsigned page);
+/* frees the data kept for the page of the ending process besides its frame	*/
+
 Boolean storeEmptyFrame(int frame);
 /* Store the frame number in the data structure of empty frames				*/
 /* and update emptyFrameCounter												*/
 
+Boolean appendEmptyFrame(int frame);
+/* appends the frame, which holds no page, to the list of empty frames		*/
+
+void clearFrame(int frame);
+/* removes the page from the frame table and the data of the replacement	*/
+/* algorithm, i.e. the frame holds no page any more							*/
+
 int getEmptyFrame(void);
 /* Returns the frame number of an empty frame.								*/
 /* A return value of -1 indicates that no empty frame exists. In this case	*/
 /* a page replacement algorithm must be called to free evict a page and		*/
 /* thus clear one frame */
 
+int getEmptyFrameOnNode(unsigned node);
+/* as getEmptyFrame(), with several nodes the frame is taken from the		*/
+/* given node if possible, see numaTakeFrame()								*/
+
+void migratePages(void);
+/* moves the hot pages accessed remotely to the home node of their process	*/
+
+void exchangeFrames(int a, int b);
+/* the pages in the frames a and b change places, b may be empty			*/
+
+unsigned findHugePageCandidates(unsigned pids[], unsigned regions[]);
+/* returns the regions of the pages referenced since the last timer event	*/
+/* that are to be promoted, at most HUGEPAGE_PROMOTE_LIMIT of them			*/
+
+void promoteHugePages(const unsigned pids[], const unsigned regions[], unsigned count);
+/* promotes the regions found by findHugePageCandidates() and samples the	*/
+/* mappings and the fragmentation for the statistics						*/
+
+Boolean promoteRegion(unsigned pid, unsigned region);
+/* moves the pages of the region into an aligned run of frames and maps		*/
+/* them as one huge page. Returns FALSE if no run is found					*/
+
+void demoteHugePage(unsigned pid, unsigned page);
+/* splits the huge page holding the page into base pages					*/
+
 Boolean movePageOut(unsigned pid, unsigned page, int frame);
 /* Creates an empty frame at the given location.							*/
 /* Copies the content of the frame occupid by the given page to secondary	*/
@@ -36,6 +130,10 @@ Boolean movePageOut(unsigned pid, unsigned page, int frame);
 /* present in RAM, including its location in seondary storage				*/
 /* Returns TRUE on success and FALSE on any error							*/
 
+void storePage(unsigned pid, unsigned page, int frame, Boolean modified);
+/* writes the page of the process in the frame to the compressed pool or	*/
+/* to the swap device, see movePageOut()									*/
+
 Boolean movePageIn(unsigned pid, unsigned page, unsigned frame);
 /* Returns TRUE on success and FALSE on any error							*/
 
@@ -47,11 +145,63 @@ Boolean updatePageEntry(unsigned pid, action_t action);
 /* when accessing physical memory.											*/
 /* Returns TRUE on success and FALSE on any error							*/
 
+void setFrameReferenced(int frame);
+/* sets the R-bit of the frame and records the frame for the timer			*/
+
+/* ---- multi-CPU operation (smpCpuCount > 1) ----							*/
+/* Lock order: shardLock before pidLock and frameCacheLock before			*/
+/* emptyFrameLock, at most one frameCacheLock is held. decisionLogLock is	*/
+/* never held while acquiring another lock. All accesses of a process are	*/
+/* made by the same CPU, other CPUs only evict its pages.					*/
+/* The R-bits in frameReferenced belong to the shard of the frame, like	*/
+/* its aging counter and its entry in referencedFrames, which holds the		*/
+/* frames of each shard referenced since the timer in the part of the		*/
+/* shard: a hit sets the R-bit under the lock of the shard					*/
+/* after releasing the lock of the owner, the R-bit in the page table is	*/
+/* set and cleared under the lock of the owner.								*/
+
+void initMultiCPU(void);
+/* initialises the locks, the shards and the frame caches					*/
+
+int accessPageMultiCPU(unsigned pid, action_t action);
+/* thread-safe accessPage(), called by the CPU smpCpu						*/
+
+int handlePageFaultMultiCPU(unsigned pid, unsigned page);
+/* thread-safe handlePageFault(): the frame comes from the frame cache of	*/
+/* the CPU, else a page of the shard of the CPU is evicted					*/
+
+int evictFromShard(unsigned shard, unsigned *victimPid, unsigned *victimPage);
+/* chooses a victim in the frames of the shard and evicts it, the caller	*/
+/* holds the lock of the shard. Returns the empty frame, NONE if the shard	*/
+/* has no page in memory													*/
+
+Boolean deAllocateProcessMultiCPU(unsigned pid);
+/* thread-safe deAllocateProcess(), the frames go to the cache of the CPU	*/
+
+void updateReplacementStatisticsMultiCPU(unsigned ticks);
+/* thread-safe updateReplacementStatistics(), holds all shard locks			*/
+
+int getCachedFrame(unsigned cpu);
+/* takes an empty frame from the cache of the CPU, else the next one of	*/
+/* the list of empty frames, else one from the caches of the other CPUs		*/
+/* Returns NONE if no empty frame is available								*/
+
+void putCachedFrame(unsigned cpu, int frame);
+/* puts an empty frame into the cache of the CPU, the cache spills to the	*/
+/* list of empty frames when it is full										*/
+
+unsigned shardOf(int frame);
+/* returns the shard of the frame											*/
+
 Boolean pageReplacement(unsigned *pid, unsigned *page, int *frame);
 /* ===== The page replacement algorithm								======	*/
-/* In the initial implementation the frame to be cleared is chosen			*/
-/* globaly and randomly, i.e. a frame is chosen at random regardless of the	*/
-/* process that is currently usigt it.										*/
+/* The algorithm is selected by replacementPolicy:							*/
+/* random: the frame to be cleared is chosen globaly and randomly, i.e. a	*/
+/*         frame is chosen at random regardless of the process using it.	*/
+/* aging:  the frame with the smallest aging counter is chosen globally		*/
+/* weighted: as aging, the counters weighted by the class of the process,	*/
+/*         see procclass.h													*/
+/* arc, car, 2q, lirs, clockpro: scan resistant algorithms, see adaptive.h	*/
 /* The values of pid and page number passed to the function may be used by  */
 /* local replacement strategies */
 /* OUTPUT: */
@@ -68,9 +218,45 @@ Boolean pageReplacement(unsigned *pid, unsigned *page, int *frame);
 
 Boolean initMemoryManager(void)
 {
+	agingInit();
+	adaptiveInit();
+	classInit();
+	ownerInit();
+	numaInit(MEMORYSIZE);
+	hugePageInit();
+	buddyInit(MEMORYSIZE);
+	for (unsigned node = 0; node < NUMA_MAX_NODES; node++)
+		nodeHand[node] = (node < numaNodeCount) ? numaFirstFrame(node) : 0;
 	// mark all frames of the physical memory as empty 
 	for (int i = 0; i < MEMORYSIZE; i++)
+	{
+		frameReferenced[i] = 0;
 		storeEmptyFrame(i);
+	}
+	referencedFrameCount = 0;
+	referencedSinceTimer = FALSE;
+	pageFaultCount = 0;
+	evictionCount = 0;
+	forkCount = pagesSharedAtFork = copyOnWriteCount = 0;
+	framesSaved = maxFramesSaved = 0;
+	framesSavedSum = framesSavedSamples = 0;
+	// the state of the memory for the checkpoints, see checkpoint.h
+	checkpointRegister("mm.frameTable", frameTable, sizeof(frameTable), TRUE);
+	checkpointRegister("mm.frameReferenced", frameReferenced, sizeof(frameReferenced), TRUE);
+	checkpointRegister("mm.referencedFrames", referencedFrames, sizeof(referencedFrames), TRUE);
+	checkpointRegister("mm.referencedCount", &referencedFrameCount, sizeof(referencedFrameCount), TRUE);
+	checkpointRegister("mm.referencedSince", &referencedSinceTimer, sizeof(referencedSinceTimer), TRUE);
+	checkpointRegister("mm.nodeHand", nodeHand, sizeof(nodeHand), TRUE);
+	checkpointRegister("mm.pageFaults", &pageFaultCount, sizeof(pageFaultCount), FALSE);
+	checkpointRegister("mm.evictions", &evictionCount, sizeof(evictionCount), FALSE);
+	checkpointRegister("mm.forks", &forkCount, sizeof(forkCount), FALSE);
+	checkpointRegister("mm.pagesSharedAtFork", &pagesSharedAtFork, sizeof(pagesSharedAtFork), FALSE);
+	checkpointRegister("mm.copyOnWrites", &copyOnWriteCount, sizeof(copyOnWriteCount), FALSE);
+	checkpointRegister("mm.framesSaved", &framesSaved, sizeof(framesSaved), TRUE);
+	checkpointRegister("mm.maxFramesSaved", &maxFramesSaved, sizeof(maxFramesSaved), FALSE);
+	checkpointRegister("mm.framesSavedSum", &framesSavedSum, sizeof(framesSavedSum), FALSE);
+	checkpointRegister("mm.framesSavedSamples", &framesSavedSamples, sizeof(framesSavedSamples), FALSE);
+	initMultiCPU();
 	memoryManagerInitialised = TRUE;		// flag successfull initialisation
 	return TRUE;
 }
@@ -81,14 +267,17 @@ Boolean shutdownMemoryManager(void)
 	frameListEntry_t* toBeDeleted = NULL;
 #pragma warning(push)
 #pragma warning(disable : 6001)		// Avoid warning for uninitialised variable: emptyFrameList is known
+	if (numaEnabled || hugePagesEnabled) emptyFrameCounter = 0;	// plain frame numbers are kept there
 	while (emptyFrameCounter > 0) {
 		if (emptyFrameList == NULL) return FALSE;	// no empty frame exists, but there should 
 		// remove entry first frame from the list
 		toBeDeleted = emptyFrameList;
 		emptyFrameList = emptyFrameList->next;
-		free(toBeDeleted);
+		slabFree(toBeDeleted);
 		emptyFrameCounter--;		// one empty frame less
 	}
+	for (unsigned cpu = 0; cpu < SMP_MAX_CPUS; cpu++)
+		frameCacheCount[cpu] = 0;			// cached frames are plain numbers
 	memoryManagerInitialised = FALSE ;		// memoryManager is no longer initialised
 	return TRUE;
 #pragma warning(pop)
@@ -101,35 +290,86 @@ int accessPage(unsigned pid, action_t action)
 /* Returns a negative value on error										*/
 {
 	int frame = INT_MAX;		// the frame the page resides in on return of the function
-	unsigned outPid = pid;
-	unsigned outPage= action.page;
+	pageTableEntry_t *pTable = processTable[pid].pageTable;
+	unsigned long long started = 0;	// wall-clock time of the call, for the latency histograms
+	if (smpCpuCount > 1) return accessPageMultiCPU(pid, action);
+	if ((pTable == NULL) || (action.page >= processTable[pid].size))
+	{	// process not started or page outside of its logical memory
+		logPid(pid, "OS-ERROR: Access to a page outside of the logical memory");
+		return NONE;
+	}
+	if (latencyEnabled) started = latencyStart(action.op);
 	// check if page is present
-	if (isPagePresent(pid, action.page))
-	{// yes: page is present
-		// look up frame in page table and we are done
-		frame = processTable[pid].pageTable[action.page].frame;
+	if (pTable[action.page].present)
+	{	// yes: page is present, look up frame in page table and we are done
+		frame = pTable[action.page].frame;
+		if ((action.op == write) && (frameTable[frame].sharers > 1))
+			frame = breakCopyOnWrite(pid, action.page);	// the frame is mapped read-only
+		else if (IS_ADAPTIVE_POLICY(replacementPolicy)) adaptiveFrameAccessed(frame);
 	}
 	else
-	{// no: page is not present
-		logPid(pid, "Pagefault");
-		// check for an empty frame
-		frame = getEmptyFrame();
-		if (frame < 0)
-		{	// no empty frame available: start replacement algorithm to find candidate frame
-			logPid(pid, "No empty frame found, running replacement algorithm");
-			pageReplacement(&outPid, &outPage, &frame);
-			// move candidate frame out to secondary storage
-			movePageOut(outPid, outPage, frame);			
-			frame = getEmptyFrame();
-		} // now we have an empty frame to move the page into
-		// move page in to empty frame
-		movePageIn(pid, action.page, frame);
-	}
+		// no: page is not present
+		frame = handlePageFault(pid, action.page);
+	if (numaEnabled) numaAccess(pid, frame);
+	classAccessed(pid, 1);
+	if (localQuota > 0) localAccessed(pid, 1);
 	// update page table for replacement algorithm
 	updatePageEntry(pid, action);
+	if (latencyEnabled) latencyAccessed(pid, action.op, started);
 	return frame;
 }
 
+unsigned accessPages(unsigned pid, const action_t actions[], unsigned count, int frames[])
+/* batched variant of accessPage() for a list of read/write actions of one	*/
+/* process at the same point in time										*/
+{
+	pageTableEntry_t *pTable = processTable[pid].pageTable;	// looked up once for all actions
+	unsigned size = processTable[pid].size;
+	unsigned i;
+	unsigned long long started = 0;	// wall-clock time of an access, for the latency histograms
+	if (smpCpuCount > 1)
+	{	// the page table may change under the hands of other CPUs
+		for (i = 0; i < count; i++)
+			if ((frames[i] = accessPageMultiCPU(pid, actions[i])) < 0) break;
+		return i;
+	}
+	for (i = 0; i < count; i++)
+	{
+		if ((pTable == NULL) || (actions[i].page >= size))
+		{	// process not started or page outside of its logical memory
+			logPid(pid, "OS-ERROR: Access to a page outside of the logical memory");
+			frames[i] = NONE;
+			break;
+		}
+		if (latencyEnabled) started = latencyStart(actions[i].op);
+		// check if page is present
+		if (pTable[actions[i].page].present)
+		{	// yes: page is present, look up frame in page table and we are done
+			frames[i] = pTable[actions[i].page].frame;
+			if ((actions[i].op == write) && (frameTable[frames[i]].sharers > 1))
+				frames[i] = breakCopyOnWrite(pid, actions[i].page);	// the frame is mapped read-only
+			else if (IS_ADAPTIVE_POLICY(replacementPolicy)) adaptiveFrameAccessed(frames[i]);
+		}
+		else
+			// no: page is not present
+			frames[i] = handlePageFault(pid, actions[i].page);
+		if (numaEnabled) numaAccess(pid, frames[i]);
+		// update page table for replacement algorithm
+		updatePageEntry(pid, actions[i]);
+		if (latencyEnabled) latencyAccessed(pid, actions[i].op, started);
+	}
+	classAccessed(pid, i);
+	if (localQuota > 0) localAccessed(pid, i);
+	return i;
+}
+
+Boolean isPageFault(unsigned pid, unsigned page)
+{
+	if ((processTable[pid].pageTable == NULL) || (page >= processTable[pid].size))
+		return FALSE;
+	return !isPagePresent(pid, page);
+}
+
 Boolean createPageTable(unsigned pid)
 /* Create and initialise the page table	for the given process									*/
 /* Information on max. process size must be already stored in the PCB		*/
@@ -139,7 +379,7 @@ Boolean createPageTable(unsigned pid)
 {
 	pageTableEntry_t *pTable = NULL;
 	// create and initialise the page table of the process
-	pTable = malloc(processTable[pid].size * sizeof(pageTableEntry_t));
+	pTable = slabAlloc(pid, processTable[pid].size * sizeof(pageTableEntry_t));
 	if (pTable == NULL) return FALSE; 
 	// initialise the page table
 	for (unsigned i = 0; i < processTable[pid].size; i++)
@@ -147,42 +387,274 @@ Boolean createPageTable(unsigned pid)
 		pTable[i].present = FALSE;
 		pTable[i].frame = NONE;
 		pTable[i].swapLocation = NONE;
+		pTable[i].zswapEntry = NONE;
+		pTable[i].huge = FALSE;
+		pTable[i].nextSharer = NOPROCESS;
+		pTable[i].listNext = NONE;
+		pTable[i].listPrev = UNLISTED;
 	}
 	processTable[pid].pageTable = pTable; 
+	processTable[pid].residentPages = NONE;
+	processTable[pid].residentCount = 0;
+	processTable[pid].movedOutPages = NONE;
+	if (numaEnabled) numaProcessStarted(pid);
+	if (ownersEnabled) ownerProcessStarted(pid);
+	processStarted(pid);
 	return TRUE;
 #pragma warning( pop )				// restore unaltered settings
 }
 
+Boolean forkProcess(unsigned pid, unsigned child)
+/* creates the page table of the child as a copy of the one of the process,	*/
+/* the resident pages are shared copy-on-write, under local quotas the		*/
+/* child gets copies of its own												*/
+{
+	pageTableEntry_t *pTable = processTable[pid].pageTable;
+	pageTableEntry_t *cTable = NULL;
+	unsigned shared = 0, missing = 0;
+	int frame;
+	if ((pTable == NULL) || (child == pid) || (child >= processCount) || !processTable[child].valid
+		|| (processTable[child].pageTable != NULL))
+	{
+		logPid(pid, "OS-ERROR: Fork of a process that is not defined or already started");
+		return FALSE;
+	}
+	// the child has the logical memory of its parent
+	processTable[child].size = processTable[pid].size;
+	processTable[child].ppid = pid;
+	processTable[child].ownerID = processTable[pid].ownerID;
+	if (!createPageTable(child)) return FALSE;
+	cTable = processTable[child].pageTable;
+	for (int i = processTable[pid].residentPages; i != NONE; i = pTable[i].listNext)
+	{
+		if (localQuota > 0)
+		{	// the copies are moved in like faulted pages, without replacing others
+			if ((frame = getEmptyFrame()) < 0)
+				missing++;
+			else
+			{
+				movePageIn(child, (unsigned)i, (unsigned)frame);
+				cTable[i].modified = pTable[i].modified;
+			}
+			continue;
+		}
+		if (pTable[i].huge)
+			demoteHugePage(pid, (unsigned)i);	// shared frames are mapped as base pages
+		// the child maps the frame read-only and follows its parent in the list of the sharers
+		cTable[i].present = TRUE;
+		cTable[i].frame = pTable[i].frame;
+		cTable[i].modified = pTable[i].modified;
+		cTable[i].referenced = FALSE;
+		cTable[i].nextSharer = pTable[i].nextSharer;
+		pTable[i].nextSharer = child;
+		frameTable[pTable[i].frame].sharers++;
+		pageMovedIn(child, (unsigned)i);
+		shared++;
+	}
+	if (localQuota > 0) localForked(child, missing);
+	forkCount++;
+	pagesSharedAtFork += shared;
+	framesSaved += shared;
+	if (framesSaved > maxFramesSaved) maxFramesSaved = framesSaved;
+	if (logEnabled)
+		printf("%6u : PID %3u : Forked process %u, %u pages shared\n", systemTime, processTable[pid].pid,
+			processTable[child].pid, shared);
+	return TRUE;
+}
+
 Boolean deAllocateProcess(unsigned pid)
 /* free the physical memory used by a process, destroy the page table		*/
 /* returns TRUE on success, FALSE on error									*/
 {
-	// iterate the page table and mark all currently used frames as free
+	// walk the resident pages and mark their frames as free, then the pages
+	// moved out: the time taken depends on the resident set, not on the size
 	pageTableEntry_t *pTable = processTable[pid].pageTable;
-	for (unsigned i = 0; i < processTable[pid].size; i++)
+	int next;
+	processEnded(pid);
+	if (smpCpuCount > 1) return deAllocateProcessMultiCPU(pid);
+	if (logEnabled)
+		printf("%6u : PID %3u : Releasing %u resident pages\n", systemTime, processTable[pid].pid,
+			processTable[pid].residentCount);
+	for (int i = processTable[pid].residentPages; i != NONE; i = next)
 	{
-		if (pTable[i].present == TRUE)
+		next = pTable[i].listNext;
+		if (pTable[i].huge && ((i & ((1 << hugePageOrder) - 1)) == 0))
+			hugePageDemoted(pid, (unsigned)i >> hugePageOrder, FALSE);	// the huge page is released
+		if (frameTable[pTable[i].frame].sharers > 1)
+		{	// the frame stays with the other processes
+			unmapSharer(pid, (unsigned)i);
+			unlistPage(pid, (unsigned)i);
+		}
+		else
 		{	// page is in memory, so free the allocated frame
 			storeEmptyFrame(pTable[i].frame);	// add to pool of empty frames
 			// update the simulation accordingly !! DO NOT REMOVE !!
 			sim_UpdateMemoryMapping(pid, (action_t) { deallocate, i }, pTable[i].frame);
 		}
+		releasePage(pid, (unsigned)i);
 	}
-	free(processTable[pid].pageTable);	// free the memory of the page table
+	for (int i = processTable[pid].movedOutPages; i != NONE; i = pTable[i].listNext)
+	{
+		if (IS_ADAPTIVE_POLICY(replacementPolicy))
+			adaptiveForgetPage(pid, (unsigned)i);	// the ghost of the page is useless now
+		releasePage(pid, (unsigned)i);
+	}
+	slabReleaseOwner(pid);				// free the page table and all other data of the process
 	processTable[pid].pageTable = NULL;
 	return TRUE;
 }
 
+unsigned swapOutProcess(unsigned pid)
+/* moves all resident pages of the process out at once, keeps the page table*/
+{
+	// walk the resident pages like deAllocateProcess(), but the pages keep
+	// their contents in the swap file or the compressed pool
+	pageTableEntry_t *pTable = processTable[pid].pageTable;
+	unsigned count = 0;
+	int next;
+	if ((pTable == NULL) || (smpCpuCount > 1)) return 0;
+	for (int i = processTable[pid].residentPages; i != NONE; i = next)
+	{
+		next = pTable[i].listNext;
+		if (pTable[i].huge)
+			demoteHugePage(pid, (unsigned)i);		// the pages leave the memory one by one
+		if (frameTable[pTable[i].frame].sharers > 1)
+			unmapSharer(pid, (unsigned)i);			// the frame stays with the other processes
+		else
+			movePageOut(pid, (unsigned)i, pTable[i].frame);
+		count++;
+	}
+	return count;
+}
+
+unsigned listEmptyFrames(int frames[])
+{
+	unsigned count = 0;
+	for (frameListEntry_t* entry = emptyFrameList; entry != NULL; entry = entry->next)
+		frames[count++] = entry->frame;
+	return count;
+}
+
+Boolean restoreEmptyFrames(const int frames[], unsigned count)
+{
+	while (getEmptyFrame() != NONE);
+	for (unsigned i = 0; i < count; i++)
+		if ((frames[i] < 0) || (frames[i] >= MEMORYSIZE) || !appendEmptyFrame(frames[i])) return FALSE;
+	return TRUE;
+}
+
+void resetPageTable(unsigned pid)
+{
+	pageTableEntry_t *pTable = processTable[pid].pageTable;
+	for (unsigned i = 0; i < processTable[pid].size; i++)
+	{	// the swap locations are kept like the ones of pages moved out
+		pTable[i].present = FALSE;
+		pTable[i].modified = FALSE;
+		pTable[i].referenced = FALSE;
+		pTable[i].frame = NONE;
+		pTable[i].huge = FALSE;
+		pTable[i].nextSharer = NOPROCESS;
+		pTable[i].listNext = NONE;
+		pTable[i].listPrev = UNLISTED;
+	}
+	processTable[pid].residentPages = NONE;
+	processTable[pid].residentCount = 0;
+	processTable[pid].movedOutPages = NONE;
+}
+
+int restorePage(unsigned pid, unsigned page, Boolean modified)
+{
+	int frame = getEmptyFrame();
+	if (frame == NONE) return NONE;
+	// the page is moved in like on a page fault, without counting one
+	if (IS_ADAPTIVE_POLICY(replacementPolicy)) adaptiveFault(pid, page);
+	movePageIn(pid, page, (unsigned)frame);
+	processTable[pid].pageTable[page].modified = modified;
+	return frame;
+}
+
 int getEmptyFrameCount(void)
 /* Returns the current number of empty frames.								*/
 /* A return value of -1 indicates an unitialised memoryManager				*/
 {
+	unsigned cached = 0;
+	for (unsigned cpu = 0; cpu < smpCpuCount; cpu++)
+		cached += frameCacheCount[cpu];		// a snapshot only with several CPUs
 	if (memoryManagerInitialised)
-		return emptyFrameCounter;
+		return emptyFrameCounter + cached;
 	else
 		return -1;
 }
 
+void updateReplacementStatistics(unsigned ticks)
+/* updates the data used by the page replacement algorithm for <ticks>		*/
+/* timer events and resets the R-bits of all present pages					*/
+{
+	if (smpCpuCount > 1)
+	{
+		updateReplacementStatisticsMultiCPU(ticks);
+		return;
+	}
+	unsigned hugePids[HUGEPAGE_PROMOTE_LIMIT], hugeRegions[HUGEPAGE_PROMOTE_LIMIT];
+	unsigned hugeCount = 0;
+	// the owners evict by the aging counters with all algorithms
+	if ((replacementPolicy == agingReplacement) || (replacementPolicy == weightedReplacement) || ownersEnabled)
+		agingTick(frameReferenced, ticks);
+	// the hot regions are known by the R-bits
+	if (hugePagesEnabled) hugeCount = findHugePageCandidates(hugePids, hugeRegions);
+	// reset the R-bits: only the frames referenced since the last timer event
+	// are visited, the frame table gives the page residing in each of them
+	for (unsigned i = 0; i < referencedFrameCount; i++)
+	{
+		int frame = referencedFrames[i];
+		unsigned page = frameTable[frame].page;
+		if (frameReferenced[frame])		// all processes sharing the frame
+			for (unsigned pid = frameTable[frame].pid; pid != NOPROCESS; pid = processTable[pid].pageTable[page].nextSharer)
+				processTable[pid].pageTable[page].referenced = FALSE;
+		frameReferenced[frame] = 0;
+	}
+	referencedFrameCount = 0;
+	referencedSinceTimer = FALSE;
+	framesSavedSum += (unsigned long long)framesSaved * ticks;
+	framesSavedSamples += ticks;
+	if (numaEnabled) migratePages();
+	if (hugePagesEnabled) promoteHugePages(hugePids, hugeRegions, hugeCount);
+}
+
+Boolean selectReplacementPolicy(const char* name)
+{
+	for (unsigned i = 0; i < sizeof(replacementPolicyNames) / sizeof(replacementPolicyNames[0]); i++)
+		if (strcmp(name, replacementPolicyNames[i]) == 0)
+		{
+			replacementPolicy = (replacementPolicy_t)i;
+			return TRUE;
+		}
+	return FALSE;
+}
+
+const char* getReplacementPolicyName(replacementPolicy_t policy)
+{
+	return replacementPolicyNames[policy];
+}
+
+void printReplacementStatistics(void)
+{
+	printf("Page replacement statistics (%s, %u frames)\n", getReplacementPolicyName(replacementPolicy), MEMORYSIZE);
+	printf("%-28s %15llu\n", "page faults", pageFaultCount);
+	printf("%-28s %15llu\n", "evictions", evictionCount);
+	if (forkCount > 0)
+	{	// frames saved: the copies of the shared pages that were not made
+		printf("%-28s %15llu\n", "forks", forkCount);
+		printf("%-28s %15llu\n", "pages shared at fork", pagesSharedAtFork);
+		printf("%-28s %15llu\n", "copy-on-write breaks", copyOnWriteCount);
+		printf("%-28s %15u\n", "max. frames saved", maxFramesSaved);
+		printf("%-28s %15.1f\n", "avg. frames saved",
+			(framesSavedSamples > 0) ? (double)framesSavedSum / framesSavedSamples : 0.0);
+	}
+	if (IS_ADAPTIVE_POLICY(replacementPolicy))
+		adaptivePrintStatistics(pageFaultCount);
+}
+
 
 /* ---------------------------------------------------------------- */
 /*                Implementation of local helper functions          */
@@ -193,12 +665,203 @@ Boolean isPagePresent(unsigned pid, unsigned page)
 	return processTable[pid].pageTable[page].present; 
 }
 
+int handlePageFault(unsigned pid, unsigned page)
+/* brings the absent page into memory, evicting a page if no empty frame	*/
+/* exists. Returns the frame the page was moved into						*/
+{
+	int frame = NONE;
+	unsigned victimPid = NOPROCESS;	// process of the evicted page, for the decision log
+	unsigned victimPage = page;
+	logPid(pid, "Pagefault");
+	pageFaultCount++;
+	classFault(pid);
+	if (IS_ADAPTIVE_POLICY(replacementPolicy)) adaptiveFault(pid, page);
+	frame = getFrameForPage(pid, page, &victimPid, &victimPage);
+	// move page in to empty frame
+	movePageIn(pid, page, frame);
+	if (localQuota > 0) localFaulted(pid);
+	// the log holds the PIDs of the process file, not the entries of the process table
+	decisionLogFault(systemTime, processTable[pid].pid, page, frame, processTable[victimPid].pid, victimPage);
+	if (latencyEnabled) latencyFault(pid, page, frame);
+	return frame;
+}
+
+int getFrameForPage(unsigned pid, unsigned page, unsigned *victimPid, unsigned *victimPage)
+{
+	int frame = NONE;
+	unsigned outPid = pid;
+	unsigned outPage = page;
+	unsigned node = numaEnabled ? numaSelectNode(pid, page) : 0;	// node the page is placed on
+	unsigned limited = ownersEnabled ? ownerAtLimit(pid) : OWNER_MAX;	// owner using its limit of frames
+	Boolean atQuota = (localQuota > 0) && (processTable[pid].residentCount >= localQuota);
+	unsigned long long started = 0;	// wall-clock time of the replacement, for the latency histograms
+	// check for an empty frame, unless the process or its owner has to give one back
+	frame = ((limited == OWNER_MAX) && !atQuota) ? getEmptyFrameOnNode(node) : NONE;
+	if (frame < 0)
+	{
+		if (atQuota)
+		{	// the process replaces one of its own pages, see localsim.h
+			logPid(pid, "Process at its quota, evicting one of its pages");
+			frame = localSelectVictim(pid, frameReferenced);
+		}
+		else if (limited != OWNER_MAX)
+		{	// the owner reclaims one of its own pages
+			logPid(pid, "Owner at its memory limit, evicting a page of the owner");
+			frame = ownerSelectVictim(limited, frameReferenced);
+		}
+		else
+		{	// no empty frame available: start replacement algorithm to find candidate frame
+			logPid(pid, "No empty frame found, running replacement algorithm");
+			if (latencyEnabled) started = latencyClock();
+			if (profileEnabled) profileEnter(profileReplacement);
+			pageReplacement(&outPid, &outPage, &frame);
+			if (profileEnabled) profileLeave();
+			if (latencyEnabled) latencyReplaced(pid, started);
+			if (ownersEnabled)		// the pages within a reservation are spared if possible
+				frame = ownerSpareReservation(frame, frameReferenced);
+		}
+		if (ownersEnabled || atQuota)
+		{	// the victim is not necessarily the one of the replacement algorithm
+			outPid = frameTable[frame].pid;
+			outPage = frameTable[frame].page;
+		}
+		if (localQuota > 0) localEvicted(pid, atQuota, processTable[outPid].pageTable[outPage].modified);
+		if (processTable[outPid].pageTable[outPage].huge)
+			demoteHugePage(outPid, outPage);	// only the victim leaves the memory
+		// move candidate frame out to secondary storage
+		movePageOut(outPid, outPage, frame);
+		if (latencyEnabled) latencyEvicted(pid, outPid, outPage, frame);
+		frame = getEmptyFrameOnNode(node);
+		*victimPid = outPid;
+		*victimPage = outPage;
+		evictionCount++;
+		classEvicted(outPid);
+	} // now we have an empty frame to move the page into
+	return frame;
+}
+
+int breakCopyOnWrite(unsigned pid, unsigned page)
+{
+	unsigned long long copy[BACKINGSTORE_PAGE_SIZE / sizeof(unsigned long long)];
+	unsigned victimPid = NOPROCESS, victimPage = page;
+	int frame;
+	if (logEnabled)
+		printf("%6u : PID %3u : Copy-on-write of page %u shared in frame %d\n", systemTime, processTable[pid].pid, page,
+			processTable[pid].pageTable[page].frame);
+	copyOnWriteCount++;
+	// the replacement may evict the shared frame for the copy, so its contents
+	// are kept aside first
+	if (backingStoreEnabled)
+		memcpy(copy, backingStoreFrame(processTable[pid].pageTable[page].frame), BACKINGSTORE_PAGE_SIZE);
+	// the process leaves the sharers first, so that the replacement may evict
+	// the shared frame for the copy without unmapping the process twice
+	unmapSharer(pid, page);
+	frame = getFrameForPage(pid, page, &victimPid, &victimPage);
+	// the copy is moved in like a page from secondary storage, with a backing
+	// store it gets the contents of the shared frame and belongs to the process
+	movePageIn(pid, page, frame);
+	if (backingStoreEnabled)
+	{
+		copy[0] = pid;
+		memcpy(backingStoreFrame(frame), copy, BACKINGSTORE_PAGE_SIZE);
+	}
+	return frame;
+}
+
+void unmapSharer(unsigned pid, unsigned page)
+{
+	int frame = processTable[pid].pageTable[page].frame;
+	unsigned next = processTable[pid].pageTable[page].nextSharer;
+	unsigned prev;
+	if (frameTable[frame].pid == pid)
+	{	// the next sharer becomes the first one, which is known to the replacement
+		frameTable[frame].pid = next;
+		if (IS_ADAPTIVE_POLICY(replacementPolicy)) adaptiveFrameRemapped(frame, next, page);
+		// update the simulation accordingly !! DO NOT REMOVE !!
+		sim_UpdateMemoryMapping(next, (action_t) { allocate, page }, frame);
+	}
+	else
+	{
+		for (prev = frameTable[frame].pid; processTable[prev].pageTable[page].nextSharer != pid;
+			prev = processTable[prev].pageTable[page].nextSharer);
+		processTable[prev].pageTable[page].nextSharer = next;
+	}
+	pageMovedOut(pid, page);
+	processTable[pid].pageTable[page].present = FALSE;
+	processTable[pid].pageTable[page].nextSharer = NOPROCESS;
+	frameTable[frame].sharers--;
+	framesSaved--;
+}
+
+void pageMovedIn(unsigned pid, unsigned page)
+{
+	pageTableEntry_t *pTable = processTable[pid].pageTable;
+	unlistPage(pid, page);
+	pTable[page].listPrev = NONE;
+	pTable[page].listNext = processTable[pid].residentPages;
+	if (pTable[page].listNext != NONE) pTable[pTable[page].listNext].listPrev = (int)page;
+	processTable[pid].residentPages = (int)page;
+	processTable[pid].residentCount++;
+}
+
+void pageMovedOut(unsigned pid, unsigned page)
+{
+	pageTableEntry_t *pTable = processTable[pid].pageTable;
+	unlistPage(pid, page);
+	// only the replacement, the compressed pool and the backing store keep data
+	// of a page that was moved out
+	if (!IS_ADAPTIVE_POLICY(replacementPolicy) && !zswapEnabled && !backingStoreEnabled) return;
+	pTable[page].listPrev = NONE;
+	pTable[page].listNext = processTable[pid].movedOutPages;
+	if (pTable[page].listNext != NONE) pTable[pTable[page].listNext].listPrev = (int)page;
+	processTable[pid].movedOutPages = (int)page;
+}
+
+void unlistPage(unsigned pid, unsigned page)
+{
+	pageTableEntry_t *pTable = processTable[pid].pageTable;
+	int prev = pTable[page].listPrev, next = pTable[page].listNext;
+	if (prev == UNLISTED) return;
+	if (next != NONE) pTable[next].listPrev = prev;
+	if (prev != NONE) pTable[prev].listNext = next;
+	else if (processTable[pid].residentPages == (int)page) processTable[pid].residentPages = next;
+	else processTable[pid].movedOutPages = next;
+	if (pTable[page].present) processTable[pid].residentCount--;
+	pTable[page].listPrev = UNLISTED;
+	pTable[page].listNext = NONE;
+}
+
+void releasePage(unsigned pid, unsigned page)
+{
+	if (zswapEnabled) zswapForget(pid, page);
+	if (backingStoreEnabled) backingStoreFreeSlot(processTable[pid].pageTable[page].swapLocation);
+}
+
 Boolean storeEmptyFrame(int frame)
 /* Store the frame number in the data structure of empty frames				*/
 /* and update emptyFrameCounter												*/
+{
+	clearFrame(frame);				// the frame holds no page any more
+	return appendEmptyFrame(frame);
+}
+
+Boolean appendEmptyFrame(int frame)
+/* appends the frame, which holds no page, to the list of empty frames		*/
 {
 	frameListEntry_t *newEntry = NULL;
-	newEntry = malloc(sizeof(frameListEntry_t)); 
+	if (numaEnabled)
+	{	// each node keeps its own empty frames
+		numaPutFrame(frame);
+		emptyFrameCounter++;
+		return TRUE;
+	}
+	if (hugePagesEnabled)
+	{	// the runs of empty frames for huge pages are kept by the buddy allocator
+		buddyFree(frame);
+		emptyFrameCounter++;
+		return TRUE;
+	}
+	newEntry = slabAlloc(NOPROCESS, sizeof(frameListEntry_t)); 
 	if (newEntry != NULL)
 	{
 		// create new entry for the frame passed
@@ -216,6 +879,20 @@ Boolean storeEmptyFrame(int frame)
 	return (newEntry != NULL); 
 }
 
+void clearFrame(int frame)
+/* removes the page from the frame table and the data of the replacement	*/
+/* algorithm, i.e. the frame holds no page any more							*/
+{
+	frameTable[frame].pid = NOPROCESS;
+	frameTable[frame].page = 0;
+	frameTable[frame].sharers = 0;
+	// frameReferenced stays until the next timer event, which expects the
+	// frame in referencedFrames only once; the empty frame is skipped there
+	agingFrameFreed(frame);
+	if (IS_ADAPTIVE_POLICY(replacementPolicy)) adaptiveFrameFreed(frame);
+	if (ownersEnabled) ownerUncharge(frame);
+}
+
 int getEmptyFrame(void)
 /* Returns the frame number of an empty frame.								*/
 /* A return value of -1 indicates that no empty frame exists. In this case	*/
@@ -224,29 +901,204 @@ int getEmptyFrame(void)
 {
 	frameListEntry_t *toBeDeleted = NULL;
 	int emptyFrameNo = NONE;
+	if (hugePagesEnabled)
+	{
+		emptyFrameNo = buddyAlloc(0);
+		if (emptyFrameNo != NONE) emptyFrameCounter--;
+		return emptyFrameNo;
+	}
 	if (emptyFrameList == NULL) return NONE;	// no empty frame exists
 	emptyFrameNo = emptyFrameList->frame;	// get number of empty frame
 	// remove entry of that frame from the list
 	toBeDeleted = emptyFrameList;			
 	emptyFrameList = emptyFrameList->next; 
-	free(toBeDeleted); 
+	slabFree(toBeDeleted); 
 	emptyFrameCounter--;					// one empty frame less
 	return emptyFrameNo; 
 }
 
+int getEmptyFrameOnNode(unsigned node)
+/* as getEmptyFrame(), with several nodes the frame is taken from the		*/
+/* given node if possible, see numaTakeFrame()								*/
+{
+	int frame;
+	if (!numaEnabled) return getEmptyFrame();
+	frame = numaTakeFrame(node);
+	if (frame != NONE) emptyFrameCounter--;
+	return frame;
+}
+
+void migratePages(void)
+/* moves the hot pages accessed remotely to the home node of their process	*/
+{
+	int hot[NUMA_MIGRATE_LIMIT], target[NUMA_MIGRATE_LIMIT];
+	unsigned count = numaSelectMigrations(hot, target, NUMA_MIGRATE_LIMIT);
+	for (unsigned i = 0; i < count; i++)
+	{
+		Boolean empty = (frameTable[target[i]].pid == NOPROCESS);
+		exchangeFrames(hot[i], target[i]);
+		if (empty)
+		{	// the target was taken from the empty frames, the old frame is empty now
+			emptyFrameCounter--;
+			appendEmptyFrame(hot[i]);
+		}
+	}
+}
+
+unsigned findHugePageCandidates(unsigned pids[], unsigned regions[])
+/* returns the regions of the pages referenced since the last timer event	*/
+/* that are to be promoted, at most HUGEPAGE_PROMOTE_LIMIT of them			*/
+{
+	unsigned count = 0, pid, region, k;
+	for (unsigned i = 0; (i < referencedFrameCount) && (count < HUGEPAGE_PROMOTE_LIMIT); i++)
+	{
+		int frame = referencedFrames[i];
+		if (!frameReferenced[frame] || (frameTable[frame].pid == NOPROCESS)) continue;
+		pid = frameTable[frame].pid;
+		region = frameTable[frame].page >> hugePageOrder;
+		for (k = 0; (k < count) && ((pids[k] != pid) || (regions[k] != region)); k++);
+		if ((k == count) && hugePageIsCandidate(pid, region))
+		{
+			pids[count] = pid;
+			regions[count] = region;
+			count++;
+		}
+	}
+	return count;
+}
+
+void promoteHugePages(const unsigned pids[], const unsigned regions[], unsigned count)
+/* promotes the regions found by findHugePageCandidates() and samples the	*/
+/* mappings and the fragmentation for the statistics						*/
+{
+	for (unsigned i = 0; i < count; i++)
+		if (promoteRegion(pids[i], regions[i]) && logEnabled)
+			printf("%6u : PID %3u : Region %u promoted to a huge page\n", systemTime, processTable[pids[i]].pid,
+				regions[i]);
+	hugePageSample(MEMORYSIZE - emptyFrameCounter, emptyFrameCounter, buddyFreeFrames(hugePageOrder));
+}
+
+Boolean promoteRegion(unsigned pid, unsigned region)
+/* moves the pages of the region into an aligned run of frames and maps		*/
+/* them as one huge page. Returns FALSE if no run is found					*/
+{
+	pageTableEntry_t *pTable = processTable[pid].pageTable;
+	unsigned size = 1u << hugePageOrder;
+	unsigned first = region << hugePageOrder;
+	unsigned moved = 0, best = 0, count;
+	int run = buddyAlloc(hugePageOrder);	// an empty run, if there is one
+	int start, frame;
+	Boolean compacted = (run == NONE);
+	if (compacted && (emptyFrameCounter < size))
+		return FALSE;						// the memory is full, the replacement would split it soon
+	if (compacted)
+	{	// compaction: the run holding most pages of the region is used, the
+		// other pages in it must be base pages, which are exchanged
+		for (unsigned i = 0; i < size; i++)
+		{
+			start = pTable[first + i].frame & ~(int)(size - 1);
+			if (start + (int)size > MEMORYSIZE) continue;
+			count = 0;
+			for (frame = start; frame < start + (int)size; frame++)
+			{
+				if ((frameTable[frame].pid == NOPROCESS)
+					|| processTable[frameTable[frame].pid].pageTable[frameTable[frame].page].huge)
+					break;
+				if ((frameTable[frame].pid == pid) && ((frameTable[frame].page >> hugePageOrder) == region))
+					count++;
+			}
+			if ((frame == start + (int)size) && (count > best))
+			{
+				best = count;
+				run = start;
+			}
+		}
+		if (run == NONE) return FALSE;
+	}
+	for (unsigned i = 0; i < size; i++)
+	{
+		frame = pTable[first + i].frame;
+		if (frame == run + (int)i) continue;
+		exchangeFrames(frame, run + (int)i);
+		if (!compacted) buddyFree(frame);	// the frame of the empty run was taken
+		moved++;
+	}
+	for (unsigned i = 0; i < size; i++)
+		pTable[first + i].huge = TRUE;
+	hugePagePromoted(compacted, moved);
+	return TRUE;
+}
+
+void demoteHugePage(unsigned pid, unsigned page)
+/* splits the huge page holding the page into base pages					*/
+{
+	unsigned first = page & ~((1u << hugePageOrder) - 1);
+	for (unsigned i = 0; i < (1u << hugePageOrder); i++)
+		processTable[pid].pageTable[first + i].huge = FALSE;
+	hugePageDemoted(pid, page >> hugePageOrder, TRUE);
+	if (logEnabled)
+		printf("%6u : PID %3u : Huge page of page %u split into base pages\n", systemTime, processTable[pid].pid,
+			page);
+}
+
+void exchangeFrames(int a, int b)
+/* the pages in the frames a and b change places, b may be empty			*/
+{
+	frameTableEntry_t entry = frameTable[a];
+	int frames[2] = { a, b };
+	frameTable[a] = frameTable[b];
+	frameTable[b] = entry;
+	for (unsigned i = 0; i < 2; i++)
+	{
+		int frame = frames[i];
+		unsigned page = frameTable[frame].page;
+		if (frameTable[frame].pid != NOPROCESS)
+		{	// all processes sharing the page follow it
+			for (unsigned pid = frameTable[frame].pid; pid != NOPROCESS; pid = processTable[pid].pageTable[page].nextSharer)
+				processTable[pid].pageTable[page].frame = frame;
+			// update the simulation accordingly !! DO NOT REMOVE !!
+			sim_UpdateMemoryMapping(frameTable[frame].pid, (action_t) { allocate, frameTable[frame].page }, frame);
+		}
+		else
+			sim_UpdateMemoryMapping(NOPROCESS, (action_t) { deallocate, 0 }, frame);
+	}
+	agingFramesExchanged(a, b);
+	if (IS_ADAPTIVE_POLICY(replacementPolicy)) adaptiveFramesExchanged(a, b);
+	if (ownersEnabled) ownerFramesExchanged(a, b);
+	if (backingStoreEnabled)
+	{	// the contents are copied like by the migration of a real page
+		unsigned long long page[BACKINGSTORE_PAGE_SIZE / sizeof(unsigned long long)];
+		memcpy(page, backingStoreFrame(a), BACKINGSTORE_PAGE_SIZE);
+		memcpy(backingStoreFrame(a), backingStoreFrame(b), BACKINGSTORE_PAGE_SIZE);
+		memcpy(backingStoreFrame(b), page, BACKINGSTORE_PAGE_SIZE);
+	}
+}
+
 Boolean movePageIn(unsigned pid, unsigned page, unsigned frame)
 /* Returns TRUE on success ans FALSE on any error							*/
 {
-	// copy of the content of the page from secondary memory to RAM not simulated
+	Boolean modified = FALSE;	// a page from the compressed pool may be newer than its copy in the swap file
+	// the content of the page is only copied with a backing store
+	if (zswapEnabled && zswapPageIn(pid, page, frame, &modified))
+		;	// decompressed from the pool
+	else if (backingStoreEnabled && !backingStorePageIn(pid, page, frame, processTable[pid].pageTable[page].swapLocation))
+		logPid(pid, "OS-ERROR: Page read from the swap file with wrong contents");
 	// update the page table: mark present, store frame number, clear statistics
 	// *** This must not be removed. The statistics is used by other components of the OS ***
+	pageMovedIn(pid, page);
 	processTable[pid].pageTable[page].frame = frame;	// list in the pageTabele
 	processTable[pid].pageTable[page].present = TRUE;	// mark as present 
 	// page was just moved in, i.e. is used and not modified: set R-bit, reset M-bit. 
-	processTable[pid].pageTable[page].modified = FALSE;
+	processTable[pid].pageTable[page].modified = modified;
 	processTable[pid].pageTable[page].referenced = TRUE;
 	// Statistics for advanced replacement algorithms need to be reset here also
-	// *** This must be extended for advences page replacement algorithms ***
+	frameTable[frame].pid = pid;				// reverse mapping frame -> page
+	frameTable[frame].page = page;
+	frameTable[frame].sharers = 1;
+	agingFrameLoaded(frame);
+	if (IS_ADAPTIVE_POLICY(replacementPolicy)) adaptiveFrameLoaded(frame, pid, page);
+	if (ownersEnabled) ownerCharge(pid, frame);
+	setFrameReferenced(frame);
 	// 
 	// update the simulation accordingly !! DO NOT REMOVE !!
 	sim_UpdateMemoryMapping(pid, (action_t) { allocate, page }, frame);
@@ -263,18 +1115,49 @@ Boolean movePageOut(unsigned pid, unsigned page, int frame)
 /* present in RAM, including its location in seondary storage				*/
 /* Returns TRUE on success and FALSE on any error							*/
 {
-	// allocation of secondary memory storage location and copy of page are ommitted for this simulation
-	// no distinction between clean and dirty pages made at this point
+	Boolean modified = processTable[pid].pageTable[page].modified;
+	storePage(pid, page, frame, modified);
 	// update the page table: mark absent, add frame to pool of empty frames
 	// *** This must be extended for advences page replacement algorithms ***
+	pageMovedOut(pid, page);
 	processTable[pid].pageTable[page].present = FALSE;
-
+	// a shared frame is evicted once and unmapped from all processes sharing it,
+	// each of them keeps a copy of its own in the pool or the swap file
+	for (unsigned sharer = processTable[pid].pageTable[page].nextSharer, next; sharer != NOPROCESS; sharer = next)
+	{
+		next = processTable[sharer].pageTable[page].nextSharer;
+		storePage(sharer, page, frame, modified);
+		pageMovedOut(sharer, page);
+		processTable[sharer].pageTable[page].present = FALSE;
+		processTable[sharer].pageTable[page].nextSharer = NOPROCESS;
+	}
+	processTable[pid].pageTable[page].nextSharer = NOPROCESS;
+	framesSaved -= frameTable[frame].sharers - 1;
+	// the replacement algorithm may keep the page as ghost
+	if (IS_ADAPTIVE_POLICY(replacementPolicy)) adaptiveFrameEvicted(frame);
 	storeEmptyFrame(frame);	// add to pool of empty frames
 	// update the simulation accordingly !! DO NOT REMOVE !!
 	sim_UpdateMemoryMapping(pid, (action_t) { deallocate, page }, frame);
 	return TRUE;
 }
 
+void storePage(unsigned pid, unsigned page, int frame, Boolean modified)
+{
+	// allocation of secondary memory storage location and copy of page are only
+	// done with a backing store, which writes dirty pages only. The compressed
+	// pool comes first, pages not kept there go to the swap device
+	if (backingStoreEnabled && (backingStoreFrame(frame)[0] != pid))
+	{	// the frame was shared at a fork and holds the contents of another
+		// process: the copy of this process is written even if clean
+		backingStoreFrame(frame)[0] = pid;
+		modified = TRUE;
+	}
+	if (zswapEnabled && zswapPageOut(pid, page, frame, modified))
+		;	// held in the pool
+	else if (backingStoreEnabled && !backingStorePageOut(frame, modified, &processTable[pid].pageTable[page].swapLocation))
+		logPid(pid, "OS-ERROR: Page could not be written to the swap file");
+}
+
 Boolean updatePageEntry(unsigned pid, action_t action)
 /* updates the data relevant for page replacement in the page table entry,	*/
 /* e.g. set reference and modify bit.										*/
@@ -285,17 +1168,42 @@ Boolean updatePageEntry(unsigned pid, action_t action)
 // *** This must be extended for advences page replacement algorithms ***
 {
 	processTable[pid].pageTable[action.page].referenced = TRUE; 
+	// with several CPUs the caller sets it under the lock of the shard
+	if (smpCpuCount == 1) setFrameReferenced(processTable[pid].pageTable[action.page].frame);
 	if (action.op == write)
+	{
 		processTable[pid].pageTable[action.page].modified = TRUE;
+		if (backingStoreEnabled) backingStoreWrite(processTable[pid].pageTable[action.page].frame);
+	}
 	return TRUE; 
 }
 
 
+void setFrameReferenced(int frame)
+/* sets the R-bit of the frame and records the frame for the timer			*/
+{
+	unsigned shard;
+	if (frameReferenced[frame]) return;		// already recorded
+	frameReferenced[frame] = 1;
+	if (smpCpuCount > 1)
+	{	// each shard records its frames in its own part of the list, under its lock
+		shard = shardOf(frame);
+		referencedFrames[shardFirst[shard] + (int)shardReferencedCount[shard]++] = frame;
+		return;
+	}
+	referencedFrames[referencedFrameCount++] = frame;
+	referencedSinceTimer = TRUE;			// the next timer event must reset R-bits
+}
+
 Boolean pageReplacement(unsigned *outPid, unsigned *outPage, int *outFrame)
 /* ===== The page replacement algorithm								======	*/
-/* In the initial implementation the frame to be cleared is chosen			*/
-/* globaly and randomly, i.e. a frame is chosen at random regardless of the	*/
-/* process that is currently usigt it.										*/
+/* The algorithm is selected by replacementPolicy:							*/
+/* random: the frame to be cleared is chosen globaly and randomly, i.e. a	*/
+/*         frame is chosen at random regardless of the process using it.	*/
+/* aging:  the frame with the smallest aging counter is chosen globally		*/
+/* weighted: as aging, the counters weighted by the class of the process,	*/
+/*         see procclass.h													*/
+/* arc, car, 2q, lirs, clockpro: scan resistant algorithms, see adaptive.h	*/
 /* The values of pid and page number passed to the function may be used by  */
 /* local replacement strategies */
 /* OUTPUT: */
@@ -310,26 +1218,56 @@ Boolean pageReplacement(unsigned *outPid, unsigned *outPage, int *outFrame)
 	unsigned pid = (*outPid); 
 	unsigned page = (*outPage);
 	int frame = *outFrame; 
+	unsigned node = 0;			// with several nodes the page is placed on this node
+	int first = 0, last = MEMORYSIZE;	// frames of the node
+	if (numaEnabled)
+	{
+		node = numaSelectNode(pid, page);
+		first = numaFirstFrame(node);
+		last = numaFirstFrame(node + 1);
+	}
 	
-	// +++++ START OF REPLACEMENT ALGORITHM IMPLEMENTATION: GLOBAL RANDOM ++++
-	logGeneric("MEM: Choosing a frame randomly, this must be improved");
-	frame = rand() % MEMORYSIZE;		// chose a frame by random
-	// As the initial implemetation does not have data structures that allows
-	// easy retrieval of the identity of a page residing in a given frame, 
-	// now the frame ist searched for in all page tables of all running processes
-	// I.e.: Iterate through the process table and for each valid PCB check 
-	//the valid entries in its page table until the frame is found
-	pid = 0; page = 0; 
-	do 
-	{
-		pid++;
-		if ((processTable[pid].valid) && (processTable[pid].pageTable != NULL))
-			for (page = 0; page < processTable[pid].size; page++)
-				if (processTable[pid].pageTable[page].frame == frame) {
-					found = TRUE;
-					break;
-				}
-	} while ((!found) && (pid < MAX_PROCESSES));
+	// +++++ START OF REPLACEMENT ALGORITHM IMPLEMENTATION ++++
+	switch (replacementPolicy)
+	{
+	case agingReplacement:
+		// global aging: evict the page with the smallest aging counter
+		logGeneric("MEM: Choosing the frame with the smallest aging counter");
+		if (numaEnabled)		// evict on the node the page is placed on
+			frame = agingSelectVictimRange(frameReferenced, first, last, &nodeHand[node]);
+		else
+			frame = agingSelectVictim(frameReferenced);
+		break;
+	case weightedReplacement:
+		// aging weighted by the class of the process, sparing the protected resident sets
+		logGeneric("MEM: Choosing the frame with the smallest weighted aging counter");
+		frame = classSelectVictim(frameReferenced, first, last, &nodeHand[node]);
+		break;
+	case arcReplacement:
+	case carReplacement:
+	case twoQueueReplacement:
+	case lirsReplacement:
+	case clockProReplacement:
+		// scan resistant algorithms, based on recency and ghost lists
+		logGeneric("MEM: Choosing a frame with a scan resistant algorithm");
+		frame = adaptiveSelectVictim();
+		break;
+	case randomReplacement:
+	default:
+		logGeneric("MEM: Choosing a frame randomly, this must be improved");
+		frame = first + rand() % (last - first);		// chose a frame by random
+		// skip empty frames, the replacement may be used while some exist
+		for (int i = first; (i < last) && (frameTable[frame].pid == NOPROCESS); i++)
+			frame = (frame + 1 < last) ? frame + 1 : first;
+		break;
+	}
+	// the frame table gives the identity of the page residing in the frame
+	if ((frame >= 0) && (frameTable[frame].pid != NOPROCESS))
+	{
+		pid = frameTable[frame].pid;
+		page = frameTable[frame].page;
+		found = TRUE;
+	}
 	// +++++ END OF REPLACEMENT ALFGORITHM found indicates success/failure
 	// RESULT is pid, page, frame
 
@@ -341,4 +1279,293 @@ Boolean pageReplacement(unsigned *outPid, unsigned *outPage, int *outFrame)
 		(*outFrame) = frame;
 	}
 	return found; 
-}
\ No newline at end of file
+}
+/* ---------------------------------------------------------------- */
+/*                Multi-CPU operation (smpCpuCount > 1)				*/
+
+void initMultiCPU(void)
+{
+	registerProcessArray((void**)&pidLock, sizeof(smpLock_t));	// all unlocked
+	smpLockInit(&emptyFrameLock);
+	smpLockInit(&decisionLogLock);
+	// each CPU evicts in a shard of its own first, with its own aging hand,
+	// so the CPUs only meet at the timer. The adaptive algorithms keep
+	// global lists, they form one shard
+	shardCount = IS_ADAPTIVE_POLICY(replacementPolicy) ? 1 : smpCpuCount;
+	if (shardCount > MEMORYSIZE) shardCount = MEMORYSIZE;
+	for (unsigned shard = 0; shard <= shardCount; shard++)
+		shardFirst[shard] = (int)(((unsigned long long)shard * MEMORYSIZE + shardCount - 1) / shardCount);
+	for (unsigned shard = 0; shard < shardCount; shard++)
+	{
+		smpLockInit(&shardLock[shard]);
+		shardHand[shard] = shardFirst[shard];
+		shardReferencedCount[shard] = 0;
+		shardRandom[shard] = 2463534242u + shard;
+	}
+	for (unsigned cpu = 0; cpu < SMP_MAX_CPUS; cpu++)
+	{
+		smpLockInit(&frameCacheLock[cpu]);
+		frameCacheCount[cpu] = 0;
+	}
+	// a CPU caches at most a quarter of its share of the memory
+	frameCacheBatch = MEMORYSIZE / (4 * smpCpuCount);
+	if (frameCacheBatch > FRAME_CACHE_SIZE / 2) frameCacheBatch = FRAME_CACHE_SIZE / 2;
+	if (frameCacheBatch < 1) frameCacheBatch = 1;
+}
+
+int accessPageMultiCPU(unsigned pid, action_t action)
+{
+	pageTableEntry_t *pTable;
+	unsigned shard;
+	int frame;
+	smpLock(&pidLock[pid]);
+	pTable = processTable[pid].pageTable;
+	if ((pTable == NULL) || (action.page >= processTable[pid].size))
+	{	// process not started or page outside of its logical memory
+		smpUnlock(&pidLock[pid]);
+		logPid(pid, "OS-ERROR: Access to a page outside of the logical memory");
+		return NONE;
+	}
+	if (pTable[action.page].present)
+	{	// hit: the lock of the process keeps other CPUs from evicting the page
+		frame = pTable[action.page].frame;
+		updatePageEntry(pid, action);
+		sim_UpdateMemoryMapping(pid, action, frame);
+		smpUnlock(&pidLock[pid]);
+		// the page may have been evicted meanwhile: check the frame again.
+		// The adaptive algorithms have a single shard, their lists are global
+		shard = shardOf(frame);
+		smpLock(&shardLock[shard]);
+		if ((frameTable[frame].pid == pid) && (frameTable[frame].page == action.page))
+		{
+			setFrameReferenced(frame);
+			if (IS_ADAPTIVE_POLICY(replacementPolicy)) adaptiveFrameAccessed(frame);
+		}
+		smpUnlock(&shardLock[shard]);
+		return frame;
+	}
+	smpUnlock(&pidLock[pid]);
+	// fault: only this CPU maps pages of the process, so the page stays absent
+	frame = handlePageFaultMultiCPU(pid, action.page);
+	if (frame >= 0)
+	{
+		smpLock(&pidLock[pid]);
+		if (pTable[action.page].present && (pTable[action.page].frame == frame))
+		{
+			updatePageEntry(pid, action);
+			sim_UpdateMemoryMapping(pid, action, frame);
+		}
+		smpUnlock(&pidLock[pid]);
+	}
+	return frame;
+}
+
+int handlePageFaultMultiCPU(unsigned pid, unsigned page)
+{
+	unsigned cpu = smpCpu;
+	unsigned home = cpu % shardCount;
+	unsigned victimPid = NOPROCESS, victimPage = page;
+	unsigned shard = 0;
+	Boolean adaptive = IS_ADAPTIVE_POLICY(replacementPolicy);
+	int frame = NONE;
+	logPid(pid, "Pagefault");
+	smpAtomicAdd(&pageFaultCount, 1);
+	if (adaptive)
+	{	// the whole fault is handled under the lock of the only shard
+		smpLock(&shardLock[0]);
+		adaptiveFault(pid, page);
+	}
+	for (unsigned attempt = 0; frame < 0; attempt++)
+	{
+		frame = getCachedFrame(cpu);
+		// no empty frame: evict in the shard of this CPU, then in the others
+		for (unsigned i = 0; (frame < 0) && (i < shardCount); i++)
+		{
+			shard = (home + i) % shardCount;
+			if (!adaptive) smpLock(&shardLock[shard]);
+			frame = evictFromShard(shard, &victimPid, &victimPage);
+			if (!adaptive) smpUnlock(&shardLock[shard]);
+		}
+		if ((frame < 0) && (adaptive || (attempt >= MEMORYSIZE)))
+		{	// under the lock of the only shard no frame can be in transit
+			if (adaptive) smpUnlock(&shardLock[0]);
+			logPid(pid, "OS-ERROR: No frame available");
+			return NONE;
+		}
+		// the frames are in transit between eviction and page-in on other CPUs
+		if (frame < 0) smpYield();
+	}
+	if (victimPid != NOPROCESS) smpAtomicAdd(&evictionCount, 1);
+	// move the page in, holding the lock of the shard of the frame
+	shard = shardOf(frame);
+	if (!adaptive) smpLock(&shardLock[shard]);
+	smpLock(&pidLock[pid]);
+	movePageIn(pid, page, frame);
+	smpUnlock(&pidLock[pid]);
+	smpUnlock(&shardLock[shard]);
+	smpLock(&decisionLogLock);
+	decisionLogFault(smpTime, processTable[pid].pid, page, frame, processTable[victimPid].pid, victimPage);
+	smpUnlock(&decisionLogLock);
+	return frame;
+}
+
+int evictFromShard(unsigned shard, unsigned *victimPid, unsigned *victimPage)
+{
+	int frame = NONE;
+	unsigned pid, page;
+	switch (replacementPolicy)
+	{
+	case agingReplacement:
+		frame = agingSelectVictimRange(frameReferenced, shardFirst[shard], shardFirst[shard + 1], &shardHand[shard]);
+		break;
+	case randomReplacement:
+		// rand() is not thread-safe: xorshift generator of the shard
+		shardRandom[shard] ^= shardRandom[shard] << 13;
+		shardRandom[shard] ^= shardRandom[shard] >> 17;
+		shardRandom[shard] ^= shardRandom[shard] << 5;
+		frame = shardFirst[shard] + (int)(shardRandom[shard] % (unsigned)(shardFirst[shard + 1] - shardFirst[shard]));
+		for (int i = shardFirst[shard]; (i < shardFirst[shard + 1]) && (frameTable[frame].pid == NOPROCESS); i++)
+			frame = (frame + 1 < shardFirst[shard + 1]) ? frame + 1 : shardFirst[shard];
+		break;
+	default:
+		frame = adaptiveSelectVictim();
+		break;
+	}
+	if ((frame < 0) || (frameTable[frame].pid == NOPROCESS)) return NONE;
+	pid = frameTable[frame].pid;
+	page = frameTable[frame].page;
+	// unmap the page, the owner may be running on another CPU
+	smpLock(&pidLock[pid]);
+	pageMovedOut(pid, page);
+	processTable[pid].pageTable[page].present = FALSE;
+	if (IS_ADAPTIVE_POLICY(replacementPolicy)) adaptiveFrameEvicted(frame);
+	clearFrame(frame);
+	sim_UpdateMemoryMapping(pid, (action_t) { deallocate, page }, frame);
+	smpUnlock(&pidLock[pid]);
+	*victimPid = pid;
+	*victimPage = page;
+	return frame;
+}
+
+Boolean deAllocateProcessMultiCPU(unsigned pid)
+{
+	pageTableEntry_t *pTable = processTable[pid].pageTable;
+	unsigned shard;
+	int frame;
+	Boolean adaptive = IS_ADAPTIVE_POLICY(replacementPolicy);
+	int i;
+	for (;;)
+	{
+		// the first resident page may be evicted concurrently: check again under the locks
+		smpLock(&pidLock[pid]);
+		i = processTable[pid].residentPages;
+		frame = (i != NONE) ? pTable[i].frame : NONE;
+		smpUnlock(&pidLock[pid]);
+		if (i == NONE) break;
+		shard = adaptive ? 0 : shardOf(frame);
+		smpLock(&shardLock[shard]);
+		smpLock(&pidLock[pid]);
+		if ((processTable[pid].residentPages == i) && (pTable[i].frame == frame))
+		{
+			pageMovedOut(pid, (unsigned)i);
+			pTable[i].present = FALSE;
+			clearFrame(frame);
+			sim_UpdateMemoryMapping(pid, (action_t) { deallocate, i }, frame);
+			smpUnlock(&pidLock[pid]);
+			smpUnlock(&shardLock[shard]);
+			putCachedFrame(smpCpu, frame);
+		}
+		else
+		{
+			smpUnlock(&pidLock[pid]);
+			smpUnlock(&shardLock[shard]);
+		}
+	}
+	if (adaptive)
+	{	// the ghosts of the pages moved out are useless now
+		smpLock(&shardLock[0]);
+		for (i = processTable[pid].movedOutPages; i != NONE; i = pTable[i].listNext)
+			adaptiveForgetPage(pid, (unsigned)i);
+		smpUnlock(&shardLock[0]);
+	}
+	smpLock(&pidLock[pid]);
+	processTable[pid].pageTable = NULL;
+	smpUnlock(&pidLock[pid]);
+	slabReleaseOwner(pid);
+	return TRUE;
+}
+
+void updateReplacementStatisticsMultiCPU(unsigned ticks)
+{
+	unsigned pid;
+	for (unsigned shard = 0; shard < shardCount; shard++)
+		smpLock(&shardLock[shard]);
+	if (replacementPolicy == agingReplacement)
+		agingTick(frameReferenced, ticks);
+	// only the frames referenced since the last timer event are visited, a
+	// frame that holds a page keeps the page table of its process alive.
+	// The R-bit of the frame belongs to the shards locked here, the one in
+	// the page table to the owner
+	for (unsigned shard = 0; shard < shardCount; shard++)
+	{
+		for (unsigned i = 0; i < shardReferencedCount[shard]; i++)
+		{
+			int frame = referencedFrames[shardFirst[shard] + (int)i];
+			frameReferenced[frame] = 0;
+			pid = frameTable[frame].pid;
+			if (pid == NOPROCESS) continue;
+			smpLock(&pidLock[pid]);
+			processTable[pid].pageTable[frameTable[frame].page].referenced = FALSE;
+			smpUnlock(&pidLock[pid]);
+		}
+		shardReferencedCount[shard] = 0;
+	}
+	referencedSinceTimer = FALSE;
+	for (unsigned shard = shardCount; shard > 0; shard--)
+		smpUnlock(&shardLock[shard - 1]);
+}
+
+int getCachedFrame(unsigned cpu)
+{
+	int frame = NONE;
+	smpLock(&frameCacheLock[cpu]);
+	if (frameCacheCount[cpu] > 0)
+		frame = frameCache[cpu][--frameCacheCount[cpu]];
+	else
+	{	// the next frame of the list, not a batch: the pages get the frames
+		// they get on a single CPU, aging breaks ties by the frame number
+		smpLock(&emptyFrameLock);
+		frame = getEmptyFrame();
+		smpUnlock(&emptyFrameLock);
+	}
+	smpUnlock(&frameCacheLock[cpu]);
+	// steal from the other CPUs before a page is evicted
+	for (unsigned i = 1; (frame < 0) && (i < smpCpuCount); i++)
+	{
+		unsigned other = (cpu + i) % smpCpuCount;
+		smpLock(&frameCacheLock[other]);
+		if (frameCacheCount[other] > 0) frame = frameCache[other][--frameCacheCount[other]];
+		smpUnlock(&frameCacheLock[other]);
+	}
+	return frame;
+}
+
+void putCachedFrame(unsigned cpu, int frame)
+{
+	smpLock(&frameCacheLock[cpu]);
+	if (frameCacheCount[cpu] >= 2 * frameCacheBatch)
+	{	// spill a batch to the list of empty frames, other CPUs may need them
+		smpLock(&emptyFrameLock);
+		while (frameCacheCount[cpu] > frameCacheBatch)
+			appendEmptyFrame(frameCache[cpu][--frameCacheCount[cpu]]);
+		smpUnlock(&emptyFrameLock);
+	}
+	frameCache[cpu][frameCacheCount[cpu]++] = frame;
+	smpUnlock(&frameCacheLock[cpu]);
+}
+
+unsigned shardOf(int frame)
+{
+	// shardFirst[s] is rounded up, so this is the inverse of its computation
+	return (unsigned)(((unsigned long long)frame * shardCount) / MEMORYSIZE);
+}
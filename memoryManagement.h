@@ -8,6 +8,9 @@
 #include "log.h"
 #include "simruntime.h"
 
+extern Boolean referencedSinceTimer;	// a page was referenced since the last timer event
+extern replacementPolicy_t replacementPolicy;	// the page replacement algorithm in use
+
 Boolean initMemoryManager(void);		// initialise the memory management system emptyFrameCounter = MEMSIZE;		
 /* initialises the memory manager, allocates and iniatlises the				*/
 /* required data structures													*/
@@ -29,14 +32,75 @@ int accessPage(unsigned pid, action_t action);
 /* Returns the number of the frame, the page resides in, and				*/
 /* a negative value on error												*/
 
+unsigned accessPages(unsigned pid, const action_t actions[], unsigned count, int frames[]);
+/* batched variant of accessPage() for a list of read/write actions of one	*/
+/* process at the same point in time. The page table of the process is		*/
+/* looked up once for the whole list, the actions are performed in the		*/
+/* given order and frames[i] receives the frame of actions[i].				*/
+/* Returns the number of actions performed. If this is less than count,		*/
+/* the next action failed and its entry in frames[] is negative				*/
+
+Boolean isPageFault(unsigned pid, unsigned page);
+/* predicate: an access to the page causes a page fault. Returns FALSE for	*/
+/* resident pages and for invalid accesses, accessPage() reports those		*/
+
 Boolean createPageTable(unsigned pid);
 /* Create and initialise the page table	of the giveb process				*/
 /* Information on max. process size must be already stored in the PCB		*/
 /* Returns TRUE on success, FALSE otherwise									*/
 
+Boolean forkProcess(unsigned pid, unsigned child);
+/* creates the page table of the child as a copy of the one of the process.	*/
+/* The child must be defined in the process table and not be started, its	*/
+/* size is set to the one of its parent. The resident pages are shared		*/
+/* read-only, the first write of a sharer gives it a private copy			*/
+/* (copy-on-write). Not available with the backing store or the compressed	*/
+/* pool. Returns TRUE on success, FALSE otherwise							*/
+
 Boolean deAllocateProcess(unsigned pid);
 /* free the physical memory used by a process, destroy the page table		*/
 /* returns TRUE on success, FALSE on error									*/
 
+unsigned swapOutProcess(unsigned pid);
+/* moves all resident pages of the process out at once, like the			*/
+/* replacement would move them out one by one, and keeps the page table.	*/
+/* The frames shared with other processes stay with them. Used by the		*/
+/* load control to suspend a process, on a single CPU only.					*/
+/* Returns the number of pages moved out									*/
+
+unsigned listEmptyFrames(int frames[]);
+/* copies the empty frames in the order of their list, which they are		*/
+/* taken from, to frames[] and returns their number. Single CPU only		*/
+
+Boolean restoreEmptyFrames(const int frames[], unsigned count);
+/* replaces the list of the empty frames by the given one, the frames		*/
+/* must hold no page. Returns FALSE on invalid frames or out of memory		*/
+
+void resetPageTable(unsigned pid);
+/* marks all pages of the page table as not resident and in no list, e.g.	*/
+/* a page table restored from a snapshot whose frames are not taken over	*/
+
+int restorePage(unsigned pid, unsigned page, Boolean modified);
+/* moves the page into an empty frame without counting a page fault, the	*/
+/* replacement algorithm sees it as just loaded. Returns the frame, NONE	*/
+/* if no empty frame is left												*/
+
+void updateReplacementStatistics(unsigned ticks);
+/* called by the timer event handler for <ticks> consecutive timer events	*/
+/* without memory accesses in between: updates the data used by the page	*/
+/* replacement algorithm (e.g. the aging counters) and resets the R-bits	*/
+/* of all present pages														*/
+
+Boolean selectReplacementPolicy(const char* name);
+/* selects the page replacement algorithm by its name, see					*/
+/* getReplacementPolicyName(). Returns FALSE for unknown names				*/
+
+const char* getReplacementPolicyName(replacementPolicy_t policy);
+/* returns the name of the given page replacement algorithm					*/
+
+void printReplacementStatistics(void);
+/* prints the number of page faults and evictions and the statistics of	*/
+/* the replacement algorithm, e.g. the ghost hits, to stdout				*/
+
 
 #endif  /* __MEMORY_MANAGEMENT__ */ 
\ No newline at end of file
@@ -0,0 +1,214 @@
+/* Implementation of the model of a physical memory with several nodes		*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <stdio.h>
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "numa.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in numa.h		*/
+unsigned numaNodeCount = NUMA_NODES;
+numaPlacement_t numaPlacementPolicy = NUMA_PLACEMENT;
+Boolean numaMigration = FALSE;
+Boolean numaEnabled = FALSE;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+extern frameTableEntry_t frameTable[];		// owned by the memory manager
+
+// names of the placement policies, in the order of numaPlacement_t
+const char* numaPlacementNames[] = { "firsttouch", "interleave" };
+
+int numaFirst[NUMA_MAX_NODES + 1];			// first frame of each node
+unsigned char numaFrameNode[MEMORYSIZE];	// node of each frame
+int numaFreeFrames[MEMORYSIZE];				// stacks of empty frames, one per node at numaFirst[node]
+unsigned numaFreeCount[NUMA_MAX_NODES];		// number of empty frames of each node
+unsigned* numaHome = NULL;					// home node of each process, grows with the process table
+unsigned numaNextHome = 0;					// home node of the next process started
+unsigned numaFrameAccesses[MEMORYSIZE];		// accesses to each frame in the timer period
+unsigned numaFrameRemote[MEMORYSIZE];		// remote accesses among them
+numaStatistics_t numaStats;
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+int coldestFrame(unsigned node);
+/* returns the frame of the node accessed least in the timer period,		*/
+/* NONE if all frames of the node are excluded								*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+void numaInit(unsigned frames)
+{
+	if (numaNodeCount < 1) numaNodeCount = 1;
+	if (numaNodeCount > NUMA_MAX_NODES) numaNodeCount = NUMA_MAX_NODES;
+	if (numaNodeCount > frames) numaNodeCount = frames;
+	for (unsigned node = 0; node <= numaNodeCount; node++)
+		numaFirst[node] = (int)(((unsigned long long)node * frames + numaNodeCount - 1) / numaNodeCount);
+	for (unsigned node = 0; node < numaNodeCount; node++)
+	{
+		numaFreeCount[node] = 0;
+		for (int frame = numaFirst[node]; frame < numaFirst[node + 1]; frame++)
+			numaFrameNode[frame] = (unsigned char)node;
+	}
+	registerProcessArray((void**)&numaHome, sizeof(unsigned));
+	memset(numaFrameAccesses, 0, sizeof(numaFrameAccesses));
+	memset(numaFrameRemote, 0, sizeof(numaFrameRemote));
+	memset(&numaStats, 0, sizeof(numaStats));
+	numaNextHome = 0;
+	numaEnabled = (numaNodeCount > 1);
+}
+
+Boolean selectNumaPlacement(const char* name)
+{
+	for (unsigned i = 0; i < sizeof(numaPlacementNames) / sizeof(numaPlacementNames[0]); i++)
+		if (strcmp(name, numaPlacementNames[i]) == 0)
+		{
+			numaPlacementPolicy = (numaPlacement_t)i;
+			return TRUE;
+		}
+	return FALSE;
+}
+
+void numaProcessStarted(unsigned pid)
+{
+	numaHome[pid] = numaNextHome;
+	numaNextHome = (numaNextHome + 1) % numaNodeCount;
+}
+
+unsigned numaNodeOf(int frame)
+{
+	return numaFrameNode[frame];
+}
+
+int numaFirstFrame(unsigned node)
+{
+	return numaFirst[node];
+}
+
+unsigned numaSelectNode(unsigned pid, unsigned page)
+{
+	if (numaPlacementPolicy == numaInterleave)
+		return (numaHome[pid] + page) % numaNodeCount;
+	return numaHome[pid];
+}
+
+void numaPutFrame(int frame)
+{
+	unsigned node = numaFrameNode[frame];
+	numaFreeFrames[numaFirst[node] + (int)numaFreeCount[node]++] = frame;
+}
+
+int numaTakeFrame(unsigned node)
+{
+	// the nodes are searched in the order of their distance, all remote
+	// nodes are equally far
+	for (unsigned i = 0; i < numaNodeCount; i++)
+	{
+		unsigned n = (node + i) % numaNodeCount;
+		if (numaFreeCount[n] > 0)
+		{
+			if (i > 0) numaStats.fallbacks++;
+			return numaFreeFrames[numaFirst[n] + (int)--numaFreeCount[n]];
+		}
+	}
+	return NONE;
+}
+
+void numaAccess(unsigned pid, int frame)
+{
+	unsigned node = numaFrameNode[frame];
+	numaStats.nodeAccesses[node]++;
+	if (node == numaHome[pid])
+	{
+		numaStats.localAccesses++;
+		numaStats.cost += NUMA_LOCAL_COST;
+	}
+	else
+	{
+		numaStats.remoteAccesses++;
+		numaStats.nodeRemote[node]++;
+		numaStats.cost += NUMA_REMOTE_COST;
+		numaFrameRemote[frame]++;
+	}
+	numaFrameAccesses[frame]++;
+}
+
+unsigned numaSelectMigrations(int hot[], int target[], unsigned max)
+{
+	unsigned count = 0, home;
+	int partner;
+	if (!numaMigration) return 0;
+	for (int frame = 0; (frame < MEMORYSIZE) && (count < max); frame++)
+	{
+		if ((numaFrameRemote[frame] < NUMA_MIGRATE_THRESHOLD) || (frameTable[frame].pid == NOPROCESS))
+			continue;
+		home = numaHome[frameTable[frame].pid];
+		if (numaFreeCount[home] > 0)
+			partner = numaFreeFrames[numaFirst[home] + (int)--numaFreeCount[home]];
+		else
+		{	// exchange with the page used least on the home node, if it is used
+			// less than the hot page is used remotely
+			partner = coldestFrame(home);
+			if ((partner == NONE) || (numaFrameAccesses[partner] >= numaFrameRemote[frame])) continue;
+			numaFrameAccesses[partner] = UINT_MAX;	// exclude it from further exchanges
+			numaFrameRemote[partner] = 0;
+			numaStats.exchanges++;
+		}
+		numaFrameAccesses[frame] = UINT_MAX;
+		hot[count] = frame;
+		target[count] = partner;
+		count++;
+	}
+	numaStats.migrations += count;
+	memset(numaFrameAccesses, 0, sizeof(numaFrameAccesses));
+	memset(numaFrameRemote, 0, sizeof(numaFrameRemote));
+	return count;
+}
+
+void numaGetStatistics(numaStatistics_t* stats)
+{
+	*stats = numaStats;
+}
+
+void numaPrintStatistics(void)
+{
+	numaStatistics_t s;
+	unsigned long long accesses;
+	char label[32];
+	numaGetStatistics(&s);
+	accesses = s.localAccesses + s.remoteAccesses;
+	printf("NUMA (%u nodes, %s%s)\n", numaNodeCount, numaPlacementNames[numaPlacementPolicy],
+		numaMigration ? ", migration" : "");
+	printf("%-28s %15llu\n", "local accesses", s.localAccesses);
+	printf("%-28s %15llu\n", "remote accesses", s.remoteAccesses);
+	printf("%-28s %14.1f%%\n", "remote access ratio", (accesses > 0) ? 100.0 * s.remoteAccesses / accesses : 0.0);
+	printf("%-28s %15.2f\n", "avg. access cost", (accesses > 0) ? (double)s.cost / accesses : 0.0);
+	printf("%-28s %15llu\n", "pages placed on other node", s.fallbacks);
+	printf("%-28s %15llu\n", "pages migrated", s.migrations);
+	printf("%-28s %15llu\n", "pages exchanged", s.exchanges);
+	for (unsigned node = 0; node < numaNodeCount; node++)
+	{
+		snprintf(label, sizeof(label), "node %u remote ratio", node);
+		printf("%-28s %14.1f%%\n", label,
+			(s.nodeAccesses[node] > 0) ? 100.0 * s.nodeRemote[node] / s.nodeAccesses[node] : 0.0);
+	}
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+int coldestFrame(unsigned node)
+{
+	int coldest = NONE;
+	for (int frame = numaFirst[node]; frame < numaFirst[node + 1]; frame++)
+		if ((frameTable[frame].pid != NOPROCESS) && (numaFrameAccesses[frame] != UINT_MAX)
+			&& ((coldest == NONE) || (numaFrameAccesses[frame] < numaFrameAccesses[coldest])))
+			coldest = frame;
+	return coldest;
+}
@@ -0,0 +1,93 @@
+/* Include-file defining the model of a physical memory with several nodes	*/
+/* (NUMA). The frames are split into nodes of consecutive frames, each		*/
+/* process has a home node it runs on. An access to a frame of the home		*/
+/* node costs NUMA_LOCAL_COST, an access to another node NUMA_REMOTE_COST.	*/
+/* Each node keeps its own empty frames. The placement policy selects the	*/
+/* node a page is moved into:												*/
+/* firsttouch : the home node of the process touching the page				*/
+/* interleave : the pages of a process are spread over all nodes in turn	*/
+/* If the node has no empty frame, an empty frame of the nearest node is	*/
+/* used; if there is none, aging and random evict a page of the node, the	*/
+/* other algorithms evict globally and the page goes where the frame is.	*/
+/* With migration, the pages accessed remotely at least						*/
+/* NUMA_MIGRATE_THRESHOLD times in a timer period are moved to the home		*/
+/* node at the timer event, into an empty frame or in exchange for the page	*/
+/* accessed least in that period.											*/
+#ifndef __NUMA__
+#define __NUMA__
+
+#include "bs_types.h"
+
+#define NUMA_MAX_NODES 16
+#define NUMA_MIGRATE_THRESHOLD 4	// remote accesses in a timer period making a page hot
+#define NUMA_MIGRATE_LIMIT 8		// pages migrated per timer event at most
+
+/* the placement policies, in the order of numaPlacementNames */
+typedef enum
+{
+	numaFirstTouch, numaInterleave
+} numaPlacement_t;
+
+/* statistics of the accesses, for the report at the end of the run		*/
+typedef struct numaStatistics_struct
+{
+	unsigned long long localAccesses;	// accesses to the home node of the process
+	unsigned long long remoteAccesses;	// accesses to another node
+	unsigned long long cost;			// sum of the costs of all accesses
+	unsigned long long fallbacks;		// pages moved into another node than selected
+	unsigned long long migrations;		// hot pages moved to their home node
+	unsigned long long exchanges;		// of these, moved in exchange for another page
+	unsigned long long nodeAccesses[NUMA_MAX_NODES];	// accesses to the frames of each node
+	unsigned long long nodeRemote[NUMA_MAX_NODES];		// remote accesses among them
+} numaStatistics_t;
+
+extern unsigned numaNodeCount;			// number of nodes, 1: uniform memory
+extern numaPlacement_t numaPlacementPolicy;
+extern Boolean numaMigration;			// move hot remote pages at the timer events
+extern Boolean numaEnabled;				// set by numaInit() for more than one node
+
+void numaInit(unsigned frames);
+/* splits the frames into numaNodeCount nodes, all of them without empty	*/
+/* frames, and clears the statistics										*/
+
+Boolean selectNumaPlacement(const char* name);
+/* selects the placement policy by its name, e.g. "interleave"				*/
+/* Returns FALSE for an unknown name										*/
+
+void numaProcessStarted(unsigned pid);
+/* gives the process its home node, the nodes are used in turn				*/
+
+unsigned numaNodeOf(int frame);
+/* returns the node of the frame											*/
+
+int numaFirstFrame(unsigned node);
+/* returns the first frame of the node, numaFirstFrame(numaNodeCount) is	*/
+/* the number of frames														*/
+
+unsigned numaSelectNode(unsigned pid, unsigned page);
+/* returns the node the page is to be moved into by the placement policy	*/
+
+void numaPutFrame(int frame);
+/* adds the empty frame to the empty frames of its node						*/
+
+int numaTakeFrame(unsigned node);
+/* removes and returns an empty frame of the node, else of the nearest node	*/
+/* with an empty frame. Returns NONE if no empty frame exists				*/
+
+void numaAccess(unsigned pid, int frame);
+/* charges the access of the process to the frame as local or remote		*/
+
+unsigned numaSelectMigrations(int hot[], int target[], unsigned max);
+/* selects up to max hot pages accessed remotely in the timer period and	*/
+/* starts the next period. hot[i] is the frame of the page, target[i] the	*/
+/* frame on its home node to exchange it with: an empty frame, which is		*/
+/* removed from the empty frames of the node, or the frame of the page		*/
+/* accessed least. Returns the number of pages selected						*/
+
+void numaGetStatistics(numaStatistics_t* stats);
+/* returns the current statistics											*/
+
+void numaPrintStatistics(void);
+/* prints the local and remote accesses and their ratio per node			*/
+
+#endif  /* __NUMA__ */
@@ -0,0 +1,273 @@
+/* Implementation of the memory limits of the owners of the processes		*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <stdio.h>
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "owner.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in owner.h		*/
+Boolean ownersEnabled = FALSE;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+ownerStatistics_t ownerTable[OWNER_MAX];	// the owners, the root owner first
+unsigned ownerCount = 1;					// entries in use in ownerTable
+unsigned* ownerOfProcess = NULL;			// owner of each process, grows with the process table
+int ownerCharged[MEMORYSIZE];				// owner each frame is charged to, NONE if empty
+int ownerReclaimHand = 0;					// start of the search for ties
+int ownerSpareHand = 0;
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+unsigned findOwner(unsigned id);
+/* returns the index of the owner with the given ownerID, OWNER_MAX if none	*/
+
+Boolean isDescendant(unsigned owner, unsigned ancestor);
+/* predicate: the owner is the ancestor or below it in the tree				*/
+
+int selectCharged(const Boolean eligible[], const unsigned char referenced[], int* hand);
+/* returns the frame with the smallest aging counter of those charged to	*/
+/* the eligible owners, ties are resolved from the hand, which is updated.	*/
+/* Returns NONE if no frame is charged to them								*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+void ownerInit(void)
+{
+	registerProcessArray((void**)&ownerOfProcess, sizeof(unsigned));
+	for (int frame = 0; frame < MEMORYSIZE; frame++)
+		ownerCharged[frame] = NONE;
+	for (unsigned owner = 0; owner < ownerCount; owner++)
+	{
+		ownerTable[owner].usage = ownerTable[owner].maxUsage = 0;
+		ownerTable[owner].charges = ownerTable[owner].limitReclaims = ownerTable[owner].spared = 0;
+	}
+	ownerReclaimHand = ownerSpareHand = 0;
+}
+
+Boolean setOwnerLimits(const char* spec)
+{
+	unsigned id, limit, reservation, parentId, owner, parent;
+	int length;
+	while (*spec != '\0')
+	{
+		if (sscanf(spec, "%u=%u%n", &id, &limit, &length) != 2) return FALSE;
+		spec += length;
+		reservation = 0;
+		parentId = ownerTable[OWNER_ROOT].id;
+		// the reservation may be left out before the parent, e.g. 3=16::1
+		if ((*spec == ':') && (sscanf(spec + 1, "%u%n", &reservation, &length) == 1))
+			spec += length + 1;
+		else if (*spec == ':')
+			spec++;
+		if ((*spec == ':') && (sscanf(spec + 1, "%u%n", &parentId, &length) == 1))
+			spec += length + 1;
+		if (*spec == ',')
+			spec++;
+		else if (*spec != '\0')
+			return FALSE;
+		if (!ownerDefine(id) || !ownerDefine(parentId)) return FALSE;
+		owner = findOwner(id);
+		parent = findOwner(parentId);
+		// the root has no parent, the others must not become their own ancestor
+		if ((owner == OWNER_ROOT) ? (parent != OWNER_ROOT) : isDescendant(parent, owner))
+			return FALSE;
+		ownerTable[owner].parent = parent;
+		ownerTable[owner].limit = limit;
+		ownerTable[owner].reservation = reservation;
+		if ((limit > 0) || (reservation > 0)) ownersEnabled = TRUE;
+	}
+	return TRUE;
+}
+
+Boolean ownerDefine(unsigned id)
+{
+	if (findOwner(id) != OWNER_MAX) return TRUE;
+	if (ownerCount == OWNER_MAX) return FALSE;
+	memset(&ownerTable[ownerCount], 0, sizeof(ownerStatistics_t));
+	ownerTable[ownerCount].id = id;
+	ownerTable[ownerCount].parent = OWNER_ROOT;
+	ownerCount++;
+	return TRUE;
+}
+
+void ownerProcessStarted(unsigned pid)
+{
+	unsigned owner = OWNER_ROOT;
+	if (ownerDefine(processTable[pid].ownerID))
+		owner = findOwner(processTable[pid].ownerID);
+	else
+		logPid(pid, "OS-ERROR: Too many owners, the process belongs to the root owner");
+	ownerOfProcess[pid] = owner;
+}
+
+void ownerCharge(unsigned pid, int frame)
+{
+	unsigned owner = ownerOfProcess[pid];
+	if (ownerCharged[frame] != NONE) ownerUncharge(frame);
+	ownerCharged[frame] = (int)owner;
+	ownerTable[owner].charges++;
+	// the owner and all its ancestors are charged
+	for (;;)
+	{
+		ownerTable[owner].usage++;
+		if (ownerTable[owner].usage > ownerTable[owner].maxUsage)
+			ownerTable[owner].maxUsage = ownerTable[owner].usage;
+		if (owner == OWNER_ROOT) break;
+		owner = ownerTable[owner].parent;
+	}
+}
+
+void ownerUncharge(int frame)
+{
+	unsigned owner;
+	if (ownerCharged[frame] == NONE) return;
+	owner = (unsigned)ownerCharged[frame];
+	ownerCharged[frame] = NONE;
+	for (;;)
+	{
+		ownerTable[owner].usage--;
+		if (owner == OWNER_ROOT) break;
+		owner = ownerTable[owner].parent;
+	}
+}
+
+void ownerFramesExchanged(int a, int b)
+{
+	int owner = ownerCharged[a];
+	ownerCharged[a] = ownerCharged[b];
+	ownerCharged[b] = owner;
+}
+
+unsigned ownerAtLimit(unsigned pid)
+{
+	for (unsigned owner = ownerOfProcess[pid]; ; owner = ownerTable[owner].parent)
+	{
+		if ((ownerTable[owner].limit > 0) && (ownerTable[owner].usage >= ownerTable[owner].limit))
+			return owner;
+		if (owner == OWNER_ROOT) break;
+	}
+	return OWNER_MAX;
+}
+
+int ownerSelectVictim(unsigned owner, const unsigned char referenced[])
+{
+	Boolean eligible[OWNER_MAX];
+	int frame;
+	for (unsigned o = 0; o < ownerCount; o++)
+		eligible[o] = isDescendant(o, owner);
+	frame = selectCharged(eligible, referenced, &ownerReclaimHand);
+	if (frame != NONE) ownerTable[owner].limitReclaims++;
+	return frame;
+}
+
+int ownerSpareReservation(int frame, const unsigned char referenced[])
+{
+	Boolean eligible[OWNER_MAX];	// owners neither within their reservation nor below one that is
+	unsigned owner;
+	int other;
+	if ((frame < 0) || (ownerCharged[frame] == NONE)) return frame;
+	for (unsigned o = 0; o < ownerCount; o++)
+	{
+		eligible[o] = TRUE;
+		for (owner = o; ; owner = ownerTable[owner].parent)
+		{
+			if ((ownerTable[owner].reservation > 0) && (ownerTable[owner].usage <= ownerTable[owner].reservation))
+				eligible[o] = FALSE;
+			if (owner == OWNER_ROOT) break;
+		}
+	}
+	owner = (unsigned)ownerCharged[frame];
+	if (eligible[owner]) return frame;
+	other = selectCharged(eligible, referenced, &ownerSpareHand);
+	if (other == NONE) return frame;		// all resident pages are reserved
+	ownerTable[owner].spared++;
+	return other;
+}
+
+void ownerGetStatistics(ownerStatistics_t stats[], unsigned* count)
+{
+	memcpy(stats, ownerTable, ownerCount * sizeof(ownerStatistics_t));
+	*count = ownerCount;
+}
+
+void ownerLogStatistics(void)
+{
+	if (!logEnabled) return;
+	for (unsigned owner = 0; owner < ownerCount; owner++)
+		printf("%6u : MEM: owner %u usage %u, limit %u, reservation %u, reclaimed %llu, spared %llu\n", systemTime,
+			ownerTable[owner].id, ownerTable[owner].usage, ownerTable[owner].limit, ownerTable[owner].reservation,
+			ownerTable[owner].limitReclaims, ownerTable[owner].spared);
+}
+
+void ownerPrintStatistics(void)
+{
+	ownerStatistics_t s[OWNER_MAX];
+	unsigned count;
+	char label[32];
+	ownerGetStatistics(s, &count);
+	printf("Owners (%u)\n", count);
+	for (unsigned owner = 0; owner < count; owner++)
+	{
+		snprintf(label, sizeof(label), "owner %u parent", s[owner].id);
+		printf("%-28s %15u\n", label, s[s[owner].parent].id);
+		snprintf(label, sizeof(label), "owner %u limit", s[owner].id);
+		printf("%-28s %15u\n", label, s[owner].limit);
+		snprintf(label, sizeof(label), "owner %u reservation", s[owner].id);
+		printf("%-28s %15u\n", label, s[owner].reservation);
+		snprintf(label, sizeof(label), "owner %u max. usage", s[owner].id);
+		printf("%-28s %15u\n", label, s[owner].maxUsage);
+		snprintf(label, sizeof(label), "owner %u frames charged", s[owner].id);
+		printf("%-28s %15llu\n", label, s[owner].charges);
+		snprintf(label, sizeof(label), "owner %u limit reclaims", s[owner].id);
+		printf("%-28s %15llu\n", label, s[owner].limitReclaims);
+		snprintf(label, sizeof(label), "owner %u victims spared", s[owner].id);
+		printf("%-28s %15llu\n", label, s[owner].spared);
+	}
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+unsigned findOwner(unsigned id)
+{
+	for (unsigned owner = 0; owner < ownerCount; owner++)
+		if (ownerTable[owner].id == id) return owner;
+	return OWNER_MAX;
+}
+
+Boolean isDescendant(unsigned owner, unsigned ancestor)
+{
+	for (;;)
+	{
+		if (owner == ancestor) return TRUE;
+		if (owner == OWNER_ROOT) return FALSE;
+		owner = ownerTable[owner].parent;
+	}
+}
+
+int selectCharged(const Boolean eligible[], const unsigned char referenced[], int* hand)
+{
+	agingCounter_t best = AGING_EMPTY, key;
+	int victim = NONE, frame;
+	for (int i = 0; i < MEMORYSIZE; i++)
+	{
+		frame = (*hand + i) % MEMORYSIZE;
+		if ((ownerCharged[frame] == NONE) || !eligible[ownerCharged[frame]]) continue;
+		key = agingGetKey(referenced, frame);
+		if ((victim == NONE) || (key < best))
+		{
+			best = key;
+			victim = frame;
+		}
+	}
+	if (victim != NONE) *hand = (victim + 1) % MEMORYSIZE;
+	return victim;
+}
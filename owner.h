@@ -0,0 +1,97 @@
+/* Include-file defining the memory limits of the owners of the processes	*/
+/* (like the memory controller of Linux cgroups). Each process belongs to	*/
+/* the owner given by an optional fourth column of the process file, a		*/
+/* forked process to the owner of its parent. The owners form a tree below	*/
+/* the root owner 0, which all other processes belong to.					*/
+/* A frame is charged to the owner of the process moving the page in and	*/
+/* to all ancestors of that owner, it is uncharged when it becomes empty.	*/
+/* A frame shared after a fork stays charged to the owner of the first		*/
+/* process.																	*/
+/* limit       : a fault of a process whose owner or an ancestor uses its	*/
+/*               limit of frames evicts a page charged to that owner or		*/
+/*               its descendants instead of taking an empty frame or		*/
+/*               running the replacement algorithm							*/
+/* reservation : the pages charged to an owner using at most its			*/
+/*               reservation are spared by the replacement algorithm if		*/
+/*               pages of owners beyond theirs are resident (soft limit)	*/
+/* The page of an owner to evict is the one with the smallest aging			*/
+/* counter, the counters are updated with all replacement algorithms while	*/
+/* owners are enabled. The owners are enabled as soon as one of them has a	*/
+/* limit or a reservation, an owner column alone only names them.			*/
+/* Simulated on a single CPU only.											*/
+#ifndef __OWNER__
+#define __OWNER__
+
+#include "bs_types.h"
+
+#define OWNER_MAX 64			// owners known at most, the root owner included
+#define OWNER_ROOT 0			// index of the root owner
+
+/* statistics of an owner, for the report at the end of the run and the		*/
+/* log at the timer events													*/
+typedef struct ownerStatistics_struct
+{
+	unsigned id;						// ownerID of the processes
+	unsigned parent;					// index of the parent owner, OWNER_ROOT for the root itself
+	unsigned limit;						// frames the owner and its descendants may use, 0: none
+	unsigned reservation;				// frames spared by the replacement algorithm
+	unsigned usage;						// frames charged to the owner and its descendants
+	unsigned maxUsage;					// largest value of usage
+	unsigned long long charges;			// frames charged
+	unsigned long long limitReclaims;	// pages evicted as the owner was at its limit
+	unsigned long long spared;			// victims of the replacement replaced by another page as
+										// the owner was within its reservation
+} ownerStatistics_t;
+
+extern Boolean ownersEnabled;			// an owner has a limit or a reservation (option -o)
+
+void ownerInit(void);
+/* uncharges all frames and clears the statistics, the limits are kept		*/
+
+Boolean setOwnerLimits(const char* spec);
+/* defines owners from a list of the form									*/
+/* owner=limit[:reservation[:parent]],... e.g. "1=64,2=32:8:1,3=16::1",		*/
+/* a limit of 0 is no limit. Enables the owners if any limit or				*/
+/* reservation is given. Returns FALSE on syntax errors, a loop of parents	*/
+/* or too many owners														*/
+
+Boolean ownerDefine(unsigned id);
+/* makes the owner known, below the root if it is new. Returns FALSE if		*/
+/* too many owners															*/
+
+void ownerProcessStarted(unsigned pid);
+/* assigns the process to the owner given by its ownerID					*/
+
+void ownerCharge(unsigned pid, int frame);
+/* charges the frame to the owner of the process							*/
+
+void ownerUncharge(int frame);
+/* uncharges the frame, if it is charged									*/
+
+void ownerFramesExchanged(int a, int b);
+/* the pages in the frames a and b changed places, also if one is empty		*/
+
+unsigned ownerAtLimit(unsigned pid);
+/* returns the owner of the process or the nearest ancestor using its		*/
+/* limit of frames, OWNER_MAX if none										*/
+
+int ownerSelectVictim(unsigned owner, const unsigned char referenced[]);
+/* returns the frame charged to the owner or its descendants with the		*/
+/* smallest aging counter. Returns NONE if none is charged					*/
+
+int ownerSpareReservation(int frame, const unsigned char referenced[]);
+/* returns the frame to evict instead of the victim of the replacement		*/
+/* algorithm: the frame itself unless it is charged to an owner within its	*/
+/* reservation, else the frame outside of all reservations with the			*/
+/* smallest aging counter, the frame itself if there is none				*/
+
+void ownerGetStatistics(ownerStatistics_t stats[], unsigned* count);
+/* returns the current statistics of all owners and their number			*/
+
+void ownerLogStatistics(void);
+/* writes one log line per owner with its usage and reclaims				*/
+
+void ownerPrintStatistics(void);
+/* prints the usage, limits and reclaims per owner							*/
+
+#endif  /* __OWNER__ */
@@ -0,0 +1,173 @@
+/* Implementation of the classes of the processes and the weighted			*/
+/* page replacement															*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <stdio.h>
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "procclass.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in procclass.h	*/
+unsigned classWeight[CLASS_COUNT] = CLASS_WEIGHTS;
+unsigned classMinResident[CLASS_COUNT] = CLASS_MIN_RESIDENT;
+Boolean classesConfigured = FALSE;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+extern frameTableEntry_t frameTable[];		// owned by the memory manager
+
+// names of the classes, in the order of processType_t
+const char* processClassNames[] = { "os", "interactive", "batch", "background", "foreground" };
+
+classStatistics_t classStats[CLASS_COUNT];
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+void classInit(void)
+{
+	memset(classStats, 0, sizeof(classStats));
+	checkpointRegister("class.statistics", classStats, sizeof(classStats), FALSE);
+}
+
+Boolean selectProcessClass(const char* name, processType_t* type)
+{
+	for (unsigned i = 0; i < CLASS_COUNT; i++)
+		if (strcmp(name, processClassNames[i]) == 0)
+		{
+			*type = (processType_t)i;
+			classesConfigured = TRUE;
+			return TRUE;
+		}
+	return FALSE;
+}
+
+const char* getProcessClassName(processType_t type)
+{
+	return processClassNames[type];
+}
+
+Boolean setClassWeights(const char* spec)
+{
+	char name[16];
+	unsigned weight, minimum;
+	int length;
+	processType_t type;
+	while (*spec != '\0')
+	{
+		if ((sscanf(spec, "%15[^=]=%u%n", name, &weight, &length) != 2)
+			|| !selectProcessClass(name, &type) || (weight == 0))
+			return FALSE;
+		spec += length;
+		minimum = classMinResident[type];	// kept if not given
+		if ((*spec == ':') && (sscanf(spec + 1, "%u%n", &minimum, &length) == 1))
+			spec += length + 1;
+		if (*spec == ',')
+			spec++;
+		else if (*spec != '\0')
+			return FALSE;
+		classWeight[type] = weight;
+		classMinResident[type] = minimum;
+	}
+	return TRUE;
+}
+
+int classSelectVictim(const unsigned char referenced[], int first, int last, int* hand)
+{
+	unsigned long long best = ULLONG_MAX, bestSpared = ULLONG_MAX, score;
+	int victim = NONE, spared = NONE, frame;
+	unsigned pid;
+	processType_t type;
+	if ((*hand < first) || (*hand >= last)) *hand = first;
+	// the first frame with the smallest score from the hand on, ties are
+	// resolved round robin like with aging
+	for (int i = first; i < last; i++)
+	{
+		frame = *hand + i - first;
+		if (frame >= last) frame -= last - first;
+		pid = frameTable[frame].pid;
+		if (pid == NOPROCESS) continue;
+		type = processTable[pid].type;
+		score = ((unsigned long long)agingGetKey(referenced, frame) + 1) * classWeight[type];
+		if (processTable[pid].residentCount <= classMinResident[type])
+		{	// protected: only evicted if all other pages are protected as well
+			if (score < bestSpared)
+			{
+				bestSpared = score;
+				spared = frame;
+			}
+		}
+		else if (score < best)
+		{
+			best = score;
+			victim = frame;
+		}
+	}
+	if (victim == NONE) victim = spared;
+	if (victim != NONE) *hand = (victim + 1 < last) ? victim + 1 : first;
+	return victim;
+}
+
+void classAccessed(unsigned pid, unsigned count)
+{
+	classStats[processTable[pid].type].accesses += count;
+}
+
+void classFault(unsigned pid)
+{
+	classStats[processTable[pid].type].faults++;
+}
+
+void classEvicted(unsigned pid)
+{
+	classStats[processTable[pid].type].evictions++;
+}
+
+void classFaultLatency(unsigned pid, unsigned time)
+{
+	classStats[processTable[pid].type].faultLatency += time;
+}
+
+void classReleased(unsigned pid)
+{
+	classStats[processTable[pid].type].processes++;
+}
+
+void classGetStatistics(classStatistics_t stats[CLASS_COUNT])
+{
+	// classStats counts the released processes, the others are in the table
+	memcpy(stats, classStats, sizeof(classStats));
+	for (unsigned index = 1; index < processCount; index++)
+		if (processTable[index].valid) stats[processTable[index].type].processes++;
+}
+
+void classPrintStatistics(void)
+{
+	classStatistics_t s[CLASS_COUNT];
+	char label[32];
+	classGetStatistics(s);
+	printf("Process classes\n");
+	for (unsigned i = 0; i < CLASS_COUNT; i++)
+	{
+		if (s[i].processes == 0) continue;
+		snprintf(label, sizeof(label), "%s processes", processClassNames[i]);
+		printf("%-28s %15u\n", label, s[i].processes);
+		snprintf(label, sizeof(label), "%s weight", processClassNames[i]);
+		printf("%-28s %15u\n", label, classWeight[i]);
+		snprintf(label, sizeof(label), "%s protected pages", processClassNames[i]);
+		printf("%-28s %15u\n", label, classMinResident[i]);
+		snprintf(label, sizeof(label), "%s page faults", processClassNames[i]);
+		printf("%-28s %15llu\n", label, s[i].faults);
+		snprintf(label, sizeof(label), "%s fault rate", processClassNames[i]);
+		printf("%-28s %14.1f%%\n", label, (s[i].accesses > 0) ? 100.0 * s[i].faults / s[i].accesses : 0.0);
+		snprintf(label, sizeof(label), "%s evictions", processClassNames[i]);
+		printf("%-28s %15llu\n", label, s[i].evictions);
+		// the processes only wait for their pages with blocking page faults
+		snprintf(label, sizeof(label), "%s fault latency", processClassNames[i]);
+		printf("%-28s %15.1f\n", label, (s[i].faults > 0) ? (double)s[i].faultLatency / s[i].faults : 0.0);
+	}
+}
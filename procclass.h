@@ -0,0 +1,77 @@
+/* Include-file defining the classes of the processes for the weighted		*/
+/* page replacement. The class of a process is its processType_t, given by	*/
+/* an optional third column of the process file, foreground by default.		*/
+/* Each class has a weight and a protected minimum resident set:			*/
+/* The weighted replacement evicts the page with the smallest product of	*/
+/* (aging counter + 1) and the weight of the class of its process, i.e. a	*/
+/* page of a class with twice the weight must have been used half as		*/
+/* recently to be evicted first. The pages of a process with no more than	*/
+/* the minimum resident set of its class are only evicted if no other		*/
+/* page is left.															*/
+/* The faults and the time the processes of each class waited for them are	*/
+/* counted with all replacement algorithms, on a single CPU only.			*/
+#ifndef __PROCCLASS__
+#define __PROCCLASS__
+
+#include "bs_types.h"
+
+#define CLASS_COUNT (foreground + 1)	// number of values of processType_t
+
+/* statistics of a class, for the report at the end of the run				*/
+typedef struct classStatistics_struct
+{
+	unsigned processes;					// processes of the class in the process table or released
+	unsigned long long accesses;		// memory accesses of its processes
+	unsigned long long faults;			// page faults of its processes
+	unsigned long long evictions;		// pages of its processes evicted
+	unsigned long long faultLatency;	// time its processes waited for pages read from the
+										// disk or decompressed, with blocking page faults
+} classStatistics_t;
+
+extern unsigned classWeight[CLASS_COUNT];		// weight of the pages of each class
+extern unsigned classMinResident[CLASS_COUNT];	// protected resident pages of each process
+extern Boolean classesConfigured;				// types in the process file or weights given
+
+void classInit(void);
+/* clears the statistics, the weights are kept								*/
+
+Boolean selectProcessClass(const char* name, processType_t* type);
+/* returns the class of the given name, e.g. "interactive", in *type		*/
+/* Returns FALSE for an unknown name										*/
+
+const char* getProcessClassName(processType_t type);
+/* returns the name of the class											*/
+
+Boolean setClassWeights(const char* spec);
+/* sets weights and minimum resident sets from a list of the form			*/
+/* class=weight[:minimum],... e.g. "background=1,interactive=8:16"			*/
+/* Returns FALSE on syntax errors, unknown classes or a weight of zero		*/
+
+int classSelectVictim(const unsigned char referenced[], int first, int last, int* hand);
+/* returns the occupied frame of first..last-1 with the smallest weighted	*/
+/* aging counter, sparing the minimum resident sets if possible. Ties are	*/
+/* resolved from the given hand, which is updated. Returns NONE if all		*/
+/* frames are empty															*/
+
+void classAccessed(unsigned pid, unsigned count);
+/* the process made count memory accesses									*/
+
+void classFault(unsigned pid);
+/* the process had a page fault												*/
+
+void classEvicted(unsigned pid);
+/* a page of the process was evicted										*/
+
+void classFaultLatency(unsigned pid, unsigned time);
+/* the process waited the given time for a page								*/
+
+void classReleased(unsigned pid);
+/* the process leaves the process table, it is still counted in its class	*/
+
+void classGetStatistics(classStatistics_t stats[CLASS_COUNT]);
+/* returns the current statistics of all classes							*/
+
+void classPrintStatistics(void);
+/* prints the weights, fault rates and average fault latency per class		*/
+
+#endif  /* __PROCCLASS__ */
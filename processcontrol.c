@@ -4,13 +4,49 @@
 
 /* ----------------------------------------------------------------	*/
 /* Include required external definitions */
+#include <string.h>
 #include "processcontrol.h"
 
 /* ----------------------------------------------------------------	*/
 /* Declare global variables according to definition in globals.h	*/
-PCB_t processTable[MAX_PROCESSES + 1]; 	// the process table
+PCB_t* processTable = NULL; 	// the process table
+unsigned processTableSize = 0;
+unsigned processCount = 0;
+unsigned* liveProcessList = NULL;
+unsigned liveProcessCount = 0;
+unsigned* freeProcessSlots = NULL;
+unsigned freeProcessCount = 0;
+
 /* ----------------------------------------------------------------	*/
 /* Declarations of global variables visible only in this file 		*/
+
+// array of another module growing with the process table
+typedef struct processArray_struct
+{
+	void** array;
+	size_t elementSize;
+} processArray_t;
+
+unsigned* processHash = NULL;		// indices of the processes by the hash of their PID, 0: empty
+unsigned processHashBits = 0;		// the hash has 2^processHashBits entries
+processArray_t processArrays[PROCESS_ARRAYS_MAX];
+unsigned processArrayCount = 0;
+smpLock_t liveProcessLock;			// serialises the list of the live processes with several CPUs
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+Boolean growProcessTable(unsigned size);
+/* enlarges the process table and all registered arrays to the given number	*/
+/* of entries. All arrays are allocated before any of them is replaced, so	*/
+/* they keep the old size if out of memory, then FALSE is returned			*/
+
+Boolean growProcessHash(void);
+/* doubles the size of the hash and enters all processes again				*/
+
+unsigned hashPid(bsPid_t pid);
+/* returns the first entry of the hash to look for the PID					*/
+
 void resetPCB (PCB_t *pcb)
 /* initilises a PCB with data representing an empty process entry	*/
 {
@@ -27,6 +63,10 @@ void resetPCB (PCB_t *pcb)
 						// placeholder, but is not initialised
 	pcb->size = 0;		// process has no physical memory allocated
 	pcb->pageTable = NULL;
+	pcb->residentPages = NONE;
+	pcb->residentCount = 0;
+	pcb->movedOutPages = NONE;
+	pcb->liveIndex = NONE;
 }
 
 /* ---------------------------------------------------------------- */
@@ -36,9 +76,179 @@ void resetPCB (PCB_t *pcb)
 Boolean initProcessTable(void)
 /* allocates the process table and initialises it with empty entries		*/
 {
-	for (int i = 0; i <= MAX_PROCESSES; i++)
+	if ((processTableSize == 0) && !growProcessTable(MAX_PROCESSES + 1))
+		return FALSE;
+	for (unsigned i = 0; i < processTableSize; i++)
 		resetPCB(&processTable[i]);
+	if (processHash != NULL)
+		memset(processHash, 0, sizeof(unsigned) << processHashBits);
+	processCount = 1;					// index 0 is NOPROCESS
+	liveProcessCount = 0;
+	freeProcessCount = 0;
+	smpLockInit(&liveProcessLock);
 	return TRUE;
 		
 }
 
+unsigned createProcess(bsPid_t pid)
+{
+	unsigned index = findProcess(pid);
+	unsigned h;
+	if ((index != NOPROCESS) || (pid == NOPROCESS)) return index;
+	// the hash is kept at most half full
+	if ((2 * processCount >= (1u << processHashBits)) && !growProcessHash())
+		return NOPROCESS;
+	if (freeProcessCount > 0)
+		index = freeProcessSlots[--freeProcessCount];	// entry of an ended process
+	else
+	{
+		if ((processCount == processTableSize) && !growProcessTable(2 * processTableSize))
+			return NOPROCESS;
+		index = processCount++;
+	}
+	processTable[index].pid = pid;
+	for (h = hashPid(pid); processHash[h] != 0; h = (h + 1) & ((1u << processHashBits) - 1));
+	processHash[h] = index;
+	return index;
+}
+
+unsigned findProcess(bsPid_t pid)
+{
+	if (processHash == NULL) return NOPROCESS;
+	for (unsigned h = hashPid(pid); processHash[h] != 0; h = (h + 1) & ((1u << processHashBits) - 1))
+		if (processTable[processHash[h]].pid == pid) return processHash[h];
+	return NOPROCESS;
+}
+
+void releaseProcess(unsigned index)
+{
+	unsigned mask = (1u << processHashBits) - 1;
+	unsigned h, next, home;
+	for (h = hashPid(processTable[index].pid); processHash[h] != index; h = (h + 1) & mask);
+	// backward shift deletion: the entries behind the hole that may be found
+	// through it move into it, so no search stops early at the hole
+	for (next = (h + 1) & mask; processHash[next] != 0; next = (next + 1) & mask)
+	{
+		home = hashPid(processTable[processHash[next]].pid);
+		if (((next - home) & mask) >= ((next - h) & mask))
+		{
+			processHash[h] = processHash[next];
+			h = next;
+		}
+	}
+	processHash[h] = 0;
+	resetPCB(&processTable[index]);
+	freeProcessSlots[freeProcessCount++] = index;
+}
+
+void processStarted(unsigned index)
+{
+	if (smpCpuCount > 1) smpLock(&liveProcessLock);
+	if (processTable[index].liveIndex == NONE)
+	{
+		processTable[index].liveIndex = (int)liveProcessCount;
+		liveProcessList[liveProcessCount++] = index;
+	}
+	if (smpCpuCount > 1) smpUnlock(&liveProcessLock);
+}
+
+void processEnded(unsigned index)
+{
+	int live;
+	if (smpCpuCount > 1) smpLock(&liveProcessLock);
+	live = processTable[index].liveIndex;
+	if (live != NONE)
+	{	// the last process of the list takes the place of the ended one
+		liveProcessList[live] = liveProcessList[--liveProcessCount];
+		processTable[liveProcessList[live]].liveIndex = live;
+		processTable[index].liveIndex = NONE;
+	}
+	if (smpCpuCount > 1) smpUnlock(&liveProcessLock);
+}
+
+Boolean registerProcessArray(void** array, size_t elementSize)
+{
+	unsigned i;
+	void* p;
+	for (i = 0; (i < processArrayCount) && (processArrays[i].array != array); i++);
+	if ((i == processArrayCount) && (processArrayCount == PROCESS_ARRAYS_MAX)) return FALSE;
+	p = realloc(*array, processTableSize * elementSize);
+	if (p == NULL) return FALSE;
+	memset(p, 0, processTableSize * elementSize);
+	*array = p;
+	processArrays[i].array = array;
+	processArrays[i].elementSize = elementSize;
+	if (i == processArrayCount) processArrayCount++;
+	return TRUE;
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+Boolean growProcessTable(unsigned size)
+{
+	PCB_t* table = malloc(size * sizeof(PCB_t));
+	unsigned* live = malloc(size * sizeof(unsigned));
+	unsigned* slots = malloc(size * sizeof(unsigned));
+	void* grown[PROCESS_ARRAYS_MAX];
+	unsigned i;
+	size_t old;
+	for (i = 0; i < processArrayCount; i++)
+		if ((grown[i] = malloc(size * processArrays[i].elementSize)) == NULL) break;
+	if ((table == NULL) || (live == NULL) || (slots == NULL) || (i < processArrayCount))
+	{	// nothing is replaced, the table keeps its size
+		while (i > 0) free(grown[--i]);
+		free(table);
+		free(live);
+		free(slots);
+		return FALSE;
+	}
+	if (processTableSize > 0)
+	{
+		memcpy(table, processTable, processTableSize * sizeof(PCB_t));
+		memcpy(live, liveProcessList, processTableSize * sizeof(unsigned));
+		memcpy(slots, freeProcessSlots, processTableSize * sizeof(unsigned));
+	}
+	for (i = processTableSize; i < size; i++)
+		resetPCB(&table[i]);
+	for (i = 0; i < processArrayCount; i++)
+	{
+		old = processTableSize * processArrays[i].elementSize;
+		if (old > 0) memcpy(grown[i], *processArrays[i].array, old);
+		memset((char*)grown[i] + old, 0, size * processArrays[i].elementSize - old);
+		free(*processArrays[i].array);
+		*processArrays[i].array = grown[i];
+	}
+	free(processTable);
+	free(liveProcessList);
+	free(freeProcessSlots);
+	processTable = table;
+	liveProcessList = live;
+	freeProcessSlots = slots;
+	processTableSize = size;
+	return TRUE;
+}
+
+Boolean growProcessHash(void)
+{
+	unsigned bits = (processHashBits == 0) ? 8 : processHashBits + 1;
+	unsigned* hash = calloc((size_t)1 << bits, sizeof(unsigned));
+	unsigned h;
+	if (hash == NULL) return FALSE;
+	free(processHash);
+	processHash = hash;
+	processHashBits = bits;
+	for (unsigned index = 1; index < processCount; index++)
+	{
+		if (processTable[index].pid == NOPROCESS) continue;	// free entry
+		for (h = hashPid(processTable[index].pid); processHash[h] != 0; h = (h + 1) & ((1u << bits) - 1));
+		processHash[h] = index;
+	}
+	return TRUE;
+}
+
+unsigned hashPid(bsPid_t pid)
+{
+	// multiplicative hashing, the PIDs of a file are often consecutive
+	return (unsigned)((pid * 2654435769u) >> (32 - processHashBits));
+}
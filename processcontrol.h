@@ -1,14 +1,55 @@
 /* header-file defining the interface of the process contol					*/
 /* the process control contains all functions required to administrate the 	*/
 /* simulated processes 														*/
+/* The process table is a dense array of PCBs that grows with the number	*/
+/* of processes. The OS refers to a process by the index of its PCB, the	*/
+/* PID given in the process and stimulus files is kept in the PCB and		*/
+/* found by an open addressing hash, so that the PIDs may be spread over	*/
+/* the whole range of bsPid_t. Index 0 is NOPROCESS. The entries of			*/
+/* released processes are kept in a free list and reused first.				*/
+/* The processes holding a page table are kept in the list of the live		*/
+/* processes, sweeps over the processes walk this list instead of the		*/
+/* whole table.																*/
 
 #ifndef __PROCESSCONTROL__
 #define __PROCESSCONTROL__
 
+#include <stddef.h>
 #include "bs_types.h"
 #include "global.h"
 
+#define PROCESS_ARRAYS_MAX 16		// arrays of the other modules growing with the table
+
+extern unsigned processTableSize;	// entries allocated in the process table
+extern unsigned processCount;		// entries in use, index 0 included
+extern unsigned* liveProcessList;	// indices of the live processes, in no particular order
+extern unsigned liveProcessCount;	// number of entries in liveProcessList
+
 Boolean initProcessTable(void);		// const unsigned int maxPID
 /* allocates the process table and initialises it with empty entries		*/
 
+unsigned createProcess(bsPid_t pid);
+/* returns the index of the process with the given PID, a new entry is		*/
+/* added if there is none yet. Returns NOPROCESS for the PID NOPROCESS or	*/
+/* if out of memory															*/
+
+unsigned findProcess(bsPid_t pid);
+/* returns the index of the process with the given PID, NOPROCESS if none	*/
+
+void releaseProcess(unsigned index);
+/* removes the process from the table, its entry is reused by the next		*/
+/* process created. The entries of the registered arrays are not cleared,	*/
+/* the modules set them up when the process starts							*/
+
+void processStarted(unsigned index);
+/* adds the process to the list of the live processes						*/
+
+void processEnded(unsigned index);
+/* removes the process from the list of the live processes					*/
+
+Boolean registerProcessArray(void** array, size_t elementSize);
+/* allocates an array with one element of the given size per entry of the	*/
+/* process table, all set to zero, and enlarges it with the table. May be	*/
+/* called again to clear the array. Returns FALSE if out of memory			*/
+
 #endif /* __PROCESSCONTROL__ */
@@ -0,0 +1,128 @@
+/* Implementation of the profile of the phases of coreLoop()				*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "profile.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in profile.h	*/
+Boolean profileEnabled = PROFILE_ENABLED;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+const char* profilePhaseNames[PROFILE_PHASES] = { "other", "parse", "timer", "access", "replacement", "logging" };
+const int profileColumnWidth[HOST_COUNTERS] = { 11, 12, 10, 10 };	// of the counters in the report
+profileStatistics_t profileStats[PROFILE_PHASES];
+profilePhase_t profileStack[PROFILE_DEPTH];	// phases entered, the last one is counted
+unsigned profileDepth = 0;					// 0: outside of coreLoop(), nothing is counted
+int profileAvailable[HOST_COUNTERS];		// counters opened, the others read 0
+unsigned profileCounterCount = 0;
+unsigned long long profileLastTime;			// reading at the last bracket
+unsigned long long profileLastCounters[HOST_COUNTERS];
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+void countPhase(void);
+/* reads the clock and the counters and adds the difference to the last		*/
+/* reading to the phase on top of the stack									*/
+
+void printProfileCounter(unsigned counter, const profileStatistics_t* stats, unsigned long long events);
+/* prints a counter of the phase per event, "-" if it is unavailable		*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+void profileOpen(void)
+{
+	memset(profileStats, 0, sizeof(profileStats));
+	profileDepth = 0;
+	if (!profileEnabled) return;
+	profileCounterCount = (unsigned)hostCountersOpen(profileAvailable);
+	profileLastTime = hostNanoseconds();
+	hostCountersRead(profileLastCounters);
+}
+
+void profileEnter(profilePhase_t phase)
+{
+	countPhase();
+	if (profileDepth == PROFILE_DEPTH) return;	// nested too deep, counted for the outer phase
+	profileStack[profileDepth++] = phase;
+	profileStats[phase].calls++;
+}
+
+void profileLeave(void)
+{
+	countPhase();
+	if (profileDepth > 0) profileDepth--;
+}
+
+void profilePrintStatistics(void)
+{
+	unsigned long long totalTime = 0;
+	unsigned long long events = profileStats[profileParse].calls;	// each call reads one event
+	const profileStatistics_t* stats;
+	if (events == 0) return;
+	for (unsigned phase = 0; phase < PROFILE_PHASES; phase++)
+		totalTime += profileStats[phase].nanoseconds;
+	printf("Profile of coreLoop() per stimulus event (%llu events)\n", events);
+	if (profileCounterCount < HOST_COUNTERS)
+		printf("%-28s %s\n", "counters unavailable", hostCountersError());
+	printf("%-12s %11s %8s %11s %12s %6s %10s %10s %7s\n", "phase", "calls", "ns", "cycles", "instructions",
+		"IPC", "LLC-misses", "br-misses", "time");
+	for (unsigned phase = 0; phase < PROFILE_PHASES; phase++)
+	{
+		stats = &profileStats[phase];
+		if ((stats->calls == 0) && (stats->nanoseconds == 0)) continue;
+		printf("%-12s %11llu %8.1f", profilePhaseNames[phase], stats->calls, (double)stats->nanoseconds / events);
+		printProfileCounter(0, stats, events);
+		printProfileCounter(1, stats, events);
+		if (profileAvailable[0] && profileAvailable[1] && (stats->counters[0] > 0))
+			printf(" %6.2f", (double)stats->counters[1] / stats->counters[0]);
+		else
+			printf(" %6s", "-");
+		printProfileCounter(2, stats, events);
+		printProfileCounter(3, stats, events);
+		printf(" %6.1f%%\n", (totalTime > 0) ? 100.0 * stats->nanoseconds / totalTime : 0.0);
+	}
+}
+
+void profileClose(void)
+{
+	hostCountersClose();
+	profileCounterCount = 0;
+	profileDepth = 0;
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+void countPhase(void)
+{
+	unsigned long long time = hostNanoseconds();
+	unsigned long long counters[HOST_COUNTERS];
+	profileStatistics_t* stats = &profileStats[profileStack[(profileDepth > 0) ? profileDepth - 1 : 0]];
+	if (profileCounterCount > 0) hostCountersRead(counters);
+	if (profileDepth > 0)
+	{
+		stats->nanoseconds += time - profileLastTime;
+		if (profileCounterCount > 0)
+			for (unsigned i = 0; i < HOST_COUNTERS; i++)
+				if (counters[i] > profileLastCounters[i])	// the scaling may shrink a multiplexed count
+					stats->counters[i] += counters[i] - profileLastCounters[i];
+	}
+	profileLastTime = time;
+	if (profileCounterCount > 0) memcpy(profileLastCounters, counters, sizeof(counters));
+}
+
+void printProfileCounter(unsigned counter, const profileStatistics_t* stats, unsigned long long events)
+{
+	if (profileAvailable[counter])
+		printf(" %*.1f", profileColumnWidth[counter], (double)stats->counters[counter] / events);
+	else
+		printf(" %*s", profileColumnWidth[counter], "-");
+}
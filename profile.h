@@ -0,0 +1,61 @@
+/* Include-file defining the profile of the phases of coreLoop(), to tune	*/
+/* the simulator itself. The phases are bracketed by profileEnter() and		*/
+/* profileLeave(): reading the stimulus, the timer events, the memory		*/
+/* accesses, the page replacement within them and the console log. Each		*/
+/* bracket reads the wall-clock time and the hardware counters of the CPU	*/
+/* (cycles, instructions, last level cache misses and branch misses, see	*/
+/* hostCountersOpen()), the difference to the last reading is added to the	*/
+/* phase on top of a stack, so that the replacement is not counted twice	*/
+/* in the accesses. The rest of the loop, e.g. starting and ending			*/
+/* processes, is counted as "other". The report divides the counts of all	*/
+/* phases by the number of stimulus events, the IPC shows whether a phase	*/
+/* stalls, e.g. on cache misses.											*/
+/* Without hardware counters, e.g. in a virtual machine or with a			*/
+/* restrictive perf_event_paranoid, only the time is reported. A bracket	*/
+/* costs a system call, the small phases include a part of it. The console	*/
+/* log is only bracketed if it is enabled.									*/
+#ifndef __PROFILE__
+#define __PROFILE__
+
+#include "bs_types.h"
+#include "host.h"
+
+#define PROFILE_DEPTH 8					// phases nested at most
+
+/* the phases of coreLoop(), profileOther while none is entered				*/
+typedef enum
+{
+	profileOther, profileParse, profileTimer, profileAccess, profileReplacement, profileLogging
+} profilePhase_t;
+
+#define PROFILE_PHASES (profileLogging + 1)	// number of values of profilePhase_t
+
+/* counts of one phase, for the report at the end of the run				*/
+typedef struct profileStatistics_struct
+{
+	unsigned long long calls;			// times the phase was entered
+	unsigned long long nanoseconds;		// wall-clock time spent in it
+	unsigned long long counters[HOST_COUNTERS];	// see hostCountersOpen()
+} profileStatistics_t;
+
+extern Boolean profileEnabled;			// profile coreLoop(), printed at the end
+
+void profileOpen(void);
+/* opens the hardware counters and clears the statistics if profileEnabled	*/
+/* A missing counter is reported at the end, the profile then shows the		*/
+/* time only																*/
+
+void profileEnter(profilePhase_t phase);
+/* starts the phase, the time since the last bracket is counted for the		*/
+/* phase entered before														*/
+
+void profileLeave(void);
+/* ends the phase entered last												*/
+
+void profilePrintStatistics(void);
+/* prints the calls of each phase with the time and the counts per event	*/
+
+void profileClose(void);
+/* closes the hardware counters												*/
+
+#endif  /* __PROFILE__ */
@@ -0,0 +1,139 @@
+/* Implementation of the short-term scheduler of the generated workloads	*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <stdio.h>
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "scheduler.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in scheduler.h	*/
+schedulingPolicy_t schedulingPolicy = SCHEDULING_POLICY;
+unsigned schedulingQuantum = SCHEDULING_QUANTUM;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+const char* schedulingPolicyNames[] = { "rr", "priority" };
+const unsigned classPriority[CLASS_COUNT] = SCHEDULING_PRIORITIES;
+unsigned* readyNext = NULL;				// next process in the same ready queue, grows with the process table
+unsigned readyHead[SCHEDULING_LEVELS];	// first and last process of each ready queue, NOPROCESS if empty
+unsigned readyTail[SCHEDULING_LEVELS];
+schedulingStatistics_t schedStats;
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+unsigned priorityOf(unsigned pid);
+/* returns the ready queue of the process									*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+Boolean setSchedulingPolicy(const char* spec)
+{
+	size_t length = strcspn(spec, ",");
+	unsigned quantum = schedulingQuantum;
+	unsigned policy;
+	for (policy = 0; policy < sizeof(schedulingPolicyNames) / sizeof(schedulingPolicyNames[0]); policy++)
+		if ((strlen(schedulingPolicyNames[policy]) == length) && (strncmp(spec, schedulingPolicyNames[policy], length) == 0))
+			break;
+	if (policy == sizeof(schedulingPolicyNames) / sizeof(schedulingPolicyNames[0])) return FALSE;
+	if ((spec[length] == ',') && ((sscanf(spec + length + 1, "%u", &quantum) != 1) || (quantum == 0)))
+		return FALSE;
+	schedulingPolicy = (schedulingPolicy_t)policy;
+	schedulingQuantum = quantum;
+	return TRUE;
+}
+
+const char* getSchedulingPolicyName(schedulingPolicy_t policy)
+{
+	return schedulingPolicyNames[policy];
+}
+
+void schedInit(void)
+{
+	registerProcessArray((void**)&readyNext, sizeof(unsigned));
+	for (unsigned level = 0; level < SCHEDULING_LEVELS; level++)
+		readyHead[level] = readyTail[level] = NOPROCESS;
+	memset(&schedStats, 0, sizeof(schedStats));
+}
+
+void schedReady(unsigned pid)
+{
+	unsigned level = priorityOf(pid);
+	readyNext[pid] = NOPROCESS;
+	if (readyHead[level] == NOPROCESS)
+		readyHead[level] = pid;
+	else
+		readyNext[readyTail[level]] = pid;
+	readyTail[level] = pid;
+}
+
+unsigned schedNext(void)
+{
+	unsigned pid;
+	for (unsigned level = 0; level < SCHEDULING_LEVELS; level++)
+	{
+		pid = readyHead[level];
+		if (pid == NOPROCESS) continue;
+		readyHead[level] = readyNext[pid];
+		if (readyHead[level] == NOPROCESS) readyTail[level] = NOPROCESS;
+		schedStats.dispatches++;
+		return pid;
+	}
+	return NOPROCESS;
+}
+
+void schedLeave(unsigned pid, schedulingEvent_t event, unsigned used)
+{
+	processTable[pid].usedCPU += used;
+	schedStats.busyTime += used;
+	schedStats.events[event]++;
+	if (event == completed)
+	{
+		processTable[pid].duration = systemTime - processTable[pid].start;
+		schedStats.turnaround += processTable[pid].duration;
+		schedStats.completed++;
+	}
+	logPidSchedulingEvent(pid, event, used);
+}
+
+void schedIdle(unsigned time)
+{
+	schedStats.idleTime += time;
+}
+
+void schedGetStatistics(schedulingStatistics_t* stats)
+{
+	*stats = schedStats;
+}
+
+void schedPrintStatistics(void)
+{
+	schedulingStatistics_t s;
+	schedGetStatistics(&s);
+	printf("Scheduler (%s, quantum %u)\n", getSchedulingPolicyName(schedulingPolicy), schedulingQuantum);
+	printf("%-28s %15llu\n", "processes completed", s.completed);
+	printf("%-28s %15llu\n", "dispatches", s.dispatches);
+	printf("%-28s %15llu\n", "quantum over", s.events[quantumOver]);
+	printf("%-28s %15llu\n", "blocked on page faults", s.events[io]);
+	printf("%-28s %15llu\n", "CPU busy time", s.busyTime);
+	printf("%-28s %15llu\n", "CPU idle time", s.idleTime);
+	printf("%-28s %14.1f%%\n", "CPU utilisation",
+		(s.busyTime + s.idleTime > 0) ? 100.0 * s.busyTime / (s.busyTime + s.idleTime) : 0.0);
+	printf("%-28s %15.1f\n", "avg. CPU per process", (s.completed > 0) ? (double)s.busyTime / s.completed : 0.0);
+	printf("%-28s %15.1f\n", "avg. turnaround time", (s.completed > 0) ? (double)s.turnaround / s.completed : 0.0);
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+unsigned priorityOf(unsigned pid)
+{
+	if (schedulingPolicy == roundRobinScheduling) return 0;
+	if (classPriority[processTable[pid].type] >= SCHEDULING_LEVELS) return SCHEDULING_LEVELS - 1;
+	return classPriority[processTable[pid].type];
+}
@@ -0,0 +1,64 @@
+/* Include-file defining the short-term scheduler of the generated workload	*/
+/* (see workload.h and coreLoopScheduled()). The processes able to run		*/
+/* wait in FIFO ready queues, one per priority. The first process of the	*/
+/* highest priority runs next for at most schedulingQuantum accesses, each	*/
+/* of them takes one time unit of the CPU. It leaves the CPU when the		*/
+/* quantum is over (quantumOver), when it blocks on a page fault (io) or	*/
+/* when it ends (completed). The time it ran is accounted in usedCPU of		*/
+/* its PCB.																	*/
+/* roundRobin : one queue for all processes									*/
+/* priority   : the priority of a process is given by its class, see		*/
+/*              SCHEDULING_PRIORITIES, 0 is the highest						*/
+#ifndef __SCHEDULER__
+#define __SCHEDULER__
+
+#include "bs_types.h"
+
+#define SCHEDULING_LEVELS 8		// number of priorities
+
+/* statistics of the scheduler, for the report at the end of the run		*/
+typedef struct schedulingStatistics_struct
+{
+	unsigned long long dispatches;		// processes given the CPU
+	unsigned long long events[3];		// scheduling events, indexed by schedulingEvent_t
+	unsigned long long busyTime;		// time the CPU ran processes
+	unsigned long long idleTime;		// time all processes waited for the disk
+	unsigned long long turnaround;		// sum of the times from start to end of the processes
+	unsigned long long completed;		// processes ended
+} schedulingStatistics_t;
+
+extern schedulingPolicy_t schedulingPolicy;	// selected by SCHEDULING_POLICY or option -S
+extern unsigned schedulingQuantum;			// accesses a process may run at most per dispatch
+
+Boolean setSchedulingPolicy(const char* spec);
+/* sets the policy and the quantum from a string of the form				*/
+/* <policy>[,<quantum>], e.g. "priority,10". Returns FALSE on unknown		*/
+/* policies or syntax errors												*/
+
+const char* getSchedulingPolicyName(schedulingPolicy_t policy);
+/* returns the name of the policy as used on the command line				*/
+
+void schedInit(void);
+/* empties the ready queues and clears the statistics						*/
+
+void schedReady(unsigned pid);
+/* appends the process to the ready queue of its priority					*/
+
+unsigned schedNext(void);
+/* removes the process to run next from the ready queues and returns it,	*/
+/* NOPROCESS if none is ready												*/
+
+void schedLeave(unsigned pid, schedulingEvent_t event, unsigned used);
+/* the process leaves the CPU after it ran used time units, which are		*/
+/* added to its usedCPU														*/
+
+void schedIdle(unsigned time);
+/* the CPU was idle for the given time, as all processes waited				*/
+
+void schedGetStatistics(schedulingStatistics_t* stats);
+/* returns the current statistics											*/
+
+void schedPrintStatistics(void);
+/* prints the dispatches, the scheduling events and the CPU utilisation		*/
+
+#endif  /* __SCHEDULER__ */
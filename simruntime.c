@@ -24,10 +24,17 @@ Boolean stimulusComplete = FALSE;		// stimulus file completely read ?
 Boolean noMoreProcessesAvailable = FALSE;
 Boolean simComplete = FALSE;		// end of OS indicator
 FILE* runFile=NULL;					// the file containing the stimulus informatio
+Boolean sim_compressedStimulus = FALSE;	// the stimulus file is compressed, read by sim_stimulusReader
+stimulusReader_t sim_stimulusReader;	// reader of a compressed stimulus file, see stimulus.h
+char stimulusLine[LINEBUFFER_SIZE + 1];	// the line of the stimulus file read last
+char* pStimulusRest = NULL;			// its actions beyond the event returned, NULL if none
+unsigned stimulusLineTime, stimulusLinePid;	// time and PID of that line, as in the file
 memoryEvent_t currentEvent;			// buffer for the next currently processed event
 memoryEvent_t *pCurrentEvent;		// pointer to next event to process, NULL indicates none available
 unsigned sim_processCount = 0;		// number of processes listed in process.txt
 Boolean sim_randomAccess;			// flag for random access stimulus generation
+char sim_processFileName[FILENAME_LENGTH] = PROCESS_FILENAME;	// may be changed before sim_initSim()
+char sim_runFileName[FILENAME_LENGTH] = RUN_FILENAME;			// may be changed before sim_initSim()
 // list of valid pid, i.e. processes used in the simulation
 sim_pidList_t *sim_pidList = NULL, *sim_pidListTail = NULL;	
 
@@ -47,6 +54,11 @@ FILE* openStimulusFile(FILE *file, const char* filename);
 /* returns the file handle (which is NULL on error)							*/
 /* Data in the file must be read using the function readNextAction()		*/
 
+void mapEventProcesses(memoryEvent_t* pMemoryEvent);
+/* maps the PIDs of the event and of the children of its forks to their		*/
+/* entries of the process table, the actions of an unknown PID become		*/
+/* 'error'																	*/
+
 Boolean lineIsComment(const char* line);
 /* predicat that return TRUE if the given string starts with '//'			*/
 /* and FALSE otherwise */
@@ -66,20 +78,36 @@ unsigned getNthPid(unsigned n);
 int sim_initSim(void)
 /* initialise the simulation, not part of the os					*/
 {
-	char filename[FILENAME_LENGTH] = RUN_FILENAME;
+	char* filename = sim_runFileName;
 	unsigned pid = 0; 
 #pragma warning(push)
 #pragma warning(disable : 6001)		// Avoid warning for uninitialised variable: filename is initialised from constant
 	systemTime = 0;				// reset the system time to zero
 	// open the file with process definitions
-	readProcessFile(PROCESS_FILENAME);
+	readProcessFile(sim_processFileName);
 	if (strlen(filename) > 0)		// stimulus based on a file
 	{	
-		// open the file with stimulus information
-		runFile = openStimulusFile(runFile, filename);
-		if (runFile == NULL) exit(-1);
 		sim_randomAccess = FALSE;
-		logGeneric("Sim: Stimulus file opened");
+		if (sim_compressedStimulus) stimulusReaderClose(&sim_stimulusReader);
+		sim_compressedStimulus = stimulusIsCompressed(filename);
+		if (sim_compressedStimulus)
+		{	// compressed stimulus, decoded block by block
+			if (!stimulusReaderOpen(&sim_stimulusReader, filename))
+			{
+				logGeneric("Error opening compressed stimulus file");
+				exit(-1);
+			}
+			noMoreProcessesAvailable = FALSE;
+			logGeneric("Sim: Compressed stimulus file opened");
+		}
+		else
+		{
+			// open the file with stimulus information
+			runFile = openStimulusFile(runFile, filename);
+			if (runFile == NULL) exit(-1);
+			pStimulusRest = NULL;
+			logGeneric("Sim: Stimulus file opened");
+		}
 	}
 	else						// randon stimulus
 	{
@@ -98,6 +126,7 @@ int sim_initSim(void)
 		sim_memoryMap[i].pid = NOPROCESS;
 		sim_memoryMap[i].page = NONE;
 	}
+	checkpointRegister("sim.memoryMap", sim_memoryMap, sizeof(sim_memoryMap), TRUE);
 
 	srand((unsigned int)time(NULL));
 
@@ -120,6 +149,8 @@ int sim_shutdownSim(void)
 		free(pDelete); 
 		sim_processCount--;
 	} 
+	if (sim_compressedStimulus) stimulusReaderClose(&sim_stimulusReader);
+	sim_compressedStimulus = FALSE;
 	return TRUE;
 }
 
@@ -130,52 +161,66 @@ memoryEvent_t* sim_ReadNextEvent(memoryEvent_t* pMemoryEvent)
 /* return the next sumlation event due for execution.						*/
 /* Or, if no stimulus file was given, the generation of memory access events*/
 /* is based on selection of the pid and a valid page number of that process */
-// TODO : Liste von Ereignissen untersttzen zu einem Zeitpunkt 
+/* A line of the stimulus file may list several actions of the process,		*/
+/* they are returned in one event, MAX_EVENT_ACTIONS at most. The rest of	*/
+/* them form the next events, with the same time and PID					*/
 {
-	char linebuffer[129] = "";		// read buffer for file-input
-	char eventTypeStr[21] = ""; 	// buffers for reading process type-string
+	char *linebuffer = stimulusLine;	// read buffer for file-input
 #pragma warning(push)
 #pragma warning(disable : 6001)		// Avoid warning for uninitialised variable: linebuffer is read from file
 	// array for possible periods to advance the simulation time
 	unsigned simTimeDelta[12] = { 0,0,0,0,5,5,5,10,10,10,15,25 };	// for random stimulus
 	unsigned myRandom,pid;											// for random stimulus
-	int count;					// check number of read characters to avoid warning
-	if (sim_randomAccess == FALSE)				// file-based stimulus
+	if (sim_compressedStimulus)					// compressed stimulus file
+	{
+		if (!stimulusRead(&sim_stimulusReader, pMemoryEvent))
+		{
+			if (sim_stimulusReader.position < sim_stimulusReader.eventCount)
+				logGeneric("Error reading compressed stimulus file");
+			stimulusComplete = TRUE;
+			return NULL;
+		}
+		mapEventProcesses(pMemoryEvent);
+	}
+	else if (sim_randomAccess == FALSE)			// file-based stimulus
 	{
 		if (runFile == NULL) return NULL;		// error: file handle not initialised
-		if (feof(runFile)) {
+		if (pStimulusRest != NULL)
+		{	// the next actions of the line read last
+			pMemoryEvent->time = stimulusLineTime;
+			pMemoryEvent->pid = stimulusLinePid;
+			stimulusParseActions(&pStimulusRest, pMemoryEvent);
+			mapEventProcesses(pMemoryEvent);
+		}
+		else if (feof(runFile)) {
 			fclose(runFile);			// close the file on reaching EOF
+			runFile = NULL;
 			stimulusComplete = TRUE; // file completely processed
 			return NULL;		// error occured (EOF reached)
 		}
 		else
 		{	// read line, skip comment lines
+			linebuffer[0] = '\0';
 			do {
 				if (!feof(runFile))
-					fgets(linebuffer, 128, runFile);
+					fgets(linebuffer, LINEBUFFER_SIZE, runFile);
 			} while ((!feof(runFile)) && (lineIsComment(linebuffer)));
 			if (strcmp(linebuffer, "") == 0) {
 				logGeneric("Error reading process-info file: empty line");
 				return NULL;			// error occured: line is empty
 			}
 			else {
-				// initialise with "error", if parsing of the event is OK, this will be overwritten
-				pMemoryEvent->action.op = error; pMemoryEvent->action.page = 0;
 				// printf("%6u : Sim: Read from File: %s", systemTime, linebuffer);
-				count = sscanf(linebuffer, "%u %u %s", &pMemoryEvent->time, &pMemoryEvent->pid, eventTypeStr);
-				// evaluate string, convert page to integer
-				if (strcmp(eventTypeStr, "S") == 0)
-					pMemoryEvent->action.op = start;
-				else if (strcmp(eventTypeStr, "E") == 0)
-					pMemoryEvent->action.op = end;
-				else
-					if (strlen(eventTypeStr) > 0)
-					{
-						count = sscanf(&eventTypeStr[1], "%i", &pMemoryEvent->action.page);
-						if (eventTypeStr[0] == 'R') pMemoryEvent->action.op = read;
-						else if (eventTypeStr[0] == 'W') pMemoryEvent->action.op = write;
-						else pMemoryEvent->action.op = error;
-					}
+				// evaluate the list of actions, convert pages to integer
+				if (!stimulusParseLine(linebuffer, pMemoryEvent, &pStimulusRest))
+				{	// no valid time and pid: report the error action
+					pMemoryEvent->actionCount = 1;
+					pMemoryEvent->action[0].op = error; pMemoryEvent->action[0].page = 0;
+					return pMemoryEvent;
+				}
+				stimulusLineTime = pMemoryEvent->time;
+				stimulusLinePid = pMemoryEvent->pid;
+				mapEventProcesses(pMemoryEvent);
 			}
 		}
 	}
@@ -187,19 +232,42 @@ memoryEvent_t* sim_ReadNextEvent(memoryEvent_t* pMemoryEvent)
 		myRandom = (rand() % sim_processCount) + 1;
 		pid = getNthPid(myRandom);
 		pMemoryEvent->pid = pid; 
+		pMemoryEvent->actionCount = 1;
 		// select page
-		pMemoryEvent->action.page = rand() % processTable[pid].size; 
+		pMemoryEvent->action[0].page = rand() % processTable[pid].size; 
 		// choose r/w (3:1)
 		myRandom = rand() % 4; 
 		if (myRandom<3)
-			pMemoryEvent->action.op = read; 
+			pMemoryEvent->action[0].op = read; 
 		else 
-			pMemoryEvent->action.op = write;
+			pMemoryEvent->action[0].op = write;
 	}
 	return pMemoryEvent;
 #pragma warning(push)
 }
 
+long sim_StimulusOffset(void)
+/* returns the position of the next line in the stimulus file, the number	*/
+/* of the next event in a compressed one									*/
+{
+	if (sim_compressedStimulus) return (long)sim_stimulusReader.position;
+	if ((runFile == NULL) || sim_randomAccess) return -1;
+	return ftell(runFile);
+}
+
+Boolean sim_SeekStimulus(long offset)
+/* continues reading the stimulus file at the given position, opens it		*/
+/* again if it was read to the end											*/
+{
+	stimulusComplete = FALSE;
+	if (sim_compressedStimulus)
+		return (offset >= 0) && stimulusSeek(&sim_stimulusReader, (unsigned long long)offset);
+	if (sim_randomAccess || (offset < 0)) return FALSE;
+	if ((runFile == NULL) && ((runFile = fopen(sim_runFileName, "r")) == NULL)) return FALSE;
+	pStimulusRest = NULL;
+	return (fseek(runFile, offset, SEEK_SET) == 0);
+}
+
 void sim_UpdateMemoryMapping(unsigned pid, action_t action, int frame)
 /* keep track of use of the physical memory in the simulation				*/
 /* This is unly used for analysis and tracking of the OS-behaviour			*/
@@ -225,19 +293,17 @@ void sim_UpdateMemoryMapping(unsigned pid, action_t action, int frame)
 /*                Implementation of local helper functions          */
 
 Boolean readProcessFile(const char * filename)
-/* reads the process informations by reading the given file twice			*/
-/* The first iteration is used to determine the largest PID used which is	*/
-/* used to determine the size of the process table.							*/
-/* the process table is then initilalised with empty PCBs					*/
-/* Based on the known size of the processtable, in the second iteration,the */
-/* file is read and the information about all listed processes is read and	*/
-/* stored in the process table initialised*/
+/* reads the process informations from the given file, each process gets	*/
+/* an entry of the process table, which grows as needed. A line holds the	*/
+/* PID, the size and optionally the class of the process, see procclass.h,	*/
+/* and after the class its owner, see owner.h								*/
 /* Returns FALSE on any error, e.g. missing file or syntax errors			*/
 {
 	FILE* processFile;
 	char linebuffer[LINEBUFFER_SIZE+1] = "x";			// read buffer for file-input
-	unsigned int maxPID = MAX_PROCESSES;
-	unsigned pid, size;					
+	unsigned pid, size, index, owner;
+	char className[16];			// optional class of the process
+	processType_t type;
 	int count;					// check number of read characters to avoid warning
 #pragma warning( push )
 #pragma warning( disable : 6001 )		// Avoid warning for uninitialised variable: linebuffer is read from file
@@ -257,11 +323,25 @@ Boolean readProcessFile(const char * filename)
 	// now read information on all processes used for simulation
 	do {
 		// process current line
-		count = sscanf(linebuffer, "%u %u", &pid, &size);
-		processTable[pid].size = size; 
-		processTable[pid].valid = TRUE; 
-		// printf("PID: %2u has %2u pages\n", pid, size);			// Debug file IO
-		addToSimProcesslist(pid);		// store pid in list of valid pids for simulation!
+		count = sscanf(linebuffer, "%u %u %15s %u", &pid, &size, className, &owner);
+		type = foreground;
+		if ((count >= 3) && !selectProcessClass(className, &type))
+			count = 0;				// unknown class
+		if ((count == 4) && !ownerDefine(owner))
+			count = 0;				// too many owners
+		if (count < 4) owner = 0;	// the root owner
+		index = (count >= 2) ? createProcess(pid) : NOPROCESS;
+		if (index != NOPROCESS)
+		{
+			processTable[index].size = size; 
+			processTable[index].type = type;
+			processTable[index].ownerID = owner;
+			processTable[index].valid = TRUE; 
+			// printf("PID: %2u has %2u pages\n", pid, size);			// Debug file IO
+			addToSimProcesslist(index);		// store process in list of valid processes for simulation!
+		}
+		else
+			logGeneric("Error reading process-info file: invalid PID, unknown class, too many owners or out of memory");
 		// read next line (or EOF) and skip comment lines
 		do {
 			if (!feof(processFile))
@@ -289,7 +369,7 @@ FILE* openStimulusFile(FILE *file, const char * filename)
 	// skip first line, only a comment
 	if (!feof(file))
 		fgets(linebuffer, FILENAME_LENGTH, file);
-	printf("Read from File: %s", linebuffer);
+	if (logEnabled) printf("Read from File: %s", linebuffer);
 	sim_randomAccess = FALSE; 
 	}
 	else							// no filename given --> random access stimulus
@@ -300,6 +380,18 @@ FILE* openStimulusFile(FILE *file, const char * filename)
 	return file;
 }
 
+void mapEventProcesses(memoryEvent_t* pMemoryEvent)
+{	// the OS refers to the processes by their entries in the process table
+	pMemoryEvent->pid = findProcess(pMemoryEvent->pid);
+	for (unsigned i = 0; i < pMemoryEvent->actionCount; i++)
+	{
+		if (pMemoryEvent->pid == NOPROCESS)
+			pMemoryEvent->action[i].op = error;		// PID not in the process file
+		else if (pMemoryEvent->action[i].op == forkAction)
+			pMemoryEvent->action[i].page = findProcess(pMemoryEvent->action[i].page);
+	}
+}
+
 Boolean lineIsComment(const char* line)
 {	// detects comments and empty lines
 	if (line == NULL) return FALSE;	// error handling
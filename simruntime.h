@@ -14,7 +14,10 @@ extern Boolean sim_randomAccess;		// flag for random access stimulus generation
 #include "bs_types.h"
 #include "global.h"
 
-#define LINEBUFFER_SIZE 256	// maximum length of a line in the stimulus-file
+#define LINEBUFFER_SIZE 1024	// maximum length of a line in the stimulus-file
+
+extern char sim_processFileName[];			// process definitions, defaults to PROCESS_FILENAME
+extern char sim_runFileName[];				// stimulus file, defaults to RUN_FILENAME
 
 typedef struct sim_frame_struct
 {
@@ -50,6 +53,16 @@ memoryEvent_t* sim_NextRandomAccess(memoryEvent_t* pMemoryEvent);
 /* Returns the pointer pMemoryEvent on success, containing the Action		*/
 /* to perform	*/
 
+long sim_StimulusOffset(void);
+/* returns the position of the next line in the stimulus file, to be		*/
+/* passed to sim_SeekStimulus() later. Returns -1 for the random stimulus	*/
+/* For a compressed stimulus file (see stimulus.h) it is the number of the	*/
+/* next event, which only applies to the same file							*/
+
+Boolean sim_SeekStimulus(long offset);
+/* continues reading the stimulus file at the given position, e.g. after	*/
+/* restoring a checkpoint. Returns FALSE on errors							*/
+
 void sim_UpdateMemoryMapping(unsigned pid, action_t action, int frame);
 /* keep track of use of the physical memory in the simulation				*/			
 /* This is unly used for analysis and tracking of the OS-behaviour			*/
@@ -0,0 +1,231 @@
+/* Implementation of the slab allocator of the OS metadata					*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <stdio.h>
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "slab.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in slab.h		*/
+Boolean slabEnabled = SLAB_ALLOCATOR;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+
+#define LARGE_BLOCK SLAB_CLASSES		// sizeClass of a block allocated by malloc()
+
+// header in front of each block
+typedef struct slabBlock_struct
+{
+	struct slabBlock_struct* next;	// free list of the class, or the blocks of the owner
+	unsigned size;					// bytes requested
+	unsigned sizeClass : 8;			// LARGE_BLOCK for a block allocated by malloc()
+	unsigned owner : 24;			// process the block belongs to, NOPROCESS for the OS
+} slabBlock_t;
+
+// header in front of each chunk, the blocks follow it
+typedef struct slabChunk_struct
+{
+	struct slabChunk_struct* next;
+	size_t size;
+} slabChunk_t;
+
+slabBlock_t* slabFreeList[SLAB_CLASSES];		// empty blocks of each class
+slabBlock_t** slabOwnerBlocks = NULL;			// blocks in use of each process, grows with the process table
+slabChunk_t* slabChunks = NULL;					// all chunks taken from the system
+smpLock_t slabLock;								// serialises the allocator with several CPUs
+slabStatistics_t slabStats;
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+unsigned sizeClassOf(size_t bytes);
+/* returns the smallest class holding the given number of bytes,			*/
+/* SLAB_CLASSES if none does												*/
+
+size_t classSize(unsigned sizeClass);
+/* returns the size of the blocks of the class								*/
+
+Boolean addChunk(unsigned sizeClass);
+/* cuts a new chunk into blocks of the class, returns FALSE if out of memory*/
+
+void releaseBlock(slabBlock_t* block);
+/* puts the block back on the free list of its class or returns it to the	*/
+/* system if allocated by malloc()											*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+void slabInit(void)
+{
+	slabShutdown();
+	registerProcessArray((void**)&slabOwnerBlocks, sizeof(slabBlock_t*));
+	smpLockInit(&slabLock);
+	memset(&slabStats, 0, sizeof(slabStats));
+}
+
+void slabShutdown(void)
+{
+	slabChunk_t* chunk;
+	while (slabChunks != NULL)
+	{
+		chunk = slabChunks;
+		slabChunks = chunk->next;
+		free(chunk);
+	}
+	for (unsigned c = 0; c < SLAB_CLASSES; c++)
+		slabFreeList[c] = NULL;
+}
+
+void* slabAlloc(unsigned owner, size_t size)
+{
+	slabBlock_t* block = NULL;
+	size_t total = sizeof(slabBlock_t) + size;
+	unsigned sizeClass = sizeClassOf(total);
+	if (!slabEnabled || (sizeClass == SLAB_CLASSES))
+		sizeClass = LARGE_BLOCK;
+	if (smpCpuCount > 1) smpLock(&slabLock);
+	if (sizeClass == LARGE_BLOCK)
+	{
+		block = malloc(total);
+		if (block != NULL) slabStats.blockBytes += total;
+		if ((block != NULL) && slabEnabled) slabStats.largeAllocations++;
+	}
+	else if ((slabFreeList[sizeClass] != NULL) || addChunk(sizeClass))
+	{
+		block = slabFreeList[sizeClass];
+		slabFreeList[sizeClass] = block->next;
+		slabStats.blockBytes += classSize(sizeClass);
+	}
+	if (block != NULL)
+	{
+		block->size = (unsigned)size;
+		block->sizeClass = sizeClass;
+		block->owner = owner;
+		block->next = NULL;
+		if (owner != NOPROCESS)
+		{	// the blocks of a process are released together at its end
+			block->next = slabOwnerBlocks[owner];
+			slabOwnerBlocks[owner] = block;
+		}
+		slabStats.allocations++;
+		slabStats.requestedBytes += size;
+		slabStats.bytesInUse += size;
+		if (slabStats.bytesInUse > slabStats.peakBytesInUse)
+			slabStats.peakBytesInUse = slabStats.bytesInUse;
+	}
+	if (smpCpuCount > 1) smpUnlock(&slabLock);
+	return (block != NULL) ? block + 1 : NULL;
+}
+
+void slabFree(void* p)
+{
+	slabBlock_t* block;
+	slabBlock_t** link;
+	if (p == NULL) return;
+	block = (slabBlock_t*)p - 1;
+	if (smpCpuCount > 1) smpLock(&slabLock);
+	if (block->owner != NOPROCESS)
+	{
+		for (link = &slabOwnerBlocks[block->owner]; *link != block; link = &(*link)->next);
+		*link = block->next;
+	}
+	slabStats.frees++;
+	releaseBlock(block);
+	if (smpCpuCount > 1) smpUnlock(&slabLock);
+}
+
+void slabReleaseOwner(unsigned owner)
+{
+	slabBlock_t* block;
+	if (smpCpuCount > 1) smpLock(&slabLock);
+	if (slabOwnerBlocks[owner] != NULL) slabStats.releases++;
+	while (slabOwnerBlocks[owner] != NULL)
+	{
+		block = slabOwnerBlocks[owner];
+		slabOwnerBlocks[owner] = block->next;
+		slabStats.released++;
+		releaseBlock(block);
+	}
+	if (smpCpuCount > 1) smpUnlock(&slabLock);
+}
+
+void slabGetStatistics(slabStatistics_t* stats)
+{
+	*stats = slabStats;
+}
+
+void slabPrintStatistics(void)
+{
+	slabStatistics_t s;
+	slabGetStatistics(&s);
+	printf("OS metadata allocator (%s)\n", slabEnabled ? "slab" : "malloc");
+	printf("%-28s %15llu\n", "allocations", s.allocations);
+	printf("%-28s %15llu\n", "blocks freed", s.frees);
+	printf("%-28s %15llu\n", "processes released", s.releases);
+	printf("%-28s %15llu\n", "blocks released with them", s.released);
+	printf("%-28s %15llu\n", "larger than any class", s.largeAllocations);
+	printf("%-28s %15llu\n", "chunks from the system", s.chunks);
+	printf("%-28s %15.1f\n", "peak KiB in use", s.peakBytesInUse / 1024.0);
+	// memory lost to the headers and to rounding up to the size classes
+	printf("%-28s %14.1f%%\n", "block overhead",
+		(s.blockBytes > 0) ? 100.0 * (s.blockBytes - s.requestedBytes) / s.blockBytes : 0.0);
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+unsigned sizeClassOf(size_t bytes)
+{
+	unsigned shift = SLAB_MIN_SHIFT;
+	size_t step;
+	if (bytes <= ((size_t)1 << SLAB_MIN_SHIFT)) return 0;
+	// 2^shift < bytes <= 2^(shift + 1), the classes are a quarter of 2^shift apart
+	while ((bytes - 1) >> (shift + 1)) shift++;
+	if (shift >= SLAB_MAX_SHIFT) return SLAB_CLASSES;
+	step = (size_t)1 << (shift - 2);
+	return 4 * (shift - SLAB_MIN_SHIFT) + (unsigned)((bytes - ((size_t)1 << shift) + step - 1) / step);
+}
+
+size_t classSize(unsigned sizeClass)
+{
+	return (size_t)(4 + sizeClass % 4) << (SLAB_MIN_SHIFT + sizeClass / 4 - 2);
+}
+
+Boolean addChunk(unsigned sizeClass)
+{
+	size_t blockSize = classSize(sizeClass);
+	slabChunk_t* chunk = malloc(sizeof(slabChunk_t) + SLAB_CHUNK_SIZE);
+	char* blocks;
+	if (chunk == NULL) return FALSE;
+	chunk->size = SLAB_CHUNK_SIZE;
+	chunk->next = slabChunks;
+	slabChunks = chunk;
+	slabStats.chunks++;
+	// the blocks are put on the free list back to front, so that they are
+	// handed out in the order of their addresses
+	blocks = (char*)(chunk + 1);
+	for (size_t offset = SLAB_CHUNK_SIZE; offset >= blockSize; offset -= blockSize)
+	{
+		slabBlock_t* block = (slabBlock_t*)(blocks + offset - blockSize);
+		block->next = slabFreeList[sizeClass];
+		slabFreeList[sizeClass] = block;
+	}
+	return TRUE;
+}
+
+void releaseBlock(slabBlock_t* block)
+{
+	slabStats.bytesInUse -= block->size;
+	if (block->sizeClass == LARGE_BLOCK)
+	{
+		free(block);
+		return;
+	}
+	block->next = slabFreeList[block->sizeClass];
+	slabFreeList[block->sizeClass] = block;
+}
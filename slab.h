@@ -0,0 +1,67 @@
+/* Include-file defining the slab allocator of the OS metadata				*/
+/* Page tables and the other data of the OS are taken from size classes		*/
+/* from 2^SLAB_MIN_SHIFT to 2^SLAB_MAX_SHIFT bytes, four per power of two	*/
+/* (2^k, 1.25 * 2^k, 1.5 * 2^k, 1.75 * 2^k), so that rounding up wastes	*/
+/* less than a quarter of a block. The blocks of a class are cut from		*/
+/* chunks of SLAB_CHUNK_SIZE bytes taken from the system, a freed block is	*/
+/* kept on the free list of its class and used again by the next			*/
+/* allocation of that class. The chunks are returned to the system by		*/
+/* slabShutdown() only.														*/
+/* Each block records the process it belongs to, so that all blocks of a	*/
+/* process are released at once when it ends (slabReleaseOwner()).			*/
+/* Larger blocks, and all blocks with slabEnabled == FALSE, are allocated	*/
+/* by malloc(), which allows to compare both.								*/
+#ifndef __SLAB__
+#define __SLAB__
+
+#include <stddef.h>
+#include "bs_types.h"
+
+#define SLAB_MIN_SHIFT 5				// smallest block: 32 bytes, the header included
+#define SLAB_MAX_SHIFT 18				// largest block of a size class: 256 KiB
+#define SLAB_CLASSES (4 * (SLAB_MAX_SHIFT - SLAB_MIN_SHIFT) + 1)
+#define SLAB_CHUNK_SIZE (1024 * 1024)	// memory taken from the system at once
+
+/* statistics of the allocator, for the report at the end of the run		*/
+typedef struct slabStatistics_struct
+{
+	unsigned long long allocations;		// blocks allocated
+	unsigned long long frees;			// blocks freed one by one
+	unsigned long long releases;		// processes whose blocks were released at once
+	unsigned long long released;		// blocks released with them
+	unsigned long long largeAllocations;	// blocks allocated by malloc() as larger than any class
+	unsigned long long chunks;			// chunks taken from the system
+	unsigned long long requestedBytes;	// sum of the sizes requested by all allocations
+	unsigned long long blockBytes;		// sum of the sizes of the blocks allocated for them
+	size_t bytesInUse;					// bytes requested by the blocks in use
+	size_t peakBytesInUse;				// largest value of bytesInUse
+} slabStatistics_t;
+
+extern Boolean slabEnabled;				// FALSE: all blocks are allocated by malloc()
+
+void slabInit(void);
+/* clears the free lists and the statistics, must be called before the		*/
+/* first allocation															*/
+
+void slabShutdown(void);
+/* returns all chunks to the system, blocks still in use become invalid		*/
+
+void* slabAlloc(unsigned owner, size_t size);
+/* returns a block of at least size bytes belonging to the process owner,	*/
+/* NOPROCESS for data of the OS. Returns NULL if out of memory				*/
+
+void slabFree(void* block);
+/* frees the block, NULL is ignored. The block is removed from the blocks	*/
+/* of its process, which takes a walk along them							*/
+
+void slabReleaseOwner(unsigned owner);
+/* frees all blocks of the process at once, e.g. when it ends				*/
+
+void slabGetStatistics(slabStatistics_t* stats);
+/* returns the current statistics											*/
+
+void slabPrintStatistics(void);
+/* prints the allocations, the chunks taken from the system and the		*/
+/* memory lost to rounding up to the size classes							*/
+
+#endif  /* __SLAB__ */
@@ -0,0 +1,176 @@
+/* Implementation of the primitives for the simulation of several CPUs		*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#ifdef _WIN32
+#include <windows.h>
+#else
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
+#include <stdlib.h>
+#include "bs_types.h"
+#include "smp.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in smp.h		*/
+unsigned smpCpuCount = 1;
+SMP_THREAD_LOCAL unsigned smpCpu = 0;
+SMP_THREAD_LOCAL unsigned smpTime = 0;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+
+/* start parameters of a thread, freed by the thread */
+typedef struct smpStart_struct
+{
+	void (*function)(unsigned cpu);
+	unsigned cpu;
+} smpStart_t;
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+void smpLockInit(smpLock_t* lock)
+{
+	*lock = 0;
+}
+
+#ifdef _WIN32
+
+void smpLock(smpLock_t* lock)
+{
+	for (unsigned spins = 0; _InterlockedExchange(lock, 1) != 0; spins++)
+		if (spins >= SMP_SPINS) smpYield();
+}
+
+Boolean smpTryLock(smpLock_t* lock)
+{
+	return (_InterlockedExchange(lock, 1) == 0);
+}
+
+void smpUnlock(smpLock_t* lock)
+{
+	_InterlockedExchange(lock, 0);
+}
+
+void smpAtomicAdd(unsigned long long* counter, unsigned long long value)
+{
+	_InterlockedExchangeAdd64((volatile long long*)counter, (long long)value);
+}
+
+DWORD WINAPI smpThreadMain(LPVOID parameter)
+{
+	smpStart_t start = *(smpStart_t*)parameter;
+	free(parameter);
+	smpCpu = start.cpu;
+	start.function(start.cpu);
+	return 0;
+}
+
+Boolean smpThreadStart(smpThread_t* thread, void (*function)(unsigned cpu), unsigned cpu)
+{
+	smpStart_t* start = malloc(sizeof(smpStart_t));
+	if (start == NULL) return FALSE;
+	start->function = function;
+	start->cpu = cpu;
+	*thread = CreateThread(NULL, 0, smpThreadMain, start, 0, NULL);
+	if (*thread == NULL) free(start);
+	return (*thread != NULL);
+}
+
+void smpThreadJoin(smpThread_t thread)
+{
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+}
+
+double smpWallClock(void)
+{
+	LARGE_INTEGER count, frequency;
+	QueryPerformanceCounter(&count);
+	QueryPerformanceFrequency(&frequency);
+	return (double)count.QuadPart / (double)frequency.QuadPart;
+}
+
+void smpYield(void)
+{
+	SwitchToThread();
+}
+
+#else
+
+void smpLock(smpLock_t* lock)
+{
+	for (unsigned spins = 0; __atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE) != 0; spins++)
+		if (spins >= SMP_SPINS) smpYield();
+}
+
+Boolean smpTryLock(smpLock_t* lock)
+{
+	return (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE) == 0);
+}
+
+void smpUnlock(smpLock_t* lock)
+{
+	__atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+void smpAtomicAdd(unsigned long long* counter, unsigned long long value)
+{
+	__atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+}
+
+void* smpThreadMain(void* parameter)
+{
+	smpStart_t start = *(smpStart_t*)parameter;
+	free(parameter);
+	smpCpu = start.cpu;
+	start.function(start.cpu);
+	return NULL;
+}
+
+Boolean smpThreadStart(smpThread_t* thread, void (*function)(unsigned cpu), unsigned cpu)
+{
+	pthread_t* handle = malloc(sizeof(pthread_t));
+	smpStart_t* start = malloc(sizeof(smpStart_t));
+	if ((handle == NULL) || (start == NULL))
+	{
+		free(handle);
+		free(start);
+		return FALSE;
+	}
+	start->function = function;
+	start->cpu = cpu;
+	if (pthread_create(handle, NULL, smpThreadMain, start) != 0)
+	{
+		free(handle);
+		free(start);
+		return FALSE;
+	}
+	*thread = handle;
+	return TRUE;
+}
+
+void smpThreadJoin(smpThread_t thread)
+{
+	pthread_join(*(pthread_t*)thread, NULL);
+	free(thread);
+}
+
+double smpWallClock(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void smpYield(void)
+{
+	sched_yield();
+}
+
+#endif
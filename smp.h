@@ -0,0 +1,58 @@
+/* Include-file defining the primitives for the simulation of several CPUs	*/
+/* Each simulated CPU is a thread of the host. The primitives are thin		*/
+/* wrappers of the Win32 API resp. POSIX threads and compiler intrinsics,	*/
+/* so that the memory manager stays portable.								*/
+#ifndef __SMP__
+#define __SMP__
+
+#include "bs_types.h"
+
+#define SMP_MAX_CPUS 64			// maximum number of simulated CPUs
+#define SMP_SPINS 64			// spins on a busy lock before the thread yields
+
+#ifdef _WIN32
+#define SMP_THREAD_LOCAL __declspec(thread)
+#else
+#define SMP_THREAD_LOCAL _Thread_local
+#endif
+
+/* spin lock, 0 if free. The critical sections of the memory manager are	*/
+/* short, a lock only yields the CPU if it is held by a preempted thread	*/
+typedef volatile long smpLock_t;
+
+/* handle of a thread running a simulated CPU */
+typedef void* smpThread_t;
+
+extern unsigned smpCpuCount;					// number of simulated CPUs, 1: single CPU
+extern SMP_THREAD_LOCAL unsigned smpCpu;		// number of the CPU run by the calling thread
+extern SMP_THREAD_LOCAL unsigned smpTime;		// simulated time of the CPU run by the calling thread
+
+void smpLockInit(smpLock_t* lock);
+/* initialises the lock as free												*/
+
+void smpLock(smpLock_t* lock);
+/* acquires the lock, spinning and yielding until it is free				*/
+
+Boolean smpTryLock(smpLock_t* lock);
+/* acquires the lock if it is free, returns TRUE on success					*/
+
+void smpUnlock(smpLock_t* lock);
+/* releases the lock														*/
+
+void smpYield(void);
+/* gives the host CPU to other threads										*/
+
+void smpAtomicAdd(unsigned long long* counter, unsigned long long value);
+/* adds the value to the counter shared by several CPUs						*/
+
+Boolean smpThreadStart(smpThread_t* thread, void (*function)(unsigned cpu), unsigned cpu);
+/* starts a thread running function(cpu), smpCpu is set to cpu in it		*/
+/* Returns FALSE if the thread cannot be created							*/
+
+void smpThreadJoin(smpThread_t thread);
+/* waits for the end of the thread											*/
+
+double smpWallClock(void);
+/* returns a monotonic wall clock time in seconds							*/
+
+#endif  /* __SMP__ */
@@ -0,0 +1,529 @@
+/* Implementation of the compressed stimulus file							*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "stimulus.h"
+
+#define STIMULUS_HEADER_SIZE 16			// magic, version, events per block, reserved
+#define STIMULUS_BLOCK_HEADER_SIZE 8	// payload bytes, events
+#define STIMULUS_INDEX_ENTRY_SIZE 16	// file offset, number of the first event
+#define STIMULUS_FOOTER_SIZE 16			// offset of the index, blocks, magic
+#define STIMULUS_INDEX_MAGIC "BSSI"
+#define STIMULUS_DATA_SIZE (1 << 20)	// initial payload buffer in bytes
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+void putStimulusVarint(stimulusBlock_t* block, unsigned long long value);
+/* appends the value as LEB128 varint to the payload of the block			*/
+
+Boolean getStimulusVarint(stimulusBlock_t* block, unsigned long long* value);
+/* decodes the next varint of the payload, returns FALSE at its end			*/
+
+unsigned zigzag(unsigned delta);
+/* maps a signed difference of 32 bit to small unsigned values				*/
+
+unsigned unzigzag(unsigned long long value);
+/* inverse of zigzag()														*/
+
+void putLittleEndian(unsigned char* buffer, unsigned long long value, unsigned bytes);
+/* stores the value in the given number of bytes, little endian				*/
+
+unsigned long long getLittleEndian(const unsigned char* buffer, unsigned bytes);
+/* inverse of putLittleEndian()												*/
+
+Boolean seekStimulusFile(FILE* file, unsigned long long offset);
+/* positions the file at the offset, also beyond 2 GiB						*/
+
+Boolean writeStimulusBlock(stimulusWriter_t* writer);
+/* writes the open block, adds it to the index and starts the next one		*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+Boolean stimulusIsCompressed(const char* filename)
+{
+	char magic[4];
+	FILE* file = fopen(filename, "rb");
+	Boolean compressed;
+	if (file == NULL) return FALSE;
+	compressed = (fread(magic, 1, 4, file) == 4) && (memcmp(magic, STIMULUS_MAGIC, 4) == 0);
+	fclose(file);
+	return compressed;
+}
+
+Boolean stimulusReaderOpen(stimulusReader_t* reader, const char* filename)
+{
+	unsigned char header[STIMULUS_HEADER_SIZE], footer[STIMULUS_FOOTER_SIZE], entry[STIMULUS_INDEX_ENTRY_SIZE];
+	unsigned long long indexOffset;
+	memset(reader, 0, sizeof(stimulusReader_t));
+	reader->file = fopen(filename, "rb");
+	if (reader->file == NULL) return FALSE;
+	if ((fread(header, 1, STIMULUS_HEADER_SIZE, reader->file) != STIMULUS_HEADER_SIZE)
+		|| (memcmp(header, STIMULUS_MAGIC, 4) != 0)
+		|| (getLittleEndian(&header[4], 4) != STIMULUS_VERSION)
+		|| (getLittleEndian(&header[8], 4) > STIMULUS_BLOCK_EVENTS))	// the dictionary would overflow
+	{
+		stimulusReaderClose(reader);
+		return FALSE;
+	}
+	// the footer locates the index of the blocks
+	if ((fseek(reader->file, -STIMULUS_FOOTER_SIZE, SEEK_END) != 0)
+		|| (fread(footer, 1, STIMULUS_FOOTER_SIZE, reader->file) != STIMULUS_FOOTER_SIZE)
+		|| (memcmp(&footer[12], STIMULUS_INDEX_MAGIC, 4) != 0))
+	{
+		stimulusReaderClose(reader);
+		return FALSE;							// truncated, e.g. the writer was not closed
+	}
+	indexOffset = getLittleEndian(&footer[0], 8);
+	reader->blockCount = (unsigned)getLittleEndian(&footer[8], 4);
+	reader->blockOffset = malloc((reader->blockCount + 1) * sizeof(unsigned long long));
+	reader->blockFirst = malloc((reader->blockCount + 1) * sizeof(unsigned long long));
+	if ((reader->blockOffset == NULL) || (reader->blockFirst == NULL) || !seekStimulusFile(reader->file, indexOffset))
+	{
+		stimulusReaderClose(reader);
+		return FALSE;
+	}
+	for (unsigned i = 0; i < reader->blockCount; i++)
+	{
+		if (fread(entry, 1, STIMULUS_INDEX_ENTRY_SIZE, reader->file) != STIMULUS_INDEX_ENTRY_SIZE)
+		{
+			stimulusReaderClose(reader);
+			return FALSE;
+		}
+		reader->blockOffset[i] = getLittleEndian(&entry[0], 8);
+		reader->blockFirst[i] = getLittleEndian(&entry[8], 8);
+	}
+	// the events of the last block complete the count
+	if (reader->blockCount > 0)
+	{
+		if (!seekStimulusFile(reader->file, reader->blockOffset[reader->blockCount - 1])
+			|| (fread(entry, 1, STIMULUS_BLOCK_HEADER_SIZE, reader->file) != STIMULUS_BLOCK_HEADER_SIZE))
+		{
+			stimulusReaderClose(reader);
+			return FALSE;
+		}
+		reader->eventCount = reader->blockFirst[reader->blockCount - 1] + getLittleEndian(&entry[4], 4);
+	}
+	reader->block = reader->blockCount;		// none loaded yet
+	reader->position = 0;
+	return TRUE;
+}
+
+Boolean stimulusRead(stimulusReader_t* reader, memoryEvent_t* event)
+{
+	unsigned next;
+	while ((reader->block == reader->blockCount) || (reader->current.decoded == reader->current.events))
+	{	// block exhausted: stream in the next one
+		next = (reader->block == reader->blockCount) ? 0 : reader->block + 1;
+		if (next >= reader->blockCount) return FALSE;
+		if (!stimulusLoadBlock(reader, next, &reader->current)) return FALSE;
+		reader->block = next;
+	}
+	if (!stimulusDecode(&reader->current, event)) return FALSE;
+	reader->position++;
+	return TRUE;
+}
+
+Boolean stimulusSeek(stimulusReader_t* reader, unsigned long long position)
+{
+	memoryEvent_t skipped;
+	unsigned low = 0, high = reader->blockCount, middle;
+	if (position > reader->eventCount) return FALSE;
+	if (reader->blockCount == 0) return TRUE;	// empty file, position is 0
+	// binary search of the last block starting at or before the position
+	while (high - low > 1)
+	{
+		middle = (low + high) / 2;
+		if (reader->blockFirst[middle] <= position) low = middle; else high = middle;
+	}
+	if (!stimulusLoadBlock(reader, low, &reader->current))
+	{
+		reader->block = reader->blockCount;
+		return FALSE;
+	}
+	reader->block = low;
+	// the state of the block is rebuilt by decoding its events up to the position
+	for (unsigned long long i = reader->blockFirst[low]; i < position; i++)
+		if (!stimulusDecode(&reader->current, &skipped)) return FALSE;
+	reader->position = position;
+	return TRUE;
+}
+
+void stimulusReaderClose(stimulusReader_t* reader)
+{
+	if (reader->file != NULL) fclose(reader->file);
+	free(reader->blockOffset);
+	free(reader->blockFirst);
+	free(reader->current.data);
+	reader->file = NULL;
+	reader->blockOffset = NULL;
+	reader->blockFirst = NULL;
+	reader->current.data = NULL;
+	reader->current.capacity = 0;
+}
+
+Boolean stimulusLoadBlock(stimulusReader_t* reader, unsigned block, stimulusBlock_t* target)
+{
+	unsigned char header[STIMULUS_BLOCK_HEADER_SIZE];
+	unsigned char* data;
+	size_t size;
+	unsigned events;
+	if ((block >= reader->blockCount) || !seekStimulusFile(reader->file, reader->blockOffset[block])
+		|| (fread(header, 1, STIMULUS_BLOCK_HEADER_SIZE, reader->file) != STIMULUS_BLOCK_HEADER_SIZE))
+		return FALSE;
+	size = (size_t)getLittleEndian(&header[0], 4);
+	events = (unsigned)getLittleEndian(&header[4], 4);
+	if ((events > STIMULUS_BLOCK_EVENTS) || (size > (size_t)events * STIMULUS_EVENT_BYTES_MAX))
+		return FALSE;							// corrupt header
+	if (size > target->capacity)
+	{
+		data = realloc(target->data, size);
+		if (data == NULL) return FALSE;
+		target->data = data;
+		target->capacity = size;
+	}
+	if ((size > 0) && (fread(target->data, 1, size, reader->file) != size)) return FALSE;
+	target->size = size;
+	target->pos = 0;
+	target->events = events;
+	target->decoded = 0;
+	target->lastTime = 0;
+	target->pidCount = 0;
+	return TRUE;
+}
+
+Boolean stimulusDecode(stimulusBlock_t* block, memoryEvent_t* event)
+{
+	unsigned long long value;
+	unsigned index, count;
+	action_t* pAction;
+	if (block->decoded == block->events) return FALSE;
+	if (!getStimulusVarint(block, &value)) return FALSE;
+	block->lastTime += unzigzag(value);
+	event->time = block->lastTime;
+	// PID index and number of actions
+	if (!getStimulusVarint(block, &value)) return FALSE;
+	index = (unsigned)(value >> 3);
+	count = (unsigned)(value & 7);
+	if (count == 7)
+	{
+		if (!getStimulusVarint(block, &value) || (value > MAX_EVENT_ACTIONS - 7)) return FALSE;
+		count += (unsigned)value;
+	}
+	if (index == block->pidCount)
+	{	// new PID, added to the dictionary
+		if ((index == STIMULUS_BLOCK_EVENTS) || !getStimulusVarint(block, &value)) return FALSE;
+		block->pids[index] = (bsPid_t)value;
+		block->lastPage[index] = 0;
+		block->pidCount++;
+	}
+	else if (index > block->pidCount) return FALSE;
+	event->pid = block->pids[index];
+	event->actionCount = count;
+	for (unsigned i = 0; i < count; i++)
+	{
+		if (!getStimulusVarint(block, &value)) return FALSE;
+		pAction = &event->action[i];
+		switch (value & 3)
+		{
+		case 0:
+		case 1:
+			pAction->op = ((value & 3) == 0) ? read : write;
+			block->lastPage[index] += unzigzag(value >> 2);
+			pAction->page = block->lastPage[index];
+			break;
+		case 2:
+			pAction->op = forkAction;
+			pAction->page = (unsigned)(value >> 2);
+			break;
+		default:
+			pAction->op = ((value >> 2) <= error) ? (operation_t)(value >> 2) : error;
+			pAction->page = 0;
+			break;
+		}
+	}
+	block->decoded++;
+	return TRUE;
+}
+
+Boolean stimulusWriterOpen(stimulusWriter_t* writer, const char* filename)
+{
+	unsigned char header[STIMULUS_HEADER_SIZE];
+	memset(writer, 0, sizeof(stimulusWriter_t));
+	writer->block.data = malloc(STIMULUS_DATA_SIZE);
+	writer->block.capacity = STIMULUS_DATA_SIZE;
+	writer->pidSlot = calloc((size_t)1 << STIMULUS_PID_SLOT_BITS, sizeof(unsigned));
+	if ((writer->block.data == NULL) || (writer->pidSlot == NULL))
+	{
+		free(writer->block.data);
+		free(writer->pidSlot);
+		return FALSE;
+	}
+	writer->file = fopen(filename, "wb");
+	if (writer->file == NULL)
+	{
+		free(writer->block.data);
+		free(writer->pidSlot);
+		return FALSE;
+	}
+	memcpy(header, STIMULUS_MAGIC, 4);
+	putLittleEndian(&header[4], STIMULUS_VERSION, 4);
+	putLittleEndian(&header[8], STIMULUS_BLOCK_EVENTS, 4);
+	putLittleEndian(&header[12], 0, 4);
+	if (fwrite(header, 1, STIMULUS_HEADER_SIZE, writer->file) != STIMULUS_HEADER_SIZE) writer->error = TRUE;
+	writer->offset = STIMULUS_HEADER_SIZE;
+	return !writer->error;
+}
+
+Boolean stimulusWrite(stimulusWriter_t* writer, const memoryEvent_t* event)
+{
+	stimulusBlock_t* block = &writer->block;
+	unsigned char* data;
+	unsigned slot, mask = (1u << STIMULUS_PID_SLOT_BITS) - 1;
+	unsigned index, count = event->actionCount;
+	unsigned long long value;
+	const action_t* pAction;
+	if (count > MAX_EVENT_ACTIONS) return FALSE;
+	if ((block->events == STIMULUS_BLOCK_EVENTS) && !writeStimulusBlock(writer)) return FALSE;
+	if (block->size + STIMULUS_EVENT_BYTES_MAX > block->capacity)
+	{
+		data = realloc(block->data, block->capacity * 2);
+		if (data == NULL) return FALSE;
+		block->data = data;
+		block->capacity *= 2;
+	}
+	putStimulusVarint(block, zigzag(event->time - block->lastTime));
+	block->lastTime = event->time;
+	// look up the PID in the dictionary, multiplicative hash with linear probing
+	slot = (event->pid * 2654435761u) >> (32 - STIMULUS_PID_SLOT_BITS);
+	while ((writer->pidSlot[slot] != 0) && (block->pids[writer->pidSlot[slot] - 1] != event->pid))
+		slot = (slot + 1) & mask;
+	index = (writer->pidSlot[slot] != 0) ? writer->pidSlot[slot] - 1 : block->pidCount;
+	putStimulusVarint(block, ((unsigned long long)index << 3) | ((count < 7) ? count : 7));
+	if (count >= 7) putStimulusVarint(block, count - 7);
+	if (index == block->pidCount)
+	{
+		putStimulusVarint(block, event->pid);
+		block->pids[index] = event->pid;
+		block->lastPage[index] = 0;
+		block->pidCount++;
+		writer->pidSlot[slot] = index + 1;
+	}
+	for (unsigned i = 0; i < count; i++)
+	{
+		pAction = &event->action[i];
+		switch (pAction->op)
+		{
+		case read:
+		case write:
+			value = ((unsigned long long)zigzag(pAction->page - block->lastPage[index]) << 2) | ((pAction->op == read) ? 0 : 1);
+			block->lastPage[index] = pAction->page;
+			break;
+		case forkAction:
+			value = ((unsigned long long)pAction->page << 2) | 2;
+			break;
+		default:
+			value = ((unsigned long long)pAction->op << 2) | 3;
+			break;
+		}
+		putStimulusVarint(block, value);
+	}
+	block->events++;
+	writer->eventCount++;
+	return !writer->error;
+}
+
+Boolean stimulusWriterClose(stimulusWriter_t* writer)
+{
+	unsigned char entry[STIMULUS_INDEX_ENTRY_SIZE], footer[STIMULUS_FOOTER_SIZE];
+	unsigned long long indexOffset;
+	if (writer->file == NULL) return FALSE;
+	writeStimulusBlock(writer);
+	indexOffset = writer->offset;
+	for (unsigned i = 0; i < writer->blockCount; i++)
+	{
+		putLittleEndian(&entry[0], writer->blockOffset[i], 8);
+		putLittleEndian(&entry[8], writer->blockFirst[i], 8);
+		if (fwrite(entry, 1, STIMULUS_INDEX_ENTRY_SIZE, writer->file) != STIMULUS_INDEX_ENTRY_SIZE)
+			writer->error = TRUE;
+	}
+	putLittleEndian(&footer[0], indexOffset, 8);
+	putLittleEndian(&footer[8], writer->blockCount, 4);
+	memcpy(&footer[12], STIMULUS_INDEX_MAGIC, 4);
+	if (fwrite(footer, 1, STIMULUS_FOOTER_SIZE, writer->file) != STIMULUS_FOOTER_SIZE) writer->error = TRUE;
+	if (fclose(writer->file) != 0) writer->error = TRUE;
+	writer->file = NULL;
+	free(writer->block.data);
+	free(writer->pidSlot);
+	free(writer->blockOffset);
+	free(writer->blockFirst);
+	writer->block.data = NULL;
+	writer->pidSlot = NULL;
+	writer->blockOffset = NULL;
+	writer->blockFirst = NULL;
+	return !writer->error;
+}
+
+Boolean stimulusParseAction(char** ppLine, action_t* pAction)
+{
+	char* pos = *ppLine;
+	char* pEnd = NULL;
+	while ((*pos == ' ') || (*pos == '\t')) pos++;		// skip white-space
+	if ((*pos == '\0') || (*pos == '\n') || (*pos == '\r')) return FALSE;
+	pAction->page = 0;
+	switch (*pos)
+	{
+	case 'S': pAction->op = start; break;
+	case 'E': pAction->op = end; break;
+	case 'R': pAction->op = read; break;
+	case 'W': pAction->op = write; break;
+	case 'F': pAction->op = forkAction; break;
+	default: pAction->op = error; break;
+	}
+	pos++;
+	if ((pAction->op == read) || (pAction->op == write) || (pAction->op == forkAction))
+	{
+		pAction->page = (unsigned)strtoul(pos, &pEnd, 0);
+		if (pEnd == pos) pAction->op = error;		// page number or PID of the child missing
+		pos = pEnd;
+	}
+	// an action ends with white-space, otherwise it is malformed
+	while ((*pos != '\0') && (*pos != ' ') && (*pos != '\t') && (*pos != '\n') && (*pos != '\r'))
+	{
+		pAction->op = error;
+		pos++;
+	}
+	*ppLine = pos;
+	return TRUE;
+}
+
+void stimulusParseActions(char** ppLine, memoryEvent_t* event)
+{
+	char* pAction;
+	action_t next;
+	event->actionCount = 0;
+	while ((event->actionCount < MAX_EVENT_ACTIONS) && stimulusParseAction(ppLine, &event->action[event->actionCount]))
+		event->actionCount++;
+	// look ahead for an action that did not fit
+	pAction = *ppLine;
+	if ((event->actionCount < MAX_EVENT_ACTIONS) || !stimulusParseAction(&pAction, &next)) *ppLine = NULL;
+}
+
+Boolean stimulusParseLine(char* line, memoryEvent_t* event, char** ppRest)
+{
+	int consumed = 0;
+	if ((line[0] == '\0') || (line[0] == '#') || (line[0] == '\n')) return FALSE;
+	if (sscanf(line, "%u %u%n", &event->time, &event->pid, &consumed) < 2) return FALSE;
+	*ppRest = &line[consumed];
+	stimulusParseActions(ppRest, event);
+	if (event->actionCount == 0)		// line without any action
+	{
+		event->actionCount = 1;
+		event->action[0].op = error;
+		event->action[0].page = 0;
+	}
+	return TRUE;
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+void putStimulusVarint(stimulusBlock_t* block, unsigned long long value)
+{
+	while (value >= 0x80)
+	{
+		block->data[block->size++] = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+	block->data[block->size++] = (unsigned char)value;
+}
+
+Boolean getStimulusVarint(stimulusBlock_t* block, unsigned long long* value)
+{
+	unsigned long long result = 0;
+	unsigned shift = 0;
+	unsigned char byte;
+	do {
+		if (block->pos >= block->size) return FALSE;	// truncated payload
+		byte = block->data[block->pos++];
+		if (shift < 64) result |= (unsigned long long)(byte & 0x7f) << shift;
+		shift += 7;
+	} while (byte & 0x80);
+	*value = result;
+	return TRUE;
+}
+
+unsigned zigzag(unsigned delta)
+{
+	return (delta << 1) ^ (unsigned)((int)delta >> 31);
+}
+
+unsigned unzigzag(unsigned long long value)
+{
+	return (unsigned)(value >> 1) ^ (0u - (unsigned)(value & 1));
+}
+
+void putLittleEndian(unsigned char* buffer, unsigned long long value, unsigned bytes)
+{
+	for (unsigned i = 0; i < bytes; i++)
+		buffer[i] = (unsigned char)(value >> (8 * i));
+}
+
+unsigned long long getLittleEndian(const unsigned char* buffer, unsigned bytes)
+{
+	unsigned long long value = 0;
+	for (unsigned i = 0; i < bytes; i++)
+		value |= (unsigned long long)buffer[i] << (8 * i);
+	return value;
+}
+
+Boolean seekStimulusFile(FILE* file, unsigned long long offset)
+{
+#ifdef _WIN32
+	return (_fseeki64(file, (long long)offset, SEEK_SET) == 0);
+#else
+	return (fseeko(file, (off_t)offset, SEEK_SET) == 0);
+#endif
+}
+
+Boolean writeStimulusBlock(stimulusWriter_t* writer)
+{
+	stimulusBlock_t* block = &writer->block;
+	unsigned char header[STIMULUS_BLOCK_HEADER_SIZE];
+	unsigned long long* offsets, * firsts;
+	if (block->events == 0) return TRUE;
+	if (writer->blockCount == writer->blockCapacity)
+	{	// grow the index
+		writer->blockCapacity = (writer->blockCapacity == 0) ? 64 : writer->blockCapacity * 2;
+		offsets = realloc(writer->blockOffset, writer->blockCapacity * sizeof(unsigned long long));
+		if (offsets != NULL) writer->blockOffset = offsets;
+		firsts = realloc(writer->blockFirst, writer->blockCapacity * sizeof(unsigned long long));
+		if (firsts != NULL) writer->blockFirst = firsts;
+		if ((offsets == NULL) || (firsts == NULL))
+		{
+			writer->error = TRUE;
+			return FALSE;
+		}
+	}
+	writer->blockOffset[writer->blockCount] = writer->offset;
+	writer->blockFirst[writer->blockCount] = writer->eventCount - block->events;
+	writer->blockCount++;
+	putLittleEndian(&header[0], block->size, 4);
+	putLittleEndian(&header[4], block->events, 4);
+	if ((fwrite(header, 1, STIMULUS_BLOCK_HEADER_SIZE, writer->file) != STIMULUS_BLOCK_HEADER_SIZE)
+		|| (fwrite(block->data, 1, block->size, writer->file) != block->size))
+		writer->error = TRUE;
+	writer->offset += STIMULUS_BLOCK_HEADER_SIZE + block->size;
+	// the next block starts with an empty dictionary
+	block->size = 0;
+	block->events = 0;
+	block->lastTime = 0;
+	block->pidCount = 0;
+	memset(writer->pidSlot, 0, ((size_t)1 << STIMULUS_PID_SLOT_BITS) * sizeof(unsigned));
+	return !writer->error;
+}
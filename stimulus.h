@@ -0,0 +1,144 @@
+/* Include-file defining the compressed stimulus file, an alternative to	*/
+/* the text format of run.txt for long recorded traces. The simulation		*/
+/* reads it instead of the text if it starts with STIMULUS_MAGIC, the tool	*/
+/* stimulusPack converts the text format into it and back.					*/
+/* The events are split into blocks of STIMULUS_BLOCK_EVENTS, each of them	*/
+/* is decoded without the others, so that blocks can be decoded in			*/
+/* parallel and a reader can seek to any event through the block index at	*/
+/* the end of the file. Within a block:										*/
+/*   - the time is the zigzag coded difference to the previous event		*/
+/*   - the PID is an index into the dictionary of the PIDs seen in the		*/
+/*     block, an index one past its end adds the PID following it			*/
+/*   - the page of a read or write is the zigzag coded difference to the	*/
+/*     page of the previous access of the same PID in the block				*/
+/*   - the operation is packed into the 2 lowest bits of the action			*/
+/*																			*/
+/* File format (numbers in <> are LEB128 varints, [] are little endian):	*/
+/*   header : "BSST" [version:4] [events per block:4] [0:4]					*/
+/*   block  : [payload bytes:4] [events:4] payload							*/
+/*   payload: per event <zigzag time delta> <PID index * 8 + actions>		*/
+/*            with 7 for 7 or more actions followed by <actions - 7>, then	*/
+/*            <PID> if the index is new										*/
+/*            then per action <value * 4 + code>, code 0 read and 1 write	*/
+/*            with value the zigzag page delta, 2 fork with value the		*/
+/*            PID of the child, 3 other operations with value the			*/
+/*            operation_t (start, end, error)								*/
+/*   index  : per block [file offset:8] [number of its first event:8]		*/
+/*   footer : [offset of the index:8] [blocks:4] "BSSI"						*/
+/* The PIDs are those of the process file, the reader does not map them to	*/
+/* the process table.														*/
+#ifndef __STIMULUS__
+#define __STIMULUS__
+
+#include <stdio.h>
+#include "bs_types.h"
+
+#define STIMULUS_MAGIC "BSST"
+#define STIMULUS_VERSION 1
+#define STIMULUS_BLOCK_EVENTS 65536		// events per block, the unit of decoding and seeking
+#define STIMULUS_EVENT_BYTES_MAX (4 * 10 + MAX_EVENT_ACTIONS * 10)	// longest coded event
+#define STIMULUS_PID_SLOT_BITS 17		// hash of the writer, twice the entries of the dictionary
+
+/* a block being decoded, its state starts anew with each block				*/
+typedef struct stimulusBlock_struct
+{
+	unsigned char* data;				// payload of the block
+	size_t size;						// bytes in data
+	size_t capacity;					// bytes allocated for data
+	size_t pos;							// next byte to decode
+	unsigned events;					// events in the block
+	unsigned decoded;					// events decoded so far
+	unsigned lastTime;					// time of the previous event
+	unsigned pidCount;					// entries of the dictionary
+	bsPid_t pids[STIMULUS_BLOCK_EVENTS];		// dictionary of the PIDs
+	unsigned lastPage[STIMULUS_BLOCK_EVENTS];	// page of the last access of each PID
+} stimulusBlock_t;
+
+/* state of a streaming reader, only the current block is held in memory	*/
+typedef struct stimulusReader_struct
+{
+	FILE* file;
+	unsigned blockCount;
+	unsigned long long* blockOffset;	// index: position of each block in the file
+	unsigned long long* blockFirst;		// index: number of the first event of each block
+	unsigned long long eventCount;		// events in the file
+	unsigned block;						// block loaded into current, blockCount: none
+	unsigned long long position;		// number of the next event
+	stimulusBlock_t current;
+} stimulusReader_t;
+
+/* state of a writer, the block is coded in memory and written when full	*/
+typedef struct stimulusWriter_struct
+{
+	FILE* file;
+	stimulusBlock_t block;				// dictionary and payload of the open block
+	unsigned* pidSlot;					// hash of the PIDs to their dictionary indices + 1, 0: free
+	unsigned long long* blockOffset;	// index of the blocks written so far
+	unsigned long long* blockFirst;
+	unsigned blockCount;
+	unsigned blockCapacity;				// entries allocated for the index
+	unsigned long long eventCount;		// events written so far
+	unsigned long long offset;			// bytes written so far
+	Boolean error;						// a write error occured
+} stimulusWriter_t;
+
+Boolean stimulusIsCompressed(const char* filename);
+/* predicate: the file starts with STIMULUS_MAGIC							*/
+
+Boolean stimulusReaderOpen(stimulusReader_t* reader, const char* filename);
+/* opens a compressed stimulus file and reads its index, positioned on the	*/
+/* first event. Returns FALSE if the file cannot be read or is no			*/
+/* compressed stimulus, e.g. if it was truncated							*/
+
+Boolean stimulusRead(stimulusReader_t* reader, memoryEvent_t* event);
+/* decodes the next event, returns FALSE at the end of the file or on		*/
+/* errors																	*/
+
+Boolean stimulusSeek(stimulusReader_t* reader, unsigned long long position);
+/* continues reading at the event with the given number, counted from 0,	*/
+/* only the block holding it is decoded. Returns FALSE if it does not exist	*/
+
+void stimulusReaderClose(stimulusReader_t* reader);
+/* closes the file and releases the index and the block						*/
+
+Boolean stimulusLoadBlock(stimulusReader_t* reader, unsigned block, stimulusBlock_t* target);
+/* reads the payload of the block from the file into target and resets its	*/
+/* state, target->data grows as needed. Returns FALSE on errors				*/
+
+Boolean stimulusDecode(stimulusBlock_t* block, memoryEvent_t* event);
+/* decodes the next event of a loaded block, returns FALSE at the end of	*/
+/* the block or on errors. Blocks may be decoded in parallel, each by one	*/
+/* thread																	*/
+
+Boolean stimulusWriterOpen(stimulusWriter_t* writer, const char* filename);
+/* creates a compressed stimulus file and writes the header					*/
+/* Returns FALSE if the file cannot be created or out of memory				*/
+
+Boolean stimulusWrite(stimulusWriter_t* writer, const memoryEvent_t* event);
+/* appends the event, with the PIDs of the process file. Returns FALSE on	*/
+/* write errors																*/
+
+Boolean stimulusWriterClose(stimulusWriter_t* writer);
+/* writes the last block, the index and the footer and closes the file		*/
+/* Returns FALSE if any write failed										*/
+
+Boolean stimulusParseAction(char** ppLine, action_t* pAction);
+/* parses the next action of the list in a line of the text format			*/
+/* *ppLine points to the remaining part of the line and is advanced behind	*/
+/* the action. Unknown actions are returned with the operation 'error'		*/
+/* returns FALSE if the line contains no further action						*/
+
+void stimulusParseActions(char** ppLine, memoryEvent_t* event);
+/* parses the actions of a line into the event, at most MAX_EVENT_ACTIONS	*/
+/* of them. *ppLine is advanced behind them, set to NULL if the line holds	*/
+/* no further action														*/
+
+Boolean stimulusParseLine(char* line, memoryEvent_t* event, char** ppRest);
+/* parses a line of the text format as sim_ReadNextEvent() does, with the	*/
+/* PIDs of the process file. The actions beyond MAX_EVENT_ACTIONS are left	*/
+/* at *ppRest for stimulusParseActions(), they form further events of the	*/
+/* same time and PID. *ppRest is NULL if all actions fit into the event		*/
+/* Returns FALSE for comments, empty lines and lines without time and PID,	*/
+/* which sim_ReadNextEvent() reports as an error action						*/
+
+#endif  /* __STIMULUS__ */
@@ -0,0 +1,239 @@
+/* stimulusPack : converts a stimulus file of the text format into the		*/
+/* compressed format of stimulus.h and back. Packing streams the text line	*/
+/* by line and reports the compression. Unpacking decodes the blocks in		*/
+/* parallel, one per thread, while the blocks are read and the text is		*/
+/* written in their order, and reports the decoding rate on stderr.			*/
+/* The simulation reads either format, see sim_ReadNextEvent().				*/
+/*																			*/
+/* usage: stimulusPack <stimulus file> <compressed file>					*/
+/*        stimulusPack -d <compressed file> [threads] > <stimulus file>		*/
+/* Returns 0 on success, 2 on errors										*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "bs_types.h"
+#include "global.h"
+#include "stimulus.h"
+
+#define PACK_EVENT_TEXT_MAX (32 + MAX_EVENT_ACTIONS * 13)	// longest line of an unpacked event
+
+/* a block decoded by one thread into its text */
+typedef struct packWorker_struct
+{
+	stimulusBlock_t block;
+	char* text;
+	size_t size;					// bytes used in text
+	size_t capacity;				// bytes allocated for text
+	Boolean failed;					// the block is corrupt or out of memory
+} packWorker_t;
+
+packWorker_t* packWorkers[SMP_MAX_CPUS];
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+int pack(const char* textName, const char* packedName);
+/* converts the text format into the compressed one, returns the exit code	*/
+
+int unpack(const char* packedName, unsigned threads);
+/* converts the compressed format into the text one on stdout, decoding		*/
+/* the blocks with the given number of threads, returns the exit code		*/
+
+void unpackBlock(unsigned worker);
+/* thread function: decodes the block of the worker into its text			*/
+
+/* ------------------------------------------------------------------------ */
+
+int main(int argc, char* argv[])
+{
+	int threads = 1;
+	if ((argc == 3) && (strcmp(argv[1], "-d") != 0))
+		return pack(argv[1], argv[2]);
+	if (((argc == 3) || (argc == 4)) && (strcmp(argv[1], "-d") == 0))
+	{
+		if (argc == 4) threads = atoi(argv[3]);
+		if ((threads >= 1) && (threads <= SMP_MAX_CPUS))
+			return unpack(argv[2], (unsigned)threads);
+	}
+	fprintf(stderr, "usage: %s <stimulus file> <compressed file>\n", argv[0]);
+	fprintf(stderr, "       %s -d <compressed file> [threads 1..%u]\n", argv[0], SMP_MAX_CPUS);
+	return 2;
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+int pack(const char* textName, const char* packedName)
+{
+	char linebuffer[LINEBUFFER_SIZE + 1] = "";
+	char* pRest;
+	memoryEvent_t event;
+	stimulusWriter_t* writer;
+	FILE* textFile, * packedFile;
+	unsigned long long lines = 0, skipped = 0, textBytes = 0, packedBytes = 0;
+	double started = smpWallClock(), seconds;
+	Boolean ok = TRUE;
+
+	textFile = fopen(textName, "r");
+	if (textFile == NULL)
+	{
+		fprintf(stderr, "Error opening stimulus file %s\n", textName);
+		return 2;
+	}
+	// the writer contains the dictionary of the open block, keep it off the stack
+	writer = malloc(sizeof(stimulusWriter_t));
+	if ((writer == NULL) || !stimulusWriterOpen(writer, packedName))
+	{
+		fprintf(stderr, "Error creating compressed stimulus file %s\n", packedName);
+		fclose(textFile);
+		return 2;
+	}
+	// the first line is a comment, as for the simulation (see openStimulusFile())
+	if (fgets(linebuffer, LINEBUFFER_SIZE, textFile) != NULL) textBytes += strlen(linebuffer);
+	while (ok && (fgets(linebuffer, LINEBUFFER_SIZE, textFile) != NULL))
+	{
+		textBytes += strlen(linebuffer);
+		lines++;
+		if (stimulusParseLine(linebuffer, &event, &pRest))
+		{	// a line with more actions than an event holds gives several events
+			ok = stimulusWrite(writer, &event);
+			while (ok && (pRest != NULL))
+			{
+				stimulusParseActions(&pRest, &event);
+				ok = stimulusWrite(writer, &event);
+			}
+		}
+		else if ((linebuffer[0] != '#') && (linebuffer[0] != '\n'))
+			skipped++;				// no time and PID, the simulation reports an error for it
+	}
+	fclose(textFile);
+	if (!stimulusWriterClose(writer) || !ok)
+	{
+		fprintf(stderr, "Error writing compressed stimulus file %s\n", packedName);
+		free(writer);
+		return 2;
+	}
+	seconds = smpWallClock() - started;
+	packedFile = fopen(packedName, "rb");
+	if ((packedFile != NULL) && (fseek(packedFile, 0, SEEK_END) == 0))
+		packedBytes = (unsigned long long)ftell(packedFile);
+	if (packedFile != NULL) fclose(packedFile);
+	printf("%-28s %15llu\n", "lines", lines);
+	printf("%-28s %15llu\n", "events", writer->eventCount);
+	printf("%-28s %15u\n", "blocks", writer->blockCount);
+	printf("%-28s %15llu\n", "lines skipped", skipped);
+	printf("%-28s %15llu\n", "text bytes", textBytes);
+	printf("%-28s %15llu\n", "compressed bytes", packedBytes);
+	if (writer->eventCount > 0)
+		printf("%-28s %15.2f\n", "compressed bytes per event", (double)packedBytes / writer->eventCount);
+	if (packedBytes > 0)
+		printf("%-28s %15.2f\n", "compression ratio", (double)textBytes / packedBytes);
+	printf("%-28s %15.3f\n", "seconds", seconds);
+	free(writer);
+	return 0;
+}
+
+int unpack(const char* packedName, unsigned threads)
+{
+	stimulusReader_t* reader;
+	smpThread_t handles[SMP_MAX_CPUS];
+	unsigned count;
+	double started = smpWallClock(), seconds;
+	int result = 0;
+
+	// the reader and the workers contain the dictionaries, keep them off the stack
+	reader = malloc(sizeof(stimulusReader_t));
+	if ((reader == NULL) || !stimulusReaderOpen(reader, packedName))
+	{
+		fprintf(stderr, "Error opening compressed stimulus file %s\n", packedName);
+		free(reader);
+		return 2;
+	}
+	for (unsigned i = 0; i < threads; i++)
+	{
+		packWorkers[i] = calloc(1, sizeof(packWorker_t));
+		if (packWorkers[i] == NULL)
+		{
+			fprintf(stderr, "Out of memory\n");
+			return 2;
+		}
+	}
+	printf("# %s unpacked by stimulusPack\n", packedName);
+	// the blocks are read in rounds of one per thread, decoded in parallel and written in order
+	for (unsigned first = 0; (first < reader->blockCount) && (result == 0); first += threads)
+	{
+		count = (reader->blockCount - first < threads) ? reader->blockCount - first : threads;
+		for (unsigned i = 0; i < count; i++)
+		{
+			packWorkers[i]->failed = !stimulusLoadBlock(reader, first + i, &packWorkers[i]->block);
+			packWorkers[i]->size = 0;
+		}
+		for (unsigned i = 0; i < count; i++)
+		{
+			handles[i] = NULL;
+			if (!smpThreadStart(&handles[i], unpackBlock, i)) unpackBlock(i);	// decode in place
+		}
+		for (unsigned i = 0; i < count; i++)
+			if (handles[i] != NULL) smpThreadJoin(handles[i]);
+		for (unsigned i = 0; (i < count) && (result == 0); i++)
+		{
+			if (packWorkers[i]->failed)
+			{
+				fprintf(stderr, "Error decoding block %u of %s\n", first + i, packedName);
+				result = 2;
+			}
+			else if (fwrite(packWorkers[i]->text, 1, packWorkers[i]->size, stdout) != packWorkers[i]->size)
+				result = 2;
+		}
+	}
+	seconds = smpWallClock() - started;
+	fprintf(stderr, "%llu events in %u blocks decoded with %u threads in %.3f s (%.1f million events/s)\n",
+		reader->eventCount, reader->blockCount, threads, seconds,
+		(seconds > 0) ? reader->eventCount / seconds / 1e6 : 0.0);
+	for (unsigned i = 0; i < threads; i++)
+	{
+		free(packWorkers[i]->block.data);
+		free(packWorkers[i]->text);
+		free(packWorkers[i]);
+	}
+	stimulusReaderClose(reader);
+	free(reader);
+	return result;
+}
+
+void unpackBlock(unsigned worker)
+{
+	const char opNames[] = "SERWFXXX";		// indexed by operation_t, X is read back as 'error'
+	packWorker_t* pWorker = packWorkers[worker];
+	memoryEvent_t event;
+	char* text;
+	char* pos;
+	if (pWorker->failed) return;
+	while (stimulusDecode(&pWorker->block, &event))
+	{
+		if (pWorker->size + PACK_EVENT_TEXT_MAX > pWorker->capacity)
+		{
+			text = realloc(pWorker->text, (pWorker->capacity == 0) ? (1 << 20) : pWorker->capacity * 2);
+			if (text == NULL)
+			{
+				pWorker->failed = TRUE;
+				return;
+			}
+			pWorker->text = text;
+			pWorker->capacity = (pWorker->capacity == 0) ? (1 << 20) : pWorker->capacity * 2;
+		}
+		pos = pWorker->text + pWorker->size;
+		pos += sprintf(pos, "%u %u", event.time, event.pid);
+		for (unsigned i = 0; i < event.actionCount; i++)
+		{
+			if ((event.action[i].op == read) || (event.action[i].op == write) || (event.action[i].op == forkAction))
+				pos += sprintf(pos, " %c%u", opNames[event.action[i].op], event.action[i].page);
+			else
+				pos += sprintf(pos, " %c", opNames[event.action[i].op]);
+		}
+		*pos++ = '\n';
+		pWorker->size = (size_t)(pos - pWorker->text);
+	}
+	if (pWorker->block.decoded < pWorker->block.events) pWorker->failed = TRUE;	// corrupt payload
+}
@@ -0,0 +1,114 @@
+/* Implementation of the file I/O of the host used by the backing store		*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <sys/stat.h>
+#else
+#define _GNU_SOURCE				// O_DIRECT
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include "swapfile.h"
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+#ifdef _WIN32
+
+int swapFileOpen(const char* filename, int* direct)
+{
+	*direct = 0;			// the page cache cannot be bypassed with the C runtime
+	return _open(filename, _O_RDWR | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+}
+
+void swapFileClose(int file, const char* filename)
+{
+	_close(file);
+	remove(filename);
+}
+
+int swapFileWrite(int file, void* const pages[], unsigned count, size_t pageSize, unsigned long long offset)
+{
+	if (_lseeki64(file, (__int64)offset, SEEK_SET) < 0) return 0;
+	for (unsigned k = 0; k < count; k++)
+		if (_write(file, pages[k], (unsigned)pageSize) != (int)pageSize) return 0;
+	return 1;
+}
+
+int swapFileRead(int file, void* page, size_t pageSize, unsigned long long offset)
+{
+	if (_lseeki64(file, (__int64)offset, SEEK_SET) < 0) return 0;
+	return (_read(file, page, (unsigned)pageSize) == (int)pageSize);
+}
+
+void* swapFileAllocate(size_t bytes, size_t alignment)
+{
+	return _aligned_malloc(bytes, alignment);
+}
+
+void swapFileFree(void* memory)
+{
+	_aligned_free(memory);
+}
+
+#else
+
+int swapFileOpen(const char* filename, int* direct)
+{
+	int flags = O_RDWR | O_CREAT | O_TRUNC;
+	int file = -1;
+#ifdef O_DIRECT
+	if (*direct) file = open(filename, flags | O_DIRECT, 0600);
+#endif
+	if (file < 0)
+	{	// direct I/O is not supported by all file systems, e.g. tmpfs
+		*direct = 0;
+		file = open(filename, flags, 0600);
+	}
+	return file;
+}
+
+void swapFileClose(int file, const char* filename)
+{
+	close(file);
+	remove(filename);
+}
+
+int swapFileWrite(int file, void* const pages[], unsigned count, size_t pageSize, unsigned long long offset)
+{
+	struct iovec iov[SWAPFILE_MAX_PAGES];
+	if (count > SWAPFILE_MAX_PAGES) return 0;
+	for (unsigned k = 0; k < count; k++)
+	{
+		iov[k].iov_base = pages[k];
+		iov[k].iov_len = pageSize;
+	}
+	return (pwritev(file, iov, (int)count, (off_t)offset) == (ssize_t)(count * pageSize));
+}
+
+int swapFileRead(int file, void* page, size_t pageSize, unsigned long long offset)
+{
+	return (pread(file, page, pageSize, (off_t)offset) == (ssize_t)pageSize);
+}
+
+void* swapFileAllocate(size_t bytes, size_t alignment)
+{
+	void* memory = NULL;
+	if (posix_memalign(&memory, alignment, bytes) != 0) return NULL;
+	return memory;
+}
+
+void swapFileFree(void* memory)
+{
+	free(memory);
+}
+
+#endif
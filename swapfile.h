@@ -0,0 +1,35 @@
+/* Include-file defining the file I/O of the host used by the backing store	*/
+/* The functions are thin wrappers of the POSIX resp. Win32 calls. They are	*/
+/* kept apart from the OS, as the system headers declare read() and write(),*/
+/* which collide with the operations of the simulation in bs_types.h, so	*/
+/* this header must not include bs_types.h and uses int as truth value.		*/
+#ifndef __SWAPFILE__
+#define __SWAPFILE__
+
+#include <stddef.h>
+
+#define SWAPFILE_MAX_PAGES 64	// maximum number of pages written by one call
+
+int swapFileOpen(const char* filename, int* direct);
+/* creates the file, empty, for reading and writing. If *direct is set,		*/
+/* the page cache of the host is bypassed; *direct is cleared if this is	*/
+/* not supported. Returns the file handle, -1 on error						*/
+
+void swapFileClose(int file, const char* filename);
+/* closes and removes the file												*/
+
+int swapFileWrite(int file, void* const pages[], unsigned count, size_t pageSize, unsigned long long offset);
+/* writes the pages to consecutive locations starting at offset with one	*/
+/* call (pwritev) where available. Returns 1 on success, 0 on error			*/
+
+int swapFileRead(int file, void* page, size_t pageSize, unsigned long long offset);
+/* reads one page from offset, returns 1 on success, 0 on error				*/
+
+void* swapFileAllocate(size_t bytes, size_t alignment);
+/* allocates memory with the given alignment, as needed for direct I/O		*/
+/* Returns NULL if out of memory											*/
+
+void swapFileFree(void* memory);
+/* frees memory allocated by swapFileAllocate()								*/
+
+#endif  /* __SWAPFILE__ */
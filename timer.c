@@ -12,17 +12,31 @@ void timerEventHandler(void)
 /* xxxx extended for advanced memory management function to enable     xxxx */
 /* xxxx full functionality of the operating system					   xxxx */
 {
-	logGeneric("Processing Timer Event Handler: resetting R-Bits");
-	// in absence of a data structure indexing the pages that are present, all 
-	// running processes and all present pages must be checked. 
-	// If the page is present, the R-bit is reset.
-	for (unsigned pid = 1; pid < MAX_PROCESSES; pid++)
-	{
-		if ((processTable[pid].valid) && (processTable[pid].pageTable != NULL))
-			for (unsigned page = 0; page < processTable[pid].size; page++)
-				if (processTable[pid].pageTable[page].present)
-					processTable[pid].pageTable[page].referenced = FALSE; 
-	}
-	// for a more sophisticated memory management systems with reasonable 
-	// page replacement, this timer event endler must be improved
+	timerEventHandlerTicks(1);
+}
+
+void timerEventHandlerTicks(unsigned ticks)
+/* processes <ticks> consecutive timer events without memory accesses in	*/
+/* between in one step														*/
+{
+	unsigned long long started;	// wall-clock time of the call, for the latency histograms
+	if (ticks == 0) return;
+	started = latencyEnabled ? latencyClock() : 0;
+	if (ticks == 1)
+		logGeneric("Processing Timer Event Handler: resetting R-Bits");
+	else if (logEnabled)
+		printf("%6u : Processing Timer Event Handler: resetting R-Bits, %u idle ticks coalesced\n",
+			systemTime, ticks);
+	// The R-bits only need to be reset, if any page was referenced since the 
+	// last timer event. Otherwise, e.g. during idle periods, all R-bits are 
+	// already cleared. Further ticks without accesses in between never change
+	// the R-bits, but the aging counters are shifted by all of them.
+	updateReplacementStatistics(ticks);
+	// make the adaptation of the scan resistant algorithms visible
+	if (IS_ADAPTIVE_POLICY(replacementPolicy)) adaptiveLogStatistics();
+	// the usage of the owners, to follow them towards their limits
+	if (ownersEnabled) ownerLogStatistics();
+	// the medium-term scheduler suspends and resumes processes on thrashing
+	loadControlTick();
+	if (latencyEnabled) latencyTimer(ticks, started);
 }
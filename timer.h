@@ -13,6 +13,13 @@ void timerEventHandler(void);
 /* Will be triggered by the simulation environment periodically based on	*/
 /* the period given by TIMER_INTERVAL (see global.h)						*/
 
+void timerEventHandlerTicks(unsigned ticks);
+/* processes the given number of consecutive timer events in one step.		*/
+/* The caller guarantees that no memory access happened in between these	*/
+/* events, e.g. during an idle period of the stimulus. The result is the	*/
+/* same as calling timerEventHandler() <ticks> times, but the page tables	*/
+/* are swept at most once. systemTime must be the time of the last tick.	*/
+
 
 
 /* ----------------------------------------------------------------	*/
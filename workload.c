@@ -0,0 +1,143 @@
+/* Implementation of the generated workload, one coroutine per process		*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <stdio.h>
+#include "bs_types.h"
+#include "global.h"
+#include "workload.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in workload.h	*/
+unsigned workloadProcesses = WORKLOAD_PROCESSES;
+unsigned workloadLive = WORKLOAD_LIVE;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+
+/* the coroutine of a process: the point it continues at and the local		*/
+/* variables it keeps between its actions									*/
+typedef struct workloadCoroutine_struct
+{
+	workloadState_t state;
+	unsigned random;			// state of the random generator of the process
+	unsigned remaining;			// accesses left
+	unsigned phaseLeft;			// accesses left in the current locality phase
+	unsigned windowBase;		// first page of the window
+	unsigned window;			// pages in the window
+} workloadCoroutine_t;
+
+workloadCoroutine_t* coroutines = NULL;	// one per entry of the process table, grows with it
+unsigned workloadSerial = 0;			// processes started so far
+// the classes of the processes in turn
+const processType_t workloadClasses[] = { interactive, foreground, batch, background };
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+unsigned workloadRandom(workloadCoroutine_t* co);
+/* returns the next number of the random generator of the process			*/
+/* (xorshift), which never becomes 0										*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+Boolean setWorkload(const char* spec)
+{
+	unsigned processes, live = workloadLive;
+	if ((sscanf(spec, "%u,%u", &processes, &live) < 1) || (processes == 0) || (live == 0))
+		return FALSE;
+	workloadProcesses = processes;
+	workloadLive = live;
+	return TRUE;
+}
+
+Boolean workloadInit(void)
+{
+	if (!registerProcessArray((void**)&coroutines, sizeof(workloadCoroutine_t))) return FALSE;
+	workloadSerial = 0;
+	while ((workloadSerial < workloadLive) && (workloadSerial < workloadProcesses))
+		if (workloadSpawn() == NOPROCESS) return FALSE;
+	return TRUE;
+}
+
+unsigned workloadSpawn(void)
+{
+	workloadCoroutine_t* co;
+	PCB_t* pcb;
+	unsigned pid;
+	if (workloadSerial == workloadProcesses) return NOPROCESS;
+	// the PID is the number of the process, the entry is the one of a
+	// process that ended if there is one
+	pid = createProcess(workloadSerial + 1);
+	if (pid == NOPROCESS) return NOPROCESS;
+	workloadSerial++;
+	co = &coroutines[pid];
+	pcb = &processTable[pid];
+	// the generator of each process is seeded by its number, not by the time
+	co->random = (workloadSerial * 2654435761u) | 1;
+	pcb->valid = TRUE;
+	pcb->type = workloadClasses[workloadSerial % (sizeof(workloadClasses) / sizeof(workloadClasses[0]))];
+	pcb->size = WORKLOAD_SIZE / 2 + workloadRandom(co) % WORKLOAD_SIZE + 1;
+	pcb->ownerID = 0;
+	pcb->status = init;
+	pcb->start = systemTime;
+	pcb->duration = 0;
+	pcb->usedCPU = 0;
+	co->remaining = WORKLOAD_LENGTH / 2 + workloadRandom(co) % WORKLOAD_LENGTH + 1;
+	co->window = (WORKLOAD_WINDOW < pcb->size) ? WORKLOAD_WINDOW : pcb->size;
+	co->phaseLeft = 0;
+	co->state = workloadStarting;
+	return pid;
+}
+
+action_t workloadResume(unsigned pid)
+{
+	workloadCoroutine_t* co = &coroutines[pid];
+	action_t action = { error, 0 };
+	switch (co->state)
+	{
+	case workloadStarting:
+		co->state = workloadAccessing;
+		action.op = start;
+		break;
+	case workloadAccessing:
+		if (co->phaseLeft == 0)
+		{	// the next locality phase, the window moves
+			co->phaseLeft = WORKLOAD_PHASE;
+			co->windowBase = workloadRandom(co) % (processTable[pid].size - co->window + 1);
+		}
+		co->phaseLeft--;
+		action.page = co->windowBase + workloadRandom(co) % co->window;
+		action.op = (workloadRandom(co) % 100 < WORKLOAD_WRITES) ? write : read;
+		if (--co->remaining == 0) co->state = workloadEnding;
+		break;
+	case workloadEnding:
+		co->state = workloadDone;
+		action.op = end;
+		break;
+	default:
+	case workloadDone:
+		break;					// resumed after its end
+	}
+	return action;
+}
+
+unsigned workloadStarted(void)
+{
+	return workloadSerial;
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+unsigned workloadRandom(workloadCoroutine_t* co)
+{
+	unsigned x = co->random;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	co->random = x;
+	return x;
+}
@@ -0,0 +1,50 @@
+/* Include-file defining the generated workload: instead of reading the		*/
+/* stimulus file each simulated process is a coroutine generating its own	*/
+/* accesses from a workload model, resumed by the scheduler of				*/
+/* coreLoopScheduled() each time the process runs. The state of a			*/
+/* coroutine is a few words per process table entry, no trace is kept.		*/
+/* The workload consists of workloadProcesses processes, at most			*/
+/* workloadLive of them live at the same time. When one process completes	*/
+/* the next one starts, its PID is its number (1 for the first) and it		*/
+/* takes the entry of the process table released by the completed one.		*/
+/* The model of a process: it starts, accesses its pages and ends. The		*/
+/* accesses fall into a window of WORKLOAD_WINDOW pages, which moves to a	*/
+/* random place of the process memory every WORKLOAD_PHASE accesses			*/
+/* (locality phases). WORKLOAD_WRITES percent of the accesses are writes.	*/
+/* The classes of the processes alternate, the number of accesses and the	*/
+/* size vary around WORKLOAD_LENGTH and WORKLOAD_SIZE. Each process draws	*/
+/* from a random generator of its own seeded by its number, so a workload	*/
+/* is the same in every run.												*/
+#ifndef __WORKLOAD__
+#define __WORKLOAD__
+
+#include "bs_types.h"
+
+/* state of the coroutine of a process, the point it continues at			*/
+typedef enum
+{
+	workloadStarting, workloadAccessing, workloadEnding, workloadDone
+} workloadState_t;
+
+extern unsigned workloadProcesses;		// processes generated in total, 0: the stimulus file is used
+extern unsigned workloadLive;			// processes live at the same time at most
+
+Boolean setWorkload(const char* spec);
+/* sets the workload from a string of the form <processes>[,<live>],		*/
+/* returns FALSE on syntax errors											*/
+
+Boolean workloadInit(void);
+/* starts the first workloadLive processes. Returns FALSE if out of memory	*/
+
+unsigned workloadSpawn(void);
+/* creates the next process of the workload and returns its index in the	*/
+/* process table, NOPROCESS if all processes were started or out of memory	*/
+
+action_t workloadResume(unsigned pid);
+/* resumes the coroutine of the process up to its next action and returns	*/
+/* it: start first, then the accesses, end last								*/
+
+unsigned workloadStarted(void);
+/* returns the number of processes started so far							*/
+
+#endif  /* __WORKLOAD__ */
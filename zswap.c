@@ -0,0 +1,340 @@
+/* Implementation of the compressed in-memory swap tier						*/
+/* for comments on the global functions see the associated .h-file			*/
+
+/* ---------------------------------------------------------------- */
+/* Include required external definitions */
+#include <stdio.h>
+#include <string.h>
+#include "bs_types.h"
+#include "global.h"
+#include "zswap.h"
+
+/* ---------------------------------------------------------------- */
+/* Declare global variables according to definition in zswap.h		*/
+unsigned zswapPoolSize = ZSWAP_POOL_SIZE;
+unsigned zswapDecompressCost = ZSWAP_DECOMPRESS_COST;
+Boolean zswapEnabled = FALSE;
+
+/* ----------------------------------------------------------------	*/
+/* Declarations of global variables visible only in this file 		*/
+
+#define PAGE_WORDS (BACKINGSTORE_PAGE_SIZE / sizeof(unsigned long long))
+#define TAG_BYTES (PAGE_WORDS / 4)	// 2 bits per word
+#define TAG_ZERO 0
+#define TAG_REPEAT 1
+#define TAG_LITERAL 2
+
+/* a page held in the pool, the entries are linked in the order they were	*/
+/* stored, the free entries are linked by next								*/
+typedef struct zswapEntry_struct
+{
+	unsigned pid;
+	unsigned page;
+	unsigned size;					// bytes of the compressed page
+	Boolean modified;				// the copy on the swap device is out of date
+	int prev;						// entry stored before, NONE for the oldest
+	int next;						// entry stored after, NONE for the latest
+	unsigned char* data;			// the compressed page
+} zswapEntry_t;
+
+zswapEntry_t* zswapEntries = NULL;
+unsigned zswapCapacity = 0;			// size of zswapEntries
+int zswapFree = NONE;				// first free entry
+int zswapOldest = NONE;				// least recently stored page, written back first
+int zswapLatest = NONE;				// most recently stored page
+unsigned long long zswapLimit = 0;	// size of the pool in bytes
+unsigned long long zswapBytes = 0;	// bytes used by the pages in the pool
+unsigned zswapPages = 0;			// number of pages in the pool
+unsigned long long zswapPageBuffer[PAGE_WORDS];			// a page outside of the frames
+unsigned char zswapBuffer[TAG_BYTES + BACKINGSTORE_PAGE_SIZE];	// a page being compressed
+zswapStatistics_t zswapStats;
+
+/* ------------------------------------------------------------------------ */
+/*		               Declarations of local helper functions				*/
+
+unsigned compressPage(const unsigned long long* words, unsigned char* out);
+/* compresses the page into out, returns the size of the compressed page	*/
+
+void decompressPage(const unsigned char* in, unsigned long long* words);
+/* restores the page compressed by compressPage()							*/
+
+int allocateEntry(void);
+/* returns a free entry, NONE if out of memory								*/
+
+void removeEntry(int entry);
+/* unlinks the entry, frees its data and adds it to the free entries		*/
+
+Boolean writeBack(void);
+/* writes the least recently stored page back to the swap device and		*/
+/* removes it from the pool. Returns FALSE on an I/O error					*/
+
+/* ------------------------------------------------------------------------ */
+/*                Start of public Implementations							*/
+
+Boolean zswapOpen(unsigned poolSize)
+{
+	memset(&zswapStats, 0, sizeof(zswapStats));
+	zswapFree = zswapOldest = zswapLatest = NONE;
+	zswapBytes = 0;
+	zswapPages = 0;
+	zswapLimit = (unsigned long long)poolSize * 1024;
+	zswapEnabled = (poolSize > 0);
+	return TRUE;
+}
+
+void zswapClose(void)
+{
+	for (unsigned i = 0; i < zswapCapacity; i++)
+		slabFree(zswapEntries[i].data);
+	free(zswapEntries);
+	zswapEntries = NULL;
+	zswapCapacity = 0;
+	zswapFree = zswapOldest = zswapLatest = NONE;
+	zswapBytes = 0;
+	zswapPages = 0;
+	zswapEnabled = FALSE;
+}
+
+Boolean zswapPageOut(unsigned pid, unsigned page, int frame, Boolean modified)
+{
+	pageTableEntry_t* pte = &processTable[pid].pageTable[page];
+	const unsigned long long* words;
+	zswapEntry_t* pEntry;
+	unsigned size;
+	int entry;
+	double t0 = smpWallClock();
+	if (backingStoreEnabled)
+		words = backingStoreFrame(frame);
+	else
+	{	// without a swap file the contents of the page are not simulated
+		backingStoreFillPage(zswapPageBuffer, pid, page);
+		words = zswapPageBuffer;
+	}
+	size = compressPage(words, zswapBuffer);
+	zswapStats.compressSeconds += smpWallClock() - t0;
+	pte->zswapEntry = ZSWAP_ON_DEVICE;
+	if ((size > ZSWAP_MAX_COMPRESSED) || (size > zswapLimit))
+	{	// not worth the room in the pool
+		zswapStats.rejects++;
+		return FALSE;
+	}
+	while (zswapBytes + size > zswapLimit)
+		if (!writeBack()) logPid(pid, "OS-ERROR: Page could not be written back from the compressed pool");
+	if ((entry = allocateEntry()) == NONE)
+	{
+		zswapStats.rejects++;
+		return FALSE;
+	}
+	pEntry = &zswapEntries[entry];
+	if ((pEntry->data = slabAlloc(NOPROCESS, size)) == NULL)
+	{
+		pEntry->next = zswapFree;
+		zswapFree = entry;
+		zswapStats.rejects++;
+		return FALSE;
+	}
+	memcpy(pEntry->data, zswapBuffer, size);
+	pEntry->pid = pid;
+	pEntry->page = page;
+	pEntry->size = size;
+	pEntry->modified = modified;
+	// the latest page is written back last
+	pEntry->prev = zswapLatest;
+	pEntry->next = NONE;
+	if (zswapLatest != NONE) zswapEntries[zswapLatest].next = entry;
+	else zswapOldest = entry;
+	zswapLatest = entry;
+	pte->zswapEntry = entry;
+	zswapBytes += size;
+	zswapPages++;
+	zswapStats.stores++;
+	zswapStats.compressedBytes += size;
+	zswapStats.samples++;
+	zswapStats.sampledPages += zswapPages;
+	zswapStats.sampledBytes += zswapBytes;
+	if (zswapPages > zswapStats.maxPages) zswapStats.maxPages = zswapPages;
+	if (zswapBytes > zswapStats.maxBytes) zswapStats.maxBytes = zswapBytes;
+	return TRUE;
+}
+
+Boolean zswapPageIn(unsigned pid, unsigned page, int frame, Boolean* modified)
+{
+	pageTableEntry_t* pte = &processTable[pid].pageTable[page];
+	unsigned long long* words;
+	int entry = pte->zswapEntry;
+	double t0;
+	if (entry < 0)
+	{
+		if (entry == ZSWAP_ON_DEVICE) zswapStats.misses++;
+		pte->zswapEntry = NONE;
+		return FALSE;
+	}
+	t0 = smpWallClock();
+	words = backingStoreEnabled ? backingStoreFrame(frame) : zswapPageBuffer;
+	decompressPage(zswapEntries[entry].data, words);
+	zswapStats.decompressSeconds += smpWallClock() - t0;
+	if ((words[0] != pid) || (words[1] != page))
+	{
+		zswapStats.errors++;
+		logPid(pid, "OS-ERROR: Page decompressed from the pool with wrong contents");
+	}
+	*modified = zswapEntries[entry].modified;
+	removeEntry(entry);
+	pte->zswapEntry = NONE;
+	zswapStats.hits++;
+	return TRUE;
+}
+
+Boolean zswapHolds(unsigned pid, unsigned page)
+{
+	return zswapEnabled && (processTable[pid].pageTable[page].zswapEntry >= 0);
+}
+
+void zswapForget(unsigned pid, unsigned page)
+{
+	pageTableEntry_t* pte = &processTable[pid].pageTable[page];
+	if (pte->zswapEntry >= 0) removeEntry(pte->zswapEntry);
+	pte->zswapEntry = NONE;
+}
+
+void zswapGetStatistics(zswapStatistics_t* stats)
+{
+	*stats = zswapStats;
+}
+
+void zswapPrintStatistics(void)
+{
+	zswapStatistics_t s;
+	double frameBytes = (double)MEMORYSIZE * BACKINGSTORE_PAGE_SIZE;
+	double avgPages, avgBytes;
+	zswapGetStatistics(&s);
+	avgPages = (s.samples > 0) ? (double)s.sampledPages / s.samples : 0.0;
+	avgBytes = (s.samples > 0) ? (double)s.sampledBytes / s.samples : 0.0;
+	printf("Compressed pool (%u KiB)\n", zswapPoolSize);
+	printf("%-28s %15llu\n", "pages stored", s.stores);
+	printf("%-28s %15llu\n", "pages rejected", s.rejects);
+	printf("%-28s %15llu\n", "page faults served (hits)", s.hits);
+	printf("%-28s %15llu\n", "page faults missed", s.misses);
+	printf("%-28s %14.1f%%\n", "hit rate", (s.hits + s.misses > 0) ? 100.0 * s.hits / (s.hits + s.misses) : 0.0);
+	printf("%-28s %15llu\n", "pages written back", s.writeBacks);
+	printf("%-28s %15llu\n", "modified pages written back", s.dirtyWriteBacks);
+	printf("%-28s %15.1f\n", "avg. compressed size", (s.stores > 0) ? (double)s.compressedBytes / s.stores : 0.0);
+	printf("%-28s %15.2f\n", "compression ratio",
+		(s.compressedBytes > 0) ? (double)s.stores * BACKINGSTORE_PAGE_SIZE / s.compressedBytes : 0.0);
+	printf("%-28s %15u\n", "max. pages in the pool", s.maxPages);
+	printf("%-28s %15llu\n", "max. bytes in the pool", s.maxBytes);
+	// memory holding the frames and the pool compared to the pages it holds
+	printf("%-28s %15.2f\n", "effective memory expansion",
+		(frameBytes + avgPages * BACKINGSTORE_PAGE_SIZE) / (frameBytes + avgBytes));
+	printf("%-28s %15.2f\n", "avg. compression [us]", (s.stores + s.rejects > 0) ? 1e6 * s.compressSeconds / (s.stores + s.rejects) : 0.0);
+	printf("%-28s %15.2f\n", "avg. decompression [us]", (s.hits > 0) ? 1e6 * s.decompressSeconds / s.hits : 0.0);
+	printf("%-28s %15llu\n", "decompression errors", s.errors);
+}
+
+/* ---------------------------------------------------------------- */
+/*                Implementation of local helper functions          */
+
+unsigned compressPage(const unsigned long long* words, unsigned char* out)
+{
+	unsigned char* literal = out + TAG_BYTES;
+	unsigned long long previous = 0;
+	unsigned tag;
+	memset(out, 0, TAG_BYTES);
+	for (unsigned i = 0; i < PAGE_WORDS; i++)
+	{
+		if (words[i] == 0) tag = TAG_ZERO;
+		else if (words[i] == previous) tag = TAG_REPEAT;
+		else
+		{
+			tag = TAG_LITERAL;
+			memcpy(literal, &words[i], sizeof(unsigned long long));
+			literal += sizeof(unsigned long long);
+		}
+		out[i / 4] |= (unsigned char)(tag << (2 * (i % 4)));
+		previous = words[i];
+	}
+	return (unsigned)(literal - out);
+}
+
+void decompressPage(const unsigned char* in, unsigned long long* words)
+{
+	const unsigned char* literal = in + TAG_BYTES;
+	unsigned long long previous = 0;
+	for (unsigned i = 0; i < PAGE_WORDS; i++)
+	{
+		switch ((in[i / 4] >> (2 * (i % 4))) & 3)
+		{
+		case TAG_ZERO:
+			words[i] = 0;
+			break;
+		case TAG_REPEAT:
+			words[i] = previous;
+			break;
+		default:
+			memcpy(&words[i], literal, sizeof(unsigned long long));
+			literal += sizeof(unsigned long long);
+			break;
+		}
+		previous = words[i];
+	}
+}
+
+int allocateEntry(void)
+{
+	zswapEntry_t* grown;
+	unsigned capacity;
+	int entry;
+	if (zswapFree == NONE)
+	{
+		capacity = (zswapCapacity > 0) ? 2 * zswapCapacity : 1024;
+		grown = realloc(zswapEntries, capacity * sizeof(zswapEntry_t));
+		if (grown == NULL) return NONE;
+		zswapEntries = grown;
+		for (unsigned i = capacity; i > zswapCapacity; i--)
+		{
+			zswapEntries[i - 1].data = NULL;
+			zswapEntries[i - 1].next = zswapFree;
+			zswapFree = (int)i - 1;
+		}
+		zswapCapacity = capacity;
+	}
+	entry = zswapFree;
+	zswapFree = zswapEntries[entry].next;
+	return entry;
+}
+
+void removeEntry(int entry)
+{
+	zswapEntry_t* pEntry = &zswapEntries[entry];
+	if (pEntry->prev != NONE) zswapEntries[pEntry->prev].next = pEntry->next;
+	else zswapOldest = pEntry->next;
+	if (pEntry->next != NONE) zswapEntries[pEntry->next].prev = pEntry->prev;
+	else zswapLatest = pEntry->prev;
+	zswapBytes -= pEntry->size;
+	zswapPages--;
+	slabFree(pEntry->data);
+	pEntry->data = NULL;
+	pEntry->next = zswapFree;
+	zswapFree = entry;
+}
+
+Boolean writeBack(void)
+{
+	zswapEntry_t* pEntry = &zswapEntries[zswapOldest];
+	pageTableEntry_t* pte = &processTable[pEntry->pid].pageTable[pEntry->page];
+	Boolean ok = TRUE;
+	// a clean page keeps its copy on the swap device, like a clean page moved out
+	if (pEntry->modified)
+	{
+		if (backingStoreEnabled)
+		{
+			decompressPage(pEntry->data, zswapPageBuffer);
+			ok = backingStoreWritePage(zswapPageBuffer, &pte->swapLocation);
+		}
+		zswapStats.dirtyWriteBacks++;
+	}
+	pte->zswapEntry = ZSWAP_ON_DEVICE;
+	removeEntry(zswapOldest);
+	zswapStats.writeBacks++;
+	return ok;
+}
@@ -0,0 +1,74 @@
+/* Include-file defining the compressed in-memory swap tier (like zswap)	*/
+/* Pages moved out are compressed and held in a bounded pool in RAM before	*/
+/* they go to the swap device. A page fault on a page in the pool is served	*/
+/* by decompressing it, which costs CPU time instead of a disk read. When	*/
+/* the pool is full, the least recently stored pages are written back to	*/
+/* the swap device. Pages that compress poorly are not kept in the pool.	*/
+/* The page contents are those of the backing store if a swap file is		*/
+/* used, else the initial contents of the pages are compressed.				*/
+/* The pages are compressed word by word: a zero word and a word repeating	*/
+/* the previous one take 2 bits, any other word is copied.					*/
+#ifndef __ZSWAP__
+#define __ZSWAP__
+
+#include "bs_types.h"
+
+#define ZSWAP_ON_DEVICE -2		// pageTableEntry_t.zswapEntry: the page was moved out to the swap device
+#define ZSWAP_MAX_COMPRESSED (BACKINGSTORE_PAGE_SIZE * 3 / 4)	// larger pages are not kept in the pool
+
+/* statistics of the compressed pool, for the report at the end of the run	*/
+typedef struct zswapStatistics_struct
+{
+	unsigned long long stores;			// pages moved out into the pool
+	unsigned long long rejects;			// pages compressing poorly, moved out to the swap device
+	unsigned long long hits;			// page faults served from the pool
+	unsigned long long misses;			// page faults on pages moved out to the swap device
+	unsigned long long writeBacks;		// pages written back to the swap device as the pool was full
+	unsigned long long dirtyWriteBacks;	// modified pages among them, written to the swap file
+	unsigned long long compressedBytes;	// sum of the compressed sizes of all pages stored
+	unsigned long long errors;			// pages decompressed with wrong contents
+	unsigned long long samples;			// number of times the pool size was sampled
+	unsigned long long sampledPages;	// sum of the pages in the pool at each sample
+	unsigned long long sampledBytes;	// sum of the bytes used by the pool at each sample
+	unsigned long long maxBytes;		// largest number of bytes used by the pool
+	unsigned maxPages;					// largest number of pages in the pool
+	double compressSeconds;				// wall clock time spent compressing
+	double decompressSeconds;			// wall clock time spent decompressing
+} zswapStatistics_t;
+
+extern unsigned zswapPoolSize;			// size of the pool in KiB, 0: no compressed tier
+extern unsigned zswapDecompressCost;	// simulated time a blocking page fault served from the pool takes
+extern Boolean zswapEnabled;			// set by zswapOpen()
+
+Boolean zswapOpen(unsigned poolSize);
+/* creates the empty pool of poolSize KiB. A size of 0 leaves the tier		*/
+/* disabled and returns TRUE												*/
+
+void zswapClose(void);
+/* frees the pool and all pages held in it									*/
+
+Boolean zswapPageOut(unsigned pid, unsigned page, int frame, Boolean modified);
+/* compresses the page in the frame into the pool, writing back the least	*/
+/* recently stored pages if there is not enough room. Returns FALSE if the	*/
+/* page compresses poorly and must be moved out to the swap device			*/
+
+Boolean zswapPageIn(unsigned pid, unsigned page, int frame, Boolean* modified);
+/* loads the page from the pool into the frame and removes it from the		*/
+/* pool. *modified is set if the copy on the swap device is out of date.	*/
+/* Returns FALSE if the page is not in the pool and must be read from the	*/
+/* swap device																*/
+
+Boolean zswapHolds(unsigned pid, unsigned page);
+/* returns TRUE if a page fault on the page is served from the pool			*/
+
+void zswapForget(unsigned pid, unsigned page);
+/* removes the page of a terminated process from the pool					*/
+
+void zswapGetStatistics(zswapStatistics_t* stats);
+/* returns the current statistics											*/
+
+void zswapPrintStatistics(void);
+/* prints the hit rate, the compression ratio and the effective expansion	*/
+/* of the memory															*/
+
+#endif  /* __ZSWAP__ */